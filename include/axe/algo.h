@@ -3,6 +3,8 @@
 #include "def.h"
 #include "iter.h"
 #include "pred.h"
+#include "exec.h"
+#include "seq.h"
 
 void ax_transform(
 		const ax_citer *first1,
@@ -51,6 +53,94 @@ void ax_find_if_not(
 		const ax_citer *last,
 		const ax_pred *upred);
 
+/* acc holds the initial value and receives bpred(acc, value) for each element in order */
+void ax_reduce(
+		const ax_citer *first,
+		const ax_citer *last,
+		void *acc,
+		const ax_pred *bpred);
+
+/* Same as ax_reduce on the results of upred, which are of the type of acc, size bytes each */
+void ax_transform_reduce(
+		const ax_citer *first,
+		const ax_citer *last,
+		void *acc,
+		size_t size,
+		const ax_pred *upred,
+		const ax_pred *bpred);
+
+/*
+ * Parallel versions run on the workers of exec. Random access ranges are
+ * split into chunks, other ranges and short ones are left to the sequential
+ * version. Predicates are called concurrently and in no particular order
+ */
+
+void ax_par_transform(
+		const ax_citer *first1,
+		const ax_citer *last1,
+		const ax_iter *first2,
+		const ax_pred *upred,
+		ax_exec *exec);
+
+/* all_of, any_of and none_of stop every chunk once the answer is known */
+ax_bool ax_par_all_of(
+		const ax_citer *first,
+		const ax_citer *last,
+		const ax_pred *upred,
+		ax_exec *exec);
+
+ax_bool ax_par_any_of(
+		const ax_citer *first,
+		const ax_citer *last,
+		const ax_pred *upred,
+		ax_exec *exec);
+
+ax_bool ax_par_none_of(
+		const ax_citer *first,
+		const ax_citer *last,
+		const ax_pred *upred,
+		ax_exec *exec);
+
+size_t ax_par_count_if(
+		const ax_citer *first,
+		const ax_citer *last,
+		const ax_pred *upred,
+		ax_exec *exec);
+
+/* Finds the first match like ax_find_if, chunks after a match found are given up */
+void ax_par_find_if(
+		ax_citer *first,
+		const ax_citer *last,
+		const ax_pred *upred,
+		ax_exec *exec);
+
+/* Elements of link types are generated sequentially */
+void ax_par_generate(
+		const ax_iter *first,
+		const ax_iter *last,
+		const void *ptr,
+		ax_exec *exec);
+
+/*
+ * bpred must be associative. Chunks are folded in parallel and combined
+ * into acc in order, so the grouping depends only on the number of workers
+ */
+void ax_par_reduce(
+		const ax_citer *first,
+		const ax_citer *last,
+		void *acc,
+		const ax_pred *bpred,
+		ax_exec *exec);
+
+void ax_par_transform_reduce(
+		const ax_citer *first,
+		const ax_citer *last,
+		void *acc,
+		size_t size,
+		const ax_pred *upred,
+		const ax_pred *bpred,
+		ax_exec *exec);
+
 
 ax_bool ax_sorted(
 		const ax_citer *first,
@@ -62,10 +152,69 @@ void ax_partition(
 		const ax_iter *last,
 		const ax_pred *upred);
 
+/*
+ * Unstable O(n log n) sort by the less of the element trait. Values are
+ * gathered once and sorted as a flat array, then moved into place, so any
+ * forward range of a seq is accepted
+ */
+ax_fail ax_sort(
+		const ax_iter *first,
+		const ax_iter *last);
+
+/* Same as ax_sort */
 ax_fail ax_quick_sort(
 		const ax_iter *first,
 		const ax_iter *last);
 
+/*
+ * Leave at nth the element a sort would put there, with no greater one
+ * before it and no less one after it, in O(n) on average. bpred is a less
+ * comparator taking values as ax_iter_get gives them, NULL for the less of
+ * the element trait
+ */
+ax_fail ax_nth_element(
+		const ax_iter *first,
+		const ax_iter *nth,
+		const ax_iter *last,
+		const ax_pred *bpred);
+
+/* Sort the least middle - first elements into [first, middle), the rest is left unordered */
+ax_fail ax_partial_sort(
+		const ax_iter *first,
+		const ax_iter *middle,
+		const ax_iter *last,
+		const ax_pred *bpred);
+
+/*
+ * Append to out the k elements a sort would put first, in sorted order.
+ * The range is read once keeping a heap of at most k elements, it may
+ * belong to any box and is not modified
+ */
+ax_fail ax_top_k(
+		const ax_citer *first,
+		const ax_citer *last,
+		ax_seq *out,
+		size_t k,
+		const ax_pred *bpred);
+
+/*
+ * Unstable sort on the workers of exec. Blocks are sorted in parallel then
+ * merged by rounds of parallel merges, small ranges are left to ax_sort
+ */
+ax_fail ax_par_sort_exec(
+		const ax_iter *first,
+		const ax_iter *last,
+		ax_exec *exec);
+
+/*
+ * Same as ax_par_sort_exec on a pool of nthreads threads made for the call,
+ * 0 for the number of online processors
+ */
+ax_fail ax_par_sort(
+		const ax_iter *first,
+		const ax_iter *last,
+		unsigned nthreads);
+
 ax_bool ax_equal_to_arr(
 		const ax_iter *first, 
 		const ax_iter *last, 
@@ -79,10 +228,39 @@ void ax_merge(
 		const ax_citer *last2,
 		ax_iter *dest);
 
+/*
+ * Stable sort. Elements that ax_radix_sort accepts are sorted by it, others
+ * by an adaptive merge sort that takes O(n) on sorted input, benefits from
+ * any existing runs, and borrows at most n / 2 entries of scratch from the pool
+ */
 ax_fail ax_merge_sort(
 		const ax_iter *first,
 		const ax_iter *last);
 
+/* True for traits ordered like a builtin integer or float type, and for AX_ST_S */
+ax_bool ax_radix_sortable(const ax_stuff_trait *etr);
+
+/*
+ * Stable radix sort, LSD for the numeric types and MSD for strings. The
+ * scratch buffer is used if it holds n elements (n * 2 pointers for
+ * strings), otherwise one is taken from the pool
+ */
+ax_fail ax_radix_sort(
+		const ax_iter *first,
+		const ax_iter *last,
+		void *scratch,
+		size_t scratch_size);
+
+/*
+ * Move first to the first element not less than the value p, given as
+ * ax_iter_get gives it. Contiguous ranges are searched without branching on
+ * the comparison, prefetching the next probe
+ */
+void ax_lower_bound(
+		ax_citer *first,
+		const ax_citer *last,
+		const void *p);
+
 void ax_binary_search(
 		ax_citer *first, 
 		const ax_citer *last,
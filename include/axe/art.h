@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2021 Li hsilin <lihsilyn@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef AXE_ART_H_
+#define AXE_ART_H_
+#include "trie.h"
+
+#define AX_ART_NAME AX_TRIE_NAME ".art"
+
+/*
+ * Adaptive radix tree. Inner nodes grow from 4 to 16, 48 and 256 children
+ * for byte sized key elements, wider elements use sorted nodes whose
+ * capacity keeps doubling after 16. Runs of up to AX_ART_LABEL_MAX elements
+ * without branches are compressed into a single node, and new keys end in
+ * a leaf carrying the rest of the key instead of one node per element.
+ *
+ * Key elements are compared as plain memory, so key traits with link set
+ * are not supported. Children of byte sized elements are ordered by their
+ * unsigned value.
+ */
+
+#define AX_ART_LABEL_MAX 8
+
+#ifndef AX_ART_DEFINED
+#define AX_ART_DEFINED
+typedef struct ax_art_st ax_art;
+#endif
+
+typedef union
+{
+	const ax_art *art;
+	const ax_trie *trie;
+	const ax_box *box;
+	const ax_any *any;
+	const ax_one *one;
+} ax_art_cr;
+
+typedef union
+{
+	ax_art *art;
+	ax_trie *trie;
+	ax_box *box;
+	ax_any *any;
+	ax_one *one;
+	ax_art_cr c;
+} ax_art_r;
+
+extern const ax_trie_trait ax_art_tr;
+
+ax_trie *__ax_art_construct(ax_base *base, const ax_stuff_trait *key_tr, const ax_stuff_trait *val_tr);
+
+ax_art_r ax_art_create(ax_scope *scope, const ax_stuff_trait *key_tr, const ax_stuff_trait *val_tr);
+
+#endif
@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2021 Li hsilin <lihsilyn@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef AXE_DATRIE_H_
+#define AXE_DATRIE_H_
+#include "trie.h"
+
+#define AX_DATRIE_NAME AX_ONE_NAME ".datrie"
+
+/*
+ * Read-only double-array trie compiled from any ax_trie. Key elements are
+ * mapped to dense codes, children of a node occupy base + code cells and
+ * are verified by check. The whole structure lives in one flat image of
+ * native byte order, which can be written out and later loaded in place
+ * (e.g. from mmap) without any parsing.
+ *
+ * Keys and values are copied as plain memory, so traits with link set are
+ * not supported. Keys are passed in the raw layout of ax_trie_get_raw.
+ */
+
+#ifndef AX_DATRIE_DEFINED
+#define AX_DATRIE_DEFINED
+typedef struct ax_datrie_st ax_datrie;
+#endif
+
+typedef union
+{
+	const ax_datrie *datrie;
+	const ax_one *one;
+} ax_datrie_cr;
+
+typedef union
+{
+	ax_datrie *datrie;
+	ax_one *one;
+	ax_datrie_cr c;
+} ax_datrie_r;
+
+typedef ax_bool (*ax_datrie_scan_cb_f)(const ax_datrie *datrie, const void *key, size_t len, const void *val, void *ctx);
+
+ax_one *__ax_datrie_construct(ax_base *base, const ax_trie *trie);
+
+ax_datrie_r ax_trie_freeze(ax_scope *scope, const ax_trie *trie);
+
+/* The image is borrowed and must be 8 bytes aligned and outlive the datrie */
+ax_one *__ax_datrie_load(ax_base *base, const void *image, size_t size);
+
+ax_datrie_r ax_datrie_load(ax_scope *scope, const void *image, size_t size);
+
+const void *ax_datrie_image(const ax_datrie *datrie, size_t *size);
+
+size_t ax_datrie_size(const ax_datrie *datrie);
+
+const void *ax_datrie_get(const ax_datrie *datrie, const void *key, size_t len);
+
+const void *ax_datrie_longest_prefix(const ax_datrie *datrie, const void *key, size_t len, size_t *plen);
+
+/* Children are visited in byte order of their key elements */
+ax_fail ax_datrie_scan_prefix(const ax_datrie *datrie, const void *prefix, size_t len,
+		ax_datrie_scan_cb_f cb, void *ctx);
+
+#endif
@@ -19,6 +19,12 @@ typedef void (*ax_unary_f)(void *out, const void *in, void *arg);
 
 typedef void (*ax_binary_f)(void *out, const void *in1, const void *in2, void *arg);
 
+/* Batch forms working on arrays of n values */
+typedef void (*ax_unary_batch_f)(void *out, const void *in, size_t n, void *arg);
+
+/* in1 or in2 is a single value when AX_BIND_1 or AX_BIND_2 is set in bind */
+typedef void (*ax_binary_batch_f)(void *out, const void *in1, const void *in2, size_t n, int bind, void *arg);
+
 #define AX_MIN(a, b) ((a) < (b) ? a : b)
 #define AX_MAX(a, b) ((a) > (b) ? a : b)
 
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2021 Li hsilin <lihsilyn@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef AXE_DEQUE_H_
+#define AXE_DEQUE_H_
+#include "seq.h"
+
+#define AX_DEQUE_NAME AX_SEQ_NAME ".deque"
+
+/*
+ * Double-ended sequence stored in fixed-size chunks indexed by a chunk map.
+ * push/pop on both ends are amortized O(1) and never move existing elements,
+ * random access is O(1)
+ */
+
+typedef struct ax_deque_st ax_deque;
+
+typedef union
+{
+	const ax_deque *deque;
+	const ax_seq *seq;
+	const ax_box *box;
+	const ax_any *any;
+	const ax_one *one;
+} ax_deque_cr;
+
+typedef union
+{
+	ax_deque *deque;
+	ax_seq *seq;
+	ax_box *box;
+	ax_any *any;
+	ax_one *one;
+	ax_deque_cr c;
+} ax_deque_r;
+
+extern const ax_seq_trait ax_deque_tr;
+
+ax_seq *__ax_deque_construct(ax_base *base, const ax_stuff_trait *elem_tr);
+
+ax_deque_r ax_deque_create(ax_scope *scope, const ax_stuff_trait *elem_tr);
+
+inline static ax_deque_r ax_deque_init(ax_scope *scope, const char *fmt, ...)
+{
+	va_list varg;
+	va_start(varg, fmt);
+	ax_deque_r role = { .seq = ax_seq_vinit(scope, __ax_deque_construct, fmt, varg) };
+	va_end(varg);
+	return role;
+}
+
+#endif
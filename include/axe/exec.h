@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2020 Li hsilin <lihsilyn@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#ifndef AXE_EXEC_H_
+#define AXE_EXEC_H_
+#include "def.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef AX_BASE_DEFINED
+#define AX_BASE_DEFINED
+typedef struct ax_base_st ax_base;
+#endif
+
+typedef struct ax_exec_st ax_exec;
+
+typedef struct ax_task_group_st ax_task_group;
+
+typedef void (*ax_task_f)(void *arg);
+
+typedef void (*ax_range_f)(size_t begin, size_t end, void *arg);
+
+/*
+ * Fixed-size pool of worker threads. Every worker owns a Chase-Lev deque,
+ * tasks spawned by a worker go to its own deque and are run newest first,
+ * idle workers steal the oldest tasks of the others. Tasks spawned by
+ * other threads go through a shared queue. Workers sleep when no task is
+ * left anywhere.
+ */
+
+/* Tasks spawned to a group are joined by ax_task_group_wait */
+struct ax_task_group_st
+{
+	ax_exec *exec;
+	size_t pending;
+};
+
+typedef struct ax_exec_stat_st
+{
+	uint64_t executed;     /* tasks run, including by waiting threads */
+	uint64_t stolen;       /* tasks taken from the deque of another worker */
+	uint64_t steal_failed; /* steal attempts finding nothing or losing a race */
+} ax_exec_stat;
+
+/* nworkers 0 for the number of online processors */
+ax_exec *ax_exec_create(unsigned nworkers);
+
+/* Tasks spawned before are finished first */
+void ax_exec_destroy(ax_exec *exec);
+
+unsigned ax_exec_workers(const ax_exec *exec);
+
+/* Index of the calling worker thread, -1 for other threads */
+int ax_exec_self(const ax_exec *exec);
+
+/* Base owned by the calling worker thread, NULL for other threads */
+ax_base *ax_exec_base(const ax_exec *exec);
+
+void ax_exec_stat_get(const ax_exec *exec, ax_exec_stat *stat);
+
+void ax_task_group_init(ax_task_group *group, ax_exec *exec);
+
+/* fn is run by the caller itself when no memory is left for the task */
+void ax_task_group_spawn(ax_task_group *group, ax_task_f fn, void *arg);
+
+/* The caller runs pending tasks until all tasks of the group have finished */
+void ax_task_group_wait(ax_task_group *group);
+
+/* Call fn on chunks of [begin, end) of at least grain indexes, 0 for a grain fitting the pool, and wait */
+void ax_exec_parallel_for(ax_exec *exec, size_t begin, size_t end, size_t grain, ax_range_f fn, void *arg);
+
+#endif
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2021 Li hsilin <lihsilyn@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef AXE_EYTZINGER_H_
+#define AXE_EYTZINGER_H_
+#include "one.h"
+#include "iter.h"
+
+#define AX_EYTZINGER_NAME AX_ONE_NAME ".eytzinger"
+
+/*
+ * Read-only search index over a sorted range. Elements are copied into an
+ * array in breadth-first (Eytzinger) order, so the first levels of every
+ * search share a few cache lines and the nodes of the next levels sit
+ * together and can be prefetched ahead of the comparison. Results are
+ * positions in the source range, which does not need to outlive the index.
+ *
+ * Keys are passed as ax_iter_get gives them, the batch search takes them in
+ * the storage layout of the element trait (e.g. char * for strings).
+ */
+
+#ifndef AX_EYTZINGER_DEFINED
+#define AX_EYTZINGER_DEFINED
+typedef struct ax_eytzinger_st ax_eytzinger;
+#endif
+
+typedef union
+{
+	const ax_eytzinger *eytzinger;
+	const ax_one *one;
+} ax_eytzinger_cr;
+
+typedef union
+{
+	ax_eytzinger *eytzinger;
+	ax_one *one;
+	ax_eytzinger_cr c;
+} ax_eytzinger_r;
+
+/* The range must be sorted by the less of its element trait */
+ax_one *__ax_eytzinger_construct(ax_base *base, const ax_citer *first, const ax_citer *last);
+
+ax_eytzinger_r ax_eytzinger_create(ax_scope *scope, const ax_citer *first, const ax_citer *last);
+
+size_t ax_eytzinger_size(const ax_eytzinger *eytzinger);
+
+/* Position of the first element not less than key, or the size if there is none */
+size_t ax_eytzinger_lower_bound(const ax_eytzinger *eytzinger, const void *key);
+
+/* Search n keys at once, interleaving their memory accesses */
+void ax_eytzinger_lower_bound_n(const ax_eytzinger *eytzinger, const void *keys, size_t n, size_t *out);
+
+#endif
@@ -33,6 +33,9 @@
 #define AX_IT_RAND ((1 << 3) | AX_IT_IN | AX_IT_FORW | AX_IT_BID)
 #define AX_IT_OUT  ((1 << 4))
 
+/* Random access over a flat buffer, point is the address of the element storage */
+#define AX_IT_CONT ((1 << 5) | AX_IT_RAND)
+
 #ifndef AX_ITER_DEFINED
 #define AX_ITER_DEFINED
 typedef struct ax_iter_st ax_iter;
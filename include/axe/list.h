@@ -54,4 +54,25 @@ ax_list_r ax_list_create(ax_scope *scope, const ax_stuff_trait *elem_tr);
 
 ax_list_r ax_list_init(ax_scope *scope, const char *fmt, ...);
 
+/* Stable merge sort by the less of the element trait, relinks nodes without allocation */
+void ax_list_sort(ax_list *list);
+
+/*
+ * Move the nodes in [first, last) of src in front of it, keeping their order.
+ * src may own it as long as it is out of the range, lists must share a base.
+ * Moving a whole list or within one list is O(1), a partial range taken
+ * from another list is counted node by node
+ */
+void ax_list_splice(ax_iter *it, ax_list *src, ax_iter *first, ax_iter *last);
+
+/* Move all nodes of the sorted list src into the sorted list, stable */
+void ax_list_merge(ax_list *list, ax_list *src);
+
+/*
+ * ax_seq_at always walks from the nearest of head, tail and the last position
+ * it returned. An indexed list also samples every 32nd node after it changed,
+ * so random lookups walk at most 16 nodes once the samples are rebuilt
+ */
+void ax_list_set_indexed(ax_list *list, ax_bool indexed);
+
 #endif
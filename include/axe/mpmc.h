@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2020 Li hsilin <lihsilyn@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef AXE_MPMC_H_
+#define AXE_MPMC_H_
+#include "tube.h"
+
+#define AX_MPMC_NAME AX_TUBE_NAME ".mpmc"
+
+typedef struct ax_mpmc_st ax_mpmc;
+
+typedef union
+{
+	const ax_mpmc *mpmc;
+	const ax_tube *tube;
+	const ax_any *any;
+	const ax_one *one;
+} ax_mpmc_cr;
+
+typedef union
+{
+	ax_mpmc *mpmc;
+	ax_tube *tube;
+	ax_any *any;
+	ax_one *one;
+} ax_mpmc_r;
+
+/* Bounded multi-producer multi-consumer tube, any number of threads may push
+ * and pop concurrently. Slots carry a sequence number, so producers and
+ * consumers only contend on their own position counter. The same element
+ * restrictions as ax_spsc apply, and ax_tube_prime is only meaningful while
+ * a single thread consumes. */
+
+/* capacity is rounded up to a power of two */
+ax_tube *__ax_mpmc_construct(ax_base *base, const ax_stuff_trait *elem_tr, size_t capacity);
+
+ax_mpmc_r ax_mpmc_create(ax_scope *scope, const ax_stuff_trait *elem_tr, size_t capacity);
+
+size_t ax_mpmc_capacity(const ax_mpmc *mpmc);
+
+/* Fails without waiting when the tube is full */
+ax_fail ax_mpmc_try_push(ax_mpmc *mpmc, const void *val);
+
+/* Fails without waiting when the tube is empty, out may be NULL to drop the element */
+ax_fail ax_mpmc_try_pop(ax_mpmc *mpmc, void *out);
+
+/* Push up to n elements from arr, returns how many were pushed */
+size_t ax_mpmc_push_n(ax_mpmc *mpmc, const void *arr, size_t n);
+
+/* Pop up to n elements into arr, returns how many were popped */
+size_t ax_mpmc_pop_n(ax_mpmc *mpmc, void *arr, size_t n);
+
+/* Block until there is room for val */
+void ax_mpmc_push_wait(ax_mpmc *mpmc, const void *val);
+
+/* Block until an element is available */
+void ax_mpmc_pop_wait(ax_mpmc *mpmc, void *out);
+
+#endif
@@ -34,4 +34,43 @@ struct ax_operset_st
 
 const ax_operset *ax_oper_for(int type);
 
+typedef struct ax_batch_operset_st ax_batch_operset;
+
+/* Batch kernels of an operset, vectorized with SSE2, or AVX2 when the processor has it */
+struct ax_batch_operset_st
+{
+    ax_binary_batch_f add;
+    ax_binary_batch_f sub;
+    ax_binary_batch_f mul;
+    ax_binary_batch_f div;
+    ax_binary_batch_f mod;
+
+    ax_binary_batch_f and;
+    ax_binary_batch_f or;
+    ax_unary_batch_f  not;
+
+    ax_binary_batch_f bit_and;
+    ax_binary_batch_f bit_or;
+    ax_unary_batch_f  bit_not;
+    ax_binary_batch_f bit_xor;
+
+    ax_binary_batch_f gt;
+    ax_binary_batch_f ge;
+    ax_binary_batch_f lt;
+    ax_binary_batch_f le;
+    ax_binary_batch_f eq;
+    ax_binary_batch_f ne;
+};
+
+const ax_batch_operset *ax_oper_batch_for(int type);
+
+/*
+ * Batch kernel of a function of the built-in opersets, NULL for any other
+ * function. in_size receives the size of each operand and out_size the size
+ * of each output value, either may be NULL
+ */
+ax_unary_batch_f ax_oper_unary_batch(ax_unary_f fun, size_t *in_size, size_t *out_size);
+
+ax_binary_batch_f ax_oper_binary_batch(ax_binary_f fun, size_t *in_size, size_t *out_size);
+
 #endif
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2021 Li hsilin <lihsilyn@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef AXE_PAVL_H_
+#define AXE_PAVL_H_
+#include "map.h"
+
+#define AX_PAVL_NAME AX_MAP_NAME ".pavl"
+
+/*
+ * Persistent AVL map. Updates path-copy the nodes they touch, so
+ * ax_any_copy() only shares the root and takes O(1) time and memory.
+ * Nodes are reference counted and returned to the pool when the last
+ * map referring to them drops them. Values returned by ax_map_get() and
+ * ax_iter_get() may be shared with snapshots, modify them through
+ * ax_map_put() or ax_iter_set() only. Reference counts are not atomic,
+ * snapshots are not meant to be handed to other threads.
+ */
+
+#ifndef AX_PAVL_DEFINED
+#define AX_PAVL_DEFINED
+typedef struct ax_pavl_st ax_pavl;
+#endif
+
+typedef union
+{
+	const ax_pavl *pavl;
+	const ax_map *map;
+	const ax_box *box;
+	const ax_any *any;
+	const ax_one *one;
+} ax_pavl_cr;
+
+typedef union
+{
+	ax_pavl *pavl;
+	ax_map *map;
+	ax_box *box;
+	ax_any *any;
+	ax_one *one;
+	ax_pavl_cr c;
+} ax_pavl_r;
+
+extern const ax_map_trait ax_pavl_tr;
+
+ax_map *__ax_pavl_construct(ax_base* base,
+		const ax_stuff_trait* key_tr,
+		const ax_stuff_trait* val_tr);
+
+ax_pavl_r ax_pavl_create(ax_scope *scope,
+		const ax_stuff_trait *key_tr,
+		const ax_stuff_trait *val_tr);
+
+#endif
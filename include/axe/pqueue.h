@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2020 Li hsilin <lihsilyn@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef AXE_PQUEUE_H_
+#define AXE_PQUEUE_H_
+#include "tube.h"
+
+#define AX_PQUEUE_NAME AX_TUBE_NAME ".pqueue"
+
+typedef struct ax_pqueue_st ax_pqueue;
+
+/* Names an element of a handled pqueue until it is popped or erased */
+typedef size_t ax_pqueue_handle;
+
+typedef union
+{
+	const ax_pqueue *pqueue;
+	const ax_tube *tube;
+	const ax_any *any;
+	const ax_one *one;
+} ax_pqueue_cr;
+
+typedef union
+{
+	ax_pqueue *pqueue;
+	ax_tube *tube;
+	ax_any *any;
+	ax_one *one;
+} ax_pqueue_r;
+
+/* Min-heap ordered by elem_tr->less, ax_tube_prime returns the least element */
+ax_tube *__ax_pqueue_construct(ax_base *base, const ax_stuff_trait *elem_tr);
+
+/* Same as above, and additionally tracks a handle for every element */
+ax_tube *__ax_pqueue_construct_handled(ax_base *base, const ax_stuff_trait *elem_tr);
+
+ax_pqueue_r ax_pqueue_create(ax_scope *scope, const ax_stuff_trait *elem_tr);
+
+ax_pqueue_r ax_pqueue_create_handled(ax_scope *scope, const ax_stuff_trait *elem_tr);
+
+ax_fail ax_pqueue_reserve(ax_pqueue *pqueue, size_t size);
+
+/* The functions below require a handled pqueue */
+
+ax_fail ax_pqueue_push_handle(ax_pqueue *pqueue, const void *val, ax_pqueue_handle *handle);
+
+ax_pqueue_handle ax_pqueue_prime_handle(const ax_pqueue *pqueue);
+
+void *ax_pqueue_get(const ax_pqueue *pqueue, ax_pqueue_handle handle);
+
+/* Replace the element and restore the heap order, decrease-key is the usual case */
+ax_fail ax_pqueue_update(ax_pqueue *pqueue, ax_pqueue_handle handle, const void *val);
+
+void ax_pqueue_erase(ax_pqueue *pqueue, ax_pqueue_handle handle);
+
+#endif
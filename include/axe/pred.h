@@ -18,6 +18,10 @@ struct ax_pred_st
 		ax_unary_f u;
 		ax_binary_f b;
 	} fun;
+	union {
+		ax_unary_batch_f u;
+		ax_binary_batch_f b;
+	} batch;
 	void *first;
 	void *second;
 	void *args;
@@ -28,6 +32,7 @@ inline static ax_pred ax_pred_unary_make(ax_unary_f oper, void *in, void *args)
 {
 	return (ax_pred) {
 		.fun.u = oper,
+		.batch.u = NULL,
 		.first = in,
 		.second = NULL,
 		.bind = (in ? AX_BIND_1 : 0) | AX_BIND_U,
@@ -39,6 +44,7 @@ inline static ax_pred ax_pred_binary_make(ax_binary_f oper, void *in1, void *in2
 {
 	return (ax_pred) {
 		.fun.b = oper,
+		.batch.b = NULL,
 		.first = in1,
 		.second = in2,
 		.bind = (in1 ? AX_BIND_1 : 0) | (in2 ? AX_BIND_2 : 0 ),
@@ -46,6 +52,21 @@ inline static ax_pred ax_pred_binary_make(ax_binary_f oper, void *in1, void *in2
 	};
 }
 
+/* batch is called by ax_pred_do_n, it must give the same results as oper */
+inline static ax_pred ax_pred_unary_batch_make(ax_unary_f oper, ax_unary_batch_f batch, void *in, void *args)
+{
+	ax_pred pred = ax_pred_unary_make(oper, in, args);
+	pred.batch.u = batch;
+	return pred;
+}
+
+inline static ax_pred ax_pred_binary_batch_make(ax_binary_f oper, ax_binary_batch_f batch, void *in1, void *in2, void *args)
+{
+	ax_pred pred = ax_pred_binary_make(oper, in1, in2, args);
+	pred.batch.b = batch;
+	return pred;
+}
+
 inline static void ax_pred_do(const ax_pred *pred, void *out, const void *in1, const void *in2)
 {
 #ifdef AX_DEBUG
@@ -85,4 +106,29 @@ do_binary:
 	pred->fun.b(out, in1, in2, pred->args);
 }
 
+/* Same as ax_pred_do on arrays of n inputs and outputs, bound inputs stay single values */
+inline static void ax_pred_do_n(const ax_pred *pred, void *out, const void *in1, const void *in2, size_t n)
+{
+	ax_assert(pred->batch.u, "predicate has no batch function");
+	switch (pred->bind) {
+		case AX_BIND_U:
+			ax_assert(in1 && !in2, "invalid argument for predicate input");
+			pred->batch.u(out, in1, n, pred->args);
+			return;
+		case 0:
+			ax_assert(in1 && in2, "invalid argument for predicate input");
+			pred->batch.b(out, in1, in2, n, 0, pred->args);
+			return;
+		case AX_BIND_1:
+			ax_assert(in1 && !in2, "invalid argument for predicate input");
+			pred->batch.b(out, pred->first, in1, n, AX_BIND_1, pred->args);
+			return;
+		case AX_BIND_2:
+			ax_assert(in1 && !in2, "invalid argument for predicate input");
+			pred->batch.b(out, in1, pred->second, n, AX_BIND_2, pred->args);
+			return;
+	}
+	ax_assert(0, "predicate has no free input");
+}
+
 #endif
@@ -47,8 +47,20 @@ typedef union
 
 ax_tube *__ax_queue_construct(ax_base *base, const ax_stuff_trait *elem_tr);
 
+/* A queue that never holds more than capacity elements, when it is full a
+ * push either fails with AX_ERR_FULL or, with overwrite, drops the oldest */
+ax_tube *__ax_queue_construct_fixed(ax_base *base, const ax_stuff_trait *elem_tr,
+		size_t capacity, ax_bool overwrite);
+
 ax_queue_r ax_queue_create(ax_scope *scope, const ax_stuff_trait *elem_tr);
 
+ax_queue_r ax_queue_create_fixed(ax_scope *scope, const ax_stuff_trait *elem_tr,
+		size_t capacity, ax_bool overwrite);
+
+size_t ax_queue_capacity(const ax_queue *queue);
+
+ax_fail ax_queue_reserve(ax_queue *queue, size_t size);
+
 ax_fail ax_queue_push(ax_queue *queue, const void *);
 
 void ax_queue_pop(ax_queue *queue, const void *);
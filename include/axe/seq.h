@@ -44,6 +44,9 @@ typedef ax_fail (*ax_seq_trunc_f)  (ax_seq *seq, size_t size);
 typedef ax_iter (*ax_seq_at_f)     (const ax_seq *seq, size_t index);
 typedef ax_fail (*ax_seq_insert_f) (ax_seq *seq, ax_iter *iter, const void *val);
 typedef void   *(*ax_seq_end_f)    (const ax_seq *seq);
+typedef ax_fail (*ax_seq_insert_range_f)(ax_seq *seq, ax_iter *iter, const ax_citer *first, const ax_citer *last);
+typedef ax_fail (*ax_seq_insert_arr_f)  (ax_seq *seq, ax_iter *iter, const void *arr, size_t len);
+typedef ax_fail (*ax_seq_erase_range_f) (ax_seq *seq, ax_iter *first, ax_iter *last);
 
 typedef ax_seq *(ax_seq_construct_f)(ax_base *base, const ax_stuff_trait *tr);
 
@@ -60,6 +63,9 @@ struct ax_seq_trait_st
 	const ax_seq_insert_f insert;
 	const ax_seq_end_f   first;
 	const ax_seq_end_f   last;
+	const ax_seq_insert_range_f insert_range;
+	const ax_seq_insert_arr_f   insert_arr;
+	const ax_seq_erase_range_f  erase_range;
 };
 
 typedef struct ax_seq_env_st
@@ -171,6 +177,48 @@ static inline const void *ax_seq_clast(const ax_seq *seq)
 	return seq->tr->last(seq);
 }
 
+/*
+ * Insert [first, last) before iter. The range must not belong to seq. On success
+ * iter refers to the same element as before, as ax_seq_insert does
+ */
+static inline ax_fail ax_seq_insert_range(ax_seq *seq, ax_iter *it, const ax_citer *first, const ax_citer *last)
+{
+	ax_trait_optional(seq, seq->tr->insert_range);
+	return seq->tr->insert_range(seq, it, first, last);
+}
+
+/*
+ * Insert len elements stored contiguously in arr, laid out as the element trait
+ * stores them (an array of pointers for link types)
+ */
+static inline ax_fail ax_seq_insert_arr(ax_seq *seq, ax_iter *it, const void *arr, size_t len)
+{
+	ax_trait_optional(seq, seq->tr->insert_arr);
+	return seq->tr->insert_arr(seq, it, arr, len);
+}
+
+static inline ax_fail ax_seq_append_range(ax_seq *seq, const ax_citer *first, const ax_citer *last)
+{
+	ax_iter end = ax_box_end(ax_r(seq, seq).box);
+	return ax_seq_insert_range(seq, &end, first, last);
+}
+
+static inline ax_fail ax_seq_append_arr(ax_seq *seq, const void *arr, size_t len)
+{
+	ax_iter end = ax_box_end(ax_r(seq, seq).box);
+	return ax_seq_insert_arr(seq, &end, arr, len);
+}
+
+/*
+ * Erase [first, last). On success both iterators refer to the element following
+ * the erased range
+ */
+static inline ax_fail ax_seq_erase_range(ax_seq *seq, ax_iter *first, ax_iter *last)
+{
+	ax_trait_optional(seq, seq->tr->erase_range);
+	return seq->tr->erase_range(seq, first, last);
+}
+
 ax_seq *ax_seq_init(ax_scope *scope, ax_seq_construct_f *builder, const char *fmt, ...);
 ax_seq *ax_seq_vinit(ax_scope *scope, ax_seq_construct_f *builder, const char *fmt, va_list varg); 
 ax_fail ax_seq_vpushl(ax_seq *seq, const char *fmt, va_list varg);
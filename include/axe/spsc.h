@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2020 Li hsilin <lihsilyn@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef AXE_SPSC_H_
+#define AXE_SPSC_H_
+#include "tube.h"
+
+#define AX_SPSC_NAME AX_TUBE_NAME ".spsc"
+
+typedef struct ax_spsc_st ax_spsc;
+
+typedef union
+{
+	const ax_spsc *spsc;
+	const ax_tube *tube;
+	const ax_any *any;
+	const ax_one *one;
+} ax_spsc_cr;
+
+typedef union
+{
+	ax_spsc *spsc;
+	ax_tube *tube;
+	ax_any *any;
+	ax_one *one;
+} ax_spsc_r;
+
+/* Bounded single-producer single-consumer tube. One thread may push and one
+ * other thread may pop concurrently without locking. Elements are moved by
+ * value, so elem_tr must be trivially copyable and freeable (use AX_ST_PTR to
+ * pass ownership of anything larger). Push and pop through ax_tube_trait do
+ * not wait and do not touch the base errno, which is not thread-safe. */
+
+/* capacity is rounded up to a power of two */
+ax_tube *__ax_spsc_construct(ax_base *base, const ax_stuff_trait *elem_tr, size_t capacity);
+
+ax_spsc_r ax_spsc_create(ax_scope *scope, const ax_stuff_trait *elem_tr, size_t capacity);
+
+size_t ax_spsc_capacity(const ax_spsc *spsc);
+
+/* Fails without waiting when the tube is full */
+ax_fail ax_spsc_try_push(ax_spsc *spsc, const void *val);
+
+/* Fails without waiting when the tube is empty, out may be NULL to drop the element */
+ax_fail ax_spsc_try_pop(ax_spsc *spsc, void *out);
+
+/* Push up to n elements from arr, returns how many were pushed */
+size_t ax_spsc_push_n(ax_spsc *spsc, const void *arr, size_t n);
+
+/* Pop up to n elements into arr, returns how many were popped */
+size_t ax_spsc_pop_n(ax_spsc *spsc, void *arr, size_t n);
+
+/* Block until there is room for val */
+void ax_spsc_push_wait(ax_spsc *spsc, const void *val);
+
+/* Block until an element is available */
+void ax_spsc_pop_wait(ax_spsc *spsc, void *out);
+
+#endif
@@ -109,6 +109,9 @@ struct ax_stuff_trait_st
 	ax_stuff_swap_f    swap;
 	ax_stuff_init_f    init;
 	ax_bool            link;
+	ax_bool            trivial_copy; /* copy is memcpy and init zero-fills */
+	ax_bool            trivial_move; /* move is memcpy, source left untouched */
+	ax_bool            trivial_free; /* free does nothing */
 };
 
 ax_bool ax_stuff_mem_equal(const void* p1, const void* p2, size_t size);
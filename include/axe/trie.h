@@ -46,6 +46,13 @@ typedef ax_bool (*ax_trie_erase_f)(ax_trie *trie, const ax_seq *key);
 typedef ax_bool (*ax_trie_prune_f)(ax_trie *trie, const ax_seq *key);
 typedef ax_fail (*ax_trie_rekey_f)(ax_trie *trie, const ax_seq *key_from, const ax_seq *key_to);
 
+typedef ax_fail (*ax_trie_put_raw_f)  (ax_trie *trie, const void *key, size_t len, const void *val);
+typedef void   *(*ax_trie_get_raw_f)  (const ax_trie *trie, const void *key, size_t len);
+typedef ax_iter (*ax_trie_at_raw_f)   (const ax_trie *trie, const void *key, size_t len);
+typedef ax_bool (*ax_trie_exist_raw_f)(const ax_trie *trie, const void *key, size_t len);
+typedef ax_bool (*ax_trie_erase_raw_f)(ax_trie *trie, const void *key, size_t len);
+typedef ax_iter (*ax_trie_longest_f)  (const ax_trie *trie, const void *key, size_t len, size_t *plen);
+
 typedef const void *(*ax_trie_it_word_f)(const ax_citer *it);
 typedef ax_iter (*ax_trie_it_begin_f)(const ax_citer *it);
 typedef ax_iter (*ax_trie_it_end_f)(const ax_citer *it);
@@ -65,6 +72,13 @@ struct ax_trie_trait_st
 	const ax_trie_erase_f erase;
 	const ax_trie_prune_f prune;
 	const ax_trie_rekey_f rekey;
+
+	const ax_trie_put_raw_f put_raw;
+	const ax_trie_get_raw_f get_raw;
+	const ax_trie_at_raw_f at_raw;
+	const ax_trie_exist_raw_f exist_raw;
+	const ax_trie_erase_raw_f erase_raw;
+	const ax_trie_longest_f longest;
 	
 	const ax_trie_it_word_f it_word;
 	const ax_trie_it_begin_f it_begin;
@@ -153,6 +167,53 @@ inline static ax_bool ax_trie_exist(const ax_trie *trie, const ax_seq *key)
 	return trie->tr->exist(trie, key);
 }
 
+/*
+ * The raw variants take the key as an array of len elements laid out as
+ * they are stored, each of key_tr->size bytes (pointers for link traits),
+ * so looking up a C string or an int array needs no intermediate ax_seq.
+ */
+
+inline static ax_fail ax_trie_put_raw(ax_trie *trie, const void *key, size_t len, const void *val)
+{
+	ax_trait_require(trie, trie->tr->put_raw);
+	return trie->tr->put_raw(trie, key, len, val);
+}
+
+inline static void *ax_trie_get_raw(const ax_trie *trie, const void *key, size_t len)
+{
+	ax_trait_require(trie, trie->tr->get_raw);
+	return trie->tr->get_raw(trie, key, len);
+}
+
+inline static ax_iter ax_trie_at_raw(const ax_trie *trie, const void *key, size_t len)
+{
+	ax_trait_require(trie, trie->tr->at_raw);
+	return trie->tr->at_raw(trie, key, len);
+}
+
+inline static ax_bool ax_trie_exist_raw(const ax_trie *trie, const void *key, size_t len)
+{
+	ax_trait_require(trie, trie->tr->exist_raw);
+	return trie->tr->exist_raw(trie, key, len);
+}
+
+inline static ax_bool ax_trie_erase_raw(ax_trie *trie, const void *key, size_t len)
+{
+	ax_trait_require(trie, trie->tr->erase_raw);
+	return trie->tr->erase_raw(trie, key, len);
+}
+
+/*
+ * Find the deepest valued node whose key is a prefix of the raw key, the
+ * number of elements it covers is stored in *plen if plen is not NULL.
+ * Returns the end iterator if no prefix has a value.
+ */
+inline static ax_iter ax_trie_longest_prefix(const ax_trie *trie, const void *key, size_t len, size_t *plen)
+{
+	ax_trait_require(trie, trie->tr->longest);
+	return trie->tr->longest(trie, key, len, plen);
+}
+
 inline static const void *ax_trie_iter_word(const ax_iter *it)
 {
 	ax_trie_cr self_r = { .box = ax_iter_box(it) };
@@ -226,4 +287,16 @@ typedef ax_bool (*ax_trie_enum_cb_f)(ax_trie *trie, const ax_seq *key, const voi
 
 ax_fail ax_trie_enum(ax_trie *trie, ax_trie_enum_cb_f cb, void *ctx);
 
+#define AX_TRIE_SCAN_MAX 128
+
+typedef ax_bool (*ax_trie_scan_cb_f)(const ax_trie *trie, const void *key, size_t len, const void *val, void *ctx);
+
+/*
+ * Visit every valued node under the raw prefix in key order, parents first.
+ * Keys are passed to cb in the raw layout and are only valid during the call.
+ * Nothing is allocated, keys longer than AX_TRIE_SCAN_MAX elements fail with
+ * AX_ERR_TOOLONG. Returning true from cb stops the scan.
+ */
+ax_fail ax_trie_scan_prefix(const ax_trie *trie, const void *prefix, size_t len, ax_trie_scan_cb_f cb, void *ctx);
+
 #endif
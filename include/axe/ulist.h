@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2020 Li hsilin <lihsilyn@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef AXE_ULIST_H_
+#define AXE_ULIST_H_
+#include "seq.h"
+
+#define AX_ULIST_NAME AX_SEQ_NAME ".ulist"
+
+/*
+ * Unrolled linked list, every node packs as many elements as fit in a few
+ * hundred bytes. Insertion and erasure through an iterator only shift the
+ * elements of one node and are amortized O(1), but unlike ax_list they
+ * invalidate other iterators into the same node
+ */
+
+typedef struct ax_ulist_st ax_ulist;
+
+typedef union
+{
+	const ax_ulist *ulist;
+	const ax_seq *seq;
+	const ax_box *box;
+	const ax_any *any;
+	const ax_one *one;
+} ax_ulist_cr;
+
+typedef union
+{
+	ax_ulist *ulist;
+	ax_seq *seq;
+	ax_box *box;
+	ax_any *any;
+	ax_one *one;
+	ax_ulist_cr c;
+} ax_ulist_r;
+
+extern const ax_seq_trait ax_ulist_tr;
+
+ax_seq *__ax_ulist_construct(ax_base *base, const ax_stuff_trait *elem_tr);
+
+ax_ulist_r ax_ulist_create(ax_scope *scope, const ax_stuff_trait *elem_tr);
+
+inline static ax_ulist_r ax_ulist_init(ax_scope *scope, const char *fmt, ...)
+{
+	va_list varg;
+	va_start(varg, fmt);
+	ax_ulist_r role = { .seq = ax_seq_vinit(scope, __ax_ulist_construct, fmt, varg) };
+	va_end(varg);
+	return role;
+}
+
+/* Bytes held by the nodes of the list */
+size_t ax_ulist_footprint(const ax_ulist *ulist);
+
+#endif
@@ -0,0 +1,124 @@
+#ifndef AXE_SBUFF_H_
+#define AXE_SBUFF_H_
+#include <axe/buff.h>
+#include <axe/base.h>
+#include <axe/error.h>
+#include <axe/def.h>
+#include <string.h>
+#include <stdint.h>
+
+/*
+ * Byte storage embedded in a container. The first SBUFF_INLINE bytes live
+ * inside the owner, an ax_buff is constructed only when the data outgrows
+ * them, and the storage stays spilled afterwards.
+ */
+
+#define SBUFF_INLINE 48
+
+#define SBUFF_MAX ((~(size_t)0) >> 1)
+
+struct sbuff_st
+{
+	ax_buff *buff;
+	size_t used;
+	union {
+		ax_byte bytes[SBUFF_INLINE];
+		uint64_t u64;
+		double lf;
+		void *ptr;
+	} small;
+};
+
+inline static void sbuff_init(struct sbuff_st *sb)
+{
+	sb->buff = NULL;
+	sb->used = 0;
+}
+
+inline static void *sbuff_ptr(struct sbuff_st *sb)
+{
+	return sb->buff ? ax_buff_ptr(sb->buff) : sb->small.bytes;
+}
+
+inline static const void *sbuff_cptr(const struct sbuff_st *sb)
+{
+	return sb->buff ? ax_buff_cptr(sb->buff) : sb->small.bytes;
+}
+
+inline static size_t sbuff_size(const struct sbuff_st *sb)
+{
+	return sb->buff ? ax_buff_size(sb->buff, NULL) : sb->used;
+}
+
+inline static size_t sbuff_max(const struct sbuff_st *sb)
+{
+	return sb->buff ? ax_buff_max(sb->buff) : SBUFF_MAX;
+}
+
+inline static ax_fail sbuff_spill(struct sbuff_st *sb, ax_base *base, size_t size)
+{
+	if (size > SBUFF_MAX) {
+		ax_base_set_errno(base, AX_ERR_FULL);
+		return ax_true;
+	}
+
+	ax_buff *buff = (ax_buff *)__ax_buff_construct(base);
+	if (!buff) {
+		ax_base_set_errno(base, AX_ERR_NOMEM);
+		return ax_true;
+	}
+	if (ax_buff_adapt(buff, size)) {
+		ax_one_free(ax_r(buff, buff).one);
+		return ax_true;
+	}
+	memcpy(ax_buff_ptr(buff), sb->small.bytes, sb->used);
+	sb->buff = buff;
+	return ax_false;
+}
+
+inline static ax_fail sbuff_adapt(struct sbuff_st *sb, ax_base *base, size_t size)
+{
+	if (sb->buff)
+		return ax_buff_adapt(sb->buff, size);
+	if (size > SBUFF_INLINE)
+		return sbuff_spill(sb, base, size);
+	sb->used = size;
+	return ax_false;
+}
+
+inline static ax_fail sbuff_resize(struct sbuff_st *sb, ax_base *base, size_t size)
+{
+	if (sb->buff)
+		return ax_buff_resize(sb->buff, size);
+	if (size > SBUFF_INLINE)
+		return sbuff_spill(sb, base, size);
+	sb->used = size;
+	return ax_false;
+}
+
+/* dst must be uninitialized, a spilled buffer is copied into the base local scope */
+inline static ax_fail sbuff_copy(struct sbuff_st *dst, const struct sbuff_st *src)
+{
+	if (!src->buff) {
+		memcpy(dst, src, sizeof *dst);
+		return ax_false;
+	}
+	dst->used = 0;
+	dst->buff = (ax_buff *)ax_any_copy(ax_cr(buff, src->buff).any);
+	return !dst->buff;
+}
+
+/* Take over the storage of src and leave it empty */
+inline static void sbuff_move(struct sbuff_st *dst, struct sbuff_st *src)
+{
+	memcpy(dst, src, sizeof *dst);
+	sbuff_init(src);
+}
+
+inline static void sbuff_free(struct sbuff_st *sb)
+{
+	ax_one_free(ax_r(buff, sb->buff).one);
+	sbuff_init(sb);
+}
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef AXE_WAITQ_H_
+#define AXE_WAITQ_H_
+#include <stdint.h>
+#include <limits.h>
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#else
+#include <sched.h>
+#endif
+
+/*
+ * Sleep/wake point for threads blocked on a concurrent tube. A waiter
+ * registers itself, samples seq, re-checks its condition and sleeps until
+ * seq moves. A notifier publishes its change first and bumps seq only if
+ * somebody is registered, so the fast path is a fence and a load.
+ *
+ * Translation units including this header must define _DEFAULT_SOURCE
+ * before any system header, syscall() is not declared in strict C99.
+ */
+
+#define WAITQ_SPIN 64
+
+struct waitq
+{
+	uint32_t seq;
+	uint32_t waiters;
+};
+
+inline static void waitq_init(struct waitq *q)
+{
+	q->seq = 0;
+	q->waiters = 0;
+}
+
+inline static uint32_t waitq_prepare(struct waitq *q)
+{
+	__atomic_fetch_add(&q->waiters, 1, __ATOMIC_SEQ_CST);
+	uint32_t seq = __atomic_load_n(&q->seq, __ATOMIC_SEQ_CST);
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	return seq;
+}
+
+inline static void waitq_cancel(struct waitq *q)
+{
+	__atomic_fetch_sub(&q->waiters, 1, __ATOMIC_SEQ_CST);
+}
+
+/* Sleep while seq is still equal to the value returned by waitq_prepare */
+inline static void waitq_wait(struct waitq *q, uint32_t seq)
+{
+#ifdef __linux__
+	syscall(SYS_futex, &q->seq, FUTEX_WAIT_PRIVATE, seq, NULL, NULL, 0);
+#else
+	if (__atomic_load_n(&q->seq, __ATOMIC_SEQ_CST) == seq)
+		sched_yield();
+#endif
+	waitq_cancel(q);
+}
+
+inline static void waitq_notify(struct waitq *q)
+{
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	if (!__atomic_load_n(&q->waiters, __ATOMIC_RELAXED))
+		return;
+	__atomic_fetch_add(&q->seq, 1, __ATOMIC_SEQ_CST);
+#ifdef __linux__
+	syscall(SYS_futex, &q->seq, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+#endif
+}
+
+#endif
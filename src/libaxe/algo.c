@@ -1,7 +1,7 @@
 #include "check.h"
 #include <axe/algo.h>
-#include <axe/vector.h>
 #include <axe/pred.h>
+#include <axe/oper.h>
 #include <axe/box.h>
 #include <axe/one.h>
 #include <axe/seq.h>
@@ -9,17 +9,182 @@
 #include <axe/pool.h>
 #include <axe/base.h>
 #include <axe/error.h>
+#include <axe/exec.h>
 #include <axe/def.h>
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <limits.h>
+#include <stdint.h>
 
 #define ASSERT_ITER_TYPE(_it, _type) ax_assert(ax_one_is(_it->owner, _type), "'%s' is not an iterator of '%s'", #_it, #_type);
 
+/* A range of AX_IT_CONT iterators, walked by pointer instead of through the iterator trait */
+struct cont_range
+{
+	ax_byte *begin;
+	ax_byte *end;
+	const ax_stuff_trait *etr;
+};
+
+inline static ax_bool cont_range_of(const ax_citer *first, const ax_citer *last, struct cont_range *r)
+{
+	if (!ax_citer_is(first, AX_IT_CONT))
+		return ax_false;
+	r->begin = first->point;
+	r->end = last->point;
+	r->etr = ax_box_elem_tr(first->owner);
+	return ax_true;
+}
+
+inline static size_t cont_length(const struct cont_range *r)
+{
+	return (r->end - r->begin) / r->etr->size;
+}
+
+/* Same as ax_iter_get on the element stored at p */
+inline static void *cont_value(const ax_stuff_trait *etr, const ax_byte *p)
+{
+	return etr->link ? *(void **)p : (void *)p;
+}
+
+#define BATCH_MIN 32
+#define BATCH_BLOCK 256
+
+/* A predicate resolved for batch calls, once per algorithm call */
+struct pred_batch
+{
+	ax_pred pred;
+	size_t out_size; /* 0 for batch functions given by the user */
+	ax_bool usable;
+};
+
+/*
+ * Take the batch function of pred, or the built-in kernel of its function when it has none.
+ * A kernel steps by the size of its operator type, so it is only taken when that is etr->size
+ */
+static void pred_batch_init(struct pred_batch *pb, const ax_pred *pred, const ax_stuff_trait *etr, size_t n)
+{
+	size_t in_size = 0;
+	pb->pred = *pred;
+	pb->out_size = 0;
+	pb->usable = ax_false;
+	if (etr->link || n < BATCH_MIN)
+		return;
+	if (!pred->batch.u) {
+		if (pred->bind == AX_BIND_U)
+			pb->pred.batch.u = ax_oper_unary_batch(pred->fun.u, &in_size, &pb->out_size);
+		else if (!(pred->bind & AX_BIND_U) && pred->bind != (AX_BIND_1 | AX_BIND_2))
+			pb->pred.batch.b = ax_oper_binary_batch(pred->fun.b, &in_size, &pb->out_size);
+		if (in_size != etr->size)
+			pb->pred.batch.u = NULL;
+	}
+	pb->usable = pb->pred.batch.u != NULL;
+}
+
+/* Batch calls of predicates yielding ax_bool */
+inline static ax_bool pred_batch_test(const struct pred_batch *pb)
+{
+	return pb->usable && pb->out_size <= sizeof(ax_bool);
+}
+
+/* Built-in kernels yield 0 or 1, other batch functions any true value */
+static size_t count_true(const ax_bool *buf, size_t n, ax_bool normal)
+{
+	size_t count = 0, i = 0;
+	if (normal)
+		for (; i + 8 <= n; i += 8) {
+			uint64_t word;
+			memcpy(&word, buf + i, sizeof word);
+			count += word * 0x0101010101010101 >> 56;
+		}
+	for (; i < n; i++)
+		count += buf[i] != 0;
+	return count;
+}
+
+static ax_byte *cont_find(const struct cont_range *r, const struct pred_batch *pb, ax_bool expect)
+{
+	const size_t size = r->etr->size;
+	ax_bool out;
+	ax_byte *p = r->begin;
+
+	if (pred_batch_test(pb)) {
+		ax_bool buf[BATCH_BLOCK];
+		while (p != r->end) {
+			size_t n = AX_MIN((size_t)(r->end - p) / size, BATCH_BLOCK);
+			ax_pred_do_n(&pb->pred, buf, p, NULL, n);
+			for (size_t i = 0; i < n; i++)
+				if (!buf[i] == !expect)
+					return p + i * size;
+			p += n * size;
+		}
+		return p;
+	}
+
+	for (; p != r->end; p += size)
+		if (ax_pred_do(&pb->pred, &out, cont_value(r->etr, p), NULL), !out == !expect)
+			break;
+	return p;
+}
+
+static ax_byte *cont_find_if(const struct cont_range *r, const ax_pred *upred, ax_bool expect)
+{
+	struct pred_batch pb;
+	pred_batch_init(&pb, upred, r->etr, cont_length(r));
+	return cont_find(r, &pb, expect);
+}
+
+static size_t cont_count(const struct cont_range *r, const struct pred_batch *pb)
+{
+	const size_t size = r->etr->size;
+	size_t count = 0;
+	ax_bool out = ax_false;
+
+	if (pred_batch_test(pb)) {
+		ax_bool buf[BATCH_BLOCK];
+		for (ax_byte *p = r->begin; p != r->end; ) {
+			size_t n = AX_MIN((size_t)(r->end - p) / size, BATCH_BLOCK);
+			ax_pred_do_n(&pb->pred, buf, p, NULL, n);
+			count += count_true(buf, n, pb->out_size != 0);
+			p += n * size;
+		}
+		return count;
+	}
+
+	for (ax_byte *p = r->begin; p != r->end; p += size) {
+		ax_pred_do(&pb->pred, &out, cont_value(r->etr, p), NULL);
+		count += out ? 1 : 0;
+	}
+	return count;
+}
+
+/* dst holds elements of dtr from the same position on */
+static void cont_transform(const struct cont_range *r, ax_byte *dst, const ax_stuff_trait *dtr,
+		const struct pred_batch *pb)
+{
+	if (pb->usable && !dtr->link && (!pb->out_size || pb->out_size == dtr->size)) {
+		ax_pred_do_n(&pb->pred, dst, r->begin, NULL, cont_length(r));
+		return;
+	}
+
+	for (ax_byte *p = r->begin; p != r->end; p += r->etr->size, dst += dtr->size)
+		ax_pred_do(&pb->pred, cont_value(dtr, dst), cont_value(r->etr, p), NULL);
+}
+
 void ax_transform(const ax_citer *first1, const ax_citer *last1, const ax_iter *first2, const ax_pred *upred)
 {
 	CHECK_PARAM_NULL(upred);
 	CHECK_ITER_COMPARABLE(first1, last1);
+
+	struct cont_range r;
+	if (cont_range_of(first1, last1, &r) && ax_iter_is(first2, AX_IT_CONT)) {
+		struct pred_batch pb;
+		pred_batch_init(&pb, upred, r.etr, cont_length(&r));
+		cont_transform(&r, first2->point, ax_box_elem_tr(first2->owner), &pb);
+		return;
+	}
+
 	ax_citer cur1 = *first1;
 	ax_iter cur2 = *first2;
 	for (; !ax_citer_equal(&cur1, last1); ax_citer_next(&cur1)) {
@@ -33,6 +198,10 @@ ax_bool ax_all_of(const ax_citer *first, const ax_citer *last, const ax_pred *up
 	CHECK_PARAM_NULL(upred);
 	CHECK_ITER_COMPARABLE(first, last);
 
+	struct cont_range r;
+	if (cont_range_of(first, last, &r))
+		return cont_find_if(&r, upred, ax_false) == r.end;
+
 	ax_bool out;
 	for (ax_citer it = *first; !ax_citer_equal(&it, last); ax_citer_next(&it)) {
 		ax_pred_do(upred, &out, ax_citer_get(&it), NULL);
@@ -47,6 +216,10 @@ ax_bool ax_any_of(const ax_citer *first, const ax_citer *last, const ax_pred *up
 	CHECK_PARAM_NULL(upred);
 	CHECK_ITER_COMPARABLE(first, last);
 
+	struct cont_range r;
+	if (cont_range_of(first, last, &r))
+		return cont_find_if(&r, upred, ax_true) != r.end;
+
 	ax_bool out;
 	for (ax_citer it = *first; !ax_citer_equal(&it, last); ax_citer_next(&it)) {
 		ax_pred_do(upred, &out, ax_citer_get(&it), NULL);
@@ -61,6 +234,10 @@ ax_bool ax_none_of(const ax_citer *first, const ax_citer *last, const ax_pred *u
 	CHECK_PARAM_NULL(upred);
 	CHECK_ITER_COMPARABLE(first, last);
 
+	struct cont_range r;
+	if (cont_range_of(first, last, &r))
+		return cont_find_if(&r, upred, ax_true) == r.end;
+
 	ax_bool out;
 	for (ax_citer it = *first; !ax_citer_equal(&it, last); ax_citer_next(&it)) {
 		ax_pred_do(upred, &out, ax_citer_get(&it), NULL);
@@ -77,6 +254,14 @@ size_t ax_count_if(const ax_citer *first, const ax_citer *last, const ax_pred *u
 
 	size_t count = 0;
 	ax_bool out = ax_false;
+
+	struct cont_range r;
+	if (cont_range_of(first, last, &r)) {
+		struct pred_batch pb;
+		pred_batch_init(&pb, upred, r.etr, cont_length(&r));
+		return cont_count(&r, &pb);
+	}
+
 	for (ax_citer it = *first; !ax_citer_equal(&it, last); ax_citer_next(&it)) {
 		ax_pred_do(upred, &out, ax_citer_get(&it), NULL);
 		count += out ? 1 : 0;
@@ -121,6 +306,12 @@ void ax_find_if(ax_citer *first, const ax_citer *last, const ax_pred *upred)
 	CHECK_PARAM_NULL(upred);
 	CHECK_ITER_COMPARABLE(first, last);
 
+	struct cont_range r;
+	if (cont_range_of(first, last, &r)) {
+		first->point = cont_find_if(&r, upred, ax_true);
+		return;
+	}
+
 	ax_bool retval;
 	while (!ax_citer_equal(first, last)) {
 		if (ax_pred_do(upred, &retval, ax_citer_get(first), NULL), retval)
@@ -134,6 +325,12 @@ void ax_find_if_not(ax_citer *first, const ax_citer *last, const ax_pred *upred)
 	CHECK_PARAM_NULL(upred);
 	CHECK_ITER_COMPARABLE(first, last);
 
+	struct cont_range r;
+	if (cont_range_of(first, last, &r)) {
+		first->point = cont_find_if(&r, upred, ax_false);
+		return;
+	}
+
 	ax_bool retval;
 	while (!ax_citer_equal(first, last)) {
 		if (ax_pred_do(upred, &retval, ax_citer_get(first), NULL), !retval)
@@ -142,279 +339,2127 @@ void ax_find_if_not(ax_citer *first, const ax_citer *last, const ax_pred *upred)
 	}
 }
 
-ax_bool ax_sorted(const ax_citer *first, const ax_citer *last, const ax_pred *bpred)
+/* Storage unit of reduction temporaries, aligned for any arithmetic type */
+union reduce_slot
 {
-	CHECK_PARAM_NULL(bpred);
-	CHECK_ITER_COMPARABLE(first, last);
+	intmax_t i;
+	long double lf;
+	void *ptr;
+};
 
-	if (ax_citer_equal(first, last))
-		return ax_true;
+#define REDUCE_SLOTS(_size) (((_size) + sizeof(union reduce_slot) - 1) / sizeof(union reduce_slot))
 
-	ax_bool retval;
-	ax_citer it1 = *first, it2 = it1;
-	ax_citer_next(&it2);
+void ax_reduce(const ax_citer *first, const ax_citer *last, void *acc, const ax_pred *bpred)
+{
+	CHECK_PARAM_NULL(acc);
+	CHECK_PARAM_NULL(bpred);
+	CHECK_ITER_COMPARABLE(first, last);
 
-	while (!ax_citer_equal(&it2, last)) {
-		if (ax_pred_do(bpred, &retval, ax_citer_get(&it1), ax_citer_get(&it2)), !retval)
-			return ax_false;
-		it1 = it2;
-		ax_citer_next(&it2);
+	struct cont_range r;
+	if (cont_range_of(first, last, &r)) {
+		for (ax_byte *p = r.begin; p != r.end; p += r.etr->size)
+			ax_pred_do(bpred, acc, acc, cont_value(r.etr, p));
+		return;
 	}
-	return ax_true;
+
+	for (ax_citer it = *first; !ax_citer_equal(&it, last); ax_citer_next(&it))
+		ax_pred_do(bpred, acc, acc, ax_citer_get(&it));
 }
 
-void ax_partition(ax_iter *first, const ax_iter *last, const ax_pred *pred)
+void ax_transform_reduce(const ax_citer *first, const ax_citer *last, void *acc, size_t size,
+		const ax_pred *upred, const ax_pred *bpred)
 {
-	CHECK_PARAM_NULL(pred);
+	CHECK_PARAM_NULL(acc);
+	CHECK_PARAM_NULL(upred);
+	CHECK_PARAM_NULL(bpred);
+	CHECK_PARAM_VALIDITY(size, size > 0);
 	CHECK_ITER_COMPARABLE(first, last);
-	ax_assert((first->tr->ctr.type & AX_IT_FORW) == AX_IT_FORW,
-			"iterator type is not supported");
-
-	ax_find_if_not(ax_iter_c(first), ax_iter_c(last), pred);
 
-	if (ax_iter_equal(first, last))
+	union reduce_slot tmp[REDUCE_SLOTS(size)];
+	struct cont_range r;
+	if (cont_range_of(first, last, &r)) {
+		for (ax_byte *p = r.begin; p != r.end; p += r.etr->size) {
+			ax_pred_do(upred, tmp, cont_value(r.etr, p), NULL);
+			ax_pred_do(bpred, acc, acc, tmp);
+		}
 		return;
+	}
 
-	ax_iter it = *first;
-	for (ax_iter_next(&it); !ax_iter_equal(&it, last); ax_iter_next(&it)) {
-		ax_bool retval;
-		ax_pred_do(pred, &retval, ax_iter_get(&it), NULL);
-		if (retval) {
-			ax_iter_swap(&it, first);
-			ax_iter_next(first);
-		}
+	for (ax_citer it = *first; !ax_citer_equal(&it, last); ax_citer_next(&it)) {
+		ax_pred_do(upred, tmp, ax_citer_get(&it), NULL);
+		ax_pred_do(bpred, acc, acc, tmp);
 	}
 }
 
-struct quick_sort_context_st {
+/*
+ * Parallel algorithms cut a random access range into a fixed number of
+ * chunks, run them by ax_exec_parallel_for and combine the results in chunk
+ * order. Ranges too short to give two chunks are left to the sequential
+ * version.
+ */
+
+#define PAR_CHUNKS_PER_WORKER 4
+#define PAR_MIN_CHUNK 0x1000
+#define PAR_FIND_BLOCK 0x400
+
+struct par_range
+{
+	ax_citer first;
+	struct cont_range cont;
+	ax_bool is_cont;
+	size_t n;
+};
+
+/* Walks a par_range by pointer when it is contiguous */
+struct par_cursor
+{
+	ax_citer it;
+	ax_byte *p;
+	const ax_stuff_trait *etr;
+};
+
+struct par_job
+{
+	struct par_range src;
+	struct par_range dst;
+	size_t nchunks;
+	const ax_pred *upred;
+	const ax_pred *bpred;
+	struct pred_batch pb;
+	const void *ptr;
 	ax_pool *pool;
-	const ax_stuff_trait *tr;
-	ax_pred pred;
+	union reduce_slot *partial;
+	size_t size;
+	size_t stride;
+	size_t count;
+	size_t found;
+	ax_bool expect;
+	ax_bool leftmost;
 };
 
-static void less_then(ax_bool *out, void *in1, void *in2, const ax_stuff_trait *tr)
+inline static void par_range_init(struct par_range *pr, const ax_citer *first, const ax_citer *last)
 {
-	*out = tr->less(in1, in2, tr->size);
+	pr->first = *first;
+	pr->is_cont = cont_range_of(first, last, &pr->cont);
+	pr->n = pr->is_cont ? cont_length(&pr->cont) : (size_t)ax_citer_dist(first, last);
 }
 
-static void quick_sort(struct quick_sort_context_st*ext, const ax_iter *first, const ax_iter *last)
+/* Number of chunks for the range, less than 2 when it is not worth splitting */
+static size_t par_prepare(struct par_job *job, const ax_citer *first, const ax_citer *last, ax_exec *exec)
 {
-	if (ax_iter_equal(first, last))
-		return;
+	if (!ax_citer_is(first, AX_IT_RAND))
+		return 0;
+	par_range_init(&job->src, first, last);
+	if (job->upred && job->src.is_cont)
+		pred_batch_init(&job->pb, job->upred, job->src.cont.etr, job->src.n);
+
+	size_t nchunks = ax_exec_workers(exec) * PAR_CHUNKS_PER_WORKER;
+	if (nchunks > job->src.n / PAR_MIN_CHUNK)
+		nchunks = job->src.n / PAR_MIN_CHUNK;
+	job->nchunks = nchunks;
+	return nchunks;
+}
 
-	ax_iter second = *first;
-	ax_iter_next(&second);
+inline static size_t par_chunk_begin(const struct par_job *job, size_t i)
+{
+	return (uint64_t)job->src.n * i / job->nchunks;
+}
 
-	if (ax_iter_equal(&second, last))
-		return;
+inline static void par_cont_sub(const struct par_range *pr, size_t lo, size_t hi, struct cont_range *r)
+{
+	r->etr = pr->cont.etr;
+	r->begin = pr->cont.begin + lo * r->etr->size;
+	r->end = pr->cont.begin + hi * r->etr->size;
+}
 
-	ext->pred = ax_pred_binary_make((ax_binary_f) less_then, NULL,
-			ax_iter_get(first), (void*)ext->tr);
-	ax_iter right_first = second;
-	 ax_partition(&right_first, last, &ext->pred);
+inline static void par_cursor_init(struct par_cursor *c, const struct par_range *pr, size_t pos)
+{
+	if (pr->is_cont) {
+		c->etr = pr->cont.etr;
+		c->p = pr->cont.begin + pos * c->etr->size;
+	} else {
+		c->etr = NULL;
+		c->it = pr->first;
+		ax_citer_move(&c->it, pos);
+	}
+}
 
-	ax_iter left_last = right_first;
-	ax_iter_prev(&left_last);
-	ext->tr->swap(ax_iter_get(&left_last), ax_iter_get(first), ext->tr->size);
+inline static void *par_cursor_get(const struct par_cursor *c)
+{
+	return c->etr ? cont_value(c->etr, c->p) : (void *)ax_citer_get(&c->it);
+}
 
-	quick_sort(ext, first, &left_last);
-	quick_sort(ext, &right_first, last);
+inline static void par_cursor_next(struct par_cursor *c)
+{
+	if (c->etr)
+		c->p += c->etr->size;
+	else
+		ax_citer_next(&c->it);
 }
 
-ax_fail ax_quick_sort(const ax_iter *first, const ax_iter *last)
+static void par_transform_run(size_t begin, size_t end, void *arg)
 {
-	CHECK_ITER_COMPARABLE(first, last);
-	ax_assert(ax_one_is(first->owner, "one.any.box.seq"), "unsupported container type");
-	ax_assert(ax_iter_is(first, AX_IT_BID), "unsupported iterator type");
+	const struct par_job *job = arg;
+	size_t lo = par_chunk_begin(job, begin), hi = par_chunk_begin(job, end);
+	if (job->src.is_cont && job->dst.is_cont) {
+		struct cont_range r;
+		par_cont_sub(&job->src, lo, hi, &r);
+		const ax_stuff_trait *dtr = job->dst.cont.etr;
+		cont_transform(&r, job->dst.cont.begin + lo * dtr->size, dtr, &job->pb);
+		return;
+	}
 
-	const ax_box *box = first->owner;
-	ax_one *one = (ax_one*) box;
-	ax_base *base = ax_one_base(one);
-	ax_pool *pool = ax_base_pool(base);
-	const ax_stuff_trait *tr = ax_box_elem_tr(box);
+	struct par_cursor src, dst;
+	par_cursor_init(&src, &job->src, lo);
+	par_cursor_init(&dst, &job->dst, lo);
+	for (size_t i = lo; i < hi; i++) {
+		ax_pred_do(job->upred, par_cursor_get(&dst), par_cursor_get(&src), NULL);
+		par_cursor_next(&src);
+		par_cursor_next(&dst);
+	}
+}
 
-	struct quick_sort_context_st ext = {
-		.pool = pool,
-		.tr = tr
-	};
-	quick_sort(&ext, first, last);
-	return ax_false;
+static void par_count_run(size_t begin, size_t end, void *arg)
+{
+	struct par_job *job = arg;
+	size_t lo = par_chunk_begin(job, begin), hi = par_chunk_begin(job, end);
+	size_t count = 0;
+	if (job->src.is_cont) {
+		struct cont_range r;
+		par_cont_sub(&job->src, lo, hi, &r);
+		count = cont_count(&r, &job->pb);
+	} else {
+		ax_bool out = ax_false;
+		struct par_cursor c;
+		par_cursor_init(&c, &job->src, lo);
+		for (size_t i = lo; i < hi; i++) {
+			ax_pred_do(job->upred, &out, par_cursor_get(&c), NULL);
+			count += out ? 1 : 0;
+			par_cursor_next(&c);
+		}
+	}
+	__atomic_fetch_add(&job->count, count, __ATOMIC_RELAXED);
 }
 
-void ax_merge(const ax_citer *first1, const ax_citer *last1, const ax_citer *first2, const ax_citer *last2, ax_iter *dest)
+/* Index of the first match in [i, end), or end */
+static size_t par_find_block(const struct par_job *job, struct par_cursor *c, size_t i, size_t end)
 {
-	CHECK_ITER_COMPARABLE(first1, last1);
-	CHECK_ITER_COMPARABLE(first2, last2);
+	if (job->src.is_cont) {
+		struct cont_range r;
+		par_cont_sub(&job->src, i, end, &r);
+		return i + (cont_find(&r, &job->pb, job->expect) - r.begin) / r.etr->size;
+	}
 
-	ax_box *box = (ax_box *)first1->owner;
-	const ax_stuff_trait *etr = ax_box_elem_tr(box);
-	ax_citer cur1 = *first1, cur2 = *first2;
+	ax_bool out;
+	for (; i < end; i++, par_cursor_next(c))
+		if (ax_pred_do(job->upred, &out, par_cursor_get(c), NULL), !out == !job->expect)
+			break;
+	return i;
+}
 
-	ax_citer src;
-	ax_citer src_last;
-	while (!ax_citer_equal(&cur1, last1) && !ax_citer_equal(&cur2, last2)) {
-		if (etr->less(ax_citer_get(&cur1), ax_citer_get(&cur2), etr->size)) {
-			src = cur1;
-			ax_citer_next(&cur1);
-		} else {
-			src = cur2;
-			ax_citer_next(&cur2);
+/*
+ * found holds the least index matched so far. A chunk gives up as soon as
+ * found is before its next block, or anywhere when the leftmost match is
+ * not needed
+ */
+static void par_find_run(size_t begin, size_t end, void *arg)
+{
+	struct par_job *job = arg;
+	size_t lo = par_chunk_begin(job, begin), hi = par_chunk_begin(job, end);
+	struct par_cursor c;
+	par_cursor_init(&c, &job->src, lo);
+	for (size_t i = lo; i < hi; ) {
+		size_t found = __atomic_load_n(&job->found, __ATOMIC_RELAXED);
+		if (job->leftmost ? found <= i : found != job->src.n)
+			return;
+		size_t block_end = hi - i > PAR_FIND_BLOCK ? i + PAR_FIND_BLOCK : hi;
+		i = par_find_block(job, &c, i, block_end);
+		if (i < block_end) {
+			while (i < found && !__atomic_compare_exchange_n(&job->found, &found, i,
+						0, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+			return;
 		}
-		ax_iter_set(dest, ax_citer_get(&src));
-
-		ax_iter_next(dest);
-
 	}
+}
 
-	if (!ax_citer_equal(&cur1, last1)) {
-		src = cur1;
-		src_last = *last1;
-	} else {
-		src = cur2;
-		src_last = *last2;
-	}
-	while (!ax_citer_equal(&src, &src_last)) {
-		ax_iter_set(dest, ax_citer_get(&src));
-		ax_citer_next(&src);
-		ax_iter_next(dest);
+static void par_generate_run(size_t begin, size_t end, void *arg)
+{
+	const struct par_job *job = arg;
+	size_t lo = par_chunk_begin(job, begin), hi = par_chunk_begin(job, end);
+	const ax_stuff_trait *etr = ax_box_elem_tr(job->src.first.owner);
+	struct par_cursor c;
+	par_cursor_init(&c, &job->src, lo);
+	for (size_t i = lo; i < hi; i++) {
+		etr->copy(job->pool, par_cursor_get(&c), job->ptr, etr->size);
+		par_cursor_next(&c);
 	}
 }
 
-struct merge_sort_context_st {
-	ax_seq *main;
-	void **imap;
-
-	ax_seq *aux;
-};
+/* Each chunk folds into its own partial, seeded with its first value */
+static void par_reduce_run(size_t begin, size_t end, void *arg)
+{
+	const struct par_job *job = arg;
+	union reduce_slot tmp[job->stride];
+	for (size_t chunk = begin; chunk < end; chunk++) {
+		size_t lo = par_chunk_begin(job, chunk), hi = par_chunk_begin(job, chunk + 1);
+		union reduce_slot *acc = job->partial + chunk * job->stride;
+		struct par_cursor c;
+		par_cursor_init(&c, &job->src, lo);
+		if (job->upred)
+			ax_pred_do(job->upred, acc, par_cursor_get(&c), NULL);
+		else
+			memcpy(acc, par_cursor_get(&c), job->size);
+		par_cursor_next(&c);
+		for (size_t i = lo + 1; i < hi; i++) {
+			const void *val = par_cursor_get(&c);
+			if (job->upred) {
+				ax_pred_do(job->upred, tmp, val, NULL);
+				val = tmp;
+			}
+			ax_pred_do(job->bpred, acc, acc, val);
+			par_cursor_next(&c);
+		}
+	}
+}
 
-void merge_sort(size_t left, size_t right, struct merge_sort_context_st *ext)
+/* Move first to a match, the leftmost one if asked, or to last */
+static void par_find(ax_citer *first, const ax_citer *last, const ax_pred *upred,
+		ax_bool expect, ax_bool leftmost, ax_exec *exec)
 {
-	if (right - left <= 1)
+	struct par_job job = { .upred = upred, .expect = expect, .leftmost = leftmost };
+	if (par_prepare(&job, first, last, exec) < 2) {
+		(expect ? ax_find_if : ax_find_if_not)(first, last, upred);
 		return;
-	size_t mid = left + (right - left) / 2;
-	size_t lmid = left + (mid - left) / 2;
-	size_t rmid = mid + (right - mid) / 2;
-
-	merge_sort(left, lmid, ext);
-	merge_sort(lmid, mid, ext);
-	merge_sort(mid, rmid, ext);
-	merge_sort(rmid, right, ext);
-
-	ax_iter end = ax_box_end(ax_r(seq, ext->main).box);
-	ax_iter main_first = { .owner = end.owner, .tr = end.tr };
-	ax_iter main_mid  = { .owner = end.owner, .tr = end.tr };
-	ax_iter main_last = { .owner = end.owner, .tr = end.tr };
-	ax_iter aux_first;
-	ax_iter aux_mid;
-	ax_iter aux_last;
-
-	main_first.point = ext->imap[left];
-	main_mid.point = ext->imap[lmid];
-	main_last.point = ext->imap[mid];
-
-	aux_first = ax_seq_at(ext->aux, left);
-	aux_mid = aux_first;
-	ax_merge(ax_iter_c(&main_first), ax_iter_c(&main_mid),
-			ax_iter_c(&main_mid), ax_iter_c(&main_last),
-			&aux_mid);
-
-	main_first.point = ext->imap[mid];
-	main_mid.point = ext->imap[rmid];
-	main_last.point = ext->imap[right];
-	aux_last = aux_mid;
-	ax_merge(ax_iter_c(&main_first), ax_iter_c(&main_mid),
-			ax_iter_c(&main_mid), ax_iter_c(&main_last),
-			&aux_last);
-
-	main_first.point = ext->imap[left];
-	main_last = main_first;
-	ax_merge(ax_iter_c(&aux_first), ax_iter_c(&aux_mid),
-			ax_iter_c(&aux_mid), ax_iter_c(&aux_last),
-			&main_last);
+	}
+	job.found = job.src.n;
+	ax_exec_parallel_for(exec, 0, job.nchunks, 1, par_find_run, &job);
+	if (job.found == job.src.n)
+		*first = *last;
+	else
+		ax_citer_move(first, job.found);
 }
 
-ax_fail ax_merge_sort(const ax_iter *first, const ax_iter *last)
+void ax_par_transform(const ax_citer *first1, const ax_citer *last1, const ax_iter *first2,
+		const ax_pred *upred, ax_exec *exec)
 {
-	CHECK_ITER_COMPARABLE(first, last);
-	ax_assert(ax_one_is(first->owner, AX_SEQ_NAME), "unsupported one object type");
-	ax_assert(ax_iter_is(first, AX_IT_FORW), "unsupported iterator type");
-
-	ax_seq_r main_r = { first->owner };
-
-	ax_base *base = ax_one_base(main_r.one);
-	const ax_stuff_trait *etr = ax_box_elem_tr(main_r.box);
-
-	size_t size = 0;
-	ax_iter cur = ax_box_begin(main_r.box);
-	while (!ax_iter_equal(&cur, last)) {
-		size++;
-		ax_iter_next(&cur);
-	}
-	
-	void **imap = malloc((size + 1) * sizeof *imap);
-	if (!imap) {
-		ax_base_set_errno(base, AX_ERR_NOMEM);
-		return ax_true;
-	}
-	
-	size_t pos = 0;
-	cur = ax_box_begin(main_r.box);
-	while (!ax_iter_equal(&cur, last)) {
-		imap[pos++] = cur.point;
-		ax_iter_next(&cur);
-	}
-	imap[pos] = cur.point;
+	CHECK_PARAM_NULL(upred);
+	CHECK_PARAM_NULL(exec);
+	CHECK_ITER_COMPARABLE(first1, last1);
 
-	ax_seq *aux = __ax_vector_construct(base, etr);
-	if (!aux) {
-		free(imap);
-		return ax_true;
+	struct par_job job = { .upred = upred };
+	if (!ax_iter_is(first2, AX_IT_RAND) || par_prepare(&job, first1, last1, exec) < 2) {
+		ax_transform(first1, last1, first2, upred);
+		return;
 	}
-	ax_seq_trunc(aux, size);
 
-	struct merge_sort_context_st ext = {
-		.imap = imap,
-		.main = main_r.seq,
-		.aux = aux
-	};
+	ax_citer last2 = *ax_iter_c(first2);
+	ax_citer_move(&last2, job.src.n);
+	par_range_init(&job.dst, ax_iter_c(first2), &last2);
+	ax_exec_parallel_for(exec, 0, job.nchunks, 1, par_transform_run, &job);
+}
 
-	merge_sort(0, size, &ext);
+ax_bool ax_par_all_of(const ax_citer *first, const ax_citer *last, const ax_pred *upred, ax_exec *exec)
+{
+	CHECK_PARAM_NULL(upred);
+	CHECK_PARAM_NULL(exec);
+	CHECK_ITER_COMPARABLE(first, last);
 
-	free(imap);
-	ax_one_free((ax_one *)aux);
-	
-	return ax_false;
+	ax_citer it = *first;
+	par_find(&it, last, upred, ax_false, ax_false, exec);
+	return ax_citer_equal(&it, last);
 }
 
-ax_bool ax_equal_to_arr(const ax_iter *first, const ax_iter *last, void *arr, size_t size)
+ax_bool ax_par_any_of(const ax_citer *first, const ax_citer *last, const ax_pred *upred, ax_exec *exec)
 {
-	CHECK_PARAM_VALIDITY(arr, !!arr == !!size);
-
-	const ax_box *box = first->owner;
-	const ax_stuff_trait *tr = ax_box_elem_tr(box);
-	ax_assert(size % tr->size == 0, "unexpected size");
+	CHECK_PARAM_NULL(upred);
+	CHECK_PARAM_NULL(exec);
+	CHECK_ITER_COMPARABLE(first, last);
 
-	size_t pos = 0;
-	ax_iter cur = *first;
-	while (!ax_iter_equal(&cur, last) && pos < size) {
-		if (!tr->equal(ax_iter_get(&cur), (ax_byte*)arr + pos, tr->size))
-			return ax_false;
-		ax_iter_next(&cur);
-		pos += tr->size;
-	}
-	return ax_iter_equal(&cur, last) == (pos == size);
+	ax_citer it = *first;
+	par_find(&it, last, upred, ax_true, ax_false, exec);
+	return !ax_citer_equal(&it, last);
 }
 
-void ax_binary_search(ax_citer *first, const ax_citer *last, const void* p)
+ax_bool ax_par_none_of(const ax_citer *first, const ax_citer *last, const ax_pred *upred, ax_exec *exec)
 {
+	CHECK_PARAM_NULL(upred);
+	CHECK_PARAM_NULL(exec);
 	CHECK_ITER_COMPARABLE(first, last);
-	ax_assert(ax_one_is(first->owner, "one.any.box.seq"), "unsupported container type");
-	ax_assert(ax_citer_is(first, AX_IT_RAND), "unsupported citerator type");
 
-	void *orignal_last_citer_point = last->point;
-	const ax_stuff_trait *tr = ax_box_elem_tr(first->owner);
+	ax_citer it = *first;
+	par_find(&it, last, upred, ax_true, ax_false, exec);
+	return ax_citer_equal(&it, last);
+}
 
-	ax_citer left = *first, right = *last, middle;
+size_t ax_par_count_if(const ax_citer *first, const ax_citer *last, const ax_pred *upred, ax_exec *exec)
+{
+	CHECK_PARAM_NULL(upred);
+	CHECK_PARAM_NULL(exec);
+	CHECK_ITER_COMPARABLE(first, last);
+
+	struct par_job job = { .upred = upred };
+	if (par_prepare(&job, first, last, exec) < 2)
+		return ax_count_if(first, last, upred);
+	ax_exec_parallel_for(exec, 0, job.nchunks, 1, par_count_run, &job);
+	return job.count;
+}
+
+void ax_par_find_if(ax_citer *first, const ax_citer *last, const ax_pred *upred, ax_exec *exec)
+{
+	CHECK_PARAM_NULL(upred);
+	CHECK_PARAM_NULL(exec);
+	CHECK_ITER_COMPARABLE(first, last);
+
+	par_find(first, last, upred, ax_true, ax_true, exec);
+}
+
+void ax_par_generate(const ax_iter *first, const ax_iter *last, const void *ptr, ax_exec *exec)
+{
+	CHECK_PARAM_NULL(exec);
+	CHECK_ITER_COMPARABLE(first, last);
+
+	/* Copies of link types allocate from the pool, which is not thread safe */
+	struct par_job job = { .ptr = ptr, .pool = ax_base_pool(ax_one_base(first->owner)) };
+	if (ax_box_elem_tr(first->owner)->link
+			|| par_prepare(&job, ax_iter_c(first), ax_iter_c(last), exec) < 2) {
+		ax_generate(first, last, ptr);
+		return;
+	}
+	ax_exec_parallel_for(exec, 0, job.nchunks, 1, par_generate_run, &job);
+}
+
+static ax_bool par_reduce(const ax_citer *first, const ax_citer *last, void *acc, size_t size,
+		const ax_pred *upred, const ax_pred *bpred, ax_exec *exec)
+{
+	struct par_job job = { .upred = upred, .bpred = bpred, .size = size, .stride = REDUCE_SLOTS(size) };
+	if (par_prepare(&job, first, last, exec) < 2)
+		return ax_false;
+	if (!(job.partial = malloc(job.nchunks * job.stride * sizeof(union reduce_slot))))
+		return ax_false;
+
+	ax_exec_parallel_for(exec, 0, job.nchunks, 1, par_reduce_run, &job);
+	for (size_t i = 0; i < job.nchunks; i++)
+		ax_pred_do(bpred, acc, acc, job.partial + i * job.stride);
+	free(job.partial);
+	return ax_true;
+}
+
+void ax_par_reduce(const ax_citer *first, const ax_citer *last, void *acc, const ax_pred *bpred, ax_exec *exec)
+{
+	CHECK_PARAM_NULL(acc);
+	CHECK_PARAM_NULL(bpred);
+	CHECK_PARAM_NULL(exec);
+	CHECK_ITER_COMPARABLE(first, last);
+
+	const ax_stuff_trait *etr = ax_box_elem_tr(first->owner);
+	if (etr->link || !par_reduce(first, last, acc, etr->size, NULL, bpred, exec))
+		ax_reduce(first, last, acc, bpred);
+}
+
+void ax_par_transform_reduce(const ax_citer *first, const ax_citer *last, void *acc, size_t size,
+		const ax_pred *upred, const ax_pred *bpred, ax_exec *exec)
+{
+	CHECK_PARAM_NULL(acc);
+	CHECK_PARAM_NULL(upred);
+	CHECK_PARAM_NULL(bpred);
+	CHECK_PARAM_NULL(exec);
+	CHECK_PARAM_VALIDITY(size, size > 0);
+	CHECK_ITER_COMPARABLE(first, last);
+
+	if (!par_reduce(first, last, acc, size, upred, bpred, exec))
+		ax_transform_reduce(first, last, acc, size, upred, bpred);
+}
+
+ax_bool ax_sorted(const ax_citer *first, const ax_citer *last, const ax_pred *bpred)
+{
+	CHECK_PARAM_NULL(bpred);
+	CHECK_ITER_COMPARABLE(first, last);
+
+	if (ax_citer_equal(first, last))
+		return ax_true;
+
+	ax_bool retval;
+	ax_citer it1 = *first, it2 = it1;
+	ax_citer_next(&it2);
+
+	while (!ax_citer_equal(&it2, last)) {
+		if (ax_pred_do(bpred, &retval, ax_citer_get(&it1), ax_citer_get(&it2)), !retval)
+			return ax_false;
+		it1 = it2;
+		ax_citer_next(&it2);
+	}
+	return ax_true;
+}
+
+void ax_partition(ax_iter *first, const ax_iter *last, const ax_pred *pred)
+{
+	CHECK_PARAM_NULL(pred);
+	CHECK_ITER_COMPARABLE(first, last);
+	ax_assert((first->tr->ctr.type & AX_IT_FORW) == AX_IT_FORW,
+			"iterator type is not supported");
+
+	ax_find_if_not(ax_iter_c(first), ax_iter_c(last), pred);
+
+	if (ax_iter_equal(first, last))
+		return;
+
+	ax_iter it = *first;
+	for (ax_iter_next(&it); !ax_iter_equal(&it, last); ax_iter_next(&it)) {
+		ax_bool retval;
+		ax_pred_do(pred, &retval, ax_iter_get(&it), NULL);
+		if (retval) {
+			ax_iter_swap(&it, first);
+			ax_iter_next(first);
+		}
+	}
+}
+
+static void less_then(ax_bool *out, void *in1, void *in2, const ax_stuff_trait *tr)
+{
+	*out = tr->less(in1, in2, tr->size);
+}
+
+#ifdef __GNUC__
+#define SEARCH_PREFETCH(_p) __builtin_prefetch(_p)
+#else
+#define SEARCH_PREFETCH(_p) ((void)(_p))
+#endif
+
+#define SORT_INSERTION 24
+#define SORT_NINTHER 128
+#define SORT_PARTIAL_LIMIT 8
+
+/* Element value taken from the range and its original position */
+struct sort_ent
+{
+	const void *val;
+	size_t pos;
+};
+
+/* Order of the entries, the less of the element trait unless bpred is given */
+struct ent_order
+{
+	const ax_stuff_trait *etr;
+	const ax_pred *bpred;
+};
+
+/* val is storage, a predicate takes the value as ax_iter_get gives it */
+inline static ax_bool ent_less(const struct ent_order *ord, const struct sort_ent *a, const struct sort_ent *b)
+{
+	const ax_stuff_trait *etr = ord->etr;
+	if (!ord->bpred)
+		return etr->less(a->val, b->val, etr->size);
+	ax_bool ret;
+	ax_pred_do(ord->bpred, &ret, cont_value(etr, a->val), cont_value(etr, b->val));
+	return ret;
+}
+
+#define ENT_LESS(_ord, _a, _b) ent_less(_ord, &(_a), &(_b))
+
+inline static void ent_swap(struct sort_ent *a, struct sort_ent *b)
+{
+	struct sort_ent tmp = *a;
+	*a = *b;
+	*b = tmp;
+}
+
+static void ent_insertion_sort(const struct ent_order *ord, struct sort_ent *e, size_t lo, size_t hi)
+{
+	for (size_t i = lo + 1; i < hi; i++) {
+		struct sort_ent cur = e[i];
+		size_t j = i;
+		for (; j > lo && ENT_LESS(ord, cur, e[j - 1]); j--)
+			e[j] = e[j - 1];
+		e[j] = cur;
+	}
+}
+
+/* Insertion sort giving up after a few moves, for ranges that look sorted already */
+static ax_bool ent_partial_insertion_sort(const struct ent_order *ord, struct sort_ent *e, size_t lo, size_t hi)
+{
+	size_t moves = 0;
+	for (size_t i = lo + 1; i < hi; i++) {
+		struct sort_ent cur = e[i];
+		size_t j = i;
+		for (; j > lo && ENT_LESS(ord, cur, e[j - 1]); j--)
+			e[j] = e[j - 1];
+		e[j] = cur;
+		moves += i - j;
+		if (moves > SORT_PARTIAL_LIMIT)
+			return ax_false;
+	}
+	return ax_true;
+}
+
+static void ent_sift_down(const struct ent_order *ord, struct sort_ent *e, size_t i, size_t n)
+{
+	struct sort_ent cur = e[i];
+	for (size_t child; (child = 2 * i + 1) < n; i = child) {
+		if (child + 1 < n && ENT_LESS(ord, e[child], e[child + 1]))
+			child++;
+		if (!ENT_LESS(ord, cur, e[child]))
+			break;
+		e[i] = e[child];
+	}
+	e[i] = cur;
+}
+
+static void ent_heap_sort(const struct ent_order *ord, struct sort_ent *e, size_t n)
+{
+	for (size_t i = n / 2; i > 0; i--)
+		ent_sift_down(ord, e, i - 1, n);
+	for (size_t i = n - 1; i > 0; i--) {
+		ent_swap(e, e + i);
+		ent_sift_down(ord, e, 0, i);
+	}
+}
+
+inline static void ent_sort3(const struct ent_order *ord, struct sort_ent *e, size_t a, size_t b, size_t c)
+{
+	if (ENT_LESS(ord, e[b], e[a]))
+		ent_swap(e + a, e + b);
+	if (ENT_LESS(ord, e[c], e[b])) {
+		ent_swap(e + b, e + c);
+		if (ENT_LESS(ord, e[b], e[a]))
+			ent_swap(e + a, e + b);
+	}
+}
+
+/* Move the median of three, or the ninther of a long range, to e[lo] */
+static void ent_pick_pivot(const struct ent_order *ord, struct sort_ent *e, size_t lo, size_t hi)
+{
+	size_t len = hi - lo, mid = lo + len / 2;
+	if (len > SORT_NINTHER) {
+		ent_sort3(ord, e, lo, mid, hi - 1);
+		ent_sort3(ord, e, lo + 1, mid - 1, hi - 2);
+		ent_sort3(ord, e, lo + 2, mid + 1, hi - 3);
+		ent_sort3(ord, e, mid - 1, mid, mid + 1);
+	} else
+		ent_sort3(ord, e, lo, mid, hi - 1);
+	ent_swap(e + lo, e + mid);
+}
+
+/* Partition around e[lo], returns the final pivot position, [lo, p) < pivot <= [p + 1, hi) */
+static size_t ent_partition_right(const struct ent_order *ord, struct sort_ent *e, size_t lo, size_t hi, ax_bool *swapped)
+{
+	struct sort_ent pivot = e[lo];
+	size_t i = lo + 1, j = hi - 1;
+	*swapped = ax_false;
+	for (;;) {
+		while (i <= j && ENT_LESS(ord, e[i], pivot))
+			i++;
+		while (i <= j && !ENT_LESS(ord, e[j], pivot))
+			j--;
+		if (i >= j)
+			break;
+		ent_swap(e + i, e + j);
+		*swapped = ax_true;
+		i++;
+		j--;
+	}
+	e[lo] = e[i - 1];
+	e[i - 1] = pivot;
+	return i - 1;
+}
+
+/* Move elements not greater than e[lo] to the front, returns where the greater ones start */
+static size_t ent_partition_left(const struct ent_order *ord, struct sort_ent *e, size_t lo, size_t hi)
+{
+	struct sort_ent pivot = e[lo];
+	size_t i = lo + 1, j = hi - 1;
+	for (;;) {
+		while (i <= j && !ENT_LESS(ord, pivot, e[i]))
+			i++;
+		while (i <= j && ENT_LESS(ord, pivot, e[j]))
+			j--;
+		if (i >= j)
+			break;
+		ent_swap(e + i, e + j);
+		i++;
+		j--;
+	}
+	return i;
+}
+
+/*
+ * Introsort in the style of pdqsort: ninther pivots, insertion sort for
+ * short ranges, heap sort once the depth budget runs out, and a left
+ * partition skipping runs equal to the preceding pivot. The larger side is
+ * pushed on an explicit stack, so the stack never exceeds log2(n) entries
+ */
+static void ent_sort(const struct ent_order *ord, struct sort_ent *e, size_t n)
+{
+	struct { size_t lo, hi, depth; } stack[sizeof(size_t) * CHAR_BIT];
+	size_t top = 0, depth = 0;
+	for (size_t m = n; m > 1; m >>= 1)
+		depth += 2;
+
+	size_t lo = 0, hi = n;
+	for (;;) {
+		while (hi - lo > SORT_INSERTION) {
+			if (depth == 0) {
+				ent_heap_sort(ord, e + lo, hi - lo);
+				lo = hi;
+				break;
+			}
+			depth--;
+
+			ent_pick_pivot(ord, e, lo, hi);
+
+			/* Everything before lo is not greater, so an equal predecessor means a run of equal keys */
+			if (lo > 0 && !ENT_LESS(ord, e[lo - 1], e[lo])) {
+				lo = ent_partition_left(ord, e, lo, hi);
+				continue;
+			}
+
+			ax_bool swapped;
+			size_t p = ent_partition_right(ord, e, lo, hi, &swapped);
+			if (!swapped
+					&& ent_partial_insertion_sort(ord, e, lo, p)
+					&& ent_partial_insertion_sort(ord, e, p + 1, hi)) {
+				lo = hi;
+				break;
+			}
+
+			if (p - lo < hi - p - 1) {
+				stack[top].lo = p + 1;
+				stack[top].hi = hi;
+				stack[top++].depth = depth;
+				hi = p;
+			} else {
+				stack[top].lo = lo;
+				stack[top].hi = p;
+				stack[top++].depth = depth;
+				lo = p + 1;
+			}
+		}
+		if (hi - lo > 1)
+			ent_insertion_sort(ord, e, lo, hi);
+
+		if (top == 0)
+			break;
+		top--;
+		lo = stack[top].lo;
+		hi = stack[top].hi;
+		depth = stack[top].depth;
+	}
+}
+
+/*
+ * Introselect, the partition steps of ent_sort descending only into the
+ * side holding k, so e[k] ends where a sort would put it with no greater
+ * entry before it. Heap sort of the remaining range bounds the worst case
+ */
+static void ent_select(const struct ent_order *ord, struct sort_ent *e, size_t n, size_t k)
+{
+	size_t depth = 0;
+	for (size_t m = n; m > 1; m >>= 1)
+		depth += 2;
+
+	size_t lo = 0, hi = n;
+	while (hi - lo > SORT_INSERTION) {
+		if (depth == 0) {
+			ent_heap_sort(ord, e + lo, hi - lo);
+			return;
+		}
+		depth--;
+
+		ent_pick_pivot(ord, e, lo, hi);
+
+		/* Entries before lo are not greater, as in ent_sort, so [lo, lo') are all equal */
+		if (lo > 0 && !ENT_LESS(ord, e[lo - 1], e[lo])) {
+			lo = ent_partition_left(ord, e, lo, hi);
+			if (k < lo)
+				return;
+			continue;
+		}
+
+		ax_bool swapped;
+		size_t p = ent_partition_right(ord, e, lo, hi, &swapped);
+		if (p == k)
+			return;
+		if (k < p)
+			hi = p;
+		else
+			lo = p + 1;
+	}
+	if (hi - lo > 1)
+		ent_insertion_sort(ord, e, lo, hi);
+}
+
+#define MERGE_MIN_RUN 32
+#define MERGE_MIN_GALLOP 7
+
+/*
+ * Stable sort in the style of powersort. Natural runs are found left to
+ * right, descending ones reversed and short ones extended to MERGE_MIN_RUN
+ * by insertion sort. Each new run gets the power of its border with the
+ * previous one, the depth of that border in a balanced merge tree of the
+ * whole range, and runs left of a deeper border are merged first. This
+ * keeps merges nearly balanced, takes O(n) on presorted input, and keeps
+ * at most log2(n) + 1 runs pending
+ */
+struct ent_merge_st
+{
+	const struct ent_order *ord;
+	struct sort_ent *e;
+	struct sort_ent *buf;
+	size_t min_gallop;
+};
+
+/* Bit position where the midpoints of the two runs, as fractions of n, first differ */
+static unsigned merge_power(size_t lo1, size_t n1, size_t n2, size_t n)
+{
+	size_t a = 2 * lo1 + n1, b = a + n1 + n2;
+	unsigned power = 0;
+	for (;;) {
+		power++;
+		if (a >= n) {
+			a -= n;
+			b -= n;
+		} else if (b >= n)
+			break;
+		a <<= 1;
+		b <<= 1;
+	}
+	return power;
+}
+
+static size_t ent_count_run(const struct ent_order *ord, struct sort_ent *e, size_t lo, size_t n)
+{
+	size_t hi = lo + 1;
+	if (hi < n) {
+		/* Strictly descending, so reversing keeps equal entries in order */
+		if (ENT_LESS(ord, e[hi], e[lo])) {
+			while (++hi < n && ENT_LESS(ord, e[hi], e[hi - 1]))
+				;
+			for (size_t i = lo, j = hi - 1; i < j; i++, j--)
+				ent_swap(e + i, e + j);
+		} else
+			while (++hi < n && !ENT_LESS(ord, e[hi], e[hi - 1]))
+				;
+	}
+	if (hi - lo < MERGE_MIN_RUN && hi < n) {
+		hi = n - lo < MERGE_MIN_RUN ? n : lo + MERGE_MIN_RUN;
+		ent_insertion_sort(ord, e, lo, hi);
+	}
+	return hi - lo;
+}
+
+/*
+ * Index of the first of a[0, n) not going before key, where entries equal
+ * to key go before it if right. Probes 1, 2, 4 ... from the end named by
+ * from_end, then searches the bracketed span
+ */
+static size_t ent_gallop(const struct ent_order *ord, const struct sort_ent *key,
+		const struct sort_ent *a, size_t n, ax_bool right, ax_bool from_end)
+{
+#define GALLOP_BEFORE(_j) (right ? !ENT_LESS(ord, *key, a[_j]) : ENT_LESS(ord, a[_j], *key))
+	size_t lo = 0, hi = n;
+	if (from_end) {
+		for (size_t d = 1; d <= n; d *= 2) {
+			if (GALLOP_BEFORE(n - d)) {
+				lo = n - d + 1;
+				break;
+			}
+			hi = n - d;
+		}
+	} else {
+		for (size_t j = 0; j < n; j = 2 * j + 1) {
+			if (!GALLOP_BEFORE(j)) {
+				hi = j;
+				break;
+			}
+			lo = j + 1;
+		}
+	}
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		if (GALLOP_BEFORE(mid))
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo;
+#undef GALLOP_BEFORE
+}
+
+/* Merge with the left run moved to buf, filling e from the front */
+static void ent_merge_lo(struct ent_merge_st *ms, size_t lo, size_t mid, size_t hi)
+{
+	const struct ent_order *ord = ms->ord;
+	struct sort_ent *e = ms->e, *buf = ms->buf;
+	size_t n1 = mid - lo, i = 0, j = mid, d = lo;
+	memcpy(buf, e + lo, n1 * sizeof *e);
+
+	while (i < n1 && j < hi) {
+		size_t run1 = 0, run2 = 0;
+		do {
+			if (ENT_LESS(ord, e[j], buf[i])) {
+				e[d++] = e[j++];
+				run2++;
+				run1 = 0;
+			} else {
+				e[d++] = buf[i++];
+				run1++;
+				run2 = 0;
+			}
+		} while (i < n1 && j < hi && run1 < ms->min_gallop && run2 < ms->min_gallop);
+
+		/* One side keeps winning, move whole stretches of it */
+		while (i < n1 && j < hi) {
+			run1 = ent_gallop(ord, e + j, buf + i, n1 - i, ax_true, ax_false);
+			memcpy(e + d, buf + i, run1 * sizeof *e);
+			d += run1, i += run1;
+			if (i == n1)
+				break;
+			run2 = ent_gallop(ord, buf + i, e + j, hi - j, ax_false, ax_false);
+			memmove(e + d, e + j, run2 * sizeof *e);
+			d += run2, j += run2;
+			e[d++] = buf[i++];
+			if (ms->min_gallop > 1)
+				ms->min_gallop--;
+			if (run1 < MERGE_MIN_GALLOP && run2 < MERGE_MIN_GALLOP) {
+				ms->min_gallop += 2;
+				break;
+			}
+		}
+	}
+	memcpy(e + d, buf + i, (n1 - i) * sizeof *e);
+}
+
+/* Merge with the right run moved to buf, filling e from the back */
+static void ent_merge_hi(struct ent_merge_st *ms, size_t lo, size_t mid, size_t hi)
+{
+	const struct ent_order *ord = ms->ord;
+	struct sort_ent *e = ms->e, *buf = ms->buf;
+	size_t n2 = hi - mid, i = mid, j = n2, d = hi;
+	memcpy(buf, e + mid, n2 * sizeof *e);
+
+	while (i > lo && j > 0) {
+		size_t run1 = 0, run2 = 0;
+		do {
+			if (ENT_LESS(ord, buf[j - 1], e[i - 1])) {
+				e[--d] = e[--i];
+				run1++;
+				run2 = 0;
+			} else {
+				e[--d] = buf[--j];
+				run2++;
+				run1 = 0;
+			}
+		} while (i > lo && j > 0 && run1 < ms->min_gallop && run2 < ms->min_gallop);
+
+		while (i > lo && j > 0) {
+			run1 = i - lo - ent_gallop(ord, buf + j - 1, e + lo, i - lo, ax_true, ax_true);
+			d -= run1, i -= run1;
+			memmove(e + d, e + i, run1 * sizeof *e);
+			if (i == lo)
+				break;
+			run2 = j - ent_gallop(ord, e + i - 1, buf, j, ax_false, ax_true);
+			d -= run2, j -= run2;
+			memcpy(e + d, buf + j, run2 * sizeof *e);
+			if (j == 0)
+				break;
+			e[--d] = e[--i];
+			if (ms->min_gallop > 1)
+				ms->min_gallop--;
+			if (run1 < MERGE_MIN_GALLOP && run2 < MERGE_MIN_GALLOP) {
+				ms->min_gallop += 2;
+				break;
+			}
+		}
+	}
+	memcpy(e + lo, buf, j * sizeof *e);
+}
+
+/* Entries already in place at both ends are skipped, so buf needs only the shorter of the rest */
+static void ent_merge_at(struct ent_merge_st *ms, size_t lo, size_t mid, size_t hi)
+{
+	lo += ent_gallop(ms->ord, ms->e + mid, ms->e + lo, mid - lo, ax_true, ax_false);
+	if (lo == mid)
+		return;
+	hi = mid + ent_gallop(ms->ord, ms->e + mid - 1, ms->e + mid, hi - mid, ax_false, ax_true);
+	if (mid - lo <= hi - mid)
+		ent_merge_lo(ms, lo, mid, hi);
+	else
+		ent_merge_hi(ms, lo, mid, hi);
+}
+
+static ax_fail ent_stable_sort(const struct ent_order *ord, struct sort_ent *e, size_t n, ax_pool *pool)
+{
+	size_t len = n ? ent_count_run(ord, e, 0, n) : 0;
+	if (len == n)
+		return ax_false;
+
+	struct ent_merge_st ms = { ord, e, ax_pool_alloc(pool, n / 2 * sizeof *e), MERGE_MIN_GALLOP };
+	if (!ms.buf)
+		return ax_true;
+
+	struct { size_t lo, len; unsigned power; } stack[sizeof(size_t) * CHAR_BIT + 1];
+	size_t top = 0;
+	for (size_t lo = 0; lo < n; lo += len) {
+		if (lo)
+			len = ent_count_run(ord, e, lo, n);
+		if (top) {
+			unsigned power = merge_power(stack[top - 1].lo, stack[top - 1].len, len, n);
+			for (; top > 1 && stack[top - 2].power > power; top--) {
+				ent_merge_at(&ms, stack[top - 2].lo, stack[top - 1].lo, lo);
+				stack[top - 2].len += stack[top - 1].len;
+			}
+			stack[top - 1].power = power;
+		}
+		stack[top].lo = lo;
+		stack[top++].len = len;
+	}
+	for (; top > 1; top--) {
+		ent_merge_at(&ms, stack[top - 2].lo, stack[top - 1].lo, stack[top - 1].lo + stack[top - 1].len);
+		stack[top - 2].len += stack[top - 1].len;
+	}
+
+	ax_pool_free(ms.buf);
+	return ax_false;
+}
+
+/* Place the elements of the range in the order of e, following the cycles of the permutation */
+static ax_fail sort_permute(const ax_iter *first, struct sort_ent *e, void **point, size_t n)
+{
+	const ax_stuff_trait *etr = ax_box_elem_tr(first->owner);
+	ax_base *base = ax_one_base(first->owner);
+	ax_pool *pool = ax_base_pool(base);
+
+	void *tmp = ax_pool_alloc(pool, etr->size);
+	if (!tmp) {
+		ax_base_set_errno(base, AX_ERR_NOMEM);
+		return ax_true;
+	}
+
+	ax_iter dst = *first, src = *first;
+	for (size_t k = 0; k < n; k++) {
+		if (e[k].pos == k)
+			continue;
+
+		/* Link values are only reachable through ax_iter_set, which copies */
+		dst.point = point[k];
+		if (etr->link) {
+			const void *val = ax_iter_get(&dst);
+			if (etr->copy(pool, tmp, &val, etr->size)) {
+				ax_pool_free(tmp);
+				ax_base_set_errno(base, AX_ERR_NOMEM);
+				return ax_true;
+			}
+		} else
+			etr->move(tmp, ax_iter_get(&dst), etr->size);
+
+		size_t j = k;
+		for (;;) {
+			size_t from = e[j].pos;
+			e[j].pos = j;
+			dst.point = point[j];
+			if (from == k) {
+				if (etr->link) {
+					ax_iter_set(&dst, *(void **)tmp);
+					etr->free(tmp);
+				} else
+					etr->move(ax_iter_get(&dst), tmp, etr->size);
+				break;
+			}
+			if (etr->link)
+				ax_iter_set(&dst, *(void **)e[j].val);
+			else {
+				src.point = point[from];
+				etr->move(ax_iter_get(&dst), ax_iter_get(&src), etr->size);
+			}
+			j = from;
+		}
+	}
+
+	ax_pool_free(tmp);
+	return ax_false;
+}
+
+/* Sort kernels working on the storage of a contiguous range */
+
+static ax_fail cont_permute(const ax_stuff_trait *etr, ax_byte *ptr, struct sort_ent *e, size_t n, ax_base *base)
+{
+	const size_t size = etr->size;
+
+	/*
+	 * Bytes of plain elements are gathered in order over the entries already
+	 * read, which stay ahead of the writes, then copied back in one go
+	 */
+	if (!etr->link && etr->move == ax_stuff_mem_move && size <= sizeof *e) {
+		ax_byte *out = (ax_byte *)e;
+		for (size_t k = 0; k < n; k++) {
+			size_t from = e[k].pos;
+			memcpy(out + k * size, ptr + from * size, size);
+		}
+		memcpy(ptr, out, n * size);
+		return ax_false;
+	}
+	void *tmp = ax_pool_alloc(ax_base_pool(base), size);
+	if (!tmp) {
+		ax_base_set_errno(base, AX_ERR_NOMEM);
+		return ax_true;
+	}
+
+	for (size_t k = 0; k < n; k++) {
+		if (e[k].pos == k)
+			continue;
+		etr->move(tmp, ptr + k * size, size);
+		size_t j = k;
+		for (;;) {
+			size_t from = e[j].pos;
+			e[j].pos = j;
+			if (from == k) {
+				etr->move(ptr + j * size, tmp, size);
+				break;
+			}
+			etr->move(ptr + j * size, ptr + from * size, size);
+			j = from;
+		}
+	}
+
+	ax_pool_free(tmp);
+	return ax_false;
+}
+
+/*
+ * Kernels for the builtin arithmetic types, comparing with the operator
+ * instead of a call through the element trait. Merge takes the element of
+ * the second range on ties, the same as ax_merge does. Lower bound halves
+ * the range without a branch and prefetches both possible next probes
+ */
+
+#define DECLARE_CONT_SORT(_type) \
+	static void _type##_heap_sort(_type *a, size_t n) { \
+		for (size_t k = n / 2; k-- > 0; ) \
+			_type##_sift_down(a, k, n); \
+		for (size_t m = n - 1; m > 0; m--) { \
+			_type tmp = a[0]; a[0] = a[m]; a[m] = tmp; \
+			_type##_sift_down(a, 0, m); \
+		} \
+	} \
+	static void _type##_insertion_sort(_type *a, size_t lo, size_t hi) { \
+		for (size_t i = lo + 1; i < hi; i++) { \
+			_type cur = a[i]; \
+			size_t j = i; \
+			for (; j > lo && cur < a[j - 1]; j--) \
+				a[j] = a[j - 1]; \
+			a[j] = cur; \
+		} \
+	} \
+	static size_t _type##_partition(_type *a, size_t lo, size_t hi) { \
+		_type tmp; \
+		size_t mid = lo + (hi - lo) / 2, i = lo, j = hi; \
+		if (a[lo] < a[mid]) { tmp = a[lo]; a[lo] = a[mid]; a[mid] = tmp; } \
+		if (a[hi - 1] < a[lo]) { \
+			tmp = a[lo]; a[lo] = a[hi - 1]; a[hi - 1] = tmp; \
+			if (a[lo] < a[mid]) { tmp = a[lo]; a[lo] = a[mid]; a[mid] = tmp; } \
+		} \
+		_type pivot = a[lo]; \
+		for (;;) { \
+			while (a[++i] < pivot) ; \
+			while (pivot < a[--j]) ; \
+			if (i >= j) \
+				break; \
+			tmp = a[i]; a[i] = a[j]; a[j] = tmp; \
+		} \
+		a[lo] = a[j]; \
+		a[j] = pivot; \
+		return j; \
+	} \
+	static void _type##_sort(void *ptr, size_t n) { \
+		_type *a = ptr; \
+		struct { size_t lo, hi; int depth; } stack[sizeof(size_t) * CHAR_BIT]; \
+		int top = 0, depth = 0; \
+		for (size_t m = n; m > 1; m >>= 1) \
+			depth += 2; \
+		size_t lo = 0, hi = n; \
+		for (;;) { \
+			while (hi - lo > SORT_INSERTION) { \
+				if (depth-- == 0) { \
+					_type##_heap_sort(a + lo, hi - lo); \
+					lo = hi; \
+					break; \
+				} \
+				size_t j = _type##_partition(a, lo, hi); \
+				if (j - lo < hi - j) { \
+					stack[top].lo = j + 1, stack[top].hi = hi, stack[top++].depth = depth; \
+					hi = j; \
+				} else { \
+					stack[top].lo = lo, stack[top].hi = j, stack[top++].depth = depth; \
+					lo = j + 1; \
+				} \
+			} \
+			_type##_insertion_sort(a, lo, hi); \
+			if (!top) \
+				break; \
+			top--; \
+			lo = stack[top].lo, hi = stack[top].hi, depth = stack[top].depth; \
+		} \
+	} \
+	static void _type##_select(void *ptr, size_t n, size_t k) { \
+		_type *a = ptr; \
+		int depth = 0; \
+		for (size_t m = n; m > 1; m >>= 1) \
+			depth += 2; \
+		size_t lo = 0, hi = n; \
+		while (hi - lo > SORT_INSERTION) { \
+			if (depth-- == 0) { \
+				_type##_heap_sort(a + lo, hi - lo); \
+				return; \
+			} \
+			size_t j = _type##_partition(a, lo, hi); \
+			if (j == k) \
+				return; \
+			if (k < j) \
+				hi = j; \
+			else \
+				lo = j + 1; \
+		} \
+		_type##_insertion_sort(a, lo, hi); \
+	}
+
+#define DECLARE_CONT_KERNELS(_type) \
+	static void _type##_sift_down(_type *a, size_t k, size_t n) { \
+		_type val = a[k]; \
+		for (size_t c; (c = 2 * k + 1) < n; k = c) { \
+			if (c + 1 < n && a[c] < a[c + 1]) \
+				c++; \
+			if (!(val < a[c])) \
+				break; \
+			a[k] = a[c]; \
+		} \
+		a[k] = val; \
+	} \
+	DECLARE_CONT_SORT(_type) \
+	static size_t _type##_lower_bound(const void *ptr, size_t n, const void *val) { \
+		const _type *a = ptr, *lo = a, v = *(const _type *)val; \
+		if (!n) \
+			return 0; \
+		while (n > 1) { \
+			size_t half = n / 2, next = (n - half) / 2; \
+			SEARCH_PREFETCH(lo + next); \
+			SEARCH_PREFETCH(lo + half + next); \
+			lo += (lo[half - 1] < v) * half; \
+			n -= half; \
+		} \
+		return lo - a + (*lo < v); \
+	} \
+	static void _type##_merge(const void *ptr1, size_t n1, const void *ptr2, size_t n2, void *out) { \
+		const _type *a = ptr1, *b = ptr2; \
+		_type *o = out; \
+		size_t i = 0, j = 0; \
+		while (i < n1 && j < n2) \
+			*o++ = a[i] < b[j] ? a[i++] : b[j++]; \
+		memcpy(o, a + i, (n1 - i) * sizeof *a); \
+		memcpy(o + (n1 - i), b + j, (n2 - j) * sizeof *b); \
+	}
+
+DECLARE_CONT_KERNELS(int8_t)
+DECLARE_CONT_KERNELS(int16_t)
+DECLARE_CONT_KERNELS(int32_t)
+DECLARE_CONT_KERNELS(int64_t)
+DECLARE_CONT_KERNELS(uint8_t)
+DECLARE_CONT_KERNELS(uint16_t)
+DECLARE_CONT_KERNELS(uint32_t)
+DECLARE_CONT_KERNELS(uint64_t)
+DECLARE_CONT_KERNELS(float)
+DECLARE_CONT_KERNELS(double)
+
+/*
+ * LSD radix sort with 8 bit digits, the scratch buffer holds n elements.
+ * Keys are the bit patterns mapped to unsigned integers of the same order:
+ * the sign bit of integers is flipped, negative floats have all of their bits
+ * flipped and positive ones the sign bit. -0.0 compares equal to +0.0, so it
+ * takes the key of +0.0 to keep the sort stable. Histograms of all passes are taken
+ * in one read, and passes where every element has the same digit are skipped
+ */
+
+#define RADIX_KEY_UINT(_u, _sign) ((void)(_sign), (_u))
+#define RADIX_KEY_INT(_u, _sign) ((_u) ^ (_sign))
+#define RADIX_KEY_FLOAT(_u, _sign) ((_u) == (_sign) ? (_sign) : (_u) & (_sign) ? ~(_u) : (_u) | (_sign))
+
+#define DECLARE_RADIX_SORT(_type, _utype, _key) \
+	static _utype _type##_radix_key(const _type *p) { \
+		const _utype sign = (_utype)1 << (sizeof(_utype) * CHAR_BIT - 1); \
+		_utype u; \
+		memcpy(&u, p, sizeof u); \
+		return (_utype)_key(u, sign); \
+	} \
+	static void _type##_radix_sort(void *ptr, void *buf, size_t n) { \
+		size_t count[sizeof(_type)][256] = { { 0 } }; \
+		_type *a = ptr, *b = buf, *tmp; \
+		for (size_t i = 0; i < n; i++) { \
+			_utype k = _type##_radix_key(a + i); \
+			for (size_t d = 0; d < sizeof(_type); d++) \
+				count[d][(k >> d * CHAR_BIT) & 0xFF]++; \
+		} \
+		_utype first = _type##_radix_key(a); \
+		for (size_t d = 0; d < sizeof(_type); d++) { \
+			if (count[d][(first >> d * CHAR_BIT) & 0xFF] == n) \
+				continue; \
+			size_t sum = 0; \
+			for (int c = 0; c < 256; c++) { \
+				size_t t = count[d][c]; \
+				count[d][c] = sum; \
+				sum += t; \
+			} \
+			for (size_t i = 0; i < n; i++) \
+				b[count[d][(_type##_radix_key(a + i) >> d * CHAR_BIT) & 0xFF]++] = a[i]; \
+			tmp = a, a = b, b = tmp; \
+		} \
+		if (a != ptr) \
+			memcpy(ptr, a, n * sizeof *a); \
+	}
+
+DECLARE_RADIX_SORT(int8_t, uint8_t, RADIX_KEY_INT)
+DECLARE_RADIX_SORT(int16_t, uint16_t, RADIX_KEY_INT)
+DECLARE_RADIX_SORT(int32_t, uint32_t, RADIX_KEY_INT)
+DECLARE_RADIX_SORT(int64_t, uint64_t, RADIX_KEY_INT)
+DECLARE_RADIX_SORT(uint8_t, uint8_t, RADIX_KEY_UINT)
+DECLARE_RADIX_SORT(uint16_t, uint16_t, RADIX_KEY_UINT)
+DECLARE_RADIX_SORT(uint32_t, uint32_t, RADIX_KEY_UINT)
+DECLARE_RADIX_SORT(uint64_t, uint64_t, RADIX_KEY_UINT)
+DECLARE_RADIX_SORT(float, uint32_t, RADIX_KEY_FLOAT)
+DECLARE_RADIX_SORT(double, uint64_t, RADIX_KEY_FLOAT)
+
+struct cont_kernel
+{
+	int type;
+	void (*sort)(void *ptr, size_t n);
+	void (*select)(void *ptr, size_t n, size_t k);
+	size_t (*lower_bound)(const void *ptr, size_t n, const void *val);
+	void (*merge)(const void *ptr1, size_t n1, const void *ptr2, size_t n2, void *out);
+	void (*radix_sort)(void *ptr, void *buf, size_t n);
+};
+
+#define CONT_KERNEL(_st, _type) { _st, _type##_sort, _type##_select, _type##_lower_bound, _type##_merge, _type##_radix_sort }
+
+static const struct cont_kernel cont_kernels[] = {
+	CONT_KERNEL(AX_ST_I8, int8_t),
+	CONT_KERNEL(AX_ST_I16, int16_t),
+	CONT_KERNEL(AX_ST_I32, int32_t),
+	CONT_KERNEL(AX_ST_I64, int64_t),
+	CONT_KERNEL(AX_ST_U8, uint8_t),
+	CONT_KERNEL(AX_ST_U16, uint16_t),
+	CONT_KERNEL(AX_ST_U32, uint32_t),
+	CONT_KERNEL(AX_ST_U64, uint64_t),
+	CONT_KERNEL(AX_ST_F, float),
+	CONT_KERNEL(AX_ST_LF, double),
+};
+
+/* A trait orders like a builtin type if it shares the less function and size of it */
+static const struct cont_kernel *cont_kernel_of(const ax_stuff_trait *etr)
+{
+	if (etr->link)
+		return NULL;
+	for (size_t i = 0; i < sizeof cont_kernels / sizeof *cont_kernels; i++) {
+		const ax_stuff_trait *tr = ax_stuff_traits(cont_kernels[i].type);
+		if (etr->less == tr->less && etr->size == tr->size)
+			return cont_kernels + i;
+	}
+	return NULL;
+}
+
+/* What ent_arrange does with the range and its k */
+enum arrange_mode
+{
+	ARRANGE_SELECT,
+	ARRANGE_PARTIAL,
+	ARRANGE_STABLE,
+};
+
+/*
+ * Leave e[k] in sorted position with no greater entry before it, then sort
+ * e[0, k) for ARRANGE_PARTIAL. ARRANGE_STABLE ignores k and sorts all of e
+ */
+static ax_fail ent_arrange(const struct ent_order *ord, struct sort_ent *e, size_t n, size_t k,
+		enum arrange_mode mode, ax_base *base)
+{
+	if (mode == ARRANGE_STABLE) {
+		if (ent_stable_sort(ord, e, n, ax_base_pool(base))) {
+			ax_base_set_errno(base, AX_ERR_NOMEM);
+			return ax_true;
+		}
+		return ax_false;
+	}
+	if (k < n)
+		ent_select(ord, e, n, k);
+	if (mode == ARRANGE_PARTIAL)
+		ent_sort(ord, e, k);
+	return ax_false;
+}
+
+static ax_fail cont_arrange(const struct cont_range *r, const ax_pred *bpred, size_t k,
+		enum arrange_mode mode, ax_base *base)
+{
+	const ax_stuff_trait *etr = r->etr;
+	size_t n = cont_length(r);
+	if (n < 2)
+		return ax_false;
+
+	const struct cont_kernel *kern = bpred || mode == ARRANGE_STABLE ? NULL : cont_kernel_of(etr);
+	if (kern) {
+		if (k < n)
+			kern->select(r->begin, n, k);
+		if (mode == ARRANGE_PARTIAL)
+			kern->sort(r->begin, k);
+		return ax_false;
+	}
+
+	/* less takes the storage, which is directly addressable here even for link types */
+	struct sort_ent *e = malloc(n * sizeof *e);
+	if (!e) {
+		ax_base_set_errno(base, AX_ERR_NOMEM);
+		return ax_true;
+	}
+	for (size_t pos = 0; pos < n; pos++) {
+		e[pos].val = r->begin + pos * etr->size;
+		e[pos].pos = pos;
+	}
+
+	struct ent_order ord = { etr, bpred };
+	ax_fail fail = ent_arrange(&ord, e, n, k, mode, base)
+		|| cont_permute(etr, r->begin, e, n, base);
+	free(e);
+	return fail;
+}
+
+/* less compares storage, so link values are copied to link, which needs a slot per element */
+static void ent_gather(const ax_iter *first, const ax_iter *last, struct sort_ent *e, void **point, void **link)
+{
+	const ax_stuff_trait *etr = ax_box_elem_tr(first->owner);
+	size_t pos = 0;
+	for (ax_iter cur = *first; !ax_iter_equal(&cur, last); ax_iter_next(&cur), pos++) {
+		if (etr->link) {
+			link[pos] = ax_iter_get(&cur);
+			e[pos].val = link + pos;
+		} else
+			e[pos].val = ax_iter_get(&cur);
+		e[pos].pos = pos;
+		point[pos] = cur.point;
+	}
+}
+
+/* Common part of the comparison sorts and selections, nth is the k of ent_arrange */
+static ax_fail seq_arrange(const ax_iter *first, const ax_iter *nth, const ax_iter *last,
+		const ax_pred *bpred, enum arrange_mode mode)
+{
+	CHECK_ITER_COMPARABLE(first, last);
+	CHECK_ITER_COMPARABLE(first, nth);
+	ax_assert(ax_one_is(first->owner, AX_SEQ_NAME), "unsupported container type");
+	ax_assert(ax_iter_is(first, AX_IT_FORW), "unsupported iterator type");
+
+	const ax_stuff_trait *etr = ax_box_elem_tr(first->owner);
+	ax_base *base = ax_one_base(first->owner);
+
+	struct cont_range r;
+	if (cont_range_of(ax_iter_c(first), ax_iter_c(last), &r))
+		return cont_arrange(&r, bpred, ((ax_byte *)nth->point - r.begin) / etr->size, mode, base);
+
+	size_t n = 0, k = 0;
+	for (ax_iter cur = *first; !ax_iter_equal(&cur, last); ax_iter_next(&cur)) {
+		if (ax_iter_equal(&cur, nth))
+			k = n;
+		n++;
+	}
+	if (ax_iter_equal(nth, last))
+		k = n;
+	if (n < 2)
+		return ax_false;
+
+	struct sort_ent *e = malloc(n * (sizeof *e + sizeof(void *) * (etr->link ? 2 : 1)));
+	if (!e) {
+		ax_base_set_errno(base, AX_ERR_NOMEM);
+		return ax_true;
+	}
+	void **point = (void **)(e + n);
+	void **link = point + n;
+
+	ent_gather(first, last, e, point, link);
+	struct ent_order ord = { etr, bpred };
+	ax_fail fail = ent_arrange(&ord, e, n, k, mode, base)
+		|| sort_permute(first, e, point, n);
+	free(e);
+	return fail;
+}
+
+ax_fail ax_sort(const ax_iter *first, const ax_iter *last)
+{
+	return seq_arrange(first, last, last, NULL, ARRANGE_PARTIAL);
+}
+
+ax_fail ax_nth_element(const ax_iter *first, const ax_iter *nth, const ax_iter *last, const ax_pred *bpred)
+{
+	return seq_arrange(first, nth, last, bpred, ARRANGE_SELECT);
+}
+
+ax_fail ax_partial_sort(const ax_iter *first, const ax_iter *middle, const ax_iter *last, const ax_pred *bpred)
+{
+	return seq_arrange(first, middle, last, bpred, ARRANGE_PARTIAL);
+}
+
+/*
+ * A heap of the k least entries seen so far with the greatest at e[0]. Values
+ * of link types are read through ax_citer_get, so each entry keeps one slot of
+ * link holding the value, indexed by its pos and handed over on replacement
+ */
+ax_fail ax_top_k(const ax_citer *first, const ax_citer *last, ax_seq *out, size_t k, const ax_pred *bpred)
+{
+	CHECK_PARAM_NULL(out);
+	CHECK_ITER_COMPARABLE(first, last);
+	ax_assert(ax_one_is(first->owner, AX_BOX_NAME), "unsupported container type");
+
+	const ax_stuff_trait *etr = ax_box_elem_tr(first->owner);
+	ax_base *base = ax_one_base(first->owner);
+
+	if (ax_citer_is(first, AX_IT_RAND)) {
+		size_t n = ax_citer_dist(first, last);
+		if (k > n)
+			k = n;
+	}
+	if (k == 0)
+		return ax_false;
+
+	struct sort_ent *e = malloc(k * (sizeof *e + (etr->link ? sizeof(void *) : 0)));
+	if (!e) {
+		ax_base_set_errno(base, AX_ERR_NOMEM);
+		return ax_true;
+	}
+	void **link = (void **)(e + k);
+	struct ent_order ord = { etr, bpred };
+
+	struct cont_range r;
+	ax_bool cont = cont_range_of(first, last, &r);
+	ax_byte *p = cont ? r.begin : NULL;
+	ax_citer cur = *first;
+	size_t size = 0;
+	for (;;) {
+		const void *val;
+		const void *stor;
+		if (cont) {
+			if (p == r.end)
+				break;
+			stor = p;
+			p += etr->size;
+		} else {
+			if (ax_citer_equal(&cur, last))
+				break;
+			val = ax_citer_get(&cur);
+			stor = etr->link ? (void *)&val : val;
+			ax_citer_next(&cur);
+		}
+
+		struct sort_ent ent = { stor, size < k ? size : e[0].pos };
+		if (size == k && !ENT_LESS(&ord, ent, e[0]))
+			continue;
+		if (etr->link) {
+			link[ent.pos] = *(void **)ent.val;
+			ent.val = link + ent.pos;
+		}
+
+		if (size < k) {
+			e[size++] = ent;
+			if (size == k)
+				for (size_t i = k / 2; i > 0; i--)
+					ent_sift_down(&ord, e, i - 1, k);
+		} else {
+			e[0] = ent;
+			ent_sift_down(&ord, e, 0, k);
+		}
+	}
+
+	ent_sort(&ord, e, size);
+	ax_fail fail = ax_false;
+	for (size_t i = 0; i < size && !fail; i++)
+		fail = ax_seq_push(out, cont_value(etr, e[i].val));
+	free(e);
+	return fail;
+}
+
+ax_fail ax_quick_sort(const ax_iter *first, const ax_iter *last)
+{
+	return ax_sort(first, last);
+}
+
+#define PAR_SORT_MAX_BLOCKS 64
+#define PAR_SORT_MIN_BLOCK 0x4000
+
+/*
+ * ax_par_sort_exec sorts records, either the elements themselves when a typed
+ * kernel applies to a contiguous range, or sort_ent gathered from the
+ * range otherwise. Blocks are sorted by one task each on the workers of exec,
+ * then merged pairwise for log2(nblock) rounds. Every round splits the output
+ * evenly into nblock slices by searching the merge path of each pair at the
+ * slice borders
+ */
+struct par_sort_st
+{
+	struct ent_order ord;
+	const struct cont_kernel *kern;
+	ax_byte *src;
+	ax_byte *dst;
+	size_t rsize;
+	size_t n;
+	size_t nrun;
+	size_t bound[PAR_SORT_MAX_BLOCKS + 1];
+	size_t nblock;
+};
+
+inline static ax_bool rec_less(const struct par_sort_st *ps, const ax_byte *a, const ax_byte *b)
+{
+	return ps->kern
+		? ps->ord.etr->less(a, b, ps->ord.etr->size)
+		: ENT_LESS(&ps->ord, *(const struct sort_ent *)a, *(const struct sort_ent *)b);
+}
+
+static void rec_merge(const struct par_sort_st *ps, const ax_byte *a, size_t na, const ax_byte *b, size_t nb, ax_byte *out)
+{
+	if (ps->kern) {
+		ps->kern->merge(a, na, b, nb, out);
+		return;
+	}
+
+	const struct sort_ent *ea = (const struct sort_ent *)a, *eb = (const struct sort_ent *)b;
+	struct sort_ent *eo = (struct sort_ent *)out;
+	size_t i = 0, j = 0;
+	while (i < na && j < nb)
+		*eo++ = ENT_LESS(&ps->ord, ea[i], eb[j]) ? ea[i++] : eb[j++];
+	memcpy(eo, ea + i, (na - i) * sizeof *ea);
+	memcpy(eo + (na - i), eb + j, (nb - j) * sizeof *eb);
+}
+
+/* Count of records taken from a among the first d of merging a and b, ties go to b as in rec_merge */
+static size_t merge_path(const struct par_sort_st *ps, const ax_byte *a, size_t na, const ax_byte *b, size_t nb, size_t d)
+{
+	size_t lo = d > nb ? d - nb : 0, hi = d < na ? d : na;
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		if (rec_less(ps, a + mid * ps->rsize, b + (d - mid - 1) * ps->rsize))
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+static void par_block_sort(size_t begin, size_t end, void *arg)
+{
+	struct par_sort_st *ps = arg;
+	for (size_t id = begin; id < end; id++) {
+		size_t lo = ps->bound[id], hi = ps->bound[id + 1];
+		if (ps->kern)
+			ps->kern->sort(ps->src + lo * ps->rsize, hi - lo);
+		else
+			ent_sort(&ps->ord, (struct sort_ent *)ps->src + lo, hi - lo);
+	}
+}
+
+/* Merge the part of every pair of runs falling in output slice id */
+static void par_merge_slice(struct par_sort_st *ps, size_t id)
+{
+	const size_t rsize = ps->rsize;
+	size_t lo = ps->n * id / ps->nblock, hi = ps->n * (id + 1) / ps->nblock;
+
+	for (size_t r = 0; r < ps->nrun; r += 2) {
+		size_t start = ps->bound[r], mid = ps->bound[r + 1];
+		size_t end = r + 2 <= ps->nrun ? ps->bound[r + 2] : mid;
+		if (end <= lo || start >= hi)
+			continue;
+
+		size_t d0 = (lo > start ? lo : start) - start, d1 = (hi < end ? hi : end) - start;
+		if (r + 1 == ps->nrun) {
+			memcpy(ps->dst + (start + d0) * rsize, ps->src + (start + d0) * rsize, (d1 - d0) * rsize);
+			continue;
+		}
+
+		const ax_byte *a = ps->src + start * rsize, *b = ps->src + mid * rsize;
+		size_t na = mid - start, nb = end - mid;
+		size_t i0 = merge_path(ps, a, na, b, nb, d0), i1 = merge_path(ps, a, na, b, nb, d1);
+		rec_merge(ps, a + i0 * rsize, i1 - i0, b + (d0 - i0) * rsize, (d1 - i1) - (d0 - i0),
+				ps->dst + (start + d0) * rsize);
+	}
+}
+
+static void par_merge_round(size_t begin, size_t end, void *arg)
+{
+	for (size_t id = begin; id < end; id++)
+		par_merge_slice(arg, id);
+}
+
+static void par_sort_records(struct par_sort_st *ps, ax_exec *exec)
+{
+	ps->nrun = ps->nblock;
+	for (size_t i = 0; i <= ps->nblock; i++)
+		ps->bound[i] = ps->n * i / ps->nblock;
+
+	ax_exec_parallel_for(exec, 0, ps->nblock, 1, par_block_sort, ps);
+	while (ps->nrun > 1) {
+		ax_exec_parallel_for(exec, 0, ps->nblock, 1, par_merge_round, ps);
+		ax_byte *tmp = ps->src;
+		ps->src = ps->dst;
+		ps->dst = tmp;
+
+		size_t nrun = 0;
+		for (size_t r = 0; r < ps->nrun; r += 2)
+			ps->bound[nrun++] = ps->bound[r];
+		ps->bound[nrun] = ps->n;
+		ps->nrun = nrun;
+	}
+}
+
+static size_t par_sort_length(const ax_iter *first, const ax_iter *last, struct cont_range *r, ax_bool *cont)
+{
+	*cont = cont_range_of(ax_iter_c(first), ax_iter_c(last), r);
+	if (*cont)
+		return cont_length(r);
+
+	size_t n = 0;
+	for (ax_iter cur = *first; !ax_iter_equal(&cur, last); ax_iter_next(&cur))
+		n++;
+	return n;
+}
+
+ax_fail ax_par_sort_exec(const ax_iter *first, const ax_iter *last, ax_exec *exec)
+{
+	CHECK_PARAM_NULL(exec);
+	CHECK_ITER_COMPARABLE(first, last);
+	ax_assert(ax_one_is(first->owner, AX_SEQ_NAME), "unsupported container type");
+	ax_assert(ax_iter_is(first, AX_IT_FORW), "unsupported iterator type");
+
+	const ax_stuff_trait *etr = ax_box_elem_tr(first->owner);
+	ax_base *base = ax_one_base(first->owner);
+
+	struct cont_range r;
+	ax_bool cont;
+	size_t n = par_sort_length(first, last, &r, &cont);
+
+	/* A caller outside the pool runs tasks while it waits */
+	size_t nblock = ax_exec_workers(exec) + (ax_exec_self(exec) < 0 ? 1 : 0);
+	if (nblock > PAR_SORT_MAX_BLOCKS)
+		nblock = PAR_SORT_MAX_BLOCKS;
+	if (nblock > n / PAR_SORT_MIN_BLOCK)
+		nblock = n / PAR_SORT_MIN_BLOCK;
+	if (nblock < 2)
+		return ax_sort(first, last);
+
+	struct par_sort_st *ps = malloc(sizeof *ps);
+	if (!ps) {
+		ax_base_set_errno(base, AX_ERR_NOMEM);
+		return ax_true;
+	}
+	ps->ord.etr = etr;
+	ps->ord.bpred = NULL;
+	ps->kern = cont ? cont_kernel_of(etr) : NULL;
+	ps->n = n;
+	ps->nblock = nblock;
+
+	ax_fail fail = ax_false;
+	if (ps->kern) {
+		ps->rsize = etr->size;
+		ps->src = r.begin;
+		ps->dst = malloc(n * ps->rsize);
+		if (!ps->dst)
+			goto nomem;
+		ax_byte *aux = ps->dst;
+		par_sort_records(ps, exec);
+		if (ps->src != r.begin)
+			memcpy(r.begin, ps->src, n * ps->rsize);
+		free(aux);
+	} else {
+		ps->rsize = sizeof(struct sort_ent);
+		size_t extra = cont ? 0 : sizeof(void *) * (etr->link ? 2 : 1);
+		struct sort_ent *e = malloc(n * (2 * sizeof *e + extra));
+		if (!e)
+			goto nomem;
+		void **point = (void **)(e + 2 * n);
+		if (cont) {
+			for (size_t pos = 0; pos < n; pos++) {
+				e[pos].val = r.begin + pos * etr->size;
+				e[pos].pos = pos;
+			}
+		} else
+			ent_gather(first, last, e, point, point + n);
+
+		ps->src = (ax_byte *)e;
+		ps->dst = (ax_byte *)(e + n);
+		par_sort_records(ps, exec);
+		fail = cont
+			? cont_permute(etr, r.begin, (struct sort_ent *)ps->src, n, base)
+			: sort_permute(first, (struct sort_ent *)ps->src, point, n);
+		free(e);
+	}
+	free(ps);
+	return fail;
+nomem:
+	free(ps);
+	ax_base_set_errno(base, AX_ERR_NOMEM);
+	return ax_true;
+}
+
+ax_fail ax_par_sort(const ax_iter *first, const ax_iter *last, unsigned nthreads)
+{
+	CHECK_ITER_COMPARABLE(first, last);
+
+	struct cont_range r;
+	ax_bool cont;
+	if (nthreads == 1 || par_sort_length(first, last, &r, &cont) < 2 * PAR_SORT_MIN_BLOCK)
+		return ax_sort(first, last);
+
+	/* The caller takes a share of the blocks itself */
+	ax_exec *exec = ax_exec_create(nthreads ? nthreads - 1 : 0);
+	if (!exec)
+		return ax_sort(first, last);
+	ax_fail fail = ax_par_sort_exec(first, last, exec);
+	ax_exec_destroy(exec);
+	return fail;
+}
+
+#define RADIX_INSERTION 32
+
+struct msd_task
+{
+	size_t lo;
+	size_t n;
+	size_t depth;
+};
+
+#define ENT_STR(_e) (*(const char **)(_e).val)
+
+/*
+ * MSD radix sort of string records, buf holds n records. Buckets are
+ * split one byte deeper until they fit insertion sort, strings ending at
+ * the current depth are equal and stay in front. Pending buckets are kept
+ * on a heap stack, long common prefixes would overflow a recursion
+ */
+static ax_fail msd_sort(struct sort_ent *e, struct sort_ent *buf, size_t n)
+{
+	size_t stack_cap = 64, top = 0;
+	struct msd_task *stack = malloc(stack_cap * sizeof *stack);
+	if (!stack)
+		return ax_true;
+	stack[top++] = (struct msd_task) { .lo = 0, .n = n, .depth = 0 };
+
+	while (top) {
+		struct msd_task task = stack[--top];
+		struct sort_ent *a = e + task.lo;
+
+		if (task.n <= RADIX_INSERTION) {
+			for (size_t i = 1; i < task.n; i++) {
+				struct sort_ent cur = a[i];
+				size_t j = i;
+				for (; j > 0 && strcmp(ENT_STR(cur) + task.depth, ENT_STR(a[j - 1]) + task.depth) < 0; j--)
+					a[j] = a[j - 1];
+				a[j] = cur;
+			}
+			continue;
+		}
+
+		size_t count[256] = { 0 };
+		for (size_t i = 0; i < task.n; i++)
+			count[(unsigned char)ENT_STR(a[i])[task.depth]]++;
+
+		/* All in one bucket, go deeper without moving anything */
+		unsigned char c0 = ENT_STR(a[0])[task.depth];
+		if (count[c0] == task.n) {
+			if (c0) {
+				task.depth++;
+				stack[top++] = task;
+			}
+			continue;
+		}
+
+		size_t sum = 0;
+		for (int c = 0; c < 256; c++) {
+			size_t t = count[c];
+			count[c] = sum;
+			sum += t;
+		}
+		for (size_t i = 0; i < task.n; i++)
+			buf[count[(unsigned char)ENT_STR(a[i])[task.depth]]++] = a[i];
+		memcpy(a, buf, task.n * sizeof *a);
+
+		if (top + 255 > stack_cap) {
+			size_t cap = (top + 255) * 2;
+			struct msd_task *new_stack = realloc(stack, cap * sizeof *stack);
+			if (!new_stack) {
+				free(stack);
+				return ax_true;
+			}
+			stack = new_stack;
+			stack_cap = cap;
+		}
+
+		/* count[c] is now the end of bucket c, bucket 0 is done */
+		for (int c = 1; c < 256; c++) {
+			size_t lo = count[c - 1], hi = count[c];
+			if (hi - lo > 1)
+				stack[top++] = (struct msd_task) { .lo = task.lo + lo, .n = hi - lo, .depth = task.depth + 1 };
+		}
+	}
+
+	free(stack);
+	return ax_false;
+}
+
+ax_bool ax_radix_sortable(const ax_stuff_trait *etr)
+{
+	return cont_kernel_of(etr) || etr->less == ax_stuff_traits(AX_ST_S)->less;
+}
+
+ax_fail ax_radix_sort(const ax_iter *first, const ax_iter *last, void *scratch, size_t scratch_size)
+{
+	CHECK_ITER_COMPARABLE(first, last);
+	ax_assert(ax_one_is(first->owner, AX_SEQ_NAME), "unsupported container type");
+	ax_assert(ax_iter_is(first, AX_IT_FORW), "unsupported iterator type");
+
+	const ax_stuff_trait *etr = ax_box_elem_tr(first->owner);
+	ax_base *base = ax_one_base(first->owner);
+	ax_pool *pool = ax_base_pool(base);
+	ax_assert(ax_radix_sortable(etr), "elements are not radix sortable");
+
+	struct cont_range r = { NULL };
+	ax_bool cont = cont_range_of(ax_iter_c(first), ax_iter_c(last), &r);
+	size_t n = 0;
+	if (cont)
+		n = cont_length(&r);
+	else for (ax_iter cur = *first; !ax_iter_equal(&cur, last); ax_iter_next(&cur))
+		n++;
+	if (n < 2)
+		return ax_false;
+
+	const struct cont_kernel *kern = cont_kernel_of(etr);
+	size_t rsize = kern ? etr->size : sizeof(struct sort_ent);
+	void *buf = scratch && scratch_size >= n * rsize ? scratch : ax_pool_alloc(pool, n * rsize);
+	if (!buf) {
+		ax_base_set_errno(base, AX_ERR_NOMEM);
+		return ax_true;
+	}
+
+	ax_fail fail = ax_false;
+	if (kern) {
+		/* Elements of other ranges are copied out and back, they are trivially copyable */
+		ax_byte *arr = cont ? r.begin : malloc(n * rsize);
+		if (!arr) {
+			fail = ax_true;
+			goto out;
+		}
+		size_t pos = 0;
+		if (!cont)
+			for (ax_iter cur = *first; !ax_iter_equal(&cur, last); ax_iter_next(&cur), pos++)
+				memcpy(arr + pos * rsize, ax_iter_get(&cur), rsize);
+		kern->radix_sort(arr, buf, n);
+		if (!cont) {
+			pos = 0;
+			for (ax_iter cur = *first; !ax_iter_equal(&cur, last); ax_iter_next(&cur), pos++)
+				memcpy(ax_iter_get(&cur), arr + pos * rsize, rsize);
+			free(arr);
+		}
+	} else {
+		struct sort_ent *e = malloc(n * (sizeof *e + (cont ? 0 : 2 * sizeof(void *))));
+		if (!e) {
+			fail = ax_true;
+			goto out;
+		}
+		void **point = (void **)(e + n);
+		if (cont) {
+			for (size_t pos = 0; pos < n; pos++) {
+				e[pos].val = r.begin + pos * etr->size;
+				e[pos].pos = pos;
+			}
+		} else
+			ent_gather(first, last, e, point, point + n);
+
+		fail = msd_sort(e, buf, n);
+		if (!fail)
+			fail = cont
+				? cont_permute(etr, r.begin, e, n, base)
+				: sort_permute(first, e, point, n);
+		free(e);
+	}
+out:
+	if (fail)
+		ax_base_set_errno(base, AX_ERR_NOMEM);
+	if (buf != scratch)
+		ax_pool_free(buf);
+	return fail;
+}
+
+void ax_merge(const ax_citer *first1, const ax_citer *last1, const ax_citer *first2, const ax_citer *last2, ax_iter *dest)
+{
+	CHECK_ITER_COMPARABLE(first1, last1);
+	CHECK_ITER_COMPARABLE(first2, last2);
+
+	ax_box *box = (ax_box *)first1->owner;
+	const ax_stuff_trait *etr = ax_box_elem_tr(box);
+
+	struct cont_range r1, r2;
+	if (cont_range_of(first1, last1, &r1) && cont_range_of(first2, last2, &r2)) {
+		const struct cont_kernel *kern = cont_kernel_of(etr);
+		if (kern && ax_iter_is(dest, AX_IT_CONT) && cont_kernel_of(ax_box_elem_tr(dest->owner)) == kern
+				&& cont_kernel_of(r2.etr) == kern) {
+			size_t n1 = cont_length(&r1), n2 = cont_length(&r2);
+			kern->merge(r1.begin, n1, r2.begin, n2, dest->point);
+			dest->point = (ax_byte *)dest->point + (n1 + n2) * etr->size;
+			return;
+		}
+
+		ax_byte *p1 = r1.begin, *p2 = r2.begin;
+		while (p1 != r1.end && p2 != r2.end) {
+			if (etr->less(p1, p2, etr->size)) {
+				ax_iter_set(dest, cont_value(etr, p1));
+				p1 += etr->size;
+			} else {
+				ax_iter_set(dest, cont_value(etr, p2));
+				p2 += etr->size;
+			}
+			ax_iter_next(dest);
+		}
+		for (; p1 != r1.end; p1 += etr->size, ax_iter_next(dest))
+			ax_iter_set(dest, cont_value(etr, p1));
+		for (; p2 != r2.end; p2 += etr->size, ax_iter_next(dest))
+			ax_iter_set(dest, cont_value(etr, p2));
+		return;
+	}
+
+	ax_citer cur1 = *first1, cur2 = *first2;
+
+	ax_citer src;
+	ax_citer src_last;
+	while (!ax_citer_equal(&cur1, last1) && !ax_citer_equal(&cur2, last2)) {
+		if (etr->less(ax_citer_get(&cur1), ax_citer_get(&cur2), etr->size)) {
+			src = cur1;
+			ax_citer_next(&cur1);
+		} else {
+			src = cur2;
+			ax_citer_next(&cur2);
+		}
+		ax_iter_set(dest, ax_citer_get(&src));
+
+		ax_iter_next(dest);
+
+	}
+
+	if (!ax_citer_equal(&cur1, last1)) {
+		src = cur1;
+		src_last = *last1;
+	} else {
+		src = cur2;
+		src_last = *last2;
+	}
+	while (!ax_citer_equal(&src, &src_last)) {
+		ax_iter_set(dest, ax_citer_get(&src));
+		ax_citer_next(&src);
+		ax_iter_next(dest);
+	}
+}
+
+ax_fail ax_merge_sort(const ax_iter *first, const ax_iter *last)
+{
+	CHECK_ITER_COMPARABLE(first, last);
+	ax_assert(ax_one_is(first->owner, AX_SEQ_NAME), "unsupported one object type");
+	ax_assert(ax_iter_is(first, AX_IT_FORW), "unsupported iterator type");
+
+	/* Radix sort is stable too */
+	if (ax_radix_sortable(ax_box_elem_tr(first->owner)))
+		return ax_radix_sort(first, last, NULL, 0);
+
+	return seq_arrange(first, last, last, NULL, ARRANGE_STABLE);
+}
+
+ax_bool ax_equal_to_arr(const ax_iter *first, const ax_iter *last, void *arr, size_t size)
+{
+	CHECK_PARAM_VALIDITY(arr, !!arr == !!size);
+
+	const ax_box *box = first->owner;
+	const ax_stuff_trait *tr = ax_box_elem_tr(box);
+	ax_assert(size % tr->size == 0, "unexpected size");
+
+	size_t pos = 0;
+	ax_iter cur = *first;
+	while (!ax_iter_equal(&cur, last) && pos < size) {
+		if (!tr->equal(ax_iter_get(&cur), (ax_byte*)arr + pos, tr->size))
+			return ax_false;
+		ax_iter_next(&cur);
+		pos += tr->size;
+	}
+	return ax_iter_equal(&cur, last) == (pos == size);
+}
+
+/* Index of the first element of r not less than the storage at key */
+static size_t cont_lower_bound(const struct cont_range *r, const void *key)
+{
+	const ax_stuff_trait *etr = r->etr;
+	const struct cont_kernel *kern = cont_kernel_of(etr);
+	size_t n = cont_length(r);
+	if (kern)
+		return kern->lower_bound(r->begin, n, key);
+	if (!n)
+		return 0;
+
+	const size_t size = etr->size;
+	const ax_byte *lo = r->begin;
+	while (n > 1) {
+		size_t half = n / 2, next = (n - half) / 2;
+		SEARCH_PREFETCH(lo + next * size);
+		SEARCH_PREFETCH(lo + (half + next) * size);
+		lo += etr->less(lo + (half - 1) * size, key, size) * half * size;
+		n -= half;
+	}
+	return (lo - r->begin) / size + etr->less(lo, key, size);
+}
+
+void ax_lower_bound(ax_citer *first, const ax_citer *last, const void *p)
+{
+	CHECK_ITER_COMPARABLE(first, last);
+	ax_assert(ax_one_is(first->owner, AX_SEQ_NAME), "unsupported container type");
+	ax_assert(ax_citer_is(first, AX_IT_RAND), "unsupported citerator type");
+
+	const ax_stuff_trait *etr = ax_box_elem_tr(first->owner);
+	const void *key = etr->link ? (const void *)&p : p;
+
+	struct cont_range r;
+	if (cont_range_of(first, last, &r)) {
+		first->point = r.begin + cont_lower_bound(&r, key) * etr->size;
+		return;
+	}
+
+	long n = ax_citer_dist(first, last);
+	while (n > 0) {
+		long half = n / 2;
+		ax_citer mid = *first;
+		ax_citer_move(&mid, half);
+		const void *val = ax_citer_get(&mid);
+		if (etr->less(etr->link ? (const void *)&val : val, key, etr->size)) {
+			*first = mid;
+			ax_citer_next(first);
+			n -= half + 1;
+		} else
+			n = half;
+	}
+}
+
+void ax_binary_search(ax_citer *first, const ax_citer *last, const void* p)
+{
+	CHECK_ITER_COMPARABLE(first, last);
+	ax_assert(ax_one_is(first->owner, "one.any.box.seq"), "unsupported container type");
+	ax_assert(ax_citer_is(first, AX_IT_RAND), "unsupported citerator type");
+
+	void *orignal_last_citer_point = last->point;
+	const ax_stuff_trait *tr = ax_box_elem_tr(first->owner);
+
+	/* The less of link types takes storage, which the generic path below cannot give */
+	struct cont_range r;
+	if (!tr->link && cont_range_of(first, last, &r)) {
+		size_t lo = cont_lower_bound(&r, p);
+		ax_byte *found = r.begin + lo * tr->size;
+		first->point = found != r.end && tr->equal(found, p, tr->size) ? found : r.end;
+		return;
+	}
+
+	ax_citer left = *first, right = *last, middle;
 	while (!ax_citer_equal(&left, &right)) {
 		long length = ax_citer_dist(&left, &right);
 		long m = length / 2;
@@ -442,6 +2487,26 @@ void ax_binary_search_if_not(ax_citer *first, const ax_citer *last, const ax_pre
 	ax_assert(ax_one_is(first->owner, "one.any.box.seq"), "unsupported container type");
 	ax_assert(ax_citer_is(first, AX_IT_RAND), "unsupported citerator type");
 
+	struct cont_range r;
+	if (cont_range_of(first, last, &r)) {
+		const size_t size = r.etr->size;
+		size_t n = cont_length(&r);
+		ax_byte *lo = r.begin;
+		ax_bool ret;
+		while (n > 1) {
+			size_t half = n / 2, next = (n - half) / 2;
+			SEARCH_PREFETCH(lo + next * size);
+			SEARCH_PREFETCH(lo + (half + next) * size);
+			ax_pred_do(upred, &ret, cont_value(r.etr, lo + (half - 1) * size), NULL);
+			lo += !!ret * half * size;
+			n -= half;
+		}
+		if (n && (ax_pred_do(upred, &ret, cont_value(r.etr, lo), NULL), ret))
+			lo += size;
+		first->point = lo;
+		return;
+	}
+
 	ax_citer left = *first, right = *last, middle = { .owner = first->owner, .tr = first->tr };
 	while (!ax_citer_equal(&left, &right)) {
 		ax_bool ret;
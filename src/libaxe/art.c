@@ -0,0 +1,1301 @@
+/*
+ * Copyright (c) 2021 Li hsilin <lihsilyn@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#include "check.h"
+
+#include <axe/art.h>
+#include <axe/seq.h>
+#include <axe/iter.h>
+#include <axe/scope.h>
+#include <axe/pool.h>
+#include <axe/debug.h>
+#include <axe/base.h>
+#include <axe/error.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <stdio.h>
+#include <assert.h>
+
+#undef free
+
+#define NODE0   0
+#define NODE4   1
+#define NODE16  2
+#define NODE48  3
+#define NODE256 4
+#define NODEN   5
+
+#define ALIGN(_n) (((_n) + 7) & ~(size_t)7)
+#define LABEL_OFFSET ALIGN(sizeof(struct node_st))
+#define DEPTH_MASK ((uintptr_t)(AX_ART_LABEL_MAX - 1))
+#define KEY_BUFSIZE 256
+
+/*
+ * Iterators address element positions, a position inside a compressed
+ * label is kept as the node pointer tagged with its depth in the label.
+ */
+
+struct node_st
+{
+	struct node_st *parent;
+	uint32_t count;
+	uint32_t capacity;
+	uint8_t type;
+	uint8_t len;
+	uint8_t valued;
+};
+
+struct ax_art_st
+{
+	ax_trie _trie;
+	struct node_st *root;
+	size_t size;
+	size_t ksize;
+	size_t val_off;
+	size_t child_off;
+};
+
+static ax_fail  trie_put(ax_trie *trie, const ax_seq *key, const void *val);
+static void    *trie_get(const ax_trie *trie, const ax_seq *key);
+static ax_iter  trie_at(const ax_trie *trie, const ax_seq *key);
+static ax_bool  trie_exist(const ax_trie *trie, const ax_seq *key);
+static ax_bool  trie_erase(ax_trie *trie, const ax_seq *key);
+static ax_bool  trie_prune(ax_trie *trie, const ax_seq *key);
+static ax_fail  trie_rekey(ax_trie *trie, const ax_seq *key_from, const ax_seq *key_to);
+static ax_fail  trie_put_raw(ax_trie *trie, const void *key, size_t len, const void *val);
+static void    *trie_get_raw(const ax_trie *trie, const void *key, size_t len);
+static ax_iter  trie_at_raw(const ax_trie *trie, const void *key, size_t len);
+static ax_bool  trie_exist_raw(const ax_trie *trie, const void *key, size_t len);
+static ax_bool  trie_erase_raw(ax_trie *trie, const void *key, size_t len);
+static ax_iter  trie_longest(const ax_trie *trie, const void *key, size_t len, size_t *plen);
+
+static const void *trie_it_word(const ax_citer *it);
+static ax_iter  trie_it_begin(const ax_citer *it);
+static ax_iter  trie_it_end(const ax_citer *it);
+static ax_bool  trie_it_parent(const ax_citer *it, ax_iter *parent);
+static ax_bool  trie_it_valued(const ax_citer *it);
+
+static size_t   box_size(const ax_box *box);
+static size_t   box_maxsize(const ax_box *box);
+static ax_iter  box_begin(ax_box *box);
+static ax_iter  box_end(ax_box *box);
+static void     box_clear(ax_box *box);
+static const ax_stuff_trait *box_elem_tr(const ax_box* box);
+
+static void     any_dump(const ax_any *any, int ind);
+static ax_any  *any_copy(const ax_any *any);
+static ax_any  *any_move(ax_any *any);
+
+static void     one_free(ax_one *one);
+
+static void     citer_next(ax_citer *it);
+static ax_box  *citer_box(const ax_citer *it);
+
+static void    *iter_get(const ax_iter *it);
+static ax_fail  iter_set(const ax_iter *it, const void *val);
+static void     iter_erase(ax_iter *it);
+
+inline static ax_byte *node_label(const struct node_st *node)
+{
+	return (ax_byte *)node + LABEL_OFFSET;
+}
+
+inline static void *node_val(const ax_art *self, const struct node_st *node)
+{
+	return (ax_byte *)node + self->val_off;
+}
+
+inline static ax_byte *node_keys(const ax_art *self, const struct node_st *node)
+{
+	return (ax_byte *)node + self->child_off;
+}
+
+inline static ax_bool node_sorted(const struct node_st *node)
+{
+	return node->type != NODE48 && node->type != NODE256;
+}
+
+inline static struct node_st **node_ptrs(const ax_art *self, const struct node_st *node)
+{
+	ax_byte *area = (ax_byte *)node + self->child_off;
+	switch (node->type) {
+		case NODE48:  return (struct node_st **)(area + 256);
+		case NODE256: return (struct node_st **)area;
+		default:      return (struct node_st **)(area + ALIGN(node->capacity * self->ksize));
+	}
+}
+
+inline static void *make_point(const struct node_st *node, size_t depth)
+{
+	return (void *)((uintptr_t)node | (depth ? depth - 1 : 0));
+}
+
+inline static struct node_st *point_node(const void *point)
+{
+	return (struct node_st *)((uintptr_t)point & ~DEPTH_MASK);
+}
+
+inline static size_t point_depth(const void *point)
+{
+	struct node_st *node = point_node(point);
+	return node->parent ? ((uintptr_t)point & DEPTH_MASK) + 1 : 0;
+}
+
+inline static ax_bool point_at_end(const void *point)
+{
+	return point_depth(point) == point_node(point)->len;
+}
+
+inline static int sym_comp(const ax_art *self, const void *sym1, const void *sym2)
+{
+	if (self->ksize == 1)
+		return (int)*(uint8_t *)sym1 - (int)*(uint8_t *)sym2;
+	const ax_stuff_trait *ktr = self->_trie.env.key_tr;
+	if (ktr->less(sym1, sym2, self->ksize))
+		return -1;
+	return ktr->less(sym2, sym1, self->ksize);
+}
+
+static size_t node_size(const ax_art *self, int type, size_t capacity)
+{
+	switch (type) {
+		case NODE48:  return self->child_off + 256 + 48 * sizeof(struct node_st *);
+		case NODE256: return self->child_off + 256 * sizeof(struct node_st *);
+		default:      return self->child_off + ALIGN(capacity * self->ksize)
+			      + capacity * sizeof(struct node_st *);
+	}
+}
+
+static struct node_st *node_alloc(ax_art *self, int type, size_t capacity)
+{
+	ax_base *base = ax_one_base(ax_r(art, self).one);
+	struct node_st *node = ax_pool_alloc(ax_base_pool(base), node_size(self, type, capacity));
+	if (!node) {
+		ax_base_set_errno(base, AX_ERR_NOMEM);
+		return NULL;
+	}
+	assert(((uintptr_t)node & DEPTH_MASK) == 0);
+
+	node->parent = NULL;
+	node->count = 0;
+	node->capacity = capacity;
+	node->type = type;
+	node->len = 0;
+	node->valued = 0;
+	if (type == NODE48)
+		memset(node_keys(self, node), 0, 256);
+	else if (type == NODE256)
+		memset(node_ptrs(self, node), 0, 256 * sizeof(struct node_st *));
+	return node;
+}
+
+static size_t sorted_lower_bound(const ax_art *self, const struct node_st *node, const void *sym)
+{
+	const ax_byte *keys = node_keys(self, node);
+	size_t lo = 0, hi = node->count;
+	if (self->ksize == 1) {
+		while (lo < hi && keys[lo] < *(uint8_t *)sym)
+			lo++;
+		return lo;
+	}
+	while (lo < hi) {
+		size_t mid = (lo + hi) / 2;
+		if (sym_comp(self, keys + mid * self->ksize, sym) < 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+static struct node_st **find_child(const ax_art *self, const struct node_st *node, const void *sym)
+{
+	struct node_st **ptrs = node_ptrs(self, node);
+	switch (node->type) {
+		case NODE0:
+			return NULL;
+		case NODE48: {
+			uint8_t slot = node_keys(self, node)[*(uint8_t *)sym];
+			return slot ? ptrs + slot - 1 : NULL;
+		}
+		case NODE256:
+			return ptrs[*(uint8_t *)sym] ? ptrs + *(uint8_t *)sym : NULL;
+		default:
+			break;
+	}
+
+	const ax_byte *keys = node_keys(self, node);
+	if (self->ksize == 1) {
+		for (size_t i = 0; i < node->count; i++)
+			if (keys[i] == *(uint8_t *)sym)
+				return ptrs + i;
+		return NULL;
+	}
+	size_t i = sorted_lower_bound(self, node, sym);
+	return (i < node->count && memcmp(keys + i * self->ksize, sym, self->ksize) == 0)
+		? ptrs + i
+		: NULL;
+}
+
+static struct node_st *next_child(const ax_art *self, const struct node_st *node, const void *after)
+{
+	struct node_st **ptrs = node_ptrs(self, node);
+	if (node_sorted(node)) {
+		size_t i = 0;
+		if (after) {
+			i = sorted_lower_bound(self, node, after);
+			if (i < node->count && sym_comp(self, node_keys(self, node) + i * self->ksize, after) == 0)
+				i++;
+		}
+		return i < node->count ? ptrs[i] : NULL;
+	}
+
+	const ax_byte *index = node_keys(self, node);
+	for (size_t b = after ? *(uint8_t *)after + 1 : 0; b < 256; b++) {
+		if (node->type == NODE48) {
+			if (index[b])
+				return ptrs[index[b] - 1];
+		} else if (ptrs[b])
+			return ptrs[b];
+	}
+	return NULL;
+}
+
+static void node_append(ax_art *self, struct node_st *node, struct node_st *child)
+{
+	const ax_byte *sym = node_label(child);
+	struct node_st **ptrs = node_ptrs(self, node);
+	switch (node->type) {
+		case NODE48:
+			ptrs[node->count] = child;
+			node_keys(self, node)[*sym] = node->count + 1;
+			break;
+		case NODE256:
+			ptrs[*sym] = child;
+			break;
+		default:
+			memcpy(node_keys(self, node) + node->count * self->ksize, sym, self->ksize);
+			ptrs[node->count] = child;
+	}
+	node->count++;
+	child->parent = node;
+}
+
+static struct node_st **parent_slot(ax_art *self, struct node_st *node)
+{
+	return node->parent
+		? find_child(self, node->parent, node_label(node))
+		: &self->root;
+}
+
+static struct node_st *node_resize(ax_art *self, struct node_st *node, int type, size_t capacity)
+{
+	struct node_st *new_node = node_alloc(self, type, capacity);
+	if (!new_node)
+		return NULL;
+
+	new_node->parent = node->parent;
+	new_node->len = node->len;
+	new_node->valued = node->valued;
+	memcpy(node_label(new_node), node_label(node), node->len * self->ksize);
+	memcpy(node_val(self, new_node), node_val(self, node), self->_trie.env.val_tr->size);
+
+	struct node_st **ptrs = node_ptrs(self, node);
+	if (node_sorted(node)) {
+		for (size_t i = 0; i < node->count; i++)
+			node_append(self, new_node, ptrs[i]);
+	} else {
+		for (size_t b = 0; b < 256; b++) {
+			struct node_st *child = node->type == NODE48
+				? (node_keys(self, node)[b] ? ptrs[node_keys(self, node)[b] - 1] : NULL)
+				: ptrs[b];
+			if (child)
+				node_append(self, new_node, child);
+		}
+	}
+
+	*parent_slot(self, node) = new_node;
+	ax_pool_free(node);
+	return new_node;
+}
+
+static ax_fail node_add_child(ax_art *self, struct node_st **pnode, struct node_st *child)
+{
+	struct node_st *node = *pnode;
+	if (node->type != NODE256 && node->count == node->capacity) {
+		int type;
+		size_t capacity;
+		switch (node->type) {
+			case NODE0:  type = NODE4,  capacity = 4;  break;
+			case NODE4:  type = NODE16, capacity = 16; break;
+			case NODE16: type = self->ksize == 1 ? NODE48 : NODEN, capacity = self->ksize == 1 ? 48 : 32; break;
+			case NODE48: type = NODE256, capacity = 256; break;
+			default:     type = NODEN, capacity = node->capacity << 1;
+		}
+		if (!(node = node_resize(self, node, type, capacity)))
+			return ax_true;
+		*pnode = node;
+	}
+
+	if (!node_sorted(node)) {
+		node_append(self, node, child);
+		return ax_false;
+	}
+
+	const ax_byte *sym = node_label(child);
+	size_t i = sorted_lower_bound(self, node, sym);
+	ax_byte *keys = node_keys(self, node);
+	struct node_st **ptrs = node_ptrs(self, node);
+	memmove(keys + (i + 1) * self->ksize, keys + i * self->ksize, (node->count - i) * self->ksize);
+	memmove(ptrs + i + 1, ptrs + i, (node->count - i) * sizeof *ptrs);
+	memcpy(keys + i * self->ksize, sym, self->ksize);
+	ptrs[i] = child;
+	node->count++;
+	child->parent = node;
+	return ax_false;
+}
+
+static void node_remove_child(ax_art *self, struct node_st **pnode, const void *sym)
+{
+	struct node_st *node = *pnode;
+	struct node_st **ptrs = node_ptrs(self, node);
+	ax_byte *keys = node_keys(self, node);
+
+	switch (node->type) {
+		case NODE48: {
+			size_t slot = keys[*(uint8_t *)sym] - 1, last = node->count - 1;
+			if (slot != last) {
+				ptrs[slot] = ptrs[last];
+				keys[*node_label(ptrs[slot])] = slot + 1;
+			}
+			keys[*(uint8_t *)sym] = 0;
+			break;
+		}
+		case NODE256:
+			ptrs[*(uint8_t *)sym] = NULL;
+			break;
+		default: {
+			size_t i = find_child(self, node, sym) - ptrs;
+			memmove(keys + i * self->ksize, keys + (i + 1) * self->ksize, (node->count - i - 1) * self->ksize);
+			memmove(ptrs + i, ptrs + i + 1, (node->count - i - 1) * sizeof *ptrs);
+		}
+	}
+	node->count--;
+
+	int type = -1;
+	size_t capacity = 0;
+	switch (node->type) {
+		case NODE4:   if (node->count == 0)  type = NODE0,  capacity = 0;  break;
+		case NODE16:  if (node->count <= 3)  type = NODE4,  capacity = 4;  break;
+		case NODE48:  if (node->count <= 12) type = NODE16, capacity = 16; break;
+		case NODE256: if (node->count <= 36) type = NODE48, capacity = 48; break;
+		case NODEN:   if (node->count <= node->capacity >> 2)
+				      type = node->capacity > 32 ? NODEN : NODE16,
+				      capacity = node->capacity > 32 ? node->capacity >> 1 : 16;
+			      break;
+	}
+
+	/* Shrinking is optional, the larger node stays usable when out of memory */
+	if (type >= 0 && (node = node_resize(self, node, type, capacity)))
+		*pnode = node;
+}
+
+static void node_free(ax_art *self, struct node_st *node)
+{
+	if (node->valued) {
+		self->_trie.env.val_tr->free(node_val(self, node));
+		self->size--;
+	}
+	ax_pool_free(node);
+}
+
+static void node_free_rec(ax_art *self, struct node_st *node)
+{
+	struct node_st **ptrs = node_ptrs(self, node);
+	size_t slots = node->type == NODE256 ? 256 : node->count;
+	for (size_t i = 0; i < slots; i++)
+		if (ptrs[i])
+			node_free_rec(self, ptrs[i]);
+	node_free(self, node);
+}
+
+static void node_merge_child(ax_art *self, struct node_st *node)
+{
+	struct node_st *child = next_child(self, node, NULL);
+	if (node->len + child->len > AX_ART_LABEL_MAX)
+		return;
+
+	ax_byte *label = node_label(child);
+	memmove(label + node->len * self->ksize, label, child->len * self->ksize);
+	memcpy(label, node_label(node), node->len * self->ksize);
+	child->len += node->len;
+	*parent_slot(self, node) = child;
+	child->parent = node->parent;
+	ax_pool_free(node);
+}
+
+static void node_cleanup(ax_art *self, struct node_st *node)
+{
+	while (node->parent && !node->valued && node->count == 0) {
+		struct node_st *parent = node->parent;
+		node_remove_child(self, &parent, node_label(node));
+		ax_pool_free(node);
+		node = parent;
+	}
+
+	if (!node->parent) {
+		if (!node->valued && node->count == 0) {
+			ax_pool_free(node);
+			self->root = NULL;
+		}
+		return;
+	}
+
+	if (!node->valued && node->count == 1)
+		node_merge_child(self, node);
+}
+
+static size_t match_label(const ax_art *self, const struct node_st *node, const ax_byte *key, size_t len)
+{
+	const ax_byte *label = node_label(node);
+	size_t n = AX_MIN(len, node->len), i;
+	if (self->ksize == 1) {
+		for (i = 0; i < n && label[i] == key[i]; i++);
+		return i;
+	}
+	for (i = 0; i < n && memcmp(label + i * self->ksize, key + i * self->ksize, self->ksize) == 0; i++);
+	return i;
+}
+
+static void *locate(const ax_art *self, const ax_byte *key, size_t len)
+{
+	struct node_st *node = self->root;
+	if (!node)
+		return NULL;
+
+	size_t ksize = self->ksize;
+	while (len) {
+		struct node_st **slot = find_child(self, node, key);
+		if (!slot)
+			return NULL;
+		struct node_st *child = *slot;
+		size_t matched = match_label(self, child, key, len);
+		if (matched < child->len)
+			return matched == len ? make_point(child, matched) : NULL;
+		node = child;
+		key += matched * ksize;
+		len -= matched;
+	}
+	return make_point(node, node->len);
+}
+
+static struct node_st *make_chain(ax_art *self, const ax_byte *key, size_t len, struct node_st **tail)
+{
+	struct node_st *head = NULL, *last = NULL;
+	while (len) {
+		size_t n = AX_MIN(len, AX_ART_LABEL_MAX);
+		struct node_st *node = node_alloc(self, len > n ? NODE4 : NODE0, len > n ? 4 : 0);
+		if (!node)
+			goto fail;
+		node->len = n;
+		memcpy(node_label(node), key, n * self->ksize);
+		if (last)
+			node_append(self, last, node);
+		else
+			head = node;
+		last = node;
+		key += n * self->ksize;
+		len -= n;
+	}
+	*tail = last;
+	return head;
+fail:
+	while (head) {
+		struct node_st *next = head->count ? node_ptrs(self, head)[0] : NULL;
+		ax_pool_free(head);
+		head = next;
+	}
+	return NULL;
+}
+
+static struct node_st *make_path(ax_art *self, const ax_byte *key, size_t len)
+{
+	size_t ksize = self->ksize;
+
+	if (!self->root && !(self->root = node_alloc(self, NODE0, 0)))
+		return NULL;
+
+	struct node_st *node = self->root;
+	while (len) {
+		struct node_st **slot = find_child(self, node, key);
+		if (!slot) {
+			struct node_st *tail, *chain = make_chain(self, key, len, &tail);
+			if (!chain)
+				goto fail;
+			if (node_add_child(self, &node, chain)) {
+				node_free_rec(self, chain);
+				goto fail;
+			}
+			return tail;
+		}
+
+		struct node_st *child = *slot;
+		size_t matched = match_label(self, child, key, len);
+		if (matched < child->len) {
+			struct node_st *split = node_alloc(self, NODE4, 4);
+			if (!split)
+				goto fail;
+			split->len = matched;
+			memcpy(node_label(split), node_label(child), matched * ksize);
+			child->len -= matched;
+			memmove(node_label(child), node_label(child) + matched * ksize, child->len * ksize);
+			*slot = split;
+			split->parent = node;
+			node_append(self, split, child);
+			child = split;
+		}
+		node = child;
+		key += matched * ksize;
+		len -= matched;
+	}
+	return node;
+fail:
+	node_cleanup(self, node);
+	return NULL;
+}
+
+static ax_fail node_set_value(ax_art *self, struct node_st *node, const void *val)
+{
+	ax_base *base = ax_one_base(ax_r(art, self).one);
+	ax_pool *pool = ax_base_pool(base);
+	const ax_stuff_trait *val_tr = self->_trie.env.val_tr;
+	void *pdst = node_val(self, node);
+
+	if (node->valued)
+		val_tr->free(pdst);
+
+	const void *pval = val_tr->link ? &val : val;
+	ax_fail fail = val
+		? val_tr->copy(pool, pdst, pval, val_tr->size)
+		: val_tr->init(pool, pdst, val_tr->size);
+	if (fail) {
+		if (node->valued) {
+			node->valued = 0;
+			self->size--;
+		}
+		ax_base_set_errno(base, AX_ERR_NOMEM);
+		return ax_true;
+	}
+
+	if (!node->valued) {
+		node->valued = 1;
+		self->size++;
+	}
+	return ax_false;
+}
+
+static const ax_byte *key_data(const ax_art *self, const ax_seq *key, ax_byte *buf, ax_byte **heap, size_t *len)
+{
+	ax_assert(self->_trie.env.key_tr == key->env.elem_tr, "invalid element trait for the key");
+
+	*len = ax_box_size(ax_cr(seq, key).box);
+	*heap = NULL;
+	if (*len * self->ksize > KEY_BUFSIZE) {
+		ax_base *base = ax_one_base(ax_cr(art, self).one);
+		if (!(*heap = ax_pool_alloc(ax_base_pool(base), *len * self->ksize))) {
+			ax_base_set_errno(base, AX_ERR_NOMEM);
+			return NULL;
+		}
+		buf = *heap;
+	}
+
+	ax_byte *p = buf;
+	ax_box_cforeach(ax_cr(seq, key).box, const void *, elem) {
+		memcpy(p, elem, self->ksize);
+		p += self->ksize;
+	}
+	return buf;
+}
+
+static void *locate_seq(const ax_art *self, const ax_seq *key)
+{
+	ax_byte buf[KEY_BUFSIZE], *heap;
+	size_t len;
+	const ax_byte *data = key_data(self, key, buf, &heap, &len);
+	if (!data)
+		return NULL;
+	void *point = locate(self, data, len);
+	ax_pool_free(heap);
+	return point;
+}
+
+static void *point_val(const ax_art *self, const void *point)
+{
+	struct node_st *node = point_node(point);
+	if (!point_at_end(point) || !node->valued)
+		return NULL;
+	void *pval = node_val(self, node);
+	return self->_trie.env.val_tr->link ? *(void **)pval : pval;
+}
+
+static void erase_point(ax_art *self, void *point)
+{
+	struct node_st *node = point_node(point);
+	if (!point_at_end(point) || !node->valued)
+		return;
+
+	self->_trie.env.val_tr->free(node_val(self, node));
+	node->valued = 0;
+	self->size--;
+	node_cleanup(self, node);
+}
+
+static ax_fail put_data(ax_art *self, const ax_byte *key, size_t len, const void *val)
+{
+	struct node_st *node = make_path(self, key, len);
+	if (!node)
+		return ax_true;
+	if (node_set_value(self, node, val)) {
+		node_cleanup(self, node);
+		return ax_true;
+	}
+	return ax_false;
+}
+
+static ax_iter point_iter(const ax_art *self, void *point)
+{
+	return (ax_iter) {
+		.owner = (void *)self,
+		.tr = &ax_art_tr.box.iter,
+		.point = point
+	};
+}
+
+inline static ax_bool point_valued(const void *point)
+{
+	return point && point_at_end(point) && point_node(point)->valued;
+}
+
+static ax_bool erase_located(ax_art *self, void *point)
+{
+	if (!point)
+		return ax_false;
+	erase_point(self, point);
+	return ax_true;
+}
+
+static ax_fail trie_put(ax_trie *trie, const ax_seq *key, const void *val)
+{
+	CHECK_PARAM_NULL(trie);
+	CHECK_PARAM_NULL(key);
+
+	ax_art_r self_r = { .trie = trie };
+	ax_byte buf[KEY_BUFSIZE], *heap;
+	size_t len;
+	const ax_byte *data = key_data(self_r.art, key, buf, &heap, &len);
+	if (!data)
+		return ax_true;
+
+	ax_fail fail = put_data(self_r.art, data, len, val);
+	ax_pool_free(heap);
+	return fail;
+}
+
+static void *trie_get(const ax_trie *trie, const ax_seq *key)
+{
+	CHECK_PARAM_NULL(trie);
+	CHECK_PARAM_NULL(key);
+
+	ax_art_cr self_r = { .trie = trie };
+	void *point = locate_seq(self_r.art, key);
+	return point ? point_val(self_r.art, point) : NULL;
+}
+
+static ax_iter trie_at(const ax_trie *trie, const ax_seq *key)
+{
+	CHECK_PARAM_NULL(trie);
+	CHECK_PARAM_NULL(key);
+
+	ax_art_cr self_r = { .trie = trie };
+	return point_iter(self_r.art, locate_seq(self_r.art, key));
+}
+
+static ax_bool trie_exist(const ax_trie *trie, const ax_seq *key)
+{
+	CHECK_PARAM_NULL(trie);
+	CHECK_PARAM_NULL(key);
+
+	ax_art_cr self_r = { .trie = trie };
+	return point_valued(locate_seq(self_r.art, key));
+}
+
+static ax_bool trie_erase(ax_trie *trie, const ax_seq *key)
+{
+	CHECK_PARAM_NULL(trie);
+	CHECK_PARAM_NULL(key);
+
+	ax_art_r self_r = { .trie = trie };
+	return erase_located(self_r.art, locate_seq(self_r.art, key));
+}
+
+static ax_fail trie_put_raw(ax_trie *trie, const void *key, size_t len, const void *val)
+{
+	CHECK_PARAM_NULL(trie);
+	CHECK_PARAM_VALIDITY(key, key || len == 0);
+
+	ax_art_r self_r = { .trie = trie };
+	return put_data(self_r.art, key, len, val);
+}
+
+static void *trie_get_raw(const ax_trie *trie, const void *key, size_t len)
+{
+	CHECK_PARAM_NULL(trie);
+	CHECK_PARAM_VALIDITY(key, key || len == 0);
+
+	ax_art_cr self_r = { .trie = trie };
+	void *point = locate(self_r.art, key, len);
+	return point ? point_val(self_r.art, point) : NULL;
+}
+
+static ax_iter trie_at_raw(const ax_trie *trie, const void *key, size_t len)
+{
+	CHECK_PARAM_NULL(trie);
+	CHECK_PARAM_VALIDITY(key, key || len == 0);
+
+	ax_art_cr self_r = { .trie = trie };
+	return point_iter(self_r.art, locate(self_r.art, key, len));
+}
+
+static ax_bool trie_exist_raw(const ax_trie *trie, const void *key, size_t len)
+{
+	CHECK_PARAM_NULL(trie);
+	CHECK_PARAM_VALIDITY(key, key || len == 0);
+
+	ax_art_cr self_r = { .trie = trie };
+	return point_valued(locate(self_r.art, key, len));
+}
+
+static ax_bool trie_erase_raw(ax_trie *trie, const void *key, size_t len)
+{
+	CHECK_PARAM_NULL(trie);
+	CHECK_PARAM_VALIDITY(key, key || len == 0);
+
+	ax_art_r self_r = { .trie = trie };
+	return erase_located(self_r.art, locate(self_r.art, key, len));
+}
+
+static ax_bool trie_prune(ax_trie *trie, const ax_seq *key)
+{
+	CHECK_PARAM_NULL(trie);
+	CHECK_PARAM_NULL(key);
+
+	ax_art_r self_r = { .trie = trie };
+	void *point = locate_seq(self_r.art, key);
+	if (!point)
+		return ax_false;
+
+	struct node_st *node = point_node(point), *parent = node->parent;
+	if (!parent) {
+		box_clear(self_r.box);
+		return ax_true;
+	}
+	node_remove_child(self_r.art, &parent, node_label(node));
+	node_free_rec(self_r.art, node);
+	node_cleanup(self_r.art, parent);
+	return ax_true;
+}
+
+static ax_iter trie_longest(const ax_trie *trie, const void *key, size_t len, size_t *plen)
+{
+	CHECK_PARAM_NULL(trie);
+	CHECK_PARAM_VALIDITY(key, key || len == 0);
+
+	ax_art_cr self_r = { .trie = trie };
+	const ax_art *self = self_r.art;
+	const ax_byte *word = key;
+	struct node_st *node = self->root, *found = NULL;
+	size_t depth = 0, found_len = 0;
+
+	while (node) {
+		if (node->valued) {
+			found = node;
+			found_len = depth;
+		}
+		if (depth == len)
+			break;
+		struct node_st **slot = find_child(self, node, word);
+		if (!slot)
+			break;
+		node = *slot;
+		size_t matched = match_label(self, node, word, len - depth);
+		if (matched < node->len)
+			break;
+		word += matched * self->ksize;
+		depth += matched;
+	}
+
+	if (plen)
+		*plen = found_len;
+	return point_iter(self, found ? make_point(found, found->len) : NULL);
+}
+
+static ax_fail trie_rekey(ax_trie *trie, const ax_seq *key_from, const ax_seq *key_to)
+{
+	CHECK_PARAM_NULL(trie);
+	CHECK_PARAM_NULL(key_from);
+	CHECK_PARAM_NULL(key_to);
+
+	ax_art_r self_r = { .trie = trie };
+	ax_art *self = self_r.art;
+	ax_base *base = ax_one_base(self_r.one);
+	size_t vsize = trie->env.val_tr->size;
+
+	void *point = locate_seq(self, key_from);
+	if (!point || !point_at_end(point) || !point_node(point)->valued) {
+		ax_base_set_errno(base, AX_ERR_NOKEY);
+		return ax_true;
+	}
+
+	ax_byte buf[KEY_BUFSIZE], *heap;
+	size_t len;
+	const ax_byte *data = key_data(self, key_to, buf, &heap, &len);
+	if (!data)
+		return ax_true;
+
+	ax_fail fail = ax_true;
+	void *value = ax_pool_alloc(ax_base_pool(base), vsize);
+	if (!value) {
+		ax_base_set_errno(base, AX_ERR_NOMEM);
+		goto out;
+	}
+
+	struct node_st *from = point_node(point);
+	memcpy(value, node_val(self, from), vsize);
+	from->valued = 0;
+	self->size--;
+	node_cleanup(self, from);
+
+	struct node_st *to = make_path(self, data, len);
+	if (!to) {
+		trie->env.val_tr->free(value);
+		goto out;
+	}
+	if (to->valued)
+		trie->env.val_tr->free(node_val(self, to));
+	else {
+		to->valued = 1;
+		self->size++;
+	}
+	memcpy(node_val(self, to), value, vsize);
+	fail = ax_false;
+out:
+	ax_pool_free(value);
+	ax_pool_free(heap);
+	return fail;
+}
+
+static const void *trie_it_word(const ax_citer *it)
+{
+	CHECK_PARAM_NULL(it);
+	CHECK_ITERATOR_VALIDITY(it, it->owner && it->point);
+
+	const ax_art *self = it->owner;
+	size_t depth = point_depth(it->point);
+	return depth ? node_label(point_node(it->point)) + (depth - 1) * self->ksize : NULL;
+}
+
+static ax_iter trie_it_begin(const ax_citer *it)
+{
+	CHECK_PARAM_NULL(it);
+	CHECK_ITERATOR_VALIDITY(it, it->owner && it->point);
+
+	const ax_art *self = it->owner;
+	struct node_st *node = point_node(it->point), *child;
+	size_t depth = point_depth(it->point);
+	void *point = depth < node->len
+		? make_point(node, depth + 1)
+		: ((child = next_child(self, node, NULL)) ? make_point(child, 1) : NULL);
+
+	return (ax_iter) {
+		.owner = (void *)it->owner,
+		.tr = &ax_art_tr.box.iter,
+		.point = point
+	};
+}
+
+static ax_iter trie_it_end(const ax_citer *it)
+{
+	CHECK_PARAM_NULL(it);
+	CHECK_ITERATOR_VALIDITY(it, it->owner && it->point);
+
+	return (ax_iter) {
+		.owner = (void *)it->owner,
+		.tr = &ax_art_tr.box.iter,
+		.point = NULL
+	};
+}
+
+static ax_bool trie_it_parent(const ax_citer *it, ax_iter *parent)
+{
+	CHECK_PARAM_NULL(it);
+	CHECK_PARAM_NULL(parent);
+	CHECK_ITERATOR_VALIDITY(it, it->owner && it->point);
+
+	struct node_st *node = point_node(it->point);
+	size_t depth = point_depth(it->point);
+	if (depth == 0)
+		return ax_false;
+
+	parent->owner = (void *)it->owner;
+	parent->tr = &ax_art_tr.box.iter;
+	parent->point = depth > 1
+		? make_point(node, depth - 1)
+		: make_point(node->parent, node->parent->len);
+	return ax_true;
+}
+
+static ax_bool trie_it_valued(const ax_citer *it)
+{
+	CHECK_PARAM_NULL(it);
+	CHECK_ITERATOR_VALIDITY(it, it->owner && it->point);
+
+	return point_at_end(it->point) && point_node(it->point)->valued;
+}
+
+static void citer_next(ax_citer *it)
+{
+	CHECK_PARAM_NULL(it);
+	CHECK_ITERATOR_VALIDITY(it, it->owner && it->point);
+
+	const ax_art *self = it->owner;
+	struct node_st *node = point_node(it->point), *next;
+	if (point_depth(it->point) != 1) {
+		it->point = NULL;
+		return;
+	}
+	next = next_child(self, node->parent, node_label(node));
+	it->point = next ? make_point(next, 1) : NULL;
+}
+
+static ax_box *citer_box(const ax_citer *it)
+{
+	return (ax_box *)it->owner;
+}
+
+static void *iter_get(const ax_iter *it)
+{
+	CHECK_ITERATOR_VALIDITY(it, it->owner && it->tr && it->point);
+
+	return point_val(it->owner, it->point);
+}
+
+static ax_fail iter_set(const ax_iter *it, const void *val)
+{
+	CHECK_ITERATOR_VALIDITY(it, it->owner && it->tr && it->point);
+	CHECK_ITERATOR_VALIDITY(it, point_at_end(it->point));
+
+	return node_set_value(it->owner, point_node(it->point), val);
+}
+
+static void iter_erase(ax_iter *it)
+{
+	CHECK_ITERATOR_VALIDITY(it, it->owner && it->tr && it->point);
+
+	erase_point(it->owner, it->point);
+	it->point = NULL;
+}
+
+static void one_free(ax_one *one)
+{
+	if (!one)
+		return;
+
+	ax_art_r self_r = { .one = one };
+	ax_scope_detach(one);
+	box_clear(self_r.box);
+	ax_pool_free(one);
+}
+
+static void any_dump(const ax_any *any, int ind)
+{
+	printf("not implemented\n");
+}
+
+static struct node_st *node_copy_rec(ax_art *self, const struct node_st *node)
+{
+	ax_pool *pool = ax_base_pool(ax_one_base(ax_r(art, self).one));
+	const ax_stuff_trait *val_tr = self->_trie.env.val_tr;
+
+	size_t size = node_size(self, node->type, node->capacity);
+	struct node_st *copy = ax_pool_alloc(pool, size);
+	if (!copy)
+		return NULL;
+	memcpy(copy, node, size);
+	copy->count = 0;
+	copy->valued = 0;
+	if (copy->type == NODE256)
+		memset(node_ptrs(self, copy), 0, 256 * sizeof(struct node_st *));
+	else if (copy->type == NODE48)
+		memset(node_keys(self, copy), 0, 256);
+
+	if (node->valued) {
+		if (val_tr->copy(pool, node_val(self, copy), node_val(self, node), val_tr->size))
+			goto fail;
+		copy->valued = 1;
+		self->size++;
+	}
+
+	struct node_st **src = node_ptrs(self, node);
+	size_t slots = node->type == NODE256 ? 256 : node->count;
+	for (size_t i = 0; i < slots; i++) {
+		if (!src[i])
+			continue;
+		struct node_st *child = node_copy_rec(self, src[i]);
+		if (!child)
+			goto fail;
+		node_append(self, copy, child);
+	}
+	return copy;
+fail:
+	node_free_rec(self, copy);
+	return NULL;
+}
+
+static ax_any *any_copy(const ax_any *any)
+{
+	CHECK_PARAM_NULL(any);
+
+	ax_art_cr src_r = { .any = any };
+	ax_base *base = ax_one_base(src_r.one);
+	ax_art_r dst_r = { .trie = __ax_art_construct(base, src_r.trie->env.key_tr, src_r.trie->env.val_tr) };
+	if (!dst_r.one)
+		return NULL;
+
+	if (src_r.art->root) {
+		if (!(dst_r.art->root = node_copy_rec(dst_r.art, src_r.art->root))) {
+			ax_base_set_errno(base, AX_ERR_NOMEM);
+			ax_one_free(dst_r.one);
+			return NULL;
+		}
+	}
+
+	ax_scope_attach(ax_base_local(base), dst_r.one);
+	return dst_r.any;
+}
+
+static ax_any *any_move(ax_any *any)
+{
+	CHECK_PARAM_NULL(any);
+
+	ax_art_r src_r = { .any = any };
+	ax_base *base = ax_one_base(src_r.one);
+	ax_art *dst = ax_pool_alloc(ax_base_pool(base), sizeof(ax_art));
+	if (!dst) {
+		ax_base_set_errno(base, AX_ERR_NOMEM);
+		return NULL;
+	}
+
+	memcpy(dst, src_r.art, sizeof(ax_art));
+	src_r.art->root = NULL;
+	src_r.art->size = 0;
+
+	dst->_trie.env.one.scope.macro = NULL;
+	dst->_trie.env.one.scope.micro = 0;
+	ax_scope_attach(ax_base_local(base), ax_r(art, dst).one);
+	return ax_r(art, dst).any;
+}
+
+static size_t box_size(const ax_box *box)
+{
+	CHECK_PARAM_NULL(box);
+
+	ax_art_cr self_r = { .box = box };
+	return self_r.art->size;
+}
+
+static size_t box_maxsize(const ax_box *box)
+{
+	CHECK_PARAM_NULL(box);
+
+	return SIZE_MAX;
+}
+
+static ax_iter box_begin(ax_box *box)
+{
+	CHECK_PARAM_NULL(box);
+
+	ax_art_r self_r = { .box = box };
+	return (ax_iter) {
+		.owner = box,
+		.tr = &ax_art_tr.box.iter,
+		.point = self_r.art->root ? make_point(self_r.art->root, 0) : NULL
+	};
+}
+
+static ax_iter box_end(ax_box *box)
+{
+	CHECK_PARAM_NULL(box);
+
+	return (ax_iter) {
+		.owner = box,
+		.tr = &ax_art_tr.box.iter,
+		.point = NULL
+	};
+}
+
+static void box_clear(ax_box *box)
+{
+	CHECK_PARAM_NULL(box);
+
+	ax_art_r self_r = { .box = box };
+	if (self_r.art->root)
+		node_free_rec(self_r.art, self_r.art->root);
+	self_r.art->root = NULL;
+	self_r.art->size = 0;
+}
+
+static const ax_stuff_trait *box_elem_tr(const ax_box* box)
+{
+	CHECK_PARAM_NULL(box);
+
+	ax_art_cr self_r = { .box = box };
+	return self_r.trie->env.val_tr;
+}
+
+const ax_trie_trait ax_art_tr =
+{
+	.box = {
+		.any = {
+			.one = {
+				.name = AX_ART_NAME,
+				.free = one_free,
+			},
+			.dump = any_dump,
+			.copy = any_copy,
+			.move = any_move
+		},
+		.iter = {
+			.ctr = {
+				.norm = ax_true,
+				.type = AX_IT_FORW,
+				.move = NULL,
+				.next = citer_next,
+				.prev = NULL,
+				.less = NULL,
+				.dist = NULL,
+				.box = citer_box
+			},
+			.get = iter_get,
+			.set = iter_set,
+			.erase = iter_erase
+		},
+		.riter = { { NULL } },
+
+		.size = box_size,
+		.maxsize = box_maxsize,
+
+		.begin = box_begin,
+		.end = box_end,
+		.rbegin = NULL,
+		.rend = NULL,
+
+		.clear = box_clear,
+		.elem_tr = box_elem_tr
+	},
+
+	.put = trie_put,
+	.get = trie_get,
+	.at = trie_at,
+	.exist = trie_exist,
+	.prune = trie_prune,
+	.rekey = trie_rekey,
+	.erase = trie_erase,
+	.put_raw = trie_put_raw,
+	.get_raw = trie_get_raw,
+	.at_raw = trie_at_raw,
+	.exist_raw = trie_exist_raw,
+	.erase_raw = trie_erase_raw,
+	.longest = trie_longest,
+	.it_word = trie_it_word,
+	.it_begin = trie_it_begin,
+	.it_end = trie_it_end,
+	.it_parent = trie_it_parent,
+	.it_valued = trie_it_valued
+};
+
+ax_trie *__ax_art_construct(ax_base *base, const ax_stuff_trait *key_tr, const ax_stuff_trait *val_tr)
+{
+	CHECK_PARAM_NULL(base);
+
+	CHECK_PARAM_NULL(key_tr);
+	CHECK_PARAM_NULL(key_tr->less);
+	CHECK_PARAM_VALIDITY(key_tr, !key_tr->link);
+
+	CHECK_PARAM_NULL(val_tr);
+	CHECK_PARAM_NULL(val_tr->copy);
+	CHECK_PARAM_NULL(val_tr->free);
+	CHECK_PARAM_NULL(val_tr->init);
+
+	ax_art *self = ax_pool_alloc(ax_base_pool(base), sizeof(ax_art));
+	if (!self) {
+		ax_base_set_errno(base, AX_ERR_NOMEM);
+		return NULL;
+	}
+
+	size_t val_off = ALIGN(LABEL_OFFSET + AX_ART_LABEL_MAX * key_tr->size);
+	ax_art art_init = {
+		._trie = {
+			.tr = &ax_art_tr,
+			.env = {
+				.one = {
+					.base = base,
+					.scope = { NULL },
+				},
+				.key_tr = key_tr,
+				.val_tr = val_tr
+			},
+		},
+		.root = NULL,
+		.size = 0,
+		.ksize = key_tr->size,
+		.val_off = val_off,
+		.child_off = ALIGN(val_off + val_tr->size)
+	};
+	memcpy(self, &art_init, sizeof art_init);
+	return ax_r(art, self).trie;
+}
+
+ax_art_r ax_art_create(ax_scope *scope, const ax_stuff_trait *key_tr, const ax_stuff_trait *val_tr)
+{
+	CHECK_PARAM_NULL(scope);
+	CHECK_PARAM_NULL(key_tr);
+	CHECK_PARAM_NULL(val_tr);
+
+	ax_base *base = ax_one_base(ax_r(scope, scope).one);
+	ax_art_r self_r = { .trie = __ax_art_construct(base, key_tr, val_tr) };
+	if (!self_r.one)
+		return self_r;
+	ax_scope_attach(scope, self_r.one);
+	return self_r;
+}
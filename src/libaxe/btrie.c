@@ -48,6 +48,17 @@ struct node_st
 	ax_byte *val;
 };
 
+struct key_cursor_st
+{
+	const ax_seq *seq;
+	ax_citer it;
+	const ax_byte *raw;
+	size_t size;
+	ax_bool link;
+	size_t pos;
+	size_t len;
+};
+
 struct ax_btrie_st
 {
 	ax_trie _trie;
@@ -63,6 +74,12 @@ static ax_bool  trie_exist(const ax_trie *trie, const ax_seq *key);
 static ax_bool  trie_erase(ax_trie *trie, const ax_seq *key);
 static ax_bool  trie_prune(ax_trie *trie, const ax_seq *key);
 static ax_fail  trie_rekey(ax_trie *trie, const ax_seq *key_from, const ax_seq *key_to);
+static ax_fail  trie_put_raw(ax_trie *trie, const void *key, size_t len, const void *val);
+static void    *trie_get_raw(const ax_trie *trie, const void *key, size_t len);
+static ax_iter  trie_at_raw(const ax_trie *trie, const void *key, size_t len);
+static ax_bool  trie_exist_raw(const ax_trie *trie, const void *key, size_t len);
+static ax_bool  trie_erase_raw(ax_trie *trie, const void *key, size_t len);
+static ax_iter  trie_longest(const ax_trie *trie, const void *key, size_t len, size_t *plen);
 
 static const void *trie_it_word(const ax_citer *it);
 static ax_iter  trie_it_begin(const ax_citer *it);
@@ -92,7 +109,7 @@ static void    *iter_get(const ax_iter *it);
 static ax_fail  iter_set(const ax_iter *it, const void *val);
 static void     iter_erase(ax_iter *it);
 
-static int match_key(const ax_btrie *self, const ax_seq *key, ax_citer *it_mismatched, struct node_st **last_node);
+static int match_key(const ax_btrie *self, struct key_cursor_st *cur, struct node_st **last_node);
 static ax_fail node_set_value(ax_btrie *self, struct node_st *node, const void *val);
 static ax_bool clean_path(ax_map *last);
 static void rec_remove(ax_btrie *self, ax_map *map);
@@ -386,36 +403,65 @@ void ax_btrie_dump(ax_btrie *btrie)
 	node_dump(btrie->root_r.map, 1);
 }
 
-static int match_key(const ax_btrie *self, const ax_seq *key, ax_citer *it_mismatched, struct node_st **last_node)
+static void cursor_init_seq(struct key_cursor_st *cur, const ax_seq *key)
+{
+	cur->seq = key;
+	cur->it = ax_box_cbegin(ax_cr(seq, key).box);
+	cur->raw = NULL;
+	cur->pos = 0;
+	cur->len = ax_box_size(ax_cr(seq, key).box);
+}
+
+static void cursor_init_raw(struct key_cursor_st *cur, const ax_stuff_trait *key_tr, const void *key, size_t len)
+{
+	cur->seq = NULL;
+	cur->raw = key;
+	cur->size = key_tr->size;
+	cur->link = key_tr->link;
+	cur->pos = 0;
+	cur->len = len;
+}
+
+inline static const void *cursor_word(const struct key_cursor_st *cur)
+{
+	if (cur->seq)
+		return ax_citer_get(&cur->it);
+	const ax_byte *p = cur->raw + cur->pos * cur->size;
+	return cur->link ? *(const void **)p : p;
+}
+
+inline static void cursor_next(struct key_cursor_st *cur)
+{
+	if (cur->seq)
+		ax_citer_next(&cur->it);
+	cur->pos ++;
+}
+
+static int match_key(const ax_btrie *self, struct key_cursor_st *cur, struct node_st **last_node)
 {
 	size_t match_len = 0;
 	ax_map *cur_map = self->root_r.map;
 
 	*last_node = NULL;
-	
-	ax_citer key_it = ax_box_cbegin(ax_cr(seq, key).box);
-	ax_citer key_it_end = ax_box_cend(ax_cr(seq, key).box);
 
 	if (ax_box_size(self->root_r.box) > 0) {
 		match_len ++;
 
-
 		ax_iter root_it = ax_box_begin(ax_r(map, cur_map).box);
 		*last_node = ax_iter_get(&root_it);
 		cur_map = (*last_node)->submap_r.map;
 
-		while (!ax_citer_equal(&key_it, &key_it_end)) {
-			ax_iter find_pos = ax_map_at(cur_map, ax_citer_get(&key_it));
+		while (cur->pos < cur->len) {
+			ax_iter find_pos = ax_map_at(cur_map, cursor_word(cur));
 			ax_iter find_end = ax_box_end(ax_r(map, cur_map).box);
 			if (ax_iter_equal(&find_pos, &find_end))
 				break;
 			*last_node = ax_iter_get(&find_pos);
 			cur_map = (*last_node)->submap_r.map;
-			ax_citer_next(&key_it);
+			cursor_next(cur);
 			match_len ++;
 		}
 	}
-	*it_mismatched = key_it;
 	return match_len;
 }
 
@@ -457,22 +503,19 @@ fail:
 	return ax_true;
 }
 
-static struct node_st *make_path(ax_trie *trie, const ax_seq *key)
+static struct node_st *make_path(ax_trie *trie, struct key_cursor_st *cur)
 {
-	ax_assert(trie->env.key_tr == key->env.elem_tr, "invalid element trait for the key");
-
 	ax_btrie_r self_r = { .trie = trie };
 	ax_base *base = ax_one_base(self_r.one);
 	ax_pool *pool = ax_base_pool(base);
 
-	ax_citer key_it;
 	struct node_st *last_node;
-	int match_len = match_key(self_r.btrie, key, &key_it, &last_node);
+	int match_len = match_key(self_r.btrie, cur, &last_node);
 
 	struct node_st *new_node_tab = NULL;
 	void *value = NULL;
 	
-	size_t ins_count = ax_box_size(ax_cr(seq, key).box) + 1 - match_len;
+	size_t ins_count = cur->len + 1 - match_len;
 
 	new_node_tab = ax_pool_alloc(pool, sizeof(struct node_st) * ins_count);
 	if (!new_node_tab) {
@@ -504,12 +547,11 @@ static struct node_st *make_path(ax_trie *trie, const ax_seq *key)
 
 	for (size_t i = !match_len; i < ins_count; i++) {
 		node_set_parent(new_node_tab + i, cur_map);
-		const void *key = ax_citer_get(&key_it);
-		last_node = ax_map_put(cur_map, key, new_node_tab + i);
+		last_node = ax_map_put(cur_map, cursor_word(cur), new_node_tab + i);
 		if (!last_node)
 			goto fail;
 		cur_map = new_node_tab[i].submap_r.map;
-		ax_citer_next(&key_it);
+		cursor_next(cur);
 	}
 
 	ax_pool_free(new_node_tab);
@@ -532,7 +574,9 @@ static ax_fail trie_put(ax_trie *trie, const ax_seq *key, const void *val)
 
 	ax_btrie_r self_r = { .trie = trie };
 
-	struct node_st *node = make_path(trie, key);
+	struct key_cursor_st cur;
+	cursor_init_seq(&cur, key);
+	struct node_st *node = make_path(trie, &cur);
 	if (!node)
 		return ax_true;
 	
@@ -553,11 +597,8 @@ static void *trie_get(const ax_trie *trie, const ax_seq *key)
 		: iter_get(&it);
 }
 
-static ax_iter trie_at(const ax_trie *trie, const ax_seq *key)
+static ax_iter cursor_at(const ax_trie *trie, struct key_cursor_st *cur)
 {
-	CHECK_PARAM_NULL(trie);
-	CHECK_PARAM_NULL(key);
-
 	ax_btrie *self = (ax_btrie *) trie;
 	if (ax_box_size(ax_cr(map, self->root_r.map).box) == 0)
 		return box_end((ax_box *)trie);
@@ -565,19 +606,27 @@ static ax_iter trie_at(const ax_trie *trie, const ax_seq *key)
 	ax_iter it = ax_box_begin(ax_r(map, self->root_r.map).box);
 
 	struct node_st *last_node = ax_iter_get(&it);
-	if (ax_box_size(ax_cr(seq, key).box)) {
-		ax_box_cforeach(ax_cr(seq, key).box, const void *, word) {
-			it = ax_map_at(last_node->submap_r.map, word);
-			ax_iter end = ax_box_end(last_node->submap_r.box);
-			if (ax_iter_equal(&it, &end))
-				return box_end((ax_box *)trie);
-			last_node = ax_iter_get(&it);
-		}
+	for (; cur->pos < cur->len; cursor_next(cur)) {
+		it = ax_map_at(last_node->submap_r.map, cursor_word(cur));
+		ax_iter end = ax_box_end(last_node->submap_r.box);
+		if (ax_iter_equal(&it, &end))
+			return box_end((ax_box *)trie);
+		last_node = ax_iter_get(&it);
 	}
 	it.tr = &ax_btrie_tr.box.iter;
 	return it;
 }
 
+static ax_iter trie_at(const ax_trie *trie, const ax_seq *key)
+{
+	CHECK_PARAM_NULL(trie);
+	CHECK_PARAM_NULL(key);
+
+	struct key_cursor_st cur;
+	cursor_init_seq(&cur, key);
+	return cursor_at(trie, &cur);
+}
+
 static ax_bool trie_exist(const ax_trie *trie, const ax_seq *key)
 {
 	CHECK_PARAM_NULL(trie);
@@ -689,7 +738,9 @@ static ax_fail trie_rekey(ax_trie *trie, const ax_seq *key_from, const ax_seq *k
 
 	void *value = old_node->val;
 
-	struct node_st *new_node = make_path(trie, key_to);
+	struct key_cursor_st cur;
+	cursor_init_seq(&cur, key_to);
+	struct node_st *new_node = make_path(trie, &cur);
 	if (!new_node)
 		return ax_true;
 
@@ -700,6 +751,102 @@ static ax_fail trie_rekey(ax_trie *trie, const ax_seq *key_from, const ax_seq *k
 	return ax_true;
 }
 
+static ax_fail trie_put_raw(ax_trie *trie, const void *key, size_t len, const void *val)
+{
+	CHECK_PARAM_NULL(trie);
+	CHECK_PARAM_VALIDITY(key, key || len == 0);
+
+	ax_btrie_r self_r = { .trie = trie };
+
+	struct key_cursor_st cur;
+	cursor_init_raw(&cur, trie->env.key_tr, key, len);
+	struct node_st *node = make_path(trie, &cur);
+	if (!node)
+		return ax_true;
+
+	return node_set_value(self_r.btrie, node, val);
+}
+
+static ax_iter trie_at_raw(const ax_trie *trie, const void *key, size_t len)
+{
+	CHECK_PARAM_NULL(trie);
+	CHECK_PARAM_VALIDITY(key, key || len == 0);
+
+	struct key_cursor_st cur;
+	cursor_init_raw(&cur, trie->env.key_tr, key, len);
+	return cursor_at(trie, &cur);
+}
+
+static void *trie_get_raw(const ax_trie *trie, const void *key, size_t len)
+{
+	ax_iter it = trie_at_raw(trie, key, len);
+	ax_iter end = box_end((ax_box *)trie);
+	return ax_iter_equal(&it, &end)
+		? NULL
+		: iter_get(&it);
+}
+
+static ax_bool trie_exist_raw(const ax_trie *trie, const void *key, size_t len)
+{
+	ax_iter it = trie_at_raw(trie, key, len);
+	ax_iter end = box_end((ax_box *)trie);
+	if (ax_iter_equal(&it, &end))
+		return ax_false;
+	struct node_st *node = ax_avl_tr.box.iter.get(&it);
+	return !!node->val;
+}
+
+static ax_bool trie_erase_raw(ax_trie *trie, const void *key, size_t len)
+{
+	CHECK_PARAM_NULL(trie);
+	CHECK_PARAM_VALIDITY(key, key || len == 0);
+
+	ax_iter it = trie_at_raw(trie, key, len);
+	ax_iter end = box_end((ax_box *)trie);
+	if (ax_iter_equal(&it, &end))
+		return ax_false;
+	iter_erase(&it);
+	return ax_true;
+}
+
+static ax_iter trie_longest(const ax_trie *trie, const void *key, size_t len, size_t *plen)
+{
+	CHECK_PARAM_NULL(trie);
+	CHECK_PARAM_VALIDITY(key, key || len == 0);
+
+	ax_btrie *self = (ax_btrie *) trie;
+	ax_iter found = box_end((ax_box *)trie);
+	size_t found_len = 0;
+
+	if (ax_box_size(ax_cr(map, self->root_r.map).box) == 0)
+		goto out;
+
+	struct key_cursor_st cur;
+	cursor_init_raw(&cur, trie->env.key_tr, key, len);
+
+	ax_iter it = ax_box_begin(ax_r(map, self->root_r.map).box);
+	struct node_st *last_node = ax_iter_get(&it);
+	for (;;) {
+		if (last_node->val) {
+			found = it;
+			found_len = cur.pos;
+		}
+		if (cur.pos == cur.len)
+			break;
+		it = ax_map_at(last_node->submap_r.map, cursor_word(&cur));
+		ax_iter end = ax_box_end(last_node->submap_r.box);
+		if (ax_iter_equal(&it, &end))
+			break;
+		last_node = ax_iter_get(&it);
+		cursor_next(&cur);
+	}
+	found.tr = &ax_btrie_tr.box.iter;
+out:
+	if (plen)
+		*plen = found_len;
+	return found;
+}
+
 static const void *trie_it_word(const ax_citer *it)
 {
 	CHECK_PARAM_NULL(it);
@@ -811,6 +958,12 @@ const ax_trie_trait ax_btrie_tr =
 	.prune = trie_prune,
 	.rekey = trie_rekey,
 	.erase = trie_erase,
+	.put_raw = trie_put_raw,
+	.get_raw = trie_get_raw,
+	.at_raw = trie_at_raw,
+	.exist_raw = trie_exist_raw,
+	.erase_raw = trie_erase_raw,
+	.longest = trie_longest,
 	.it_word = trie_it_word,
 	.it_begin = trie_it_begin,
 	.it_end = trie_it_end,
@@ -0,0 +1,685 @@
+/*
+ * Copyright (c) 2021 Li hsilin <lihsilyn@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#include "check.h"
+
+#include <axe/datrie.h>
+#include <axe/scope.h>
+#include <axe/pool.h>
+#include <axe/base.h>
+#include <axe/iter.h>
+#include <axe/error.h>
+
+#include <stdint.h>
+#include <string.h>
+
+#undef free
+
+#define IMAGE_MAGIC 0x41445841 /* "AXDA" */
+#define IMAGE_VERSION 1
+#define ALIGN(_n) (((_n) + 7) & ~(size_t)7)
+#define ROOT 1
+
+/*
+ * Cell 1 is the root, code 0 is reserved for the terminal cell of a valued
+ * node, whose base holds the negated value index plus one.
+ */
+
+struct header_st
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t ksize;
+	uint32_t vsize;
+	uint32_t nsym;
+	uint32_t ncell;
+	uint32_t nval;
+	uint32_t reserved;
+	uint64_t size;
+	uint64_t sym_off;
+	uint64_t code_off;
+	uint64_t cell_off;
+	uint64_t val_off;
+};
+
+struct cell_st
+{
+	int32_t base;
+	int32_t check;
+};
+
+struct ax_datrie_st
+{
+	ax_one _one;
+	ax_byte *buffer;
+	const struct header_st *header;
+	const ax_byte *symbols;
+	const uint16_t *codes;
+	const struct cell_st *cells;
+	const ax_byte *values;
+};
+
+struct child_st
+{
+	ax_iter it;
+	uint32_t code;
+};
+
+struct pending_st
+{
+	ax_iter it;
+	int32_t cell;
+};
+
+struct builder_st
+{
+	ax_base *base;
+	ax_pool *pool;
+	size_t ksize;
+	size_t vsize;
+
+	ax_byte *symbols;
+	size_t nsym, sym_cap;
+	uint16_t codes[256];
+
+	struct cell_st *cells;
+	size_t ncell, cell_cap;
+	size_t first_free;
+
+	ax_byte *values;
+	size_t nval, val_cap;
+
+	struct child_st *children;
+	size_t child_cap;
+
+	void *stack;
+	size_t stack_cap;
+};
+
+static void one_free(ax_one *one);
+
+static const ax_one_trait one_trait = {
+	.name = AX_DATRIE_NAME,
+	.free = one_free
+};
+
+static ax_fail reserve(struct builder_st *b, void *pptr, size_t *cap, size_t need, size_t elem_size)
+{
+	if (need <= *cap)
+		return ax_false;
+
+	size_t new_cap = *cap ? *cap : 16;
+	while (new_cap < need)
+		new_cap <<= 1;
+
+	void *ptr = ax_pool_realloc(b->pool, *(void **)pptr, new_cap * elem_size);
+	if (!ptr) {
+		ax_base_set_errno(b->base, AX_ERR_NOMEM);
+		return ax_true;
+	}
+	memset((ax_byte *)ptr + *cap * elem_size, 0, (new_cap - *cap) * elem_size);
+	*(void **)pptr = ptr;
+	*cap = new_cap;
+	return ax_false;
+}
+
+static size_t symbol_lower_bound(const ax_byte *symbols, size_t nsym, size_t ksize, const void *sym)
+{
+	size_t lo = 0, hi = nsym;
+	while (lo < hi) {
+		size_t mid = (lo + hi) / 2;
+		if (memcmp(symbols + mid * ksize, sym, ksize) < 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+static ax_fail add_symbol(struct builder_st *b, const void *sym)
+{
+	if (b->ksize == 1) {
+		b->codes[*(uint8_t *)sym] = 1;
+		return ax_false;
+	}
+
+	size_t i = symbol_lower_bound(b->symbols, b->nsym, b->ksize, sym);
+	if (i < b->nsym && memcmp(b->symbols + i * b->ksize, sym, b->ksize) == 0)
+		return ax_false;
+
+	if (reserve(b, &b->symbols, &b->sym_cap, b->nsym + 1, b->ksize))
+		return ax_true;
+	memmove(b->symbols + (i + 1) * b->ksize, b->symbols + i * b->ksize, (b->nsym - i) * b->ksize);
+	memcpy(b->symbols + i * b->ksize, sym, b->ksize);
+	b->nsym++;
+	return ax_false;
+}
+
+static ax_fail collect_symbols(struct builder_st *b, const ax_trie *trie)
+{
+	ax_iter root = ax_box_begin((ax_box *)ax_cr(trie, trie).box);
+	ax_iter end = ax_box_end((ax_box *)ax_cr(trie, trie).box);
+	if (ax_iter_equal(&root, &end))
+		return ax_false;
+
+	ax_iter *stack;
+	size_t depth = 0;
+	if (reserve(b, &b->stack, &b->stack_cap, 2, sizeof(ax_iter)))
+		return ax_true;
+	stack = b->stack;
+	stack[0] = ax_trie_iter_begin(&root);
+	stack[1] = ax_trie_iter_end(&root);
+
+	for (;;) {
+		ax_iter *cur = stack + depth * 2;
+		if (ax_iter_equal(cur, cur + 1)) {
+			if (depth == 0)
+				break;
+			depth--;
+			ax_iter_next(stack + depth * 2);
+			continue;
+		}
+
+		if (add_symbol(b, ax_trie_iter_word(cur)))
+			return ax_true;
+
+		ax_iter child = ax_trie_iter_begin(cur);
+		ax_iter child_end = ax_trie_iter_end(cur);
+		if (ax_iter_equal(&child, &child_end)) {
+			ax_iter_next(cur);
+			continue;
+		}
+
+		if (reserve(b, &b->stack, &b->stack_cap, (depth + 2) * 2, sizeof(ax_iter)))
+			return ax_true;
+		stack = b->stack;
+		depth++;
+		stack[depth * 2] = child;
+		stack[depth * 2 + 1] = child_end;
+	}
+
+	if (b->ksize == 1) {
+		if (reserve(b, &b->symbols, &b->sym_cap, 256, 1))
+			return ax_true;
+		for (int i = 0; i < 256; i++) {
+			if (!b->codes[i])
+				continue;
+			b->symbols[b->nsym++] = i;
+			b->codes[i] = b->nsym;
+		}
+	}
+	return ax_false;
+}
+
+static uint32_t builder_code(const struct builder_st *b, const void *sym)
+{
+	if (b->ksize == 1)
+		return b->codes[*(uint8_t *)sym];
+	return symbol_lower_bound(b->symbols, b->nsym, b->ksize, sym) + 1;
+}
+
+static inline ax_bool cell_free(const struct builder_st *b, size_t pos)
+{
+	return pos != ROOT && (pos >= b->ncell || !b->cells[pos].check);
+}
+
+static size_t find_base(const struct builder_st *b, const struct child_st *children, size_t count)
+{
+	uint32_t min_code = children[0].code;
+	for (size_t i = 1; i < count; i++)
+		if (children[i].code < min_code)
+			min_code = children[i].code;
+
+	for (size_t base = b->first_free > min_code + 1 ? b->first_free - min_code : 1; ; base++) {
+		size_t i;
+		for (i = 0; i < count && cell_free(b, base + children[i].code); i++);
+		if (i == count)
+			return base;
+	}
+}
+
+static ax_fail place_node(struct builder_st *b, const ax_iter *it, int32_t cell, size_t *npending)
+{
+	size_t count = 0;
+
+	if (ax_trie_iter_valued(it)) {
+		if (reserve(b, &b->children, &b->child_cap, count + 1, sizeof(struct child_st)))
+			return ax_true;
+		b->children[count].code = 0;
+		count++;
+	}
+
+	ax_iter child = ax_trie_iter_begin(it);
+	ax_iter child_end = ax_trie_iter_end(it);
+	while (!ax_iter_equal(&child, &child_end)) {
+		if (reserve(b, &b->children, &b->child_cap, count + 1, sizeof(struct child_st)))
+			return ax_true;
+		b->children[count].it = child;
+		b->children[count].code = builder_code(b, ax_trie_iter_word(&child));
+		count++;
+		ax_iter_next(&child);
+	}
+
+	if (count == 0)
+		return ax_false;
+
+	size_t base = find_base(b, b->children, count);
+	if (base + b->nsym >= INT32_MAX) {
+		ax_base_set_errno(b->base, AX_ERR_FULL);
+		return ax_true;
+	}
+
+	size_t top = base;
+	for (size_t i = 0; i < count; i++)
+		if (base + b->children[i].code > top)
+			top = base + b->children[i].code;
+	if (reserve(b, &b->cells, &b->cell_cap, top + 1, sizeof(struct cell_st)))
+		return ax_true;
+	if (top + 1 > b->ncell)
+		b->ncell = top + 1;
+
+	if (reserve(b, &b->stack, &b->stack_cap, *npending + count, sizeof(struct pending_st)))
+		return ax_true;
+	struct pending_st *pending = b->stack;
+
+	b->cells[cell].base = base;
+	for (size_t i = 0; i < count; i++) {
+		size_t pos = base + b->children[i].code;
+		b->cells[pos].check = cell;
+		if (b->children[i].code == 0) {
+			if (reserve(b, &b->values, &b->val_cap, (b->nval + 1) * b->vsize, 1))
+				return ax_true;
+			memcpy(b->values + b->nval * b->vsize, ax_iter_get(it), b->vsize);
+			b->nval++;
+			b->cells[pos].base = -(int32_t)b->nval;
+			continue;
+		}
+		pending[*npending].it = b->children[i].it;
+		pending[*npending].cell = pos;
+		(*npending)++;
+	}
+
+	while (b->first_free < b->ncell && !cell_free(b, b->first_free))
+		b->first_free++;
+	return ax_false;
+}
+
+static ax_fail build_cells(struct builder_st *b, const ax_trie *trie)
+{
+	if (reserve(b, &b->cells, &b->cell_cap, ROOT + 1, sizeof(struct cell_st)))
+		return ax_true;
+	b->ncell = ROOT + 1;
+	b->cells[ROOT].check = -1;
+	b->first_free = ROOT + 1;
+
+	ax_iter root = ax_box_begin((ax_box *)ax_cr(trie, trie).box);
+	ax_iter end = ax_box_end((ax_box *)ax_cr(trie, trie).box);
+	if (ax_iter_equal(&root, &end))
+		return ax_false;
+
+	ax_pool_free(b->stack);
+	b->stack = NULL;
+	b->stack_cap = 0;
+	if (reserve(b, &b->stack, &b->stack_cap, 1, sizeof(struct pending_st)))
+		return ax_true;
+
+	size_t npending = 1;
+	((struct pending_st *)b->stack)[0].it = root;
+	((struct pending_st *)b->stack)[0].cell = ROOT;
+	while (npending) {
+		struct pending_st node = ((struct pending_st *)b->stack)[--npending];
+		if (place_node(b, &node.it, node.cell, &npending))
+			return ax_true;
+	}
+	return ax_false;
+}
+
+static ax_byte *make_image(struct builder_st *b)
+{
+	struct header_st header = {
+		.magic = IMAGE_MAGIC,
+		.version = IMAGE_VERSION,
+		.ksize = b->ksize,
+		.vsize = b->vsize,
+		.nsym = b->nsym,
+		.ncell = b->ncell,
+		.nval = b->nval,
+	};
+	header.sym_off = ALIGN(sizeof header);
+	header.code_off = ALIGN(header.sym_off + b->nsym * b->ksize);
+	header.cell_off = ALIGN(header.code_off + (b->ksize == 1 ? sizeof b->codes : 0));
+	header.val_off = ALIGN(header.cell_off + b->ncell * sizeof(struct cell_st));
+	header.size = ALIGN(header.val_off + b->nval * b->vsize);
+
+	ax_byte *image = ax_pool_alloc(b->pool, header.size);
+	if (!image) {
+		ax_base_set_errno(b->base, AX_ERR_NOMEM);
+		return NULL;
+	}
+	memset(image, 0, header.size);
+	memcpy(image, &header, sizeof header);
+	if (b->nsym)
+		memcpy(image + header.sym_off, b->symbols, b->nsym * b->ksize);
+	if (b->ksize == 1)
+		memcpy(image + header.code_off, b->codes, sizeof b->codes);
+	memcpy(image + header.cell_off, b->cells, b->ncell * sizeof(struct cell_st));
+	if (b->nval)
+		memcpy(image + header.val_off, b->values, b->nval * b->vsize);
+	return image;
+}
+
+static ax_bool image_valid(const void *image, size_t size)
+{
+	const struct header_st *h = image;
+	if (((uintptr_t)image & 7) || size < sizeof *h)
+		return ax_false;
+	if (h->magic != IMAGE_MAGIC || h->version != IMAGE_VERSION || h->size > size)
+		return ax_false;
+	if (h->ksize == 0 || h->ncell <= ROOT || h->nsym >= INT32_MAX)
+		return ax_false;
+	return h->sym_off >= sizeof *h
+		&& h->sym_off + (uint64_t)h->nsym * h->ksize <= h->code_off
+		&& h->code_off + (h->ksize == 1 ? 256 * sizeof(uint16_t) : 0) <= h->cell_off
+		&& h->cell_off + (uint64_t)h->ncell * sizeof(struct cell_st) <= h->val_off
+		&& h->val_off + (uint64_t)h->nval * h->vsize <= h->size
+		&& !(h->code_off & 7) && !(h->cell_off & 7) && !(h->val_off & 7);
+}
+
+static ax_one *construct(ax_base *base, ax_byte *buffer, const void *image)
+{
+	ax_datrie *self = ax_pool_alloc(ax_base_pool(base), sizeof(ax_datrie));
+	if (!self) {
+		ax_base_set_errno(base, AX_ERR_NOMEM);
+		return NULL;
+	}
+
+	const ax_byte *p = image;
+	const struct header_st *h = image;
+	ax_datrie datrie_init = {
+		._one = {
+			.tr = &one_trait,
+			.env = {
+				.base = base,
+				.scope = { NULL },
+			},
+		},
+		.buffer = buffer,
+		.header = h,
+		.symbols = p + h->sym_off,
+		.codes = (const uint16_t *)(p + h->code_off),
+		.cells = (const struct cell_st *)(p + h->cell_off),
+		.values = p + h->val_off,
+	};
+	memcpy(self, &datrie_init, sizeof datrie_init);
+	return &self->_one;
+}
+
+static void one_free(ax_one *one)
+{
+	if (!one)
+		return;
+
+	ax_datrie_r self_r = { .one = one };
+	ax_scope_detach(one);
+	ax_pool_free(self_r.datrie->buffer);
+	ax_pool_free(one);
+}
+
+static uint32_t symbol_code(const ax_datrie *self, const void *sym)
+{
+	const struct header_st *h = self->header;
+	if (h->ksize == 1)
+		return self->codes[*(uint8_t *)sym];
+
+	size_t i = symbol_lower_bound(self->symbols, h->nsym, h->ksize, sym);
+	return (i < h->nsym && memcmp(self->symbols + i * h->ksize, sym, h->ksize) == 0)
+		? i + 1
+		: 0;
+}
+
+static inline int32_t child_cell(const ax_datrie *self, int32_t cell, uint32_t code)
+{
+	int32_t base = self->cells[cell].base;
+	if (base <= 0)
+		return 0;
+	size_t pos = (size_t)base + code;
+	return (pos < self->header->ncell && self->cells[pos].check == cell) ? pos : 0;
+}
+
+static const void *cell_value(const ax_datrie *self, int32_t cell)
+{
+	int32_t term = child_cell(self, cell, 0);
+	if (!term || self->cells[term].base >= 0)
+		return NULL;
+	size_t index = -(int64_t)self->cells[term].base - 1;
+	return index < self->header->nval
+		? self->values + index * self->header->vsize
+		: NULL;
+}
+
+static int32_t walk(const ax_datrie *self, const ax_byte *key, size_t len, size_t *matched)
+{
+	size_t ksize = self->header->ksize;
+	int32_t cell = ROOT;
+	size_t i;
+	for (i = 0; i < len; i++) {
+		uint32_t code = symbol_code(self, key + i * ksize);
+		int32_t next = code ? child_cell(self, cell, code) : 0;
+		if (!next)
+			break;
+		cell = next;
+	}
+	*matched = i;
+	return cell;
+}
+
+ax_one *__ax_datrie_construct(ax_base *base, const ax_trie *trie)
+{
+	CHECK_PARAM_NULL(base);
+	CHECK_PARAM_NULL(trie);
+	CHECK_PARAM_VALIDITY(trie, !trie->env.key_tr->link);
+	CHECK_PARAM_VALIDITY(trie, !trie->env.val_tr->link);
+
+	struct builder_st b = {
+		.base = base,
+		.pool = ax_base_pool(base),
+		.ksize = trie->env.key_tr->size,
+		.vsize = trie->env.val_tr->size,
+	};
+
+	ax_one *one = NULL;
+	ax_byte *image = NULL;
+	if (collect_symbols(&b, trie) || build_cells(&b, trie))
+		goto out;
+
+	if (!(image = make_image(&b)))
+		goto out;
+
+	if (!(one = construct(base, image, image)))
+		ax_pool_free(image);
+out:
+	ax_pool_free(b.symbols);
+	ax_pool_free(b.cells);
+	ax_pool_free(b.values);
+	ax_pool_free(b.children);
+	ax_pool_free(b.stack);
+	return one;
+}
+
+ax_datrie_r ax_trie_freeze(ax_scope *scope, const ax_trie *trie)
+{
+	CHECK_PARAM_NULL(scope);
+	CHECK_PARAM_NULL(trie);
+
+	ax_base *base = ax_one_base(ax_r(scope, scope).one);
+	ax_datrie_r self_r = { .one = __ax_datrie_construct(base, trie) };
+	if (!self_r.one)
+		return self_r;
+	ax_scope_attach(scope, self_r.one);
+	return self_r;
+}
+
+ax_one *__ax_datrie_load(ax_base *base, const void *image, size_t size)
+{
+	CHECK_PARAM_NULL(base);
+	CHECK_PARAM_NULL(image);
+
+	if (!image_valid(image, size)) {
+		ax_base_set_errno(base, AX_ERR_UNSUP);
+		return NULL;
+	}
+	return construct(base, NULL, image);
+}
+
+ax_datrie_r ax_datrie_load(ax_scope *scope, const void *image, size_t size)
+{
+	CHECK_PARAM_NULL(scope);
+	CHECK_PARAM_NULL(image);
+
+	ax_base *base = ax_one_base(ax_r(scope, scope).one);
+	ax_datrie_r self_r = { .one = __ax_datrie_load(base, image, size) };
+	if (!self_r.one)
+		return self_r;
+	ax_scope_attach(scope, self_r.one);
+	return self_r;
+}
+
+const void *ax_datrie_image(const ax_datrie *datrie, size_t *size)
+{
+	CHECK_PARAM_NULL(datrie);
+
+	if (size)
+		*size = datrie->header->size;
+	return datrie->header;
+}
+
+size_t ax_datrie_size(const ax_datrie *datrie)
+{
+	CHECK_PARAM_NULL(datrie);
+
+	return datrie->header->nval;
+}
+
+const void *ax_datrie_get(const ax_datrie *datrie, const void *key, size_t len)
+{
+	CHECK_PARAM_NULL(datrie);
+	CHECK_PARAM_VALIDITY(key, key || len == 0);
+
+	size_t matched;
+	int32_t cell = walk(datrie, key, len, &matched);
+	return matched == len ? cell_value(datrie, cell) : NULL;
+}
+
+const void *ax_datrie_longest_prefix(const ax_datrie *datrie, const void *key, size_t len, size_t *plen)
+{
+	CHECK_PARAM_NULL(datrie);
+	CHECK_PARAM_VALIDITY(key, key || len == 0);
+
+	size_t ksize = datrie->header->ksize;
+	const ax_byte *word = key;
+	const void *found = cell_value(datrie, ROOT);
+	size_t found_len = 0;
+	int32_t cell = ROOT;
+
+	for (size_t i = 0; i < len; i++) {
+		uint32_t code = symbol_code(datrie, word + i * ksize);
+		if (!code || !(cell = child_cell(datrie, cell, code)))
+			break;
+		const void *val = cell_value(datrie, cell);
+		if (val) {
+			found = val;
+			found_len = i + 1;
+		}
+	}
+
+	if (plen)
+		*plen = found ? found_len : 0;
+	return found;
+}
+
+ax_fail ax_datrie_scan_prefix(const ax_datrie *datrie, const void *prefix, size_t len,
+		ax_datrie_scan_cb_f cb, void *ctx)
+{
+	CHECK_PARAM_NULL(datrie);
+	CHECK_PARAM_VALIDITY(prefix, prefix || len == 0);
+	CHECK_PARAM_NULL(cb);
+
+	ax_base *base = ax_one_base(ax_cr(datrie, datrie).one);
+	const struct header_st *h = datrie->header;
+	size_t ksize = h->ksize;
+
+	ax_byte key[AX_TRIE_SCAN_MAX * sizeof(void *)];
+	struct { int32_t cell; uint32_t code; } stack[AX_TRIE_SCAN_MAX + 1];
+	size_t max = AX_MIN(AX_TRIE_SCAN_MAX, sizeof key / ksize);
+
+	if (len > max) {
+		ax_base_set_errno(base, AX_ERR_TOOLONG);
+		return ax_true;
+	}
+
+	size_t matched;
+	int32_t cell = walk(datrie, prefix, len, &matched);
+	if (matched != len)
+		return ax_false;
+	if (len)
+		memcpy(key, prefix, len * ksize);
+
+	const void *val = cell_value(datrie, cell);
+	if (val && cb(datrie, key, len, val, ctx))
+		return ax_false;
+
+	size_t depth = 0;
+	stack[0].cell = cell;
+	stack[0].code = 1;
+	for (;;) {
+		int32_t child = 0;
+		uint32_t code;
+		for (code = stack[depth].code; code <= h->nsym; code++)
+			if ((child = child_cell(datrie, stack[depth].cell, code)))
+				break;
+
+		if (!child) {
+			if (depth == 0)
+				break;
+			depth--;
+			continue;
+		}
+		stack[depth].code = code + 1;
+
+		size_t pos = len + depth;
+		if (pos == max) {
+			ax_base_set_errno(base, AX_ERR_TOOLONG);
+			return ax_true;
+		}
+		memcpy(key + pos * ksize, datrie->symbols + (code - 1) * ksize, ksize);
+
+		val = cell_value(datrie, child);
+		if (val && cb(datrie, key, pos + 1, val, ctx))
+			return ax_false;
+
+		depth++;
+		stack[depth].cell = child;
+		stack[depth].code = 1;
+	}
+	return ax_false;
+}
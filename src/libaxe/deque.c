@@ -0,0 +1,1012 @@
+/*
+ * Copyright (c) 2021 Li hsilin <lihsilyn@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#include <axe/deque.h>
+#include <axe/base.h>
+#include <axe/def.h>
+#include <axe/pool.h>
+#include <axe/scope.h>
+#include <axe/any.h>
+#include <axe/iter.h>
+#include <axe/debug.h>
+#include <axe/stuff.h>
+#include <axe/error.h>
+
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+
+#include "check.h"
+
+#undef free
+
+#define CHUNK_BYTES 512
+#define MAP_MIN 8
+
+/* Iterator points hold index + 1, so that rend (index -1) is NULL */
+#define POINT(_i) ((void *)((uintptr_t)(_i) + 1))
+#define INDEX(_p) ((size_t)((uintptr_t)(_p) - 1))
+
+struct ax_deque_st
+{
+	ax_seq _seq;
+	ax_byte **map;
+	ax_byte *spare;
+	size_t nmap;
+	size_t start;
+	size_t size;
+	size_t shift;
+};
+
+static ax_fail seq_push(ax_seq *seq, const void *val);
+static ax_fail seq_pop(ax_seq *seq);
+static ax_fail seq_pushf(ax_seq *seq, const void *val);
+static ax_fail seq_popf(ax_seq *seq);
+static void    seq_invert(ax_seq *seq);
+static ax_fail seq_trunc(ax_seq *seq, size_t size);
+static ax_iter seq_at(const ax_seq *seq, size_t index);
+static void   *seq_last(const ax_seq *seq);
+static void   *seq_first(const ax_seq *seq);
+static ax_fail seq_insert(ax_seq *seq, ax_iter *it, const void *val);
+static ax_fail seq_insert_range(ax_seq *seq, ax_iter *it, const ax_citer *first, const ax_citer *last);
+static ax_fail seq_insert_arr(ax_seq *seq, ax_iter *it, const void *arr, size_t len);
+static ax_fail seq_erase_range(ax_seq *seq, ax_iter *first, ax_iter *last);
+
+static size_t  box_size(const ax_box *box);
+static size_t  box_maxsize(const ax_box *box);
+static ax_iter box_begin(ax_box *box);
+static ax_iter box_end(ax_box *box);
+static ax_iter box_rbegin(ax_box *box);
+static ax_iter box_rend(ax_box *box);
+static void    box_clear(ax_box *box);
+static const ax_stuff_trait *box_elem_tr(const ax_box *box);
+
+static ax_any *any_copy(const ax_any *any);
+static ax_any *any_move(ax_any *any);
+
+static void    one_free(ax_one *one);
+
+static void    citer_move(ax_citer *it, long i);
+static void    citer_prev(ax_citer *it);
+static void    citer_next(ax_citer *it);
+static ax_bool citer_less(const ax_citer *it1, const ax_citer *it2);
+static long    citer_dist(const ax_citer *it1, const ax_citer *it2);
+
+static void    rciter_move(ax_citer *it, long i);
+static void    rciter_prev(ax_citer *it);
+static void    rciter_next(ax_citer *it);
+static ax_bool rciter_less(const ax_citer *it1, const ax_citer *it2);
+static long    rciter_dist(const ax_citer *it1, const ax_citer *it2);
+
+static void   *iter_get(const ax_iter *it);
+static void    iter_erase(ax_iter *it);
+static ax_fail iter_set(const ax_iter *it, const void *val);
+
+#ifdef AX_DEBUG
+static inline ax_bool iter_if_valid(const ax_citer *it)
+{
+	const ax_deque *self = it->owner;
+	return ax_citer_norm(it)
+		? (it->point && INDEX(it->point) <= self->size)
+		: (!it->point || INDEX(it->point) < self->size);
+}
+
+static inline ax_bool iter_if_have_value(const ax_citer *it)
+{
+	const ax_deque *self = it->owner;
+	return it->point && INDEX(it->point) < self->size;
+}
+#endif
+
+inline static size_t chunk_mask(const ax_deque *self)
+{
+	return ((size_t)1 << self->shift) - 1;
+}
+
+inline static ax_byte *elem_ptr(const ax_deque *self, size_t index)
+{
+	size_t pos = self->start + index;
+	return self->map[pos >> self->shift]
+		+ (pos & chunk_mask(self)) * self->_seq.env.elem_tr->size;
+}
+
+inline static void *elem_value(const ax_deque *self, ax_byte *ptr)
+{
+	return self->_seq.env.elem_tr->link ? *(void **)ptr : ptr;
+}
+
+inline static void elem_move(const ax_stuff_trait *etr, ax_byte *dst, ax_byte *src)
+{
+	if (etr->trivial_move)
+		memcpy(dst, src, etr->size);
+	else
+		etr->move(dst, src, etr->size);
+}
+
+static ax_fail elem_construct(ax_deque *self, ax_byte *ptr, const void *val)
+{
+	const ax_stuff_trait *etr = self->_seq.env.elem_tr;
+	ax_base *base = ax_one_base(ax_r(deque, self).one);
+	ax_pool *pool = ax_base_pool(base);
+
+	const void *pval = etr->link ? &val : val;
+	ax_fail fail = val
+		? etr->copy(pool, ptr, pval, etr->size)
+		: etr->init(pool, ptr, etr->size);
+	if (fail) {
+		ax_base_set_errno(base, AX_ERR_NOMEM);
+		return ax_true;
+	}
+	return ax_false;
+}
+
+static ax_byte *chunk_get(ax_deque *self)
+{
+	ax_byte *chunk = self->spare;
+	if (chunk) {
+		self->spare = NULL;
+		return chunk;
+	}
+
+	ax_base *base = ax_one_base(ax_r(deque, self).one);
+	size_t esize = self->_seq.env.elem_tr->size;
+	chunk = ax_pool_alloc(ax_base_pool(base), (esize ? esize : 1) << self->shift);
+	if (!chunk)
+		ax_base_set_errno(base, AX_ERR_NOMEM);
+	return chunk;
+}
+
+static void chunk_put(ax_deque *self, size_t index)
+{
+	if (self->spare)
+		ax_pool_free(self->map[index]);
+	else
+		self->spare = self->map[index];
+	self->map[index] = NULL;
+}
+
+/* Make sure the map has a slot for one more element at the front or back */
+static ax_fail map_reserve(ax_deque *self, ax_bool front)
+{
+	if (front ? self->start > 0 : ((self->start + self->size) >> self->shift) < self->nmap)
+		return ax_false;
+
+	size_t first = self->start >> self->shift;
+	size_t used = self->size
+		? ((self->start + self->size - 1) >> self->shift) - first + 1
+		: 0;
+	size_t nmap = self->nmap;
+	ax_byte **map = self->map;
+
+	if ((used + 1) * 2 > nmap) {
+		ax_base *base = ax_one_base(ax_r(deque, self).one);
+		nmap = nmap ? nmap * 2 : MAP_MIN;
+		map = ax_pool_alloc(ax_base_pool(base), nmap * sizeof *map);
+		if (!map) {
+			ax_base_set_errno(base, AX_ERR_NOMEM);
+			return ax_true;
+		}
+	}
+
+	size_t nfirst = (nmap - used) / 2;
+	if (used)
+		memmove(map + nfirst, self->map + first, used * sizeof *map);
+	for (size_t i = 0; i < nfirst; i++)
+		map[i] = NULL;
+	for (size_t i = nfirst + used; i < nmap; i++)
+		map[i] = NULL;
+
+	if (map != self->map)
+		ax_pool_free(self->map);
+	self->map = map;
+	self->nmap = nmap;
+	self->start = (nfirst << self->shift) + (self->start & chunk_mask(self));
+	return ax_false;
+}
+
+/* Append an uninitialized slot at the back */
+static ax_byte *slot_back(ax_deque *self)
+{
+	if (map_reserve(self, ax_false))
+		return NULL;
+
+	size_t pos = self->start + self->size;
+	ax_byte **chunk = self->map + (pos >> self->shift);
+	if (!*chunk && !(*chunk = chunk_get(self)))
+		return NULL;
+
+	self->size++;
+	return *chunk + (pos & chunk_mask(self)) * self->_seq.env.elem_tr->size;
+}
+
+/* Prepend an uninitialized slot at the front */
+static ax_byte *slot_front(ax_deque *self)
+{
+	if (map_reserve(self, ax_true))
+		return NULL;
+
+	size_t pos = self->start - 1;
+	ax_byte **chunk = self->map + (pos >> self->shift);
+	if (!*chunk && !(*chunk = chunk_get(self)))
+		return NULL;
+
+	self->start--;
+	self->size++;
+	return *chunk + (pos & chunk_mask(self)) * self->_seq.env.elem_tr->size;
+}
+
+/* Forget the last slot, its element must be destroyed or moved already */
+static void drop_back(ax_deque *self)
+{
+	size_t pos = self->start + self->size - 1;
+	self->size--;
+	if ((pos & chunk_mask(self)) == 0 || self->size == 0)
+		chunk_put(self, pos >> self->shift);
+}
+
+static void drop_front(ax_deque *self)
+{
+	size_t pos = self->start;
+	self->start++;
+	self->size--;
+	if ((self->start & chunk_mask(self)) == 0 || self->size == 0)
+		chunk_put(self, pos >> self->shift);
+}
+
+static void citer_move(ax_citer *it, long i)
+{
+	CHECK_PARAM_NULL(it);
+	CHECK_PARAM_VALIDITY(it, iter_if_valid(it));
+
+	it->point = (void *)((uintptr_t)it->point + i);
+
+	CHECK_PARAM_VALIDITY(i, iter_if_valid(it));
+}
+
+static void citer_prev(ax_citer *it)
+{
+	CHECK_PARAM_NULL(it);
+	CHECK_PARAM_VALIDITY(it, iter_if_valid(it));
+
+	it->point = (void *)((uintptr_t)it->point - 1);
+
+	CHECK_PARAM_VALIDITY(it, iter_if_valid(it));
+}
+
+static void citer_next(ax_citer *it)
+{
+	CHECK_PARAM_NULL(it);
+	CHECK_PARAM_VALIDITY(it, iter_if_valid(it));
+
+	it->point = (void *)((uintptr_t)it->point + 1);
+
+	CHECK_PARAM_VALIDITY(it, iter_if_valid(it));
+}
+
+static ax_bool citer_less(const ax_citer *it1, const ax_citer *it2)
+{
+	CHECK_PARAM_NULL(it1);
+	CHECK_PARAM_NULL(it2);
+	CHECK_ITER_COMPARABLE(it1, it2);
+
+	return (uintptr_t)it1->point < (uintptr_t)it2->point;
+}
+
+static long citer_dist(const ax_citer *it1, const ax_citer *it2)
+{
+	CHECK_ITER_COMPARABLE(it1, it2);
+
+	return (long)((uintptr_t)it2->point - (uintptr_t)it1->point);
+}
+
+static void rciter_move(ax_citer *it, long i)
+{
+	CHECK_PARAM_NULL(it);
+	CHECK_PARAM_VALIDITY(it, iter_if_valid(it));
+
+	it->point = (void *)((uintptr_t)it->point - i);
+
+	CHECK_PARAM_VALIDITY(i, iter_if_valid(it));
+}
+
+static void rciter_prev(ax_citer *it)
+{
+	CHECK_PARAM_VALIDITY(it, iter_if_valid(it));
+
+	it->point = (void *)((uintptr_t)it->point + 1);
+
+	CHECK_PARAM_VALIDITY(it, iter_if_valid(it));
+}
+
+static void rciter_next(ax_citer *it)
+{
+	CHECK_PARAM_VALIDITY(it, iter_if_valid(it));
+
+	it->point = (void *)((uintptr_t)it->point - 1);
+
+	CHECK_PARAM_VALIDITY(it, iter_if_valid(it));
+}
+
+static ax_bool rciter_less(const ax_citer *it1, const ax_citer *it2)
+{
+	CHECK_PARAM_NULL(it1);
+	CHECK_PARAM_NULL(it2);
+	CHECK_ITER_COMPARABLE(it1, it2);
+
+	return (uintptr_t)it1->point > (uintptr_t)it2->point;
+}
+
+static long rciter_dist(const ax_citer *it1, const ax_citer *it2)
+{
+	CHECK_ITER_COMPARABLE(it1, it2);
+
+	return (long)((uintptr_t)it1->point - (uintptr_t)it2->point);
+}
+
+static void *iter_get(const ax_iter *it)
+{
+	CHECK_PARAM_NULL(it);
+	CHECK_ITERATOR_VALIDITY(it, iter_if_have_value(ax_iter_c(it)));
+
+	const ax_deque *self = it->owner;
+	return elem_value(self, elem_ptr(self, INDEX(it->point)));
+}
+
+static ax_fail iter_set(const ax_iter *it, const void *val)
+{
+	CHECK_PARAM_NULL(it);
+	CHECK_ITERATOR_VALIDITY(it, iter_if_have_value(ax_iter_c(it)));
+
+	ax_deque *self = (ax_deque *)it->owner;
+	ax_byte *ptr = elem_ptr(self, INDEX(it->point));
+
+	self->_seq.env.elem_tr->free(ptr);
+	return elem_construct(self, ptr, val);
+}
+
+static void iter_erase(ax_iter *it)
+{
+	CHECK_PARAM_NULL(it);
+	CHECK_ITERATOR_VALIDITY(it, iter_if_have_value(ax_iter_c(it)));
+
+	ax_deque *self = (ax_deque *)it->owner;
+	const ax_stuff_trait *etr = self->_seq.env.elem_tr;
+	size_t index = INDEX(it->point);
+
+	etr->free(elem_ptr(self, index));
+
+	if (index < self->size - 1 - index) {
+		for (size_t i = index; i > 0; i--)
+			elem_move(etr, elem_ptr(self, i), elem_ptr(self, i - 1));
+		drop_front(self);
+	} else {
+		for (size_t i = index; i + 1 < self->size; i++)
+			elem_move(etr, elem_ptr(self, i), elem_ptr(self, i + 1));
+		drop_back(self);
+	}
+
+	if (!ax_iter_norm(it))
+		it->point = POINT(index - 1);
+}
+
+static void one_free(ax_one *one)
+{
+	if (!one)
+		return;
+
+	ax_deque_r self_r = { .one = one };
+	ax_scope_detach(one);
+	box_clear(self_r.box);
+	ax_pool_free(self_r.deque->spare);
+	ax_pool_free(self_r.deque->map);
+	ax_pool_free(one);
+}
+
+static void any_dump(const ax_any *any, int ind)
+{
+	printf("not implemented\n");
+}
+
+static ax_any *any_copy(const ax_any *any)
+{
+	CHECK_PARAM_NULL(any);
+
+	ax_deque_cr self_r = { .any = any };
+	const ax_stuff_trait *etr = self_r.seq->env.elem_tr;
+	ax_base *base = ax_one_base(self_r.one);
+	ax_pool *pool = ax_base_pool(base);
+
+	ax_deque_r new_r = { .seq = __ax_deque_construct(base, etr) };
+	if (!new_r.one)
+		return NULL;
+
+	for (size_t i = 0; i < self_r.deque->size; i++) {
+		ax_byte *slot = slot_back(new_r.deque);
+		if (!slot)
+			goto fail;
+		if (etr->copy(pool, slot, elem_ptr(self_r.deque, i), etr->size)) {
+			ax_base_set_errno(base, AX_ERR_NOMEM);
+			drop_back(new_r.deque);
+			goto fail;
+		}
+	}
+
+	ax_scope_attach(ax_base_local(base), new_r.one);
+	return new_r.any;
+fail:
+	one_free(new_r.one);
+	return NULL;
+}
+
+static ax_any *any_move(ax_any *any)
+{
+	CHECK_PARAM_NULL(any);
+
+	ax_deque *self = (ax_deque *)any;
+	ax_base *base = ax_one_base(ax_r(deque, self).one);
+	ax_deque *dest = ax_pool_alloc(ax_base_pool(base), sizeof(ax_deque));
+	if (!dest) {
+		ax_base_set_errno(base, AX_ERR_NOMEM);
+		return NULL;
+	}
+
+	memcpy(dest, self, sizeof(ax_deque));
+	self->map = NULL;
+	self->spare = NULL;
+	self->nmap = 0;
+	self->start = 0;
+	self->size = 0;
+
+	dest->_seq.env.one.scope.macro = NULL;
+	dest->_seq.env.one.scope.micro = 0;
+	ax_scope_attach(ax_base_local(base), ax_r(deque, dest).one);
+	return ax_r(deque, dest).any;
+}
+
+static size_t box_size(const ax_box *box)
+{
+	CHECK_PARAM_NULL(box);
+
+	return ((const ax_deque *)box)->size;
+}
+
+static size_t box_maxsize(const ax_box *box)
+{
+	CHECK_PARAM_NULL(box);
+
+	const ax_deque *self = (const ax_deque *)box;
+	size_t esize = self->_seq.env.elem_tr->size;
+	return ((~(size_t)0) >> 1) / (esize ? esize : 1);
+}
+
+static ax_iter box_begin(ax_box *box)
+{
+	CHECK_PARAM_NULL(box);
+
+	ax_iter it = {
+		.owner = box,
+		.point = POINT(0),
+		.tr = &ax_deque_tr.box.iter
+	};
+	return it;
+}
+
+static ax_iter box_end(ax_box *box)
+{
+	CHECK_PARAM_NULL(box);
+
+	ax_iter it = {
+		.owner = box,
+		.point = POINT(((ax_deque *)box)->size),
+		.tr = &ax_deque_tr.box.iter
+	};
+	return it;
+}
+
+static ax_iter box_rbegin(ax_box *box)
+{
+	CHECK_PARAM_NULL(box);
+
+	ax_iter it = {
+		.owner = box,
+		.point = POINT(((ax_deque *)box)->size - 1),
+		.tr = &ax_deque_tr.box.riter
+	};
+	return it;
+}
+
+static ax_iter box_rend(ax_box *box)
+{
+	CHECK_PARAM_NULL(box);
+
+	ax_iter it = {
+		.owner = box,
+		.point = NULL,
+		.tr = &ax_deque_tr.box.riter
+	};
+	return it;
+}
+
+static const ax_stuff_trait *box_elem_tr(const ax_box *box)
+{
+	ax_deque_cr self_r = { .box = box };
+	return self_r.seq->env.elem_tr;
+}
+
+static void box_clear(ax_box *box)
+{
+	CHECK_PARAM_NULL(box);
+
+	ax_deque *self = (ax_deque *)box;
+	const ax_stuff_trait *etr = self->_seq.env.elem_tr;
+
+	if (!etr->trivial_free)
+		for (size_t i = 0; i < self->size; i++)
+			etr->free(elem_ptr(self, i));
+
+	for (size_t i = 0; i < self->nmap; i++)
+		if (self->map[i])
+			chunk_put(self, i);
+	self->size = 0;
+}
+
+static ax_fail seq_push(ax_seq *seq, const void *val)
+{
+	CHECK_PARAM_NULL(seq);
+
+	ax_deque *self = (ax_deque *)seq;
+	ax_byte *slot = slot_back(self);
+	if (!slot)
+		return ax_true;
+
+	if (elem_construct(self, slot, val)) {
+		drop_back(self);
+		return ax_true;
+	}
+	return ax_false;
+}
+
+static ax_fail seq_pop(ax_seq *seq)
+{
+	CHECK_PARAM_NULL(seq);
+
+	ax_deque *self = (ax_deque *)seq;
+	if (self->size == 0) {
+		ax_base_set_errno(ax_one_base(ax_r(deque, self).one), AX_ERR_EMPTY);
+		return ax_true;
+	}
+
+	seq->env.elem_tr->free(elem_ptr(self, self->size - 1));
+	drop_back(self);
+	return ax_false;
+}
+
+static ax_fail seq_pushf(ax_seq *seq, const void *val)
+{
+	CHECK_PARAM_NULL(seq);
+
+	ax_deque *self = (ax_deque *)seq;
+	ax_byte *slot = slot_front(self);
+	if (!slot)
+		return ax_true;
+
+	if (elem_construct(self, slot, val)) {
+		drop_front(self);
+		return ax_true;
+	}
+	return ax_false;
+}
+
+static ax_fail seq_popf(ax_seq *seq)
+{
+	CHECK_PARAM_NULL(seq);
+
+	ax_deque *self = (ax_deque *)seq;
+	if (self->size == 0) {
+		ax_base_set_errno(ax_one_base(ax_r(deque, self).one), AX_ERR_EMPTY);
+		return ax_true;
+	}
+
+	seq->env.elem_tr->free(elem_ptr(self, 0));
+	drop_front(self);
+	return ax_false;
+}
+
+static void seq_invert(ax_seq *seq)
+{
+	CHECK_PARAM_NULL(seq);
+
+	ax_deque *self = (ax_deque *)seq;
+	const ax_stuff_trait *etr = seq->env.elem_tr;
+
+	for (size_t left = 0, right = self->size; left + 1 < right; left++, right--)
+		etr->swap(elem_ptr(self, left), elem_ptr(self, right - 1), etr->size);
+}
+
+static ax_fail seq_trunc(ax_seq *seq, size_t size)
+{
+	CHECK_PARAM_NULL(seq);
+	CHECK_PARAM_VALIDITY(size, size <= box_maxsize(ax_r(seq, seq).box));
+
+	ax_deque *self = (ax_deque *)seq;
+
+	while (self->size > size)
+		(void)seq_pop(seq);
+
+	while (self->size < size)
+		if (seq_push(seq, NULL))
+			return ax_true;
+
+	return ax_false;
+}
+
+static ax_iter seq_at(const ax_seq *seq, size_t index)
+{
+	CHECK_PARAM_NULL(seq);
+	CHECK_PARAM_VALIDITY(index, index <= ((const ax_deque *)seq)->size);
+
+	ax_iter it = {
+		.owner = (void *)seq,
+		.tr = &ax_deque_tr.box.iter,
+		.point = POINT(index)
+	};
+	return it;
+}
+
+static void *seq_last(const ax_seq *seq)
+{
+	CHECK_PARAM_NULL(seq);
+
+	const ax_deque *self = (const ax_deque *)seq;
+	ax_assert(self->size > 0, "empty");
+	return elem_value(self, elem_ptr(self, self->size - 1));
+}
+
+static void *seq_first(const ax_seq *seq)
+{
+	CHECK_PARAM_NULL(seq);
+
+	const ax_deque *self = (const ax_deque *)seq;
+	ax_assert(self->size > 0, "empty");
+	return elem_value(self, elem_ptr(self, 0));
+}
+
+static ax_fail seq_insert(ax_seq *seq, ax_iter *it, const void *val)
+{
+	CHECK_PARAM_NULL(seq);
+	CHECK_PARAM_NULL(it);
+	CHECK_PARAM_VALIDITY(it, it->owner == seq && iter_if_valid(ax_iter_c(it)));
+
+	ax_deque *self = (ax_deque *)seq;
+	const ax_stuff_trait *etr = seq->env.elem_tr;
+	size_t index = INDEX(it->point) + (ax_iter_norm(it) ? 0 : 1);
+	ax_bool front = index < self->size - index;
+
+	/* Open the gap on the nearer end */
+	if (front) {
+		if (!slot_front(self))
+			return ax_true;
+		for (size_t i = 0; i < index; i++)
+			elem_move(etr, elem_ptr(self, i), elem_ptr(self, i + 1));
+	} else {
+		if (!slot_back(self))
+			return ax_true;
+		for (size_t i = self->size - 1; i > index; i--)
+			elem_move(etr, elem_ptr(self, i), elem_ptr(self, i - 1));
+	}
+
+	if (elem_construct(self, elem_ptr(self, index), val)) {
+		if (front) {
+			for (size_t i = index; i > 0; i--)
+				elem_move(etr, elem_ptr(self, i), elem_ptr(self, i - 1));
+			drop_front(self);
+		} else {
+			for (size_t i = index; i + 1 < self->size; i++)
+				elem_move(etr, elem_ptr(self, i), elem_ptr(self, i + 1));
+			drop_back(self);
+		}
+		return ax_true;
+	}
+
+	if (ax_iter_norm(it))
+		it->point = POINT(index + 1);
+	return ax_false;
+}
+
+/* Open count uninitialized slots at index, moving the elements on the nearer end */
+static ax_fail open_gap(ax_deque *self, size_t index, size_t count, ax_bool front)
+{
+	const ax_stuff_trait *etr = self->_seq.env.elem_tr;
+	for (size_t i = 0; i < count; i++) {
+		if (!(front ? slot_front(self) : slot_back(self))) {
+			while (i--)
+				front ? drop_front(self) : drop_back(self);
+			return ax_true;
+		}
+	}
+
+	if (front)
+		for (size_t i = 0; i < index; i++)
+			elem_move(etr, elem_ptr(self, i), elem_ptr(self, i + count));
+	else
+		for (size_t i = self->size - 1; i >= index + count; i--)
+			elem_move(etr, elem_ptr(self, i), elem_ptr(self, i - count));
+	return ax_false;
+}
+
+/* Close count slots at index, whose elements must be destroyed already */
+static void close_gap(ax_deque *self, size_t index, size_t count, ax_bool front)
+{
+	const ax_stuff_trait *etr = self->_seq.env.elem_tr;
+	if (front) {
+		for (size_t i = index; i > 0; i--)
+			elem_move(etr, elem_ptr(self, i - 1 + count), elem_ptr(self, i - 1));
+		while (count--)
+			drop_front(self);
+	} else {
+		for (size_t i = index + count; i < self->size; i++)
+			elem_move(etr, elem_ptr(self, i - count), elem_ptr(self, i));
+		while (count--)
+			drop_back(self);
+	}
+}
+
+/* Destroy the filled elements of a gap opened for a failed insert, then close it */
+static void undo_gap(ax_deque *self, ax_iter *it, size_t index, size_t count, size_t filled, ax_bool front)
+{
+	const ax_stuff_trait *etr = self->_seq.env.elem_tr;
+	size_t from = index + (ax_iter_norm(it) ? 0 : count - filled);
+	for (size_t i = 0; i < filled; i++)
+		etr->free(elem_ptr(self, from + i));
+	close_gap(self, index, count, front);
+}
+
+static ax_fail seq_insert_range(ax_seq *seq, ax_iter *it, const ax_citer *first, const ax_citer *last)
+{
+	CHECK_PARAM_NULL(seq);
+	CHECK_PARAM_NULL(it);
+	CHECK_PARAM_NULL(first);
+	CHECK_PARAM_NULL(last);
+	CHECK_PARAM_VALIDITY(it, it->owner == seq && iter_if_valid(ax_iter_c(it)));
+	CHECK_PARAM_VALIDITY(first, first->owner != seq && first->owner == last->owner);
+
+	ax_deque *self = (ax_deque *)seq;
+	const ax_stuff_trait *etr = seq->env.elem_tr;
+	ax_base *base = ax_one_base(ax_r(deque, self).one);
+	ax_pool *pool = ax_base_pool(base);
+
+	size_t count = 0;
+	for (ax_citer cur = *first; !ax_citer_equal(&cur, last); ax_citer_next(&cur))
+		count++;
+	if (count == 0)
+		return ax_false;
+
+	size_t index = INDEX(it->point) + (ax_iter_norm(it) ? 0 : 1);
+	ax_bool front = index < self->size - index;
+	if (open_gap(self, index, count, front))
+		return ax_true;
+
+	size_t i = 0;
+	for (ax_citer cur = *first; i < count; ax_citer_next(&cur), i++) {
+		const void *val = ax_citer_get(&cur);
+		const void *pval = etr->link ? &val : val;
+		ax_byte *dst = elem_ptr(self, index + (ax_iter_norm(it) ? i : count - 1 - i));
+		if (etr->copy(pool, dst, pval, etr->size)) {
+			ax_base_set_errno(base, AX_ERR_NOMEM);
+			undo_gap(self, it, index, count, i, front);
+			return ax_true;
+		}
+	}
+
+	if (ax_iter_norm(it))
+		it->point = POINT(index + count);
+	return ax_false;
+}
+
+static ax_fail seq_insert_arr(ax_seq *seq, ax_iter *it, const void *arr, size_t len)
+{
+	CHECK_PARAM_NULL(seq);
+	CHECK_PARAM_NULL(it);
+	CHECK_PARAM_VALIDITY(arr, arr || len == 0);
+	CHECK_PARAM_VALIDITY(it, it->owner == seq && iter_if_valid(ax_iter_c(it)));
+
+	ax_deque *self = (ax_deque *)seq;
+	const ax_stuff_trait *etr = seq->env.elem_tr;
+	ax_base *base = ax_one_base(ax_r(deque, self).one);
+	ax_pool *pool = ax_base_pool(base);
+
+	if (len == 0)
+		return ax_false;
+
+	size_t index = INDEX(it->point) + (ax_iter_norm(it) ? 0 : 1);
+	ax_bool front = index < self->size - index;
+	if (open_gap(self, index, len, front))
+		return ax_true;
+
+	for (size_t i = 0; i < len; i++) {
+		const ax_byte *src = (const ax_byte *)arr + i * etr->size;
+		ax_byte *dst = elem_ptr(self, index + (ax_iter_norm(it) ? i : len - 1 - i));
+		if (etr->copy(pool, dst, src, etr->size)) {
+			ax_base_set_errno(base, AX_ERR_NOMEM);
+			undo_gap(self, it, index, len, i, front);
+			return ax_true;
+		}
+	}
+
+	if (ax_iter_norm(it))
+		it->point = POINT(index + len);
+	return ax_false;
+}
+
+static ax_fail seq_erase_range(ax_seq *seq, ax_iter *first, ax_iter *last)
+{
+	CHECK_PARAM_NULL(seq);
+	CHECK_PARAM_NULL(first);
+	CHECK_PARAM_NULL(last);
+	CHECK_PARAM_VALIDITY(first, first->owner == seq && iter_if_valid(ax_iter_c(first)));
+	CHECK_PARAM_VALIDITY(last, last->owner == seq && iter_if_valid(ax_iter_c(last)));
+	CHECK_PARAM_VALIDITY(last, first->tr == last->tr);
+
+	ax_deque *self = (ax_deque *)seq;
+	const ax_stuff_trait *etr = seq->env.elem_tr;
+
+	/* rend is index -1, so the reverse bounds are taken one past */
+	size_t lo = ax_iter_norm(first) ? INDEX(first->point) : INDEX(last->point) + 1;
+	size_t hi = ax_iter_norm(first) ? INDEX(last->point) : INDEX(first->point) + 1;
+	CHECK_PARAM_VALIDITY(last, lo <= hi);
+	if (lo == hi)
+		return ax_false;
+
+	if (!etr->trivial_free)
+		for (size_t i = lo; i < hi; i++)
+			etr->free(elem_ptr(self, i));
+	close_gap(self, lo, hi - lo, lo < self->size - hi);
+
+	first->point = ax_iter_norm(first) ? POINT(lo) : POINT(lo - 1);
+	last->point = first->point;
+	return ax_false;
+}
+
+const ax_seq_trait ax_deque_tr =
+{
+	.box = {
+		.any = {
+			.one = {
+				.name = AX_DEQUE_NAME,
+				.free = one_free,
+			},
+			.dump = any_dump,
+			.copy = any_copy,
+			.move = any_move
+		},
+		.iter = {
+			.ctr = {
+				.norm = ax_true,
+				.type = AX_IT_RAND,
+				.move = citer_move,
+				.next = citer_next,
+				.prev = citer_prev,
+				.less = citer_less,
+				.dist = citer_dist,
+			},
+			.get = iter_get,
+			.set = iter_set,
+			.erase = iter_erase,
+		},
+		.riter = {
+			.ctr = {
+				.norm = ax_false,
+				.type = AX_IT_RAND,
+				.move = rciter_move,
+				.next = rciter_next,
+				.prev = rciter_prev,
+				.less = rciter_less,
+				.dist = rciter_dist,
+			},
+			.get = iter_get,
+			.set = iter_set,
+			.erase = iter_erase,
+		},
+
+		.size = box_size,
+		.maxsize = box_maxsize,
+		.elem_tr = box_elem_tr,
+
+		.begin = box_begin,
+		.end = box_end,
+		.rbegin = box_rbegin,
+		.rend = box_rend,
+
+		.clear = box_clear,
+	},
+	.push = seq_push,
+	.pop = seq_pop,
+	.pushf = seq_pushf,
+	.popf = seq_popf,
+	.invert = seq_invert,
+	.trunc = seq_trunc,
+	.at = seq_at,
+	.last = seq_last,
+	.first = seq_first,
+	.insert = seq_insert,
+	.insert_range = seq_insert_range,
+	.insert_arr = seq_insert_arr,
+	.erase_range = seq_erase_range,
+};
+
+ax_seq *__ax_deque_construct(ax_base *base, const ax_stuff_trait *elem_tr)
+{
+	CHECK_PARAM_NULL(base);
+	CHECK_PARAM_NULL(elem_tr);
+	CHECK_PARAM_NULL(elem_tr->copy);
+	CHECK_PARAM_NULL(elem_tr->free);
+	CHECK_PARAM_NULL(elem_tr->init);
+	CHECK_PARAM_NULL(elem_tr->move);
+	CHECK_PARAM_NULL(elem_tr->swap);
+
+	ax_deque *self = ax_pool_alloc(ax_base_pool(base), sizeof(ax_deque));
+	if (!self) {
+		ax_base_set_errno(base, AX_ERR_NOMEM);
+		return NULL;
+	}
+
+	size_t esize = elem_tr->size ? elem_tr->size : 1, shift = 0;
+	while ((esize << (shift + 1)) <= CHUNK_BYTES)
+		shift++;
+
+	ax_deque deque_init = {
+		._seq = {
+			.tr = &ax_deque_tr,
+			.env = {
+				.one = {
+					.base = base,
+					.scope = { NULL }
+				},
+				.elem_tr = elem_tr
+			},
+		},
+		.map = NULL,
+		.spare = NULL,
+		.nmap = 0,
+		.start = 0,
+		.size = 0,
+		.shift = shift
+	};
+
+	memcpy(self, &deque_init, sizeof deque_init);
+	return ax_r(deque, self).seq;
+}
+
+ax_deque_r ax_deque_create(ax_scope *scope, const ax_stuff_trait *elem_tr)
+{
+	CHECK_PARAM_NULL(scope);
+	CHECK_PARAM_NULL(elem_tr);
+
+	ax_base *base = ax_one_base(ax_r(scope, scope).one);
+	ax_deque_r self_r = { .seq = __ax_deque_construct(base, elem_tr) };
+	if (!self_r.one)
+		return self_r;
+	ax_scope_attach(scope, self_r.one);
+	return self_r;
+}
@@ -0,0 +1,537 @@
+/*
+ * Copyright (c) 2020 Li hsilin <lihsilyn@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#define _DEFAULT_SOURCE
+
+#include <axe/exec.h>
+#include <axe/base.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sched.h>
+
+#include "check.h"
+#include "waitq.h"
+
+#define CACHE_LINE 64
+#define DEQUE_INIT_CAP 64
+#define INJECT_INIT_CAP 64
+#define IDLE_ROUNDS 64
+#define GRAIN_PER_WORKER 8
+
+struct task
+{
+	ax_task_f fn;
+	void *arg;
+	ax_task_group *group;
+};
+
+/* Arrays replaced by a larger one are kept until destruction, a thief may still read them */
+struct deque_array
+{
+	struct deque_array *retired;
+	size_t mask;
+	struct task *buf[];
+};
+
+/*
+ * The owner pushes and takes at bottom, thieves take at top. Only the
+ * last task is contended, owner and thieves settle it by a CAS on top
+ */
+struct worker
+{
+	ax_exec *exec;
+	pthread_t thread;
+	ax_base *base;
+	unsigned id;
+	uint32_t seed;
+	uint64_t executed;
+	uint64_t stolen;
+	uint64_t steal_failed;
+	ax_byte pad0[CACHE_LINE];
+	int64_t top;
+	ax_byte pad1[CACHE_LINE];
+	int64_t bottom;
+	struct deque_array *array;
+	ax_byte pad2[CACHE_LINE];
+};
+
+struct ax_exec_st
+{
+	struct worker *workers;
+	unsigned nworkers;
+	unsigned started;
+	pthread_key_t key;
+	pthread_mutex_t lock;
+	struct task **inject;
+	size_t inject_head;
+	size_t inject_size;
+	size_t inject_cap;
+	uint64_t external_executed;
+	uint64_t external_stolen;
+	uint64_t external_steal_failed;
+	int stop;
+	struct waitq idle;
+};
+
+static struct deque_array *deque_array_alloc(size_t cap)
+{
+	struct deque_array *a = malloc(sizeof *a + cap * sizeof a->buf[0]);
+	if (!a)
+		return NULL;
+	a->retired = NULL;
+	a->mask = cap - 1;
+	return a;
+}
+
+static struct deque_array *deque_grow(struct worker *w, struct deque_array *a, int64_t top, int64_t bottom)
+{
+	struct deque_array *new_a = deque_array_alloc((a->mask + 1) * 2);
+	if (!new_a)
+		return NULL;
+	for (int64_t i = top; i < bottom; i++)
+		new_a->buf[i & new_a->mask] = a->buf[i & a->mask];
+	new_a->retired = a;
+	__atomic_store_n(&w->array, new_a, __ATOMIC_RELEASE);
+	return new_a;
+}
+
+static ax_fail deque_push(struct worker *w, struct task *task)
+{
+	int64_t b = __atomic_load_n(&w->bottom, __ATOMIC_RELAXED);
+	int64_t t = __atomic_load_n(&w->top, __ATOMIC_ACQUIRE);
+	struct deque_array *a = __atomic_load_n(&w->array, __ATOMIC_RELAXED);
+	if (b - t > (int64_t)a->mask) {
+		a = deque_grow(w, a, t, b);
+		if (!a)
+			return ax_true;
+	}
+	__atomic_store_n(&a->buf[b & a->mask], task, __ATOMIC_RELAXED);
+	__atomic_store_n(&w->bottom, b + 1, __ATOMIC_RELEASE);
+	return ax_false;
+}
+
+static struct task *deque_take(struct worker *w)
+{
+	int64_t b = __atomic_load_n(&w->bottom, __ATOMIC_RELAXED) - 1;
+	struct deque_array *a = __atomic_load_n(&w->array, __ATOMIC_RELAXED);
+	__atomic_store_n(&w->bottom, b, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	int64_t t = __atomic_load_n(&w->top, __ATOMIC_RELAXED);
+
+	struct task *task = NULL;
+	if (t <= b) {
+		task = __atomic_load_n(&a->buf[b & a->mask], __ATOMIC_RELAXED);
+		if (t == b) {
+			if (!__atomic_compare_exchange_n(&w->top, &t, t + 1, 0, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+				task = NULL;
+			__atomic_store_n(&w->bottom, b + 1, __ATOMIC_RELAXED);
+		}
+	} else
+		__atomic_store_n(&w->bottom, b + 1, __ATOMIC_RELAXED);
+	return task;
+}
+
+static struct task *deque_steal(struct worker *w)
+{
+	int64_t t = __atomic_load_n(&w->top, __ATOMIC_ACQUIRE);
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	int64_t b = __atomic_load_n(&w->bottom, __ATOMIC_ACQUIRE);
+	if (t >= b)
+		return NULL;
+
+	struct deque_array *a = __atomic_load_n(&w->array, __ATOMIC_ACQUIRE);
+	struct task *task = __atomic_load_n(&a->buf[t & a->mask], __ATOMIC_RELAXED);
+	if (!__atomic_compare_exchange_n(&w->top, &t, t + 1, 0, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+		return NULL;
+	return task;
+}
+
+inline static ax_bool deque_empty(struct worker *w)
+{
+	return __atomic_load_n(&w->top, __ATOMIC_ACQUIRE) >= __atomic_load_n(&w->bottom, __ATOMIC_ACQUIRE);
+}
+
+static ax_fail inject_push(ax_exec *exec, struct task *task)
+{
+	pthread_mutex_lock(&exec->lock);
+	if (exec->inject_size == exec->inject_cap) {
+		size_t cap = exec->inject_cap * 2;
+		struct task **ring = malloc(cap * sizeof *ring);
+		if (!ring) {
+			pthread_mutex_unlock(&exec->lock);
+			return ax_true;
+		}
+		for (size_t i = 0; i < exec->inject_size; i++)
+			ring[i] = exec->inject[(exec->inject_head + i) % exec->inject_cap];
+		free(exec->inject);
+		exec->inject = ring;
+		exec->inject_head = 0;
+		exec->inject_cap = cap;
+	}
+	exec->inject[(exec->inject_head + exec->inject_size) % exec->inject_cap] = task;
+	__atomic_store_n(&exec->inject_size, exec->inject_size + 1, __ATOMIC_RELEASE);
+	pthread_mutex_unlock(&exec->lock);
+	return ax_false;
+}
+
+static struct task *inject_pop(ax_exec *exec)
+{
+	if (!__atomic_load_n(&exec->inject_size, __ATOMIC_ACQUIRE))
+		return NULL;
+
+	struct task *task = NULL;
+	pthread_mutex_lock(&exec->lock);
+	if (exec->inject_size) {
+		task = exec->inject[exec->inject_head];
+		exec->inject_head = (exec->inject_head + 1) % exec->inject_cap;
+		__atomic_store_n(&exec->inject_size, exec->inject_size - 1, __ATOMIC_RELEASE);
+	}
+	pthread_mutex_unlock(&exec->lock);
+	return task;
+}
+
+static ax_bool has_work(ax_exec *exec)
+{
+	if (__atomic_load_n(&exec->inject_size, __ATOMIC_ACQUIRE))
+		return ax_true;
+	for (unsigned i = 0; i < exec->nworkers; i++)
+		if (!deque_empty(exec->workers + i))
+			return ax_true;
+	return ax_false;
+}
+
+inline static void count_steal(ax_exec *exec, struct worker *self, ax_bool stolen)
+{
+	if (self) {
+		uint64_t *counter = stolen ? &self->stolen : &self->steal_failed;
+		__atomic_store_n(counter, *counter + 1, __ATOMIC_RELAXED);
+	} else
+		__atomic_fetch_add(stolen ? &exec->external_stolen : &exec->external_steal_failed, 1, __ATOMIC_RELAXED);
+}
+
+/*
+ * self is NULL for threads outside of the pool, they only steal from the
+ * workers and leave the shared queue to them, so that the tasks they spawn
+ * from there are pushed to a worker deque
+ */
+static struct task *find_task(ax_exec *exec, struct worker *self)
+{
+	struct task *task = NULL;
+	if (self && ((task = deque_take(self)) || (task = inject_pop(exec))))
+		return task;
+
+	uint32_t seed = self ? self->seed : (uint32_t)(uintptr_t)&task >> 4;
+	unsigned start = seed % exec->nworkers;
+	for (unsigned i = 0; i < exec->nworkers; i++) {
+		struct worker *victim = exec->workers + (start + i) % exec->nworkers;
+		if (victim == self || deque_empty(victim))
+			continue;
+		task = deque_steal(victim);
+		count_steal(exec, self, !!task);
+		if (task)
+			break;
+	}
+	if (self) {
+		seed ^= seed << 13;
+		seed ^= seed >> 17;
+		seed ^= seed << 5;
+		self->seed = seed;
+	}
+	return task;
+}
+
+static void run_task(ax_exec *exec, struct worker *self, struct task *task)
+{
+	ax_task_group *group = task->group;
+	task->fn(task->arg);
+	free(task);
+	if (self)
+		__atomic_store_n(&self->executed, self->executed + 1, __ATOMIC_RELAXED);
+	else
+		__atomic_fetch_add(&exec->external_executed, 1, __ATOMIC_RELAXED);
+	__atomic_fetch_sub(&group->pending, 1, __ATOMIC_RELEASE);
+}
+
+static void *worker_main(void *arg)
+{
+	struct worker *self = arg;
+	ax_exec *exec = self->exec;
+	pthread_setspecific(exec->key, self);
+
+	for (unsigned idle = 0; ; ) {
+		struct task *task = find_task(exec, self);
+		if (task) {
+			run_task(exec, self, task);
+			idle = 0;
+			continue;
+		}
+		if (++idle < IDLE_ROUNDS) {
+			sched_yield();
+			continue;
+		}
+
+		/* Tasks pushed after prepare bump the sequence, so they are never slept through */
+		uint32_t seq = waitq_prepare(&exec->idle);
+		if (has_work(exec)) {
+			waitq_cancel(&exec->idle);
+			continue;
+		}
+		if (__atomic_load_n(&exec->stop, __ATOMIC_ACQUIRE)) {
+			waitq_cancel(&exec->idle);
+			break;
+		}
+		waitq_wait(&exec->idle, seq);
+	}
+	return NULL;
+}
+
+ax_exec *ax_exec_create(unsigned nworkers)
+{
+	if (!nworkers) {
+		long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+		nworkers = ncpu > 0 ? ncpu : 1;
+	}
+
+	ax_exec *exec = malloc(sizeof *exec);
+	if (!exec)
+		return NULL;
+	memset(exec, 0, sizeof *exec);
+	exec->nworkers = nworkers;
+	waitq_init(&exec->idle);
+
+	void *workers = NULL;
+	if (posix_memalign(&workers, CACHE_LINE, nworkers * sizeof *exec->workers))
+		goto fail_workers;
+	exec->workers = workers;
+	memset(workers, 0, nworkers * sizeof *exec->workers);
+
+	exec->inject_cap = INJECT_INIT_CAP;
+	if (!(exec->inject = malloc(exec->inject_cap * sizeof *exec->inject)))
+		goto fail_inject;
+	if (pthread_key_create(&exec->key, NULL))
+		goto fail_key;
+	if (pthread_mutex_init(&exec->lock, NULL))
+		goto fail_lock;
+
+	for (unsigned i = 0; i < nworkers; i++) {
+		struct worker *w = exec->workers + i;
+		w->exec = exec;
+		w->id = i;
+		w->seed = 2463534242u + i * 2654435761u;
+		if (!(w->array = deque_array_alloc(DEQUE_INIT_CAP)))
+			goto fail_start;
+		if (!(w->base = ax_base_create()))
+			goto fail_start;
+		if (pthread_create(&w->thread, NULL, worker_main, w))
+			goto fail_start;
+		exec->started++;
+	}
+	return exec;
+
+fail_start:
+	ax_exec_destroy(exec);
+	return NULL;
+fail_lock:
+	pthread_key_delete(exec->key);
+fail_key:
+	free(exec->inject);
+fail_inject:
+	free(exec->workers);
+fail_workers:
+	free(exec);
+	return NULL;
+}
+
+void ax_exec_destroy(ax_exec *exec)
+{
+	if (!exec)
+		return;
+
+	__atomic_store_n(&exec->stop, 1, __ATOMIC_RELEASE);
+	waitq_notify(&exec->idle);
+	for (unsigned i = 0; i < exec->started; i++)
+		pthread_join(exec->workers[i].thread, NULL);
+
+	for (unsigned i = 0; i < exec->nworkers; i++) {
+		struct worker *w = exec->workers + i;
+		for (struct deque_array *a = w->array, *next; a; a = next) {
+			next = a->retired;
+			free(a);
+		}
+		if (w->base)
+			ax_base_destroy(w->base);
+	}
+	pthread_mutex_destroy(&exec->lock);
+	pthread_key_delete(exec->key);
+	free(exec->inject);
+	free(exec->workers);
+	free(exec);
+}
+
+unsigned ax_exec_workers(const ax_exec *exec)
+{
+	CHECK_PARAM_NULL(exec);
+	return exec->nworkers;
+}
+
+int ax_exec_self(const ax_exec *exec)
+{
+	CHECK_PARAM_NULL(exec);
+	struct worker *self = pthread_getspecific(exec->key);
+	return self ? (int)self->id : -1;
+}
+
+ax_base *ax_exec_base(const ax_exec *exec)
+{
+	CHECK_PARAM_NULL(exec);
+	struct worker *self = pthread_getspecific(exec->key);
+	return self ? self->base : NULL;
+}
+
+void ax_exec_stat_get(const ax_exec *exec, ax_exec_stat *stat)
+{
+	CHECK_PARAM_NULL(exec);
+	CHECK_PARAM_NULL(stat);
+
+	stat->executed = __atomic_load_n(&exec->external_executed, __ATOMIC_RELAXED);
+	stat->stolen = __atomic_load_n(&exec->external_stolen, __ATOMIC_RELAXED);
+	stat->steal_failed = __atomic_load_n(&exec->external_steal_failed, __ATOMIC_RELAXED);
+	for (unsigned i = 0; i < exec->nworkers; i++) {
+		const struct worker *w = exec->workers + i;
+		stat->executed += __atomic_load_n(&w->executed, __ATOMIC_RELAXED);
+		stat->stolen += __atomic_load_n(&w->stolen, __ATOMIC_RELAXED);
+		stat->steal_failed += __atomic_load_n(&w->steal_failed, __ATOMIC_RELAXED);
+	}
+}
+
+void ax_task_group_init(ax_task_group *group, ax_exec *exec)
+{
+	CHECK_PARAM_NULL(group);
+	CHECK_PARAM_NULL(exec);
+	group->exec = exec;
+	group->pending = 0;
+}
+
+void ax_task_group_spawn(ax_task_group *group, ax_task_f fn, void *arg)
+{
+	CHECK_PARAM_NULL(group);
+	CHECK_PARAM_NULL(fn);
+
+	ax_exec *exec = group->exec;
+	struct task *task = malloc(sizeof *task);
+	if (!task) {
+		fn(arg);
+		return;
+	}
+	task->fn = fn;
+	task->arg = arg;
+	task->group = group;
+	__atomic_fetch_add(&group->pending, 1, __ATOMIC_RELAXED);
+
+	struct worker *self = pthread_getspecific(exec->key);
+	if ((self && !deque_push(self, task)) || !inject_push(exec, task)) {
+		waitq_notify(&exec->idle);
+		return;
+	}
+	__atomic_fetch_sub(&group->pending, 1, __ATOMIC_RELAXED);
+	free(task);
+	fn(arg);
+}
+
+void ax_task_group_wait(ax_task_group *group)
+{
+	CHECK_PARAM_NULL(group);
+
+	ax_exec *exec = group->exec;
+	struct worker *self = pthread_getspecific(exec->key);
+	while (__atomic_load_n(&group->pending, __ATOMIC_ACQUIRE)) {
+		struct task *task = find_task(exec, self);
+		if (task)
+			run_task(exec, self, task);
+		else
+			sched_yield();
+	}
+}
+
+struct range_task
+{
+	ax_task_group *group;
+	size_t begin;
+	size_t end;
+	size_t grain;
+	ax_range_f fn;
+	void *arg;
+};
+
+static void range_split(struct range_task rt);
+
+static void range_task_run(void *arg)
+{
+	struct range_task rt = *(struct range_task *)arg;
+	free(arg);
+	range_split(rt);
+}
+
+/* Hand the upper halves to other workers and run the lowest chunk */
+static void range_split(struct range_task rt)
+{
+	while (rt.end - rt.begin > rt.grain) {
+		size_t mid = rt.begin + (rt.end - rt.begin) / 2;
+		struct range_task *upper = malloc(sizeof *upper);
+		if (!upper)
+			break;
+		*upper = rt;
+		upper->begin = mid;
+		ax_task_group_spawn(rt.group, range_task_run, upper);
+		rt.end = mid;
+	}
+	rt.fn(rt.begin, rt.end, rt.arg);
+}
+
+void ax_exec_parallel_for(ax_exec *exec, size_t begin, size_t end, size_t grain, ax_range_f fn, void *arg)
+{
+	CHECK_PARAM_NULL(exec);
+	CHECK_PARAM_NULL(fn);
+
+	if (begin >= end)
+		return;
+	if (!grain)
+		grain = (end - begin) / (exec->nworkers * GRAIN_PER_WORKER);
+	if (!grain)
+		grain = 1;
+
+	ax_task_group group;
+	ax_task_group_init(&group, exec);
+	struct range_task rt = {
+		.group = &group,
+		.begin = begin,
+		.end = end,
+		.grain = grain,
+		.fn = fn,
+		.arg = arg,
+	};
+	range_split(rt);
+	ax_task_group_wait(&group);
+}
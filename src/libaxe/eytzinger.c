@@ -0,0 +1,333 @@
+/*
+ * Copyright (c) 2021 Li hsilin <lihsilyn@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#include "check.h"
+
+#include <axe/eytzinger.h>
+#include <axe/scope.h>
+#include <axe/pool.h>
+#include <axe/base.h>
+#include <axe/box.h>
+#include <axe/error.h>
+
+#include <stdint.h>
+#include <string.h>
+
+#undef free
+
+#define LINE 64
+#define BATCH 8
+
+#ifdef __GNUC__
+#define PREFETCH(_p) __builtin_prefetch(_p)
+#else
+#define PREFETCH(_p) ((void)(_p))
+#endif
+
+/*
+ * Slot k has its children at 2k and 2k + 1, slot 0 is unused and the tree
+ * is line aligned, so the LINE / size descendants of k that lie log2(LINE /
+ * size) levels down share one cache line. The first full levels of the
+ * tree are complete and walked without a bound check, the last one may be
+ * partial and is checked once.
+ */
+
+struct ax_eytzinger_st
+{
+	ax_one _one;
+	const ax_stuff_trait *etr;
+	const struct kernel_st *kern;
+	void *block;
+	ax_byte *tree;
+	size_t *rank;
+	size_t size;
+	size_t full;
+};
+
+struct kernel_st
+{
+	int type;
+	size_t (*search)(const void *tree, size_t n, size_t full, const void *key);
+	void (*search_n)(const void *tree, size_t n, size_t full, const void *keys, size_t cnt, size_t *out);
+};
+
+static void one_free(ax_one *one);
+
+static const ax_one_trait one_trait = {
+	.name = AX_EYTZINGER_NAME,
+	.free = one_free
+};
+
+/* A walk turns right on less, dropping the trailing right turns and the last left one gives the slot */
+static inline size_t walk_slot(size_t k)
+{
+#ifdef __GNUC__
+	return k >> (__builtin_ctzll(~(unsigned long long)k) + 1);
+#else
+	while (k & 1)
+		k >>= 1;
+	return k >> 1;
+#endif
+}
+
+#define DECLARE_KERNEL(_type) \
+	static size_t _type##_search(const void *tree, size_t n, size_t full, const void *key) { \
+		const _type *b = tree, v = *(const _type *)key; \
+		size_t k = 1; \
+		for (size_t i = 0; i < full; i++) { \
+			PREFETCH(b + k * (LINE / sizeof *b)); \
+			k = 2 * k + (b[k] < v); \
+		} \
+		if (k <= n) \
+			k = 2 * k + (b[k] < v); \
+		return walk_slot(k); \
+	} \
+	static void _type##_search_n(const void *tree, size_t n, size_t full, const void *keys, size_t cnt, size_t *out) { \
+		const _type *b = tree, *v = keys; \
+		for (size_t s = 0; s < cnt; s += BATCH) { \
+			size_t m = cnt - s < BATCH ? cnt - s : BATCH, k[BATCH]; \
+			for (size_t j = 0; j < m; j++) \
+				k[j] = 1; \
+			for (size_t i = 0; i < full; i++) \
+				for (size_t j = 0; j < m; j++) { \
+					PREFETCH(b + k[j] * (LINE / sizeof *b)); \
+					k[j] = 2 * k[j] + (b[k[j]] < v[s + j]); \
+				} \
+			for (size_t j = 0; j < m; j++) { \
+				if (k[j] <= n) \
+					k[j] = 2 * k[j] + (b[k[j]] < v[s + j]); \
+				out[s + j] = walk_slot(k[j]); \
+			} \
+		} \
+	}
+
+DECLARE_KERNEL(int8_t)
+DECLARE_KERNEL(int16_t)
+DECLARE_KERNEL(int32_t)
+DECLARE_KERNEL(int64_t)
+DECLARE_KERNEL(uint8_t)
+DECLARE_KERNEL(uint16_t)
+DECLARE_KERNEL(uint32_t)
+DECLARE_KERNEL(uint64_t)
+DECLARE_KERNEL(float)
+DECLARE_KERNEL(double)
+
+#define KERNEL(_st, _type) { _st, _type##_search, _type##_search_n }
+
+static const struct kernel_st kernels[] = {
+	KERNEL(AX_ST_I8, int8_t),
+	KERNEL(AX_ST_I16, int16_t),
+	KERNEL(AX_ST_I32, int32_t),
+	KERNEL(AX_ST_I64, int64_t),
+	KERNEL(AX_ST_U8, uint8_t),
+	KERNEL(AX_ST_U16, uint16_t),
+	KERNEL(AX_ST_U32, uint32_t),
+	KERNEL(AX_ST_U64, uint64_t),
+	KERNEL(AX_ST_F, float),
+	KERNEL(AX_ST_LF, double),
+};
+
+/* A trait orders like a builtin type if it shares the less function and size of it */
+static const struct kernel_st *kernel_of(const ax_stuff_trait *etr)
+{
+	if (etr->link)
+		return NULL;
+	for (size_t i = 0; i < sizeof kernels / sizeof *kernels; i++) {
+		const ax_stuff_trait *tr = ax_stuff_traits(kernels[i].type);
+		if (etr->less == tr->less && etr->size == tr->size)
+			return kernels + i;
+	}
+	return NULL;
+}
+
+static size_t generic_search(const ax_eytzinger *self, const void *key)
+{
+	const ax_stuff_trait *etr = self->etr;
+	const size_t size = etr->size;
+	const ax_byte *b = self->tree;
+	const size_t fanout = size < LINE ? LINE / size : 2;
+	size_t k = 1;
+	for (size_t i = 0; i < self->full; i++) {
+		PREFETCH(b + k * fanout * size);
+		k = 2 * k + etr->less(b + k * size, key, size);
+	}
+	if (k <= self->size)
+		k = 2 * k + etr->less(b + k * size, key, size);
+	return walk_slot(k);
+}
+
+struct fill_st
+{
+	ax_eytzinger *self;
+	ax_pool *pool;
+	ax_citer cur;
+	size_t pos;
+};
+
+/* Visit the slots in order, taking the elements of the sorted range one by one */
+static ax_fail fill(struct fill_st *f, size_t k)
+{
+	ax_eytzinger *self = f->self;
+	if (k > self->size)
+		return ax_false;
+	if (fill(f, 2 * k))
+		return ax_true;
+
+	const ax_stuff_trait *etr = self->etr;
+	const void *val = ax_citer_get(&f->cur);
+	if (etr->copy(f->pool, self->tree + k * etr->size, etr->link ? (const void *)&val : val, etr->size))
+		return ax_true;
+	self->rank[k] = f->pos++;
+	ax_citer_next(&f->cur);
+	return fill(f, 2 * k + 1);
+}
+
+static void drop(ax_eytzinger *self, size_t filled)
+{
+	const ax_stuff_trait *etr = self->etr;
+	if (!etr->trivial_free)
+		for (size_t k = 1; k <= self->size; k++)
+			if (self->rank[k] < filled)
+				etr->free(self->tree + k * etr->size);
+	ax_pool_free(self->block);
+	ax_pool_free(self->rank);
+}
+
+static void one_free(ax_one *one)
+{
+	if (!one)
+		return;
+
+	ax_eytzinger_r self_r = { .one = one };
+	ax_scope_detach(one);
+	drop(self_r.eytzinger, self_r.eytzinger->size);
+	ax_pool_free(one);
+}
+
+ax_one *__ax_eytzinger_construct(ax_base *base, const ax_citer *first, const ax_citer *last)
+{
+	CHECK_PARAM_NULL(base);
+	CHECK_PARAM_NULL(first);
+	CHECK_PARAM_NULL(last);
+	CHECK_ITER_COMPARABLE(first, last);
+	ax_assert(ax_one_is(first->owner, AX_BOX_NAME), "unsupported container type");
+
+	const ax_stuff_trait *etr = ax_box_elem_tr(first->owner);
+	ax_pool *pool = ax_base_pool(base);
+
+	size_t n = 0;
+	if (ax_citer_is(first, AX_IT_RAND))
+		n = ax_citer_dist(first, last);
+	else for (ax_citer it = *first; !ax_citer_equal(&it, last); ax_citer_next(&it))
+		n++;
+
+	size_t full = 0;
+	while (((size_t)2 << full) - 1 <= n)
+		full++;
+
+	ax_eytzinger *self = ax_pool_alloc(pool, sizeof(ax_eytzinger));
+	void *block = ax_pool_alloc(pool, (n + 1) * etr->size + LINE);
+	size_t *rank = ax_pool_alloc(pool, (n + 1) * sizeof *rank);
+	if (!self || !block || !rank) {
+		ax_pool_free(self);
+		ax_pool_free(block);
+		ax_pool_free(rank);
+		ax_base_set_errno(base, AX_ERR_NOMEM);
+		return NULL;
+	}
+
+	ax_eytzinger eytzinger_init = {
+		._one = {
+			.tr = &one_trait,
+			.env = {
+				.base = base,
+				.scope = { NULL },
+			},
+		},
+		.etr = etr,
+		.kern = kernel_of(etr),
+		.block = block,
+		.tree = (ax_byte *)(((uintptr_t)block + LINE - 1) & ~(uintptr_t)(LINE - 1)),
+		.rank = rank,
+		.size = n,
+		.full = full,
+	};
+	memcpy(self, &eytzinger_init, sizeof eytzinger_init);
+
+	/* Slots left unfilled on failure keep a rank beyond any position */
+	memset(rank, 0xFF, (n + 1) * sizeof *rank);
+	struct fill_st f = { .self = self, .pool = pool, .cur = *first };
+	if (fill(&f, 1)) {
+		drop(self, f.pos);
+		ax_pool_free(self);
+		return NULL;
+	}
+	return &self->_one;
+}
+
+ax_eytzinger_r ax_eytzinger_create(ax_scope *scope, const ax_citer *first, const ax_citer *last)
+{
+	CHECK_PARAM_NULL(scope);
+
+	ax_base *base = ax_one_base(ax_r(scope, scope).one);
+	ax_eytzinger_r self_r = { .one = __ax_eytzinger_construct(base, first, last) };
+	if (!self_r.one)
+		return self_r;
+	ax_scope_attach(scope, self_r.one);
+	return self_r;
+}
+
+size_t ax_eytzinger_size(const ax_eytzinger *eytzinger)
+{
+	CHECK_PARAM_NULL(eytzinger);
+
+	return eytzinger->size;
+}
+
+size_t ax_eytzinger_lower_bound(const ax_eytzinger *eytzinger, const void *key)
+{
+	CHECK_PARAM_NULL(eytzinger);
+
+	const void *p = eytzinger->etr->link ? (const void *)&key : key;
+	size_t k = eytzinger->kern
+		? eytzinger->kern->search(eytzinger->tree, eytzinger->size, eytzinger->full, p)
+		: generic_search(eytzinger, p);
+	return k ? eytzinger->rank[k] : eytzinger->size;
+}
+
+void ax_eytzinger_lower_bound_n(const ax_eytzinger *eytzinger, const void *keys, size_t n, size_t *out)
+{
+	CHECK_PARAM_NULL(eytzinger);
+	CHECK_PARAM_NULL(out);
+
+	if (eytzinger->kern)
+		eytzinger->kern->search_n(eytzinger->tree, eytzinger->size, eytzinger->full, keys, n, out);
+	else {
+		const ax_byte *p = keys;
+		for (size_t i = 0; i < n; i++)
+			out[i] = generic_search(eytzinger, p + i * eytzinger->etr->size);
+	}
+
+	for (size_t i = 0; i < n; i++)
+		out[i] = out[i] ? eytzinger->rank[out[i]] : eytzinger->size;
+}
@@ -35,6 +35,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <stdarg.h>
+#include <limits.h>
 #include "check.h"
 
 #undef free
@@ -52,14 +53,34 @@ struct ax_list_st
 	struct node_st *head;
 	size_t size;
 	size_t capacity;
+	struct node_st *finger;
+	size_t finger_index;
+	struct node_st **marks;
+	size_t nmark;
+	size_t mark_cap;
+	ax_bool indexed;
+	ax_bool marks_stale;
 };
 
+/* Distance between two nodes sampled by the positional index */
+#define MARK_STRIDE 32
+
+/* Forget the positions cached by seq_at after the structure changed */
+inline static void list_touch(ax_list *list)
+{
+	list->finger = NULL;
+	list->marks_stale = ax_true;
+}
+
 static ax_fail     seq_push(ax_seq *seq, const void *val);
 static ax_fail     seq_pop(ax_seq *seq);
 static ax_fail     seq_pushf(ax_seq *seq, const void *val);
 static ax_fail     seq_popf(ax_seq *seq);
 static ax_fail     seq_trunc(ax_seq *seq, size_t size);
 static ax_fail     seq_insert(ax_seq *seq, ax_iter *it, const void *val);
+static ax_fail     seq_insert_range(ax_seq *seq, ax_iter *it, const ax_citer *first, const ax_citer *last);
+static ax_fail     seq_insert_arr(ax_seq *seq, ax_iter *it, const void *arr, size_t len);
+static ax_fail     seq_erase_range(ax_seq *seq, ax_iter *first, ax_iter *last);
 static ax_iter     seq_at(const ax_seq *seq, size_t index);
 static void       *seq_last(const ax_seq *seq);
 static void       *seq_first(const ax_seq *seq);
@@ -298,7 +319,7 @@ static ax_fail iter_set(const ax_iter *it, const void *val)
 	 
 	etr->free(node->data);
 	
-	const void *pval = etr->link ? &pval : val;
+	const void *pval = etr->link ? &val : val;
 	ax_fail fail = (val != NULL)
 		? etr->copy(pool, node->data, pval, etr->size)
 		: etr->init(pool, node->data, etr->size);
@@ -317,8 +338,10 @@ static void iter_erase(ax_iter *it)
 
 	ax_list *list = ax_r(list, it->owner).list;
 	struct node_st *node = it->point;
-	//it->point = node->next; // ?
-	it->point = ax_iter_norm(it) ? node->next : node->pre; 
+	if (ax_iter_norm(it))
+		it->point = node->next == list->head ? NULL : node->next;
+	else
+		it->point = node == list->head ? NULL : node->pre;
 	if (list->size == 1)
 		list->head = NULL;
 	else {
@@ -327,6 +350,8 @@ static void iter_erase(ax_iter *it)
 		node->pre->next = node->next;
 		node->next->pre = node->pre;
 	}
+	list->size--;
+	list_touch(list);
 
 	const ax_stuff_trait *etr = list->_seq.env.elem_tr;
 	etr->free(node->data);
@@ -343,6 +368,7 @@ static void one_free(ax_one *one)
 	ax_list_r self_r = { .one = one };
 	ax_scope_detach(one);
 	box_clear(self_r.box);
+	ax_pool_free(self_r.list->marks);
 	ax_pool_free(one);
 }
 
@@ -401,6 +427,10 @@ static ax_any *any_move(ax_any *any)
 
 	self_r.list->head = NULL;
 	self_r.list->size = 0;
+	self_r.list->marks = NULL;
+	self_r.list->nmark = 0;
+	self_r.list->mark_cap = 0;
+	list_touch(self_r.list);
 
 	new->_seq.env.one.scope.macro = NULL;
 	new->_seq.env.one.scope.micro = 0;
@@ -498,6 +528,7 @@ static void box_clear(ax_box *box)
 
 	list->head = NULL;
 	list->size = 0;
+	list_touch(list);
 }
 
 static ax_fail seq_insert(ax_seq *seq, ax_iter *it, const void *val)
@@ -519,7 +550,7 @@ static ax_fail seq_insert(ax_seq *seq, ax_iter *it, const void *val)
 		return ax_true;
 	}
 
-	const void *pval = etr->link ? &pval : val;
+	const void *pval = etr->link ? &val : val;
 	ax_fail fail = (val != NULL)
 		? etr->copy(pool, node->data, pval, etr->size)
 		: etr->init(pool, node->data, etr->size);
@@ -555,7 +586,8 @@ static ax_fail seq_insert(ax_seq *seq, ax_iter *it, const void *val)
 
 
 	self_r.list->size ++;
-	
+	list_touch(self_r.list);
+
 	it->point = ax_iter_norm(it) ? node->next : node->pre;
 	return ax_false;
 }
@@ -581,6 +613,215 @@ fail:
 	return NULL;
 }
 
+/* Append node to the open chain [*head, *tail], or prepend it when reverse */
+inline static void chain_add(struct node_st **head, struct node_st **tail, struct node_st *node, ax_bool reverse)
+{
+	if (!*head) {
+		*head = *tail = node;
+		return;
+	}
+	if (reverse) {
+		node->next = *head;
+		(*head)->pre = node;
+		*head = node;
+	} else {
+		node->pre = *tail;
+		(*tail)->next = node;
+		*tail = node;
+	}
+}
+
+static void chain_free(const ax_stuff_trait *etr, struct node_st *head, struct node_st *tail)
+{
+	if (!head)
+		return;
+	for (;;) {
+		struct node_st *next = head->next;
+		etr->free(head->data);
+		ax_pool_free(head);
+		if (head == tail)
+			break;
+		head = next;
+	}
+}
+
+inline static void *node_value(const ax_stuff_trait *etr, struct node_st *node)
+{
+	return etr->link ? *(void **)node->data : node->data;
+}
+
+/* Merge two sorted chains terminated by NULL next, a goes first on ties */
+static struct node_st *chain_merge(const ax_stuff_trait *etr, struct node_st *a, struct node_st *b)
+{
+	struct node_st *head = NULL, **tail = &head;
+	while (a && b) {
+		if (etr->less(node_value(etr, b), node_value(etr, a), etr->size)) {
+			*tail = b;
+			b = b->next;
+		} else {
+			*tail = a;
+			a = a->next;
+		}
+		tail = &(*tail)->next;
+	}
+	*tail = a ? a : b;
+	return head;
+}
+
+/* Make the chain terminated by NULL next the ring of list, rebuilding pre links */
+static void chain_close(ax_list *list, struct node_st *head)
+{
+	list->head = head;
+	if (!head)
+		return;
+
+	struct node_st *node = head;
+	while (node->next) {
+		node->next->pre = node;
+		node = node->next;
+	}
+	node->next = head;
+	head->pre = node;
+}
+
+/* Link the open chain [head, tail] of count nodes in front of it, in one step */
+static void chain_splice(ax_list *list, ax_iter *it, struct node_st *head, struct node_st *tail, size_t count)
+{
+	if (list->head) {
+		struct node_st *pre, *next;
+		if (ax_iter_norm(it)) {
+			next = (it->point) ? it->point : list->head;
+			pre = next->pre;
+		} else {
+			pre = (it->point) ? it->point : list->head->pre;
+			next = pre->next;
+		}
+		head->pre = pre;
+		tail->next = next;
+		pre->next = head;
+		next->pre = tail;
+	} else {
+		head->pre = tail;
+		tail->next = head;
+	}
+
+	if ((ax_iter_norm(it) && it->point == list->head)
+			|| (!ax_iter_norm(it) && it->point == NULL))
+		list->head = head;
+
+	list->size += count;
+	list_touch(list);
+}
+
+static ax_fail seq_insert_range(ax_seq *seq, ax_iter *it, const ax_citer *first, const ax_citer *last)
+{
+	CHECK_PARAM_NULL(seq);
+	CHECK_PARAM_NULL(it);
+	CHECK_PARAM_NULL(first);
+	CHECK_PARAM_NULL(last);
+	CHECK_PARAM_VALIDITY(it, it->owner == seq && it->tr);
+	CHECK_PARAM_VALIDITY(first, first->owner != seq && first->owner == last->owner);
+
+	ax_list_r self_r = { .seq = seq };
+	const ax_stuff_trait *etr = self_r.seq->env.elem_tr;
+	ax_base *base = ax_one_base(self_r.one);
+	ax_pool *pool = ax_base_pool(base);
+
+	struct node_st *head = NULL, *tail = NULL;
+	size_t count = 0;
+	for (ax_citer cur = *first; !ax_citer_equal(&cur, last); ax_citer_next(&cur)) {
+		struct node_st *node = make_node(pool, etr, ax_citer_get(&cur));
+		if (!node) {
+			ax_base_set_errno(base, AX_ERR_NOMEM);
+			chain_free(etr, head, tail);
+			return ax_true;
+		}
+		chain_add(&head, &tail, node, !ax_iter_norm(it));
+		count++;
+	}
+
+	if (count)
+		chain_splice(self_r.list, it, head, tail, count);
+	return ax_false;
+}
+
+static ax_fail seq_insert_arr(ax_seq *seq, ax_iter *it, const void *arr, size_t len)
+{
+	CHECK_PARAM_NULL(seq);
+	CHECK_PARAM_NULL(it);
+	CHECK_PARAM_VALIDITY(arr, arr || len == 0);
+	CHECK_PARAM_VALIDITY(it, it->owner == seq && it->tr);
+
+	ax_list_r self_r = { .seq = seq };
+	const ax_stuff_trait *etr = self_r.seq->env.elem_tr;
+	ax_base *base = ax_one_base(self_r.one);
+	ax_pool *pool = ax_base_pool(base);
+
+	struct node_st *head = NULL, *tail = NULL;
+	for (size_t i = 0; i < len; i++) {
+		const void *src = (const ax_byte *)arr + i * etr->size;
+		struct node_st *node = make_node(pool, etr, etr->link ? *(void **)src : src);
+		if (!node) {
+			ax_base_set_errno(base, AX_ERR_NOMEM);
+			chain_free(etr, head, tail);
+			return ax_true;
+		}
+		chain_add(&head, &tail, node, !ax_iter_norm(it));
+	}
+
+	if (len)
+		chain_splice(self_r.list, it, head, tail, len);
+	return ax_false;
+}
+
+static ax_fail seq_erase_range(ax_seq *seq, ax_iter *first, ax_iter *last)
+{
+	CHECK_PARAM_NULL(seq);
+	CHECK_PARAM_NULL(first);
+	CHECK_PARAM_NULL(last);
+	CHECK_PARAM_VALIDITY(first, first->owner == seq && first->tr == last->tr);
+	CHECK_PARAM_VALIDITY(last, last->owner == seq);
+
+	ax_list *list = (ax_list *)seq;
+	const ax_stuff_trait *etr = seq->env.elem_tr;
+
+	if (first->point == last->point)
+		return ax_false;
+
+	/* Translate both directions into the forward node range [lo, after) */
+	struct node_st *lo, *after;
+	if (ax_iter_norm(first)) {
+		lo = first->point;
+		after = last->point ? last->point : list->head;
+	} else {
+		lo = last->point ? ((struct node_st *)last->point)->next : list->head;
+		after = ((struct node_st *)first->point)->next;
+	}
+
+	size_t count = 0;
+	struct node_st *node = lo;
+	do {
+		count++;
+		node = node->next;
+	} while (node != after);
+
+	struct node_st *tail = after->pre;
+	if (count == list->size)
+		list->head = NULL;
+	else {
+		lo->pre->next = after;
+		after->pre = lo->pre;
+		if (lo == list->head)
+			list->head = after;
+	}
+	list->size -= count;
+	list_touch(list);
+
+	chain_free(etr, lo, tail);
+	first->point = last->point;
+	return ax_false;
+}
+
 static ax_fail seq_push(ax_seq *seq, const void *val)
 {
 	CHECK_PARAM_NULL(seq);
@@ -609,7 +850,9 @@ static ax_fail seq_push(ax_seq *seq, const void *val)
 		self_r.list->head = node;
 	}
 
+	/* Positions of the other nodes are unchanged */
 	self_r.list->size ++;
+	self_r.list->marks_stale = ax_true;
 
 	return ax_false;
 }
@@ -636,6 +879,9 @@ static ax_fail seq_pop(ax_seq *seq)
 	ax_pool_free(node);
 
 	list->size --;
+	if (list->finger == node)
+		list->finger = NULL;
+	list->marks_stale = ax_true;
 	return ax_false;
 }
 
@@ -669,6 +915,8 @@ static ax_fail seq_pushf(ax_seq *seq, const void *val)
 	}
 
 	self_r.list->size ++;
+	self_r.list->finger_index ++;
+	self_r.list->marks_stale = ax_true;
 
 	return ax_false;
 }
@@ -696,6 +944,10 @@ static ax_fail seq_popf(ax_seq *seq)
 	ax_pool_free(node);
 
 	list->size --;
+	if (list->finger == node)
+		list->finger = NULL;
+	list->finger_index --;
+	list->marks_stale = ax_true;
 	return ax_false;
 }
 
@@ -723,6 +975,7 @@ static void seq_invert(ax_seq *seq)
 	list->head->next = new_head;
 
 	list->head = new_head;
+	list_touch(list);
 }
 
 static ax_fail seq_trunc(ax_seq *seq, size_t size)
@@ -753,29 +1006,84 @@ static ax_fail seq_trunc(ax_seq *seq, size_t size)
 	return ax_false;
 }
 
-static ax_iter seq_at(const ax_seq *seq, size_t index) /* Could optimized to mean time O(n/4) */
+/* Sample every MARK_STRIDE-th node, the index is left stale on allocation failure */
+static void marks_build(ax_list *list)
+{
+	size_t nmark = (list->size + MARK_STRIDE - 1) / MARK_STRIDE;
+	if (nmark > list->mark_cap) {
+		ax_pool *pool = ax_base_pool(ax_one_base(ax_r(list, list).one));
+		size_t cap = nmark + nmark / 2;
+		ax_pool_free(list->marks);
+		list->marks = ax_pool_alloc(pool, cap * sizeof *list->marks);
+		list->mark_cap = list->marks ? cap : 0;
+		if (!list->marks)
+			return;
+	}
+
+	struct node_st *node = list->head;
+	for (size_t i = 0; i < list->size; i++, node = node->next)
+		if (i % MARK_STRIDE == 0)
+			list->marks[i / MARK_STRIDE] = node;
+	list->nmark = nmark;
+	list->marks_stale = ax_false;
+}
+
+/* Walk to index from the nearest of head, tail, the finger and the sampled nodes */
+static struct node_st *node_at(ax_list *list, size_t index)
+{
+	struct node_st *node = list->head;
+	size_t pos = 0, dist = index;
+
+	if (list->size - 1 - index < dist) {
+		node = list->head->pre;
+		pos = list->size - 1;
+		dist = pos - index;
+	}
+
+	if (list->finger) {
+		size_t d = list->finger_index > index
+			? list->finger_index - index
+			: index - list->finger_index;
+		if (d < dist) {
+			node = list->finger;
+			pos = list->finger_index;
+			dist = d;
+		}
+	}
+
+	if (list->indexed && dist > MARK_STRIDE / 2) {
+		if (list->marks_stale)
+			marks_build(list);
+		if (!list->marks_stale) {
+			size_t m = (index + MARK_STRIDE / 2) / MARK_STRIDE;
+			if (m >= list->nmark)
+				m = list->nmark - 1;
+			node = list->marks[m];
+			pos = m * MARK_STRIDE;
+		}
+	}
+
+	for (; pos < index; pos++)
+		node = node->next;
+	for (; pos > index; pos--)
+		node = node->pre;
+
+	list->finger = node;
+	list->finger_index = index;
+	return node;
+}
+
+static ax_iter seq_at(const ax_seq *seq, size_t index)
 {
 	CHECK_PARAM_NULL(seq);
 	CHECK_PARAM_VALIDITY(index, index <= ax_box_size(ax_cr(seq, seq).box));
 
 	ax_list *list = (ax_list *)seq;
-	struct node_st *cur = list->head;
 	ax_iter it = {
 		.owner = (void *)seq,
 		.tr = &ax_list_tr.box.iter,
-		.point = cur
+		.point = index < list->size ? node_at(list, index) : NULL
 	};
-
-	if (index == 0)
-		return it;
-
-	do {
-		index --;
-		cur = cur->next;
-	} while (index && cur != list->head);
-
-	ax_assert(index == 0, "index boundary exceed");
-	it.point = cur;
 	return it;
 }
 
@@ -869,7 +1177,10 @@ const ax_seq_trait ax_list_tr =
 	.insert = seq_insert,
 	.at = seq_at,
 	.first = seq_first,
-	.last = seq_last
+	.last = seq_last,
+	.insert_range = seq_insert_range,
+	.insert_arr = seq_insert_arr,
+	.erase_range = seq_erase_range,
 };
 
 
@@ -900,7 +1211,13 @@ ax_seq* __ax_list_construct(ax_base *base,const ax_stuff_trait *elem_tr)
 			},
 		},
 		.head = NULL,
-		.size = 0
+		.size = 0,
+		.finger = NULL,
+		.marks = NULL,
+		.nmark = 0,
+		.mark_cap = 0,
+		.indexed = ax_false,
+		.marks_stale = ax_true
 	};
 	memcpy(self_r.list, &list_init, sizeof list_init);
 	return self_r.seq;
@@ -929,3 +1246,126 @@ ax_list_r ax_list_init(ax_scope *scope, const char *fmt, ...)
 	return self_r;
 }
 
+
+void ax_list_sort(ax_list *list)
+{
+	CHECK_PARAM_NULL(list);
+	CHECK_PARAM_NULL(list->_seq.env.elem_tr->less);
+
+	const ax_stuff_trait *etr = list->_seq.env.elem_tr;
+	if (list->size < 2)
+		return;
+
+	/* Bottom-up, bin[i] is either empty or a sorted run of 2^i nodes */
+	struct node_st *bin[sizeof(size_t) * CHAR_BIT] = { NULL }, *run;
+	size_t nbin = 0;
+
+	list->head->pre->next = NULL;
+	struct node_st *cur = list->head;
+	while (cur) {
+		run = cur;
+		cur = cur->next;
+		run->next = NULL;
+
+		size_t i;
+		for (i = 0; i < nbin && bin[i]; i++) {
+			run = chain_merge(etr, bin[i], run);
+			bin[i] = NULL;
+		}
+		if (i == nbin)
+			nbin++;
+		bin[i] = run;
+	}
+
+	run = NULL;
+	for (size_t i = 0; i < nbin; i++)
+		if (bin[i])
+			run = run ? chain_merge(etr, bin[i], run) : bin[i];
+	chain_close(list, run);
+	list_touch(list);
+}
+
+void ax_list_splice(ax_iter *it, ax_list *src, ax_iter *first, ax_iter *last)
+{
+	CHECK_PARAM_NULL(it);
+	CHECK_PARAM_NULL(src);
+	CHECK_PARAM_NULL(first);
+	CHECK_PARAM_NULL(last);
+	CHECK_PARAM_VALIDITY(it, it->owner && it->tr);
+	CHECK_PARAM_VALIDITY(first, first->owner == src && ax_iter_norm(first));
+	CHECK_PARAM_VALIDITY(last, last->owner == src && ax_iter_norm(last));
+
+	ax_list *dst = (ax_list *)it->owner;
+	CHECK_PARAM_VALIDITY(src, dst->_seq.env.elem_tr == src->_seq.env.elem_tr);
+	CHECK_PARAM_VALIDITY(src, ax_one_base(ax_r(list, dst).one) == ax_one_base(ax_r(list, src).one));
+
+	if (first->point == last->point)
+		return;
+
+	struct node_st *lo = first->point;
+	struct node_st *after = last->point ? last->point : src->head;
+	struct node_st *tail = after->pre;
+
+	/* Only a partial range taken from another list needs to be counted */
+	ax_bool whole = lo == src->head && !last->point;
+	size_t count = 0;
+	if (dst == src) {
+		if (whole)
+			return;
+	} else if (whole)
+		count = src->size;
+	else
+		for (struct node_st *node = lo; node != after; node = node->next)
+			count++;
+
+	if (count == src->size)
+		src->head = NULL;
+	else {
+		lo->pre->next = after;
+		after->pre = lo->pre;
+		if (lo == src->head)
+			src->head = after;
+	}
+	src->size -= count;
+	list_touch(src);
+
+	chain_splice(dst, it, lo, tail, count);
+	first->point = last->point;
+}
+
+void ax_list_merge(ax_list *list, ax_list *src)
+{
+	CHECK_PARAM_NULL(list);
+	CHECK_PARAM_NULL(src);
+	CHECK_PARAM_NULL(list->_seq.env.elem_tr->less);
+	CHECK_PARAM_VALIDITY(src, list->_seq.env.elem_tr == src->_seq.env.elem_tr);
+	CHECK_PARAM_VALIDITY(src, ax_one_base(ax_r(list, list).one) == ax_one_base(ax_r(list, src).one));
+
+	if (list == src || !src->head)
+		return;
+
+	if (list->head)
+		list->head->pre->next = NULL;
+	src->head->pre->next = NULL;
+	chain_close(list, chain_merge(list->_seq.env.elem_tr, list->head, src->head));
+
+	list->size += src->size;
+	list_touch(list);
+	src->head = NULL;
+	src->size = 0;
+	list_touch(src);
+}
+
+void ax_list_set_indexed(ax_list *list, ax_bool indexed)
+{
+	CHECK_PARAM_NULL(list);
+
+	list->indexed = indexed;
+	if (!indexed) {
+		ax_pool_free(list->marks);
+		list->marks = NULL;
+		list->nmark = 0;
+		list->mark_cap = 0;
+		list->marks_stale = ax_true;
+	}
+}
@@ -0,0 +1,353 @@
+/*
+ * Copyright (c) 2020 Li hsilin <lihsilyn@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#define _DEFAULT_SOURCE
+
+#include <axe/mpmc.h>
+#include <axe/tube.h>
+#include <axe/base.h>
+#include <axe/pool.h>
+#include <axe/scope.h>
+#include <axe/any.h>
+#include <axe/error.h>
+
+#include <string.h>
+#include <stdint.h>
+
+#include "check.h"
+#include "waitq.h"
+
+#undef free
+
+#define CACHE_LINE 64
+#define MIN_CAPACITY 2
+
+/*
+ * Every cell starts with a sequence number. A cell is free for the producer
+ * claiming position pos when its sequence equals pos, and holds the element
+ * for the consumer claiming pos when it equals pos + 1. Popping sets it to
+ * pos + capacity, which frees the cell for the next lap. Claiming a range
+ * of positions is a single CAS on enq_pos or deq_pos after all its cells
+ * have been seen in the right state.
+ */
+struct ax_mpmc_st
+{
+	ax_tube tube;
+	ax_byte *cells;
+	size_t mask;
+	size_t stride;
+	ax_byte pad0[CACHE_LINE];
+	size_t enq_pos;
+	struct waitq push_wq;
+	ax_byte pad1[CACHE_LINE];
+	size_t deq_pos;
+	struct waitq pop_wq;
+	ax_byte pad2[CACHE_LINE];
+};
+
+static ax_fail tube_push(ax_tube *tube, const void *val);
+static void    tube_pop(ax_tube *tube);
+static size_t  tube_size(const ax_tube *tube);
+static void   *tube_prime(const ax_tube *tube);
+static ax_any *any_copy(const ax_any *any);
+static ax_any *any_move(ax_any *any);
+static void    one_free(ax_one *one);
+
+const ax_tube_trait ax_mpmc_tr =
+{
+		.any = {
+			.one = {
+				.name = AX_MPMC_NAME,
+				.free = one_free,
+			},
+			.copy = any_copy,
+			.move = any_move
+		},
+		.push = tube_push,
+		.pop = tube_pop,
+		.size = tube_size,
+		.prime = tube_prime
+};
+
+inline static size_t *cell_seq(const ax_mpmc *self, size_t pos)
+{
+	return (size_t *)(self->cells + (pos & self->mask) * self->stride);
+}
+
+inline static ax_byte *cell_data(const ax_mpmc *self, size_t pos)
+{
+	return self->cells + (pos & self->mask) * self->stride + sizeof(size_t);
+}
+
+/*
+ * Claim up to n consecutive positions on counter whose cells carry
+ * pos + lag, returns the first position in *pos and the count
+ */
+static size_t claim(ax_mpmc *self, size_t *counter, size_t lag, size_t n, size_t *first)
+{
+	if (!n)
+		return 0;
+
+	size_t pos = __atomic_load_n(counter, __ATOMIC_RELAXED);
+	for (;;) {
+		size_t k = 0;
+		while (k < n && __atomic_load_n(cell_seq(self, pos + k), __ATOMIC_ACQUIRE) == pos + k + lag)
+			k++;
+
+		if (k == 0) {
+			size_t seq = __atomic_load_n(cell_seq(self, pos), __ATOMIC_ACQUIRE);
+			if ((intptr_t)(seq - (pos + lag)) < 0)
+				return 0;
+			if (seq != pos + lag)
+				pos = __atomic_load_n(counter, __ATOMIC_RELAXED);
+			continue;
+		}
+
+		if (__atomic_compare_exchange_n(counter, &pos, pos + k, ax_true,
+					__ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+			*first = pos;
+			return k;
+		}
+	}
+}
+
+size_t ax_mpmc_push_n(ax_mpmc *mpmc, const void *arr, size_t n)
+{
+	CHECK_PARAM_NULL(mpmc);
+	CHECK_PARAM_NULL(arr);
+
+	size_t pos;
+	n = claim(mpmc, &mpmc->enq_pos, 0, n, &pos);
+	if (!n)
+		return 0;
+
+	size_t esize = mpmc->tube.env.elem_tr->size;
+	const ax_byte *src = arr;
+	for (size_t i = 0; i < n; i++) {
+		memcpy(cell_data(mpmc, pos + i), src + i * esize, esize);
+		__atomic_store_n(cell_seq(mpmc, pos + i), pos + i + 1, __ATOMIC_RELEASE);
+	}
+	waitq_notify(&mpmc->pop_wq);
+	return n;
+}
+
+size_t ax_mpmc_pop_n(ax_mpmc *mpmc, void *arr, size_t n)
+{
+	CHECK_PARAM_NULL(mpmc);
+
+	size_t pos;
+	n = claim(mpmc, &mpmc->deq_pos, 1, n, &pos);
+	if (!n)
+		return 0;
+
+	size_t esize = mpmc->tube.env.elem_tr->size;
+	ax_byte *dst = arr;
+	for (size_t i = 0; i < n; i++) {
+		if (dst)
+			memcpy(dst + i * esize, cell_data(mpmc, pos + i), esize);
+		__atomic_store_n(cell_seq(mpmc, pos + i), pos + i + mpmc->mask + 1, __ATOMIC_RELEASE);
+	}
+	waitq_notify(&mpmc->push_wq);
+	return n;
+}
+
+ax_fail ax_mpmc_try_push(ax_mpmc *mpmc, const void *val)
+{
+	return ax_mpmc_push_n(mpmc, val, 1) == 0;
+}
+
+ax_fail ax_mpmc_try_pop(ax_mpmc *mpmc, void *out)
+{
+	return ax_mpmc_pop_n(mpmc, out, 1) == 0;
+}
+
+void ax_mpmc_push_wait(ax_mpmc *mpmc, const void *val)
+{
+	for (int i = 0; i < WAITQ_SPIN; i++)
+		if (!ax_mpmc_try_push(mpmc, val))
+			return;
+
+	for (;;) {
+		uint32_t seq = waitq_prepare(&mpmc->push_wq);
+		if (!ax_mpmc_try_push(mpmc, val)) {
+			waitq_cancel(&mpmc->push_wq);
+			return;
+		}
+		waitq_wait(&mpmc->push_wq, seq);
+	}
+}
+
+void ax_mpmc_pop_wait(ax_mpmc *mpmc, void *out)
+{
+	for (int i = 0; i < WAITQ_SPIN; i++)
+		if (!ax_mpmc_try_pop(mpmc, out))
+			return;
+
+	for (;;) {
+		uint32_t seq = waitq_prepare(&mpmc->pop_wq);
+		if (!ax_mpmc_try_pop(mpmc, out)) {
+			waitq_cancel(&mpmc->pop_wq);
+			return;
+		}
+		waitq_wait(&mpmc->pop_wq, seq);
+	}
+}
+
+size_t ax_mpmc_capacity(const ax_mpmc *mpmc)
+{
+	CHECK_PARAM_NULL(mpmc);
+
+	return mpmc->mask + 1;
+}
+
+static ax_fail tube_push(ax_tube *tube, const void *val)
+{
+	CHECK_PARAM_NULL(tube);
+
+	return ax_mpmc_try_push((ax_mpmc *)tube, val);
+}
+
+static void tube_pop(ax_tube *tube)
+{
+	CHECK_PARAM_NULL(tube);
+
+	ax_mpmc_try_pop((ax_mpmc *)tube, NULL);
+}
+
+static size_t tube_size(const ax_tube *tube)
+{
+	CHECK_PARAM_NULL(tube);
+
+	ax_mpmc_cr self_r = { .tube = tube };
+	size_t deq = __atomic_load_n(&self_r.mpmc->deq_pos, __ATOMIC_ACQUIRE);
+	size_t enq = __atomic_load_n(&self_r.mpmc->enq_pos, __ATOMIC_ACQUIRE);
+	return (intptr_t)(enq - deq) > 0 ? enq - deq : 0;
+}
+
+static void *tube_prime(const ax_tube *tube)
+{
+	CHECK_PARAM_NULL(tube);
+
+	ax_mpmc_cr self_r = { .tube = tube };
+	size_t pos = __atomic_load_n(&self_r.mpmc->deq_pos, __ATOMIC_RELAXED);
+	if (__atomic_load_n(cell_seq(self_r.mpmc, pos), __ATOMIC_ACQUIRE) != pos + 1)
+		return NULL;
+	return cell_data(self_r.mpmc, pos);
+}
+
+static ax_any *any_copy(const ax_any *any)
+{
+	CHECK_PARAM_NULL(any);
+
+	ax_base_set_errno(ax_one_base(ax_cr(any, any).one), AX_ERR_UNSUP);
+	return NULL;
+}
+
+static ax_any *any_move(ax_any *any)
+{
+	CHECK_PARAM_NULL(any);
+
+	ax_base_set_errno(ax_one_base(ax_r(any, any).one), AX_ERR_UNSUP);
+	return NULL;
+}
+
+static void one_free(ax_one *one)
+{
+	if (!one)
+		return;
+
+	ax_mpmc_r self_r = { .one = one };
+	ax_scope_detach(one);
+	ax_pool_free(self_r.mpmc->cells);
+	ax_pool_free(one);
+}
+
+ax_tube *__ax_mpmc_construct(ax_base *base, const ax_stuff_trait *elem_tr, size_t capacity)
+{
+	CHECK_PARAM_NULL(base);
+	CHECK_PARAM_NULL(elem_tr);
+	CHECK_PARAM_VALIDITY(elem_tr, elem_tr->trivial_copy && elem_tr->trivial_free);
+	CHECK_PARAM_VALIDITY(capacity, capacity > 0);
+
+	ax_pool *pool = ax_base_pool(base);
+	size_t stride = (sizeof(size_t) + elem_tr->size + sizeof(size_t) - 1)
+		/ sizeof(size_t) * sizeof(size_t);
+	size_t cap = MIN_CAPACITY;
+	while (cap < capacity) {
+		if (cap > ((~(size_t)0) >> 2) / stride) {
+			ax_base_set_errno(base, AX_ERR_FULL);
+			return NULL;
+		}
+		cap <<= 1;
+	}
+
+	ax_mpmc *self = ax_pool_alloc(pool, sizeof(ax_mpmc));
+	if (!self) {
+		ax_base_set_errno(base, AX_ERR_NOMEM);
+		return NULL;
+	}
+
+	ax_byte *cells = ax_pool_alloc(pool, cap * stride);
+	if (!cells) {
+		ax_base_set_errno(base, AX_ERR_NOMEM);
+		ax_pool_free(self);
+		return NULL;
+	}
+
+	ax_mpmc mpmc_init = {
+		.tube = {
+			.tr = &ax_mpmc_tr,
+			.env = {
+				.one = {
+					.base = base,
+					.scope = { NULL }
+				},
+				.elem_tr = elem_tr
+			},
+		},
+		.cells = cells,
+		.mask = cap - 1,
+		.stride = stride,
+		.enq_pos = 0,
+		.deq_pos = 0,
+	};
+	waitq_init(&mpmc_init.push_wq);
+	waitq_init(&mpmc_init.pop_wq);
+
+	memcpy(self, &mpmc_init, sizeof mpmc_init);
+	for (size_t i = 0; i < cap; i++)
+		*cell_seq(self, i) = i;
+	return &self->tube;
+}
+
+ax_mpmc_r ax_mpmc_create(ax_scope *scope, const ax_stuff_trait *elem_tr, size_t capacity)
+{
+	CHECK_PARAM_NULL(scope);
+	CHECK_PARAM_NULL(elem_tr);
+
+	ax_base *base = ax_one_base(ax_r(scope, scope).one);
+	ax_mpmc_r self_r = { .tube = __ax_mpmc_construct(base, elem_tr, capacity) };
+	if (!self_r.one)
+		return self_r;
+	ax_scope_attach(scope, self_r.one);
+	return self_r;
+}
@@ -1,5 +1,7 @@
 #include <axe/oper.h>
+#include <axe/pred.h>
 #include <axe/def.h>
+#include <stddef.h>
 
 #define ptr_add(_type, _in1, _in2, _out) (*(_type*)_out = *(_type*)_in1 + *(_type*)_in2)
 #define ptr_sub(_type, _in1, _in2, _out) (*(_type*)_out = *(_type*)_in1 - *(_type*)_in2)
@@ -158,3 +160,261 @@ const ax_operset *ax_oper_for(int type)
 	}
 }
 
+/*
+ * Batch kernels are plain loops left to the vectorizer, oper.o is built
+ * with -ftree-vectorize so that they get SSE2 code on x86-64. On x86 a
+ * second copy is compiled for AVX2 and picked at run time
+ */
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define BATCH_AVX2 __attribute__((target("avx2")))
+#endif
+
+#define val_add(_x, _y) ((_x) + (_y))
+#define val_sub(_x, _y) ((_x) - (_y))
+#define val_mul(_x, _y) ((_x) * (_y))
+#define val_div(_x, _y) ((_x) / (_y))
+#define val_mod(_x, _y) ((_x) % (_y))
+
+#define val_and(_x, _y) ((_x) && (_y))
+#define val_or(_x, _y) ((_x) || (_y))
+#define val_not(_x) (!(_x))
+
+#define val_bit_and(_x, _y) ((_x) & (_y))
+#define val_bit_or(_x, _y) ((_x) | (_y))
+#define val_bit_xor(_x, _y) ((_x) ^ (_y))
+#define val_bit_not(_x) (~(_x))
+
+#define val_gt(_x, _y) ((_x) > (_y))
+#define val_ge(_x, _y) ((_x) >= (_y))
+#define val_lt(_x, _y) ((_x) < (_y))
+#define val_le(_x, _y) ((_x) <= (_y))
+#define val_eq(_x, _y) ((_x) == (_y))
+#define val_ne(_x, _y) ((_x) != (_y))
+
+#define DECLARE_UNARY_BATCH(_type, _op, _otype, _sfx, _attr) \
+	_attr static void _type##_op##_n##_sfx(void *out, const void *in, size_t n, void *arg) { \
+		_otype *o = out; \
+		const _type *a = in; \
+		for (size_t i = 0; i < n; i++) \
+			o[i] = val##_op(a[i]); \
+	}
+
+#define DECLARE_BINARY_BATCH(_type, _op, _otype, _sfx, _attr) \
+	_attr static void _type##_op##_n##_sfx(void *out, const void *in1, const void *in2, size_t n, int bind, void *arg) { \
+		_otype *o = out; \
+		const _type *a = in1, *b = in2; \
+		if (bind & AX_BIND_1) { \
+			const _type x = *a; \
+			for (size_t i = 0; i < n; i++) \
+				o[i] = val##_op(x, b[i]); \
+		} else if (bind & AX_BIND_2) { \
+			const _type y = *b; \
+			for (size_t i = 0; i < n; i++) \
+				o[i] = val##_op(a[i], y); \
+		} else { \
+			for (size_t i = 0; i < n; i++) \
+				o[i] = val##_op(a[i], b[i]); \
+		} \
+	}
+
+#define DECLARE_FLOAT_BATCH_FUNCS(_type, _sfx, _attr) \
+	DECLARE_BINARY_BATCH(_type, _add, _type, _sfx, _attr) \
+	DECLARE_BINARY_BATCH(_type, _sub, _type, _sfx, _attr) \
+	DECLARE_BINARY_BATCH(_type, _mul, _type, _sfx, _attr) \
+	DECLARE_BINARY_BATCH(_type, _div, _type, _sfx, _attr) \
+	DECLARE_BINARY_BATCH(_type, _gt, ax_bool, _sfx, _attr) \
+	DECLARE_BINARY_BATCH(_type, _ge, ax_bool, _sfx, _attr) \
+	DECLARE_BINARY_BATCH(_type, _lt, ax_bool, _sfx, _attr) \
+	DECLARE_BINARY_BATCH(_type, _le, ax_bool, _sfx, _attr) \
+	DECLARE_BINARY_BATCH(_type, _eq, ax_bool, _sfx, _attr) \
+	DECLARE_BINARY_BATCH(_type, _ne, ax_bool, _sfx, _attr)
+
+#define DECLARE_INT_BATCH_FUNCS(_type, _sfx, _attr) \
+	DECLARE_FLOAT_BATCH_FUNCS(_type, _sfx, _attr) \
+	DECLARE_BINARY_BATCH(_type, _mod, _type, _sfx, _attr) \
+	DECLARE_BINARY_BATCH(_type, _and, ax_bool, _sfx, _attr) \
+	DECLARE_BINARY_BATCH(_type, _or, ax_bool, _sfx, _attr) \
+	DECLARE_UNARY_BATCH(_type, _not, ax_bool, _sfx, _attr) \
+	DECLARE_BINARY_BATCH(_type, _bit_and, _type, _sfx, _attr) \
+	DECLARE_BINARY_BATCH(_type, _bit_or, _type, _sfx, _attr) \
+	DECLARE_BINARY_BATCH(_type, _bit_xor, _type, _sfx, _attr) \
+	DECLARE_UNARY_BATCH(_type, _bit_not, _type, _sfx, _attr)
+
+#define DECLARE_INT_BATCH_OPERSET(_type, _sfx, _attr) \
+	DECLARE_INT_BATCH_FUNCS(_type, _sfx, _attr) \
+	static const ax_batch_operset batch_operset_##_type##_sfx = \
+	{ \
+		.add = _type##_add_n##_sfx, \
+		.sub = _type##_sub_n##_sfx, \
+		.mul = _type##_mul_n##_sfx, \
+		.div = _type##_div_n##_sfx, \
+		.mod = _type##_mod_n##_sfx, \
+		.and = _type##_and_n##_sfx, \
+		.or  = _type##_or_n##_sfx, \
+		.not = _type##_not_n##_sfx, \
+		.bit_and = _type##_bit_and_n##_sfx, \
+		.bit_or  = _type##_bit_or_n##_sfx, \
+		.bit_not = _type##_bit_not_n##_sfx, \
+		.bit_xor = _type##_bit_xor_n##_sfx, \
+		.gt  = _type##_gt_n##_sfx, \
+		.ge  = _type##_ge_n##_sfx, \
+		.lt  = _type##_lt_n##_sfx, \
+		.le  = _type##_le_n##_sfx, \
+		.eq  = _type##_eq_n##_sfx, \
+		.ne  = _type##_ne_n##_sfx, \
+	};
+
+#define DECLARE_FLOAT_BATCH_OPERSET(_type, _sfx, _attr) \
+	DECLARE_FLOAT_BATCH_FUNCS(_type, _sfx, _attr) \
+	static const ax_batch_operset batch_operset_##_type##_sfx = \
+	{ \
+		.add = _type##_add_n##_sfx, \
+		.sub = _type##_sub_n##_sfx, \
+		.mul = _type##_mul_n##_sfx, \
+		.div = _type##_div_n##_sfx, \
+		.gt  = _type##_gt_n##_sfx, \
+		.ge  = _type##_ge_n##_sfx, \
+		.lt  = _type##_lt_n##_sfx, \
+		.le  = _type##_le_n##_sfx, \
+		.eq  = _type##_eq_n##_sfx, \
+		.ne  = _type##_ne_n##_sfx, \
+	};
+
+#define DECLARE_BATCH_OPERSETS(_sfx, _attr) \
+	DECLARE_INT_BATCH_OPERSET(int8_t, _sfx, _attr) \
+	DECLARE_INT_BATCH_OPERSET(int16_t, _sfx, _attr) \
+	DECLARE_INT_BATCH_OPERSET(int32_t, _sfx, _attr) \
+	DECLARE_INT_BATCH_OPERSET(int64_t, _sfx, _attr) \
+	DECLARE_INT_BATCH_OPERSET(uint8_t, _sfx, _attr) \
+	DECLARE_INT_BATCH_OPERSET(uint16_t, _sfx, _attr) \
+	DECLARE_INT_BATCH_OPERSET(uint32_t, _sfx, _attr) \
+	DECLARE_INT_BATCH_OPERSET(uint64_t, _sfx, _attr) \
+	DECLARE_INT_BATCH_OPERSET(size_t, _sfx, _attr) \
+	DECLARE_FLOAT_BATCH_OPERSET(float, _sfx, _attr) \
+	DECLARE_FLOAT_BATCH_OPERSET(double, _sfx, _attr)
+
+#define BATCH_OPERSET_CASES(_sfx) \
+		case AX_ST_I8:  return &batch_operset_int8_t##_sfx; \
+		case AX_ST_I16: return &batch_operset_int16_t##_sfx; \
+		case AX_ST_I32: return &batch_operset_int32_t##_sfx; \
+		case AX_ST_I64: return &batch_operset_int64_t##_sfx; \
+		case AX_ST_U8:  return &batch_operset_uint8_t##_sfx; \
+		case AX_ST_U16: return &batch_operset_uint16_t##_sfx; \
+		case AX_ST_U32: return &batch_operset_uint32_t##_sfx; \
+		case AX_ST_U64: return &batch_operset_uint64_t##_sfx; \
+		case AX_ST_Z:   return &batch_operset_size_t##_sfx; \
+		case AX_ST_F:   return &batch_operset_float##_sfx; \
+		case AX_ST_LF:  return &batch_operset_double##_sfx;
+
+DECLARE_BATCH_OPERSETS(, )
+
+#ifdef BATCH_AVX2
+DECLARE_BATCH_OPERSETS(_avx2, BATCH_AVX2)
+#endif
+
+const ax_batch_operset *ax_oper_batch_for(int type)
+{
+#ifdef BATCH_AVX2
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2"))
+		switch (type) {
+			BATCH_OPERSET_CASES(_avx2)
+			default: return NULL;
+		}
+#endif
+	switch (type) {
+		BATCH_OPERSET_CASES()
+		default: return NULL;
+	}
+}
+
+static const struct { int type; size_t size; } oper_types[] = {
+	{ AX_ST_I8, sizeof(int8_t) },
+	{ AX_ST_I16, sizeof(int16_t) },
+	{ AX_ST_I32, sizeof(int32_t) },
+	{ AX_ST_I64, sizeof(int64_t) },
+	{ AX_ST_U8, sizeof(uint8_t) },
+	{ AX_ST_U16, sizeof(uint16_t) },
+	{ AX_ST_U32, sizeof(uint32_t) },
+	{ AX_ST_U64, sizeof(uint64_t) },
+	{ AX_ST_Z, sizeof(size_t) },
+	{ AX_ST_F, sizeof(float) },
+	{ AX_ST_LF, sizeof(double) },
+};
+
+/* Offsets of the same member in ax_operset and ax_batch_operset, boolean for members yielding ax_bool */
+struct oper_member
+{
+	size_t offset;
+	size_t batch_offset;
+	ax_bool boolean;
+};
+
+#define OPER_MEMBER(_name, _boolean) { offsetof(ax_operset, _name), offsetof(ax_batch_operset, _name), _boolean }
+
+static const struct oper_member unary_members[] = {
+	OPER_MEMBER(not, ax_true),
+	OPER_MEMBER(bit_not, ax_false),
+};
+
+static const struct oper_member binary_members[] = {
+	OPER_MEMBER(add, ax_false),
+	OPER_MEMBER(sub, ax_false),
+	OPER_MEMBER(mul, ax_false),
+	OPER_MEMBER(div, ax_false),
+	OPER_MEMBER(mod, ax_false),
+	OPER_MEMBER(and, ax_true),
+	OPER_MEMBER(or, ax_true),
+	OPER_MEMBER(bit_and, ax_false),
+	OPER_MEMBER(bit_or, ax_false),
+	OPER_MEMBER(bit_xor, ax_false),
+	OPER_MEMBER(gt, ax_true),
+	OPER_MEMBER(ge, ax_true),
+	OPER_MEMBER(lt, ax_true),
+	OPER_MEMBER(le, ax_true),
+	OPER_MEMBER(eq, ax_true),
+	OPER_MEMBER(ne, ax_true),
+};
+
+#define member_of(_type, _set, _offset) (*(const _type *)((const char *)(_set) + (_offset)))
+
+ax_unary_batch_f ax_oper_unary_batch(ax_unary_f fun, size_t *in_size, size_t *out_size)
+{
+	if (!fun)
+		return NULL;
+	for (size_t t = 0; t < sizeof oper_types / sizeof *oper_types; t++) {
+		const ax_operset *set = ax_oper_for(oper_types[t].type);
+		for (size_t m = 0; m < sizeof unary_members / sizeof *unary_members; m++) {
+			if (member_of(ax_unary_f, set, unary_members[m].offset) != fun)
+				continue;
+			if (in_size)
+				*in_size = oper_types[t].size;
+			if (out_size)
+				*out_size = unary_members[m].boolean ? sizeof(ax_bool) : oper_types[t].size;
+			return member_of(ax_unary_batch_f, ax_oper_batch_for(oper_types[t].type),
+					unary_members[m].batch_offset);
+		}
+	}
+	return NULL;
+}
+
+ax_binary_batch_f ax_oper_binary_batch(ax_binary_f fun, size_t *in_size, size_t *out_size)
+{
+	if (!fun)
+		return NULL;
+	for (size_t t = 0; t < sizeof oper_types / sizeof *oper_types; t++) {
+		const ax_operset *set = ax_oper_for(oper_types[t].type);
+		for (size_t m = 0; m < sizeof binary_members / sizeof *binary_members; m++) {
+			if (member_of(ax_binary_f, set, binary_members[m].offset) != fun)
+				continue;
+			if (in_size)
+				*in_size = oper_types[t].size;
+			if (out_size)
+				*out_size = binary_members[m].boolean ? sizeof(ax_bool) : oper_types[t].size;
+			return member_of(ax_binary_batch_f, ax_oper_batch_for(oper_types[t].type),
+					binary_members[m].batch_offset);
+		}
+	}
+	return NULL;
+}
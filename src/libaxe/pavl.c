@@ -0,0 +1,828 @@
+/*
+ * Copyright (c) 2021 Li hsilin <lihsilyn@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#include "check.h"
+
+#include <axe/pavl.h>
+#include <axe/map.h>
+#include <axe/iter.h>
+#include <axe/scope.h>
+#include <axe/pool.h>
+#include <axe/debug.h>
+#include <axe/base.h>
+#include <axe/error.h>
+
+#include <string.h>
+#include <stdio.h>
+#include <assert.h>
+
+#undef free
+
+struct node_st
+{
+	struct node_st *left;
+	struct node_st *right;
+	size_t ref;
+	size_t height;
+	ax_byte kvbuffer[];
+};
+
+struct ax_pavl_st
+{
+	ax_map _map;
+	struct node_st *root;
+	size_t size;
+};
+
+static void     *map_put(ax_map* map, const void *key, const void *val);
+static ax_fail  map_erase(ax_map* map, const void *key);
+static void    *map_get(const ax_map* map, const void *key);
+static ax_iter  map_at(const ax_map* map, const void *key);
+static ax_bool  map_exist(const ax_map* map, const void *key);
+static const void *map_it_key(const ax_citer *it);
+
+static size_t   box_size(const ax_box* box);
+static size_t   box_maxsize(const ax_box* box);
+static ax_iter  box_begin(ax_box* box);
+static ax_iter  box_end(ax_box* box);
+static ax_iter  box_rbegin(ax_box* box);
+static ax_iter  box_rend(ax_box* box);
+static void     box_clear(ax_box* box);
+static const ax_stuff_trait *box_elem_tr(const ax_box *box);
+
+static void     any_dump(const ax_any* any, int ind);
+static ax_any  *any_copy(const ax_any* any);
+static ax_any  *any_move(ax_any* any);
+
+static void     one_free(ax_one* one);
+
+static void     citer_prev(ax_citer *it);
+static void     citer_next(ax_citer *it);
+static ax_bool  citer_less(const ax_citer *it1, const ax_citer *it2);
+static long     citer_dist(const ax_citer *it1, const ax_citer *it2);
+
+static void     rciter_prev(ax_citer *it);
+static void     rciter_next(ax_citer *it);
+static ax_bool  rciter_less(const ax_citer *it1, const ax_citer *it2);
+static long     rciter_dist(const ax_citer *it1, const ax_citer *it2);
+
+static void    *iter_get(const ax_iter *it);
+static ax_fail  iter_set(const ax_iter *it, const void *val);
+static void     iter_erase(ax_iter *it);
+
+inline static void *node_pval(const ax_map *map, struct node_st *node)
+{
+	assert(node);
+	return node->kvbuffer + map->env.key_tr->size;
+}
+
+inline static void *node_val(const ax_map* map, struct node_st *node)
+{
+	return map->env.val_tr->link
+		? *(void **)node_pval(map, node)
+		: node_pval(map, node);
+}
+
+inline static int height(struct node_st *root)
+{
+	return root ? root->height : 0;
+}
+
+inline static void adjust_height(struct node_st *root)
+{
+	root->height = 1 + AX_MAX(height(root->left), height(root->right));
+}
+
+static struct node_st *find_node(const ax_map *map, struct node_st *node, const void *key)
+{
+	const ax_stuff_trait *ktr = map->env.key_tr;
+	while (node) {
+		if (ktr->less(key, node->kvbuffer, ktr->size))
+			node = node->left;
+		else if (ktr->less(node->kvbuffer, key, ktr->size))
+			node = node->right;
+		else
+			break;
+	}
+	return node;
+}
+
+static struct node_st *find_right_node(const ax_map *map, struct node_st *node, const void *key)
+{
+	const ax_stuff_trait *ktr = map->env.key_tr;
+	struct node_st *found = NULL;
+	while (node) {
+		if (ktr->less(key, node->kvbuffer, ktr->size)) {
+			found = node;
+			node = node->left;
+		} else
+			node = node->right;
+	}
+	return found;
+}
+
+static struct node_st *find_left_node(const ax_map *map, struct node_st *node, const void *key)
+{
+	const ax_stuff_trait *ktr = map->env.key_tr;
+	struct node_st *found = NULL;
+	while (node) {
+		if (ktr->less(node->kvbuffer, key, ktr->size)) {
+			found = node;
+			node = node->right;
+		} else
+			node = node->left;
+	}
+	return found;
+}
+
+inline static struct node_st *get_left_end_node(struct node_st *node)
+{
+	if (node)
+		while (node->left)
+			node = node->left;
+	return node;
+}
+
+inline static struct node_st *get_right_end_node(struct node_st *node)
+{
+	if (node)
+		while (node->right)
+			node = node->right;
+	return node;
+}
+
+static struct node_st *make_node(ax_map *map, const void *key, const void *value)
+{
+	ax_base *base = ax_one_base(ax_r(map, map).one);
+	ax_pool *pool = ax_base_pool(base);
+	const ax_stuff_trait *ktr = map->env.key_tr, *vtr = map->env.val_tr;
+
+	struct node_st *node = ax_pool_alloc(pool, sizeof(struct node_st) + ktr->size + vtr->size);
+	if (node == NULL)
+		goto fail_alloc;
+
+	node->left = NULL;
+	node->right = NULL;
+	node->ref = 1;
+	node->height = 1;
+	if (ktr->copy(pool, node->kvbuffer, key, ktr->size))
+		goto fail_key;
+	if (vtr->copy(pool, node_pval(map, node), value, vtr->size))
+		goto fail_val;
+	return node;
+fail_val:
+	ktr->free(node->kvbuffer);
+fail_key:
+	ax_pool_free(node);
+fail_alloc:
+	ax_base_set_errno(base, AX_ERR_NOMEM);
+	return NULL;
+}
+
+static void release_node(ax_map *map, struct node_st *node)
+{
+	while (node && --node->ref == 0) {
+		struct node_st *right = node->right;
+		release_node(map, node->left);
+		map->env.key_tr->free(node->kvbuffer);
+		map->env.val_tr->free(node_pval(map, node));
+		ax_pool_free(node);
+		node = right;
+	}
+}
+
+static struct node_st *unshare_node(ax_map *map, struct node_st *node)
+{
+	assert(node);
+	if (node->ref == 1)
+		return node;
+
+	struct node_st *copy = make_node(map, node->kvbuffer, node_pval(map, node));
+	if (!copy)
+		return NULL;
+
+	copy->left = node->left;
+	copy->right = node->right;
+	copy->height = node->height;
+	if (copy->left)
+		copy->left->ref++;
+	if (copy->right)
+		copy->right->ref++;
+	node->ref--;
+	return copy;
+}
+
+static void rotate_right(struct node_st **pnode)
+{
+	struct node_st *root = *pnode, *new_root = root->left;
+	root->left = new_root->right;
+	new_root->right = root;
+	adjust_height(root);
+	adjust_height(new_root);
+	*pnode = new_root;
+}
+
+static void rotate_left(struct node_st **pnode)
+{
+	struct node_st *root = *pnode, *new_root = root->right;
+	root->right = new_root->left;
+	new_root->left = root;
+	adjust_height(root);
+	adjust_height(new_root);
+	*pnode = new_root;
+}
+
+/* Running out of memory here leaves the subtree valid but less balanced */
+static void balance(ax_map *map, struct node_st **pnode)
+{
+	struct node_st *root = *pnode, *child, *grandchild;
+	adjust_height(root);
+	if (height(root->left) - height(root->right) > 1) {
+		if (!(child = unshare_node(map, root->left)))
+			return;
+		root->left = child;
+		if (height(child->left) < height(child->right)) {
+			if (!(grandchild = unshare_node(map, child->right)))
+				return;
+			child->right = grandchild;
+			rotate_left(&root->left);
+		}
+		rotate_right(pnode);
+	}
+	else if (height(root->right) - height(root->left) > 1) {
+		if (!(child = unshare_node(map, root->right)))
+			return;
+		root->right = child;
+		if (height(child->right) < height(child->left)) {
+			if (!(grandchild = unshare_node(map, child->left)))
+				return;
+			child->left = grandchild;
+			rotate_right(&root->right);
+		}
+		rotate_left(pnode);
+	}
+}
+
+static ax_fail insert_node(ax_pavl *pavl, struct node_st **pnode, const void *key, const void *val, struct node_st **out)
+{
+	ax_map *map = &pavl->_map;
+	const ax_stuff_trait *ktr = map->env.key_tr;
+
+	if (!*pnode) {
+		if (!(*pnode = make_node(map, key, val)))
+			return ax_true;
+		pavl->size++;
+		*out = *pnode;
+		return ax_false;
+	}
+
+	struct node_st *node = unshare_node(map, *pnode);
+	if (!node)
+		return ax_true;
+	*pnode = node;
+
+	if (ktr->less(key, node->kvbuffer, ktr->size)) {
+		if (insert_node(pavl, &node->left, key, val, out))
+			return ax_true;
+	} else if (ktr->less(node->kvbuffer, key, ktr->size)) {
+		if (insert_node(pavl, &node->right, key, val, out))
+			return ax_true;
+	} else {
+		const ax_stuff_trait *vtr = map->env.val_tr;
+		ax_pool *pool = ax_base_pool(ax_one_base(ax_r(pavl, pavl).one));
+		vtr->free(node_pval(map, node));
+		if (vtr->copy(pool, node_pval(map, node), val, vtr->size)) {
+			vtr->init(pool, node_pval(map, node), vtr->size);
+			ax_base_set_errno(ax_one_base(ax_r(pavl, pavl).one), AX_ERR_NOMEM);
+			return ax_true;
+		}
+		*out = node;
+		return ax_false;
+	}
+	balance(map, pnode);
+	return ax_false;
+}
+
+static ax_fail unlink_min_node(ax_map *map, struct node_st **pnode, struct node_st **out)
+{
+	struct node_st *node = unshare_node(map, *pnode);
+	if (!node)
+		return ax_true;
+	*pnode = node;
+
+	if (!node->left) {
+		*pnode = node->right;
+		node->right = NULL;
+		*out = node;
+		return ax_false;
+	}
+	if (unlink_min_node(map, &node->left, out))
+		return ax_true;
+	balance(map, pnode);
+	return ax_false;
+}
+
+static ax_fail remove_node(ax_pavl *pavl, struct node_st **pnode, const void *key)
+{
+	ax_map *map = &pavl->_map;
+	const ax_stuff_trait *ktr = map->env.key_tr;
+
+	struct node_st *node = unshare_node(map, *pnode);
+	if (!node)
+		return ax_true;
+	*pnode = node;
+
+	if (ktr->less(key, node->kvbuffer, ktr->size)) {
+		if (remove_node(pavl, &node->left, key))
+			return ax_true;
+	} else if (ktr->less(node->kvbuffer, key, ktr->size)) {
+		if (remove_node(pavl, &node->right, key))
+			return ax_true;
+	} else {
+		if (node->left && node->right) {
+			struct node_st *min;
+			if (unlink_min_node(map, &node->right, &min))
+				return ax_true;
+			min->left = node->left;
+			min->right = node->right;
+			*pnode = min;
+			node->left = node->right = NULL;
+			release_node(map, node);
+			pavl->size--;
+		} else {
+			*pnode = node->left ? node->left : node->right;
+			node->left = node->right = NULL;
+			release_node(map, node);
+			pavl->size--;
+			return ax_false;
+		}
+	}
+	balance(map, pnode);
+	return ax_false;
+}
+
+static void citer_prev(ax_citer *it)
+{
+	CHECK_PARAM_VALIDITY(it, it->owner && it->tr);
+
+	const ax_pavl *pavl = it->owner;
+	struct node_st *node = it->point;
+	it->point = node ? find_left_node(&pavl->_map, pavl->root, node->kvbuffer)
+		: get_right_end_node(pavl->root);
+}
+
+static void citer_next(ax_citer *it)
+{
+	CHECK_PARAM_VALIDITY(it, it->owner && it->tr);
+	ax_assert(it->point != NULL, "iterator boundary exceeded");
+
+	const ax_pavl *pavl = it->owner;
+	struct node_st *node = it->point;
+	it->point = find_right_node(&pavl->_map, pavl->root, node->kvbuffer);
+}
+
+static ax_bool citer_less(const ax_citer *it1, const ax_citer *it2)
+{
+	UNSUPPORTED();
+	return ax_false;
+}
+
+static long citer_dist(const ax_citer *it1, const ax_citer *it2)
+{
+	CHECK_ITER_COMPARABLE(it1, it2);
+
+	const ax_pavl *pavl = it1->owner;
+	struct node_st *node1 = it1->point;
+	struct node_st *node2 = it2->point;
+	struct node_st *cur = get_left_end_node(pavl->root);
+
+	size_t loc1, loc2;
+	loc1 = loc2 = pavl->size;
+
+	int found = !node1 + !node2;
+	for (size_t i = 0; found < 2 && cur; i++) {
+		if (cur == node1)
+			loc1 = i, found++;
+		if (cur == node2)
+			loc2 = i, found++;
+		cur = find_right_node(&pavl->_map, pavl->root, cur->kvbuffer);
+	}
+
+	ax_assert(found == 2, "bad iterator");
+	return loc2 - loc1;
+}
+
+static void rciter_prev(ax_citer *it)
+{
+	CHECK_PARAM_VALIDITY(it, it->owner && it->tr);
+
+	const ax_pavl *pavl = it->owner;
+	struct node_st *node = it->point;
+	it->point = node ? find_right_node(&pavl->_map, pavl->root, node->kvbuffer)
+		: get_left_end_node(pavl->root);
+}
+
+static void rciter_next(ax_citer *it)
+{
+	CHECK_PARAM_VALIDITY(it, it->owner && it->tr);
+	ax_assert(it->point != NULL, "iterator boundary exceeded");
+
+	const ax_pavl *pavl = it->owner;
+	struct node_st *node = it->point;
+	it->point = find_left_node(&pavl->_map, pavl->root, node->kvbuffer);
+}
+
+static ax_bool rciter_less(const ax_citer *it1, const ax_citer *it2)
+{
+	UNSUPPORTED();
+	return ax_false;
+}
+
+static long rciter_dist(const ax_citer *it1, const ax_citer *it2)
+{
+	return citer_dist(it2, it1);
+}
+
+static void *iter_get(const ax_iter *it)
+{
+	CHECK_PARAM_VALIDITY(it, it->owner && it->point && it->tr);
+
+	const ax_pavl *pavl = it->owner;
+	return node_val(&pavl->_map, it->point);
+}
+
+static ax_fail iter_set(const ax_iter *it, const void *val)
+{
+	CHECK_PARAM_NULL(val);
+	CHECK_PARAM_VALIDITY(it, it->owner && it->point && it->tr);
+
+	ax_pavl_r pavl_r = { .one = (ax_one *)it->owner };
+	struct node_st *node = it->point, *out;
+	const void *pval = pavl_r.map->env.val_tr->link ? &val : val;
+
+	if (insert_node(pavl_r.pavl, &pavl_r.pavl->root, node->kvbuffer, pval, &out))
+		return ax_true;
+
+	/* The node may have been path-copied, keep the iterator on our own version */
+	((ax_iter *)it)->point = out;
+	return ax_false;
+}
+
+static void iter_erase(ax_iter *it)
+{
+	CHECK_PARAM_NULL(it);
+	CHECK_PARAM_NULL(it->point);
+
+	ax_pavl_r pavl_r = { .one = it->owner };
+	struct node_st *node = it->point;
+	struct node_st *next = ax_iter_norm(it)
+		? find_right_node(pavl_r.map, pavl_r.pavl->root, node->kvbuffer)
+		: find_left_node(pavl_r.map, pavl_r.pavl->root, node->kvbuffer);
+
+	/* next outlives the removal, either kept in place, moved or still owned by a snapshot */
+	if (remove_node(pavl_r.pavl, &pavl_r.pavl->root, node->kvbuffer))
+		return;
+	it->point = next ? find_node(pavl_r.map, pavl_r.pavl->root, next->kvbuffer) : NULL;
+}
+
+static void *map_put(ax_map* map, const void *key, const void *val)
+{
+	CHECK_PARAM_NULL(map);
+	CHECK_PARAM_NULL(val);
+
+	ax_pavl_r pavl_r = { .map = map };
+	const void *pkey = map->env.key_tr->link ? &key : key;
+	const void *pval = map->env.val_tr->link ? &val : val;
+
+	struct node_st *node;
+	if (insert_node(pavl_r.pavl, &pavl_r.pavl->root, pkey, pval, &node))
+		return NULL;
+	return node_val(map, node);
+}
+
+static ax_fail map_erase(ax_map* map, const void *key)
+{
+	CHECK_PARAM_NULL(map);
+
+	ax_pavl_r pavl_r = { .map = map };
+	const void *pkey = map->env.key_tr->link ? &key : key;
+
+	if (!find_node(map, pavl_r.pavl->root, pkey)) {
+		ax_base_set_errno(ax_one_base(pavl_r.one), AX_ERR_NOKEY);
+		return ax_true;
+	}
+	return remove_node(pavl_r.pavl, &pavl_r.pavl->root, pkey);
+}
+
+static void *map_get(const ax_map* map, const void *key)
+{
+	CHECK_PARAM_NULL(map);
+
+	ax_pavl_cr pavl_r = { .map = map };
+	const void *pkey = map->env.key_tr->link ? &key : key;
+
+	struct node_st *node = find_node(map, pavl_r.pavl->root, pkey);
+	return node ? node_val(map, node) : NULL;
+}
+
+static ax_iter map_at(const ax_map* map, const void *key)
+{
+	CHECK_PARAM_NULL(map);
+
+	ax_pavl_cr pavl_r = { .map = map };
+	const void *pkey = map->env.key_tr->link ? &key : key;
+
+	return (ax_iter) {
+		.owner = (void *)map,
+		.tr = &ax_pavl_tr.box.iter,
+		.point = find_node(map, pavl_r.pavl->root, pkey)
+	};
+}
+
+static ax_bool map_exist(const ax_map* map, const void *key)
+{
+	CHECK_PARAM_NULL(map);
+
+	ax_pavl_cr pavl_r = { .map = map };
+	const void *pkey = map->env.key_tr->link ? &key : key;
+	return !!find_node(map, pavl_r.pavl->root, pkey);
+}
+
+static const void *map_it_key(const ax_citer *it)
+{
+	CHECK_PARAM_VALIDITY(it, it->owner && it->point && it->tr);
+	CHECK_ITER_TYPE(it, AX_PAVL_NAME);
+
+	const ax_pavl *pavl = it->owner;
+	struct node_st *node = it->point;
+	return pavl->_map.env.key_tr->link ? *(void**)node->kvbuffer : node->kvbuffer;
+}
+
+static void one_free(ax_one* one)
+{
+	if (!one)
+		return;
+	ax_pavl_r pavl_r = { .one = one };
+	ax_scope_detach(one);
+	box_clear(pavl_r.box);
+	ax_pool_free(one);
+}
+
+static void any_dump(const ax_any* any, int ind)
+{
+	fprintf(stderr, "not implemented\n");
+}
+
+static ax_any *any_copy(const ax_any *any)
+{
+	CHECK_PARAM_NULL(any);
+
+	ax_pavl_cr src_r = { .any = any };
+	ax_base *base = ax_one_base(src_r.one);
+
+	ax_pavl *dst = ax_pool_alloc(ax_base_pool(base), sizeof(ax_pavl));
+	if (!dst) {
+		ax_base_set_errno(base, AX_ERR_NOMEM);
+		return NULL;
+	}
+	memcpy(dst, src_r.pavl, sizeof(ax_pavl));
+	if (dst->root)
+		dst->root->ref++;
+
+	dst->_map.env.one.scope.macro = NULL;
+	dst->_map.env.one.scope.micro = 0;
+	ax_scope_attach(ax_base_local(base), ax_r(pavl, dst).one);
+
+	return ax_r(pavl, dst).any;
+}
+
+static ax_any *any_move(ax_any *any)
+{
+	CHECK_PARAM_NULL(any);
+
+	ax_pavl_r src_r = { .any = any };
+	ax_base *base = ax_one_base(src_r.one);
+
+	ax_pavl *dst = ax_pool_alloc(ax_base_pool(base), sizeof(ax_pavl));
+	if (!dst) {
+		ax_base_set_errno(base, AX_ERR_NOMEM);
+		return NULL;
+	}
+	memcpy(dst, src_r.pavl, sizeof(ax_pavl));
+	src_r.pavl->root = NULL;
+	src_r.pavl->size = 0;
+
+	dst->_map.env.one.scope.macro = NULL;
+	dst->_map.env.one.scope.micro = 0;
+	ax_scope_attach(ax_base_local(base), ax_r(pavl, dst).one);
+
+	return ax_r(pavl, dst).any;
+}
+
+static size_t box_size(const ax_box* box)
+{
+	CHECK_PARAM_NULL(box);
+
+	ax_pavl_cr pavl_r = { .box = box };
+	return pavl_r.pavl->size;
+}
+
+static size_t box_maxsize(const ax_box* box)
+{
+	CHECK_PARAM_NULL(box);
+
+	return 0xFFFF;
+}
+
+static ax_iter box_begin(ax_box* box)
+{
+	CHECK_PARAM_NULL(box);
+
+	ax_pavl_r pavl_r = { .box = box };
+	return (ax_iter) {
+		.owner = box,
+		.tr = &ax_pavl_tr.box.iter,
+		.point = get_left_end_node(pavl_r.pavl->root)
+	};
+}
+
+static ax_iter box_end(ax_box* box)
+{
+	CHECK_PARAM_NULL(box);
+
+	return (ax_iter) {
+		.owner = box,
+		.tr = &ax_pavl_tr.box.iter,
+		.point = NULL
+	};
+}
+
+static ax_iter box_rbegin(ax_box* box)
+{
+	CHECK_PARAM_NULL(box);
+
+	ax_pavl_r pavl_r = { .box = box };
+	return (ax_iter) {
+		.owner = box,
+		.tr = &ax_pavl_tr.box.riter,
+		.point = get_right_end_node(pavl_r.pavl->root)
+	};
+}
+
+static ax_iter box_rend(ax_box* box)
+{
+	CHECK_PARAM_NULL(box);
+
+	return (ax_iter) {
+		.owner = box,
+		.tr = &ax_pavl_tr.box.riter,
+		.point = NULL
+	};
+}
+
+static void box_clear(ax_box* box)
+{
+	CHECK_PARAM_NULL(box);
+
+	ax_pavl_r pavl_r = { .box = box };
+	release_node(pavl_r.map, pavl_r.pavl->root);
+	pavl_r.pavl->root = NULL;
+	pavl_r.pavl->size = 0;
+}
+
+static const ax_stuff_trait *box_elem_tr(const ax_box *box)
+{
+	ax_pavl_cr pavl_r = { .box = box };
+	return pavl_r.map->env.val_tr;
+}
+
+const ax_map_trait ax_pavl_tr =
+{
+	.box = {
+		.any = {
+			.one = {
+				.name  = AX_PAVL_NAME,
+				.free  = one_free,
+			},
+			.dump = any_dump,
+			.copy = any_copy,
+			.move = any_move,
+		},
+		.iter = {
+			.ctr = {
+				.norm = ax_true,
+				.type = AX_IT_BID,
+				.move = NULL,
+				.prev = citer_prev,
+				.next = citer_next,
+				.less = citer_less,
+				.dist = citer_dist
+			},
+			.get    = iter_get,
+			.set    = iter_set,
+			.erase  = iter_erase,
+		},
+		.riter = {
+			.ctr = {
+				.norm = ax_false,
+				.type = AX_IT_BID,
+				.move = NULL,
+				.prev = rciter_prev,
+				.next = rciter_next,
+				.less = rciter_less,
+				.dist = rciter_dist,
+			},
+			.get    = iter_get,
+			.set    = iter_set,
+			.erase  = iter_erase,
+		},
+
+		.size    = box_size,
+		.maxsize = box_maxsize,
+		.begin   = box_begin,
+		.end     = box_end,
+		.rbegin  = box_rbegin,
+		.rend    = box_rend,
+		.clear   = box_clear,
+		.elem_tr = box_elem_tr
+
+	},
+	.put   = map_put,
+	.get   = map_get,
+	.at    = map_at,
+	.erase = map_erase,
+	.exist = map_exist,
+	.itkey = map_it_key
+};
+
+ax_map *__ax_pavl_construct(ax_base* base, const ax_stuff_trait* key_tr, const ax_stuff_trait* val_tr)
+{
+	CHECK_PARAM_NULL(base);
+
+	CHECK_PARAM_NULL(key_tr);
+	CHECK_PARAM_NULL(key_tr->less);
+	CHECK_PARAM_NULL(key_tr->copy);
+	CHECK_PARAM_NULL(key_tr->free);
+
+	CHECK_PARAM_NULL(val_tr);
+	CHECK_PARAM_NULL(val_tr->copy);
+	CHECK_PARAM_NULL(val_tr->free);
+	CHECK_PARAM_NULL(val_tr->init);
+
+	ax_pavl *pavl = ax_pool_alloc(ax_base_pool(base), sizeof(ax_pavl));
+	if (pavl == NULL)
+		return NULL;
+
+	ax_pavl pavl_init = {
+		._map = {
+			.tr = &ax_pavl_tr,
+			.env = {
+				.one = {
+					.base = base,
+					.scope = { NULL },
+				},
+				.key_tr = key_tr,
+				.val_tr = val_tr,
+			},
+		},
+		.size = 0,
+		.root = NULL
+	};
+
+	memcpy(pavl, &pavl_init, sizeof pavl_init);
+	return &pavl->_map;
+}
+
+ax_pavl_r ax_pavl_create(ax_scope *scope, const ax_stuff_trait *key_tr, const ax_stuff_trait *val_tr)
+{
+	CHECK_PARAM_NULL(scope);
+	CHECK_PARAM_NULL(key_tr);
+	CHECK_PARAM_NULL(val_tr);
+
+	ax_base *base = ax_one_base(ax_r(scope, scope).one);
+	ax_pavl_r pavl_r = { .map = __ax_pavl_construct(base, key_tr, val_tr) };
+	if (pavl_r.one == NULL)
+		return pavl_r;
+	ax_scope_attach(scope, pavl_r.one);
+	return pavl_r;
+}
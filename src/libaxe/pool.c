@@ -58,7 +58,7 @@ struct node
 	struct group* group;
 	intptr_t index;
 	ax_byte *blocktab;
-	ax_byte *freetab;
+	uint16_t *freetab;
 	struct node *pre;
 	struct node *next;
 	size_t blocktab_used;
@@ -218,7 +218,7 @@ prepare_buffer(struct node* node)
 		return ax_true;
 	}
 
-	node->freetab = node->blocktab + blocktab_bsize;
+	node->freetab = (uint16_t *)(node->blocktab + blocktab_bsize);
 	node->blocktab_used = 0;
 	node->freetab_used = 0;
 	return ax_false;
@@ -295,34 +295,29 @@ node_pick_free_block(struct node* node)
 	return block;
 }
 
+/* Only nodes having free blocks are kept in the available ring */
 static struct block*
 group_prepare_block(struct group* group)
 {
-	struct node* node;
-	struct block* block;
-	if ((node = group->avai_top) && (block = node_pick_free_block(node))) {
-		if (node_freed_size(node) == BLOCK_MAX)
-		{
-			group->avai_top = node_detach(group->avai_top, node);
-			group->avai_top = node_attach(group->avai_top, node);
-			group->avai_top = group->avai_top->next;
-		}
-	} else {
+	struct node* node = group->avai_top;
+	if (node == NULL) {
 		if (group->susp_top) {
 			node = group->susp_top;
-			group->susp_top = node_detach(group->susp_top, node);
-			group->avai_top = node_attach(group->avai_top, node);
 			if (prepare_buffer(node)) {
 				return NULL;
 			}
+			group->susp_top = node_detach(group->susp_top, node);
+			group->avai_top = node_attach(group->avai_top, node);
 		} else {
 			node = group_increase(group);
 			if (node == NULL)
 				return NULL;
 		}
-		node->blocktab_used = 1;
-		block = (struct block*)node->blocktab;
 	}
+
+	struct block* block = node_pick_free_block(node);
+	if (node_freed_size(node) == 0)
+		group->avai_top = node_detach(group->avai_top, node);
 	block->node = node;
 
 	return block;
@@ -368,7 +363,6 @@ block_free(struct block* block)
 		while(group->nodetab_used && group->nodetab[group->nodetab_used - 1]->blocktab == NULL) 
 			group_decrease(group);
 	} else if (avai_size == 1) {
-		group->avai_top = node_detach(group->avai_top, node);
 		group->avai_top = node_attach(group->avai_top, node);
 	}
 }
@@ -0,0 +1,577 @@
+/*
+ * Copyright (c) 2020 Li hsilin <lihsilyn@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <axe/pqueue.h>
+#include <axe/tube.h>
+#include <axe/base.h>
+#include <axe/pool.h>
+#include <axe/scope.h>
+#include <axe/any.h>
+#include <axe/error.h>
+
+#include <string.h>
+#include <stdint.h>
+
+#include "check.h"
+
+#undef free
+
+#define MIN_CAPACITY 8
+#define ARITY 4
+#define NO_HANDLE (~(size_t)0)
+
+#define PARENT(_i) (((_i) - 1) / ARITY)
+#define CHILD(_i) ((_i) * ARITY + 1)
+
+/*
+ * A 4-ary min-heap in one array, which halves the depth of a binary heap
+ * and keeps the children compared by sift_down next to each other. The
+ * array has one slot more than its capacity, the element being sifted is
+ * parked there while the others shift into its path.
+ *
+ * A handled pqueue keeps slot_handle and handle_slot as inverse mappings,
+ * free handles are chained through handle_slot starting at free_handle.
+ */
+struct ax_pqueue_st
+{
+	ax_tube tube;
+	ax_byte *heap;
+	size_t size;
+	size_t cap;
+	size_t *slot_handle;
+	size_t *handle_slot;
+	size_t nhandle;
+	size_t free_handle;
+	ax_bool handled;
+};
+
+static ax_fail tube_push(ax_tube *tube, const void *val);
+static void    tube_pop(ax_tube *tube);
+static size_t  tube_size(const ax_tube *tube);
+static void   *tube_prime(const ax_tube *tube);
+static ax_any *any_copy(const ax_any *any);
+static ax_any *any_move(ax_any *any);
+static void    one_free(ax_one *one);
+
+const ax_tube_trait ax_pqueue_tr =
+{
+		.any = {
+			.one = {
+				.name = AX_PQUEUE_NAME,
+				.free = one_free,
+			},
+			.copy = any_copy,
+			.move = any_move
+		},
+		.push = tube_push,
+		.pop = tube_pop,
+		.size = tube_size,
+		.prime = tube_prime
+};
+
+#ifdef AX_DEBUG
+static inline ax_bool handle_if_valid(const ax_pqueue *self, ax_pqueue_handle handle)
+{
+	return self->handled && handle < self->nhandle
+		&& self->handle_slot[handle] < self->size
+		&& self->slot_handle[self->handle_slot[handle]] == handle;
+}
+#endif
+
+inline static ax_byte *slot_ptr(const ax_pqueue *self, size_t index)
+{
+	return self->heap + index * self->tube.env.elem_tr->size;
+}
+
+inline static void *elem_value(const ax_pqueue *self, ax_byte *ptr)
+{
+	return self->tube.env.elem_tr->link ? *(void **)ptr : ptr;
+}
+
+inline static ax_bool slot_less(const ax_pqueue *self, size_t i1, size_t i2)
+{
+	const ax_stuff_trait *etr = self->tube.env.elem_tr;
+	return etr->less(slot_ptr(self, i1), slot_ptr(self, i2), etr->size);
+}
+
+/* Relocate the element in slot src to slot dst, keeping its handle */
+inline static void slot_move(ax_pqueue *self, size_t dst, size_t src)
+{
+	const ax_stuff_trait *etr = self->tube.env.elem_tr;
+	if (etr->trivial_move)
+		memcpy(slot_ptr(self, dst), slot_ptr(self, src), etr->size);
+	else
+		etr->move(slot_ptr(self, dst), slot_ptr(self, src), etr->size);
+
+	if (self->handled) {
+		self->slot_handle[dst] = self->slot_handle[src];
+		self->handle_slot[self->slot_handle[dst]] = dst;
+	}
+}
+
+static void slot_free(ax_pqueue *self, size_t index)
+{
+	const ax_stuff_trait *etr = self->tube.env.elem_tr;
+	if (!etr->trivial_free)
+		etr->free(slot_ptr(self, index));
+}
+
+static ax_fail slot_construct(ax_pqueue *self, size_t index, const void *val)
+{
+	const ax_stuff_trait *etr = self->tube.env.elem_tr;
+	ax_base *base = ax_one_base(ax_r(pqueue, self).one);
+	ax_pool *pool = ax_base_pool(base);
+
+	const void *pval = etr->link ? &val : val;
+	ax_fail fail = val
+		? etr->copy(pool, slot_ptr(self, index), pval, etr->size)
+		: etr->init(pool, slot_ptr(self, index), etr->size);
+	if (fail) {
+		ax_base_set_errno(base, AX_ERR_NOMEM);
+		return ax_true;
+	}
+	return ax_false;
+}
+
+static void sift_up(ax_pqueue *self, size_t i)
+{
+	size_t hole = self->cap;
+	slot_move(self, hole, i);
+	while (i > 0) {
+		size_t parent = PARENT(i);
+		if (!slot_less(self, hole, parent))
+			break;
+		slot_move(self, i, parent);
+		i = parent;
+	}
+	slot_move(self, i, hole);
+}
+
+static void sift_down(ax_pqueue *self, size_t i)
+{
+	size_t hole = self->cap;
+	slot_move(self, hole, i);
+	for (;;) {
+		size_t child = CHILD(i);
+		if (child >= self->size)
+			break;
+
+		size_t end = child + ARITY < self->size ? child + ARITY : self->size;
+		size_t least = child;
+		for (size_t c = child + 1; c < end; c++)
+			if (slot_less(self, c, least))
+				least = c;
+
+		if (!slot_less(self, least, hole))
+			break;
+		slot_move(self, i, least);
+		i = least;
+	}
+	slot_move(self, i, hole);
+}
+
+/* Move the element at i up or down to where it belongs */
+static void sift(ax_pqueue *self, size_t i)
+{
+	if (i > 0 && slot_less(self, i, PARENT(i)))
+		sift_up(self, i);
+	else
+		sift_down(self, i);
+}
+
+static ax_fail heap_realloc(ax_pqueue *self, size_t cap)
+{
+	const ax_stuff_trait *etr = self->tube.env.elem_tr;
+	ax_base *base = ax_one_base(ax_r(pqueue, self).one);
+	ax_pool *pool = ax_base_pool(base);
+	size_t esize = etr->size ? etr->size : 1;
+
+	ax_byte *heap = ax_pool_alloc(pool, (cap + 1) * esize);
+	size_t *slot_handle = NULL, *handle_slot = NULL;
+	if (!heap)
+		goto fail;
+	if (self->handled) {
+		slot_handle = ax_pool_alloc(pool, (cap + 1) * sizeof(size_t));
+		handle_slot = ax_pool_alloc(pool, cap * sizeof(size_t));
+		if (!slot_handle || !handle_slot)
+			goto fail;
+		if (self->size)
+			memcpy(slot_handle, self->slot_handle, self->size * sizeof(size_t));
+		if (self->nhandle)
+			memcpy(handle_slot, self->handle_slot, self->nhandle * sizeof(size_t));
+	}
+
+	if (self->size && etr->trivial_move)
+		memcpy(heap, self->heap, self->size * etr->size);
+	else
+		for (size_t i = 0; i < self->size; i++)
+			etr->move(heap + i * etr->size, slot_ptr(self, i), etr->size);
+
+	ax_pool_free(self->heap);
+	ax_pool_free(self->slot_handle);
+	ax_pool_free(self->handle_slot);
+	self->heap = heap;
+	self->slot_handle = slot_handle;
+	self->handle_slot = handle_slot;
+	self->cap = cap;
+	return ax_false;
+fail:
+	ax_base_set_errno(base, AX_ERR_NOMEM);
+	ax_pool_free(heap);
+	ax_pool_free(slot_handle);
+	ax_pool_free(handle_slot);
+	return ax_true;
+}
+
+static ax_fail heap_reserve(ax_pqueue *self, size_t size)
+{
+	if (size <= self->cap)
+		return ax_false;
+
+	size_t esize = self->tube.env.elem_tr->size;
+	size_t max = ((~(size_t)0) >> 2) / (esize > sizeof(size_t) ? esize : sizeof(size_t));
+	if (size > max) {
+		ax_base_set_errno(ax_one_base(ax_r(pqueue, self).one), AX_ERR_FULL);
+		return ax_true;
+	}
+
+	size_t cap = self->cap ? self->cap : MIN_CAPACITY;
+	while (cap < size)
+		cap <<= 1;
+	return heap_realloc(self, cap);
+}
+
+static size_t handle_alloc(ax_pqueue *self)
+{
+	size_t handle = self->free_handle;
+	if (handle != NO_HANDLE)
+		self->free_handle = self->handle_slot[handle];
+	else
+		handle = self->nhandle++;
+	return handle;
+}
+
+static void handle_release(ax_pqueue *self, size_t handle)
+{
+	self->handle_slot[handle] = self->free_handle;
+	self->free_handle = handle;
+}
+
+/* Destroy the element at i and fill the gap with the last element */
+static void heap_remove(ax_pqueue *self, size_t i)
+{
+	slot_free(self, i);
+	if (self->handled)
+		handle_release(self, self->slot_handle[i]);
+
+	self->size--;
+	if (i == self->size)
+		return;
+	slot_move(self, i, self->size);
+	sift(self, i);
+}
+
+ax_fail ax_pqueue_reserve(ax_pqueue *pqueue, size_t size)
+{
+	CHECK_PARAM_NULL(pqueue);
+
+	return heap_reserve(pqueue, size);
+}
+
+ax_fail ax_pqueue_push_handle(ax_pqueue *pqueue, const void *val, ax_pqueue_handle *handle)
+{
+	CHECK_PARAM_NULL(pqueue);
+
+	if (heap_reserve(pqueue, pqueue->size + 1))
+		return ax_true;
+	if (slot_construct(pqueue, pqueue->size, val))
+		return ax_true;
+
+	if (pqueue->handled) {
+		size_t h = handle_alloc(pqueue);
+		pqueue->slot_handle[pqueue->size] = h;
+		pqueue->handle_slot[h] = pqueue->size;
+		if (handle)
+			*handle = h;
+	}
+
+	pqueue->size++;
+	sift_up(pqueue, pqueue->size - 1);
+	return ax_false;
+}
+
+ax_pqueue_handle ax_pqueue_prime_handle(const ax_pqueue *pqueue)
+{
+	CHECK_PARAM_NULL(pqueue);
+	CHECK_PARAM_VALIDITY(pqueue, pqueue->handled);
+
+	ax_assert(pqueue->size > 0, "empty");
+	return pqueue->slot_handle[0];
+}
+
+void *ax_pqueue_get(const ax_pqueue *pqueue, ax_pqueue_handle handle)
+{
+	CHECK_PARAM_NULL(pqueue);
+	CHECK_PARAM_VALIDITY(handle, handle_if_valid(pqueue, handle));
+
+	return elem_value(pqueue, slot_ptr(pqueue, pqueue->handle_slot[handle]));
+}
+
+ax_fail ax_pqueue_update(ax_pqueue *pqueue, ax_pqueue_handle handle, const void *val)
+{
+	CHECK_PARAM_NULL(pqueue);
+	CHECK_PARAM_VALIDITY(handle, handle_if_valid(pqueue, handle));
+
+	/* Build the new value in the spare slot first, so failure keeps the old one */
+	size_t i = pqueue->handle_slot[handle];
+	if (slot_construct(pqueue, pqueue->cap, val))
+		return ax_true;
+	slot_free(pqueue, i);
+
+	const ax_stuff_trait *etr = pqueue->tube.env.elem_tr;
+	if (etr->trivial_move)
+		memcpy(slot_ptr(pqueue, i), slot_ptr(pqueue, pqueue->cap), etr->size);
+	else
+		etr->move(slot_ptr(pqueue, i), slot_ptr(pqueue, pqueue->cap), etr->size);
+	sift(pqueue, i);
+	return ax_false;
+}
+
+void ax_pqueue_erase(ax_pqueue *pqueue, ax_pqueue_handle handle)
+{
+	CHECK_PARAM_NULL(pqueue);
+	CHECK_PARAM_VALIDITY(handle, handle_if_valid(pqueue, handle));
+
+	heap_remove(pqueue, pqueue->handle_slot[handle]);
+}
+
+static ax_fail tube_push(ax_tube *tube, const void *val)
+{
+	CHECK_PARAM_NULL(tube);
+
+	return ax_pqueue_push_handle((ax_pqueue *)tube, val, NULL);
+}
+
+static void tube_pop(ax_tube *tube)
+{
+	CHECK_PARAM_NULL(tube);
+
+	ax_pqueue *self = (ax_pqueue *)tube;
+	if (self->size == 0) {
+		ax_base_set_errno(ax_one_base(ax_r(tube, tube).one), AX_ERR_EMPTY);
+		return;
+	}
+	heap_remove(self, 0);
+}
+
+static size_t tube_size(const ax_tube *tube)
+{
+	CHECK_PARAM_NULL(tube);
+
+	ax_pqueue_cr self_r = { .tube = tube };
+	return self_r.pqueue->size;
+}
+
+static void *tube_prime(const ax_tube *tube)
+{
+	CHECK_PARAM_NULL(tube);
+
+	ax_pqueue_cr self_r = { .tube = tube };
+	ax_assert(self_r.pqueue->size > 0, "empty");
+	return elem_value(self_r.pqueue, slot_ptr(self_r.pqueue, 0));
+}
+
+static ax_any *any_copy(const ax_any *any)
+{
+	CHECK_PARAM_NULL(any);
+
+	ax_pqueue_cr src_r = { .any = any };
+	const ax_pqueue *src = src_r.pqueue;
+	const ax_stuff_trait *etr = src->tube.env.elem_tr;
+	ax_base *base = ax_one_base(src_r.one);
+	ax_pool *pool = ax_base_pool(base);
+
+	ax_pqueue_r dst_r = { .tube = src->handled
+		? __ax_pqueue_construct_handled(base, etr)
+		: __ax_pqueue_construct(base, etr) };
+	if (!dst_r.one)
+		return NULL;
+
+	ax_pqueue *dst = dst_r.pqueue;
+	if (src->cap && heap_realloc(dst, src->cap))
+		goto fail;
+
+	if (etr->trivial_copy) {
+		memcpy(dst->heap, src->heap, src->size * etr->size);
+		dst->size = src->size;
+	} else {
+		for (; dst->size < src->size; dst->size++) {
+			if (etr->copy(pool, slot_ptr(dst, dst->size), slot_ptr(src, dst->size), etr->size)) {
+				ax_base_set_errno(base, AX_ERR_NOMEM);
+				goto fail;
+			}
+		}
+	}
+
+	if (src->handled && src->cap) {
+		memcpy(dst->slot_handle, src->slot_handle, src->size * sizeof(size_t));
+		memcpy(dst->handle_slot, src->handle_slot, src->nhandle * sizeof(size_t));
+		dst->nhandle = src->nhandle;
+		dst->free_handle = src->free_handle;
+	}
+
+	ax_scope_attach(ax_base_local(base), dst_r.one);
+	return dst_r.any;
+fail:
+	one_free(dst_r.one);
+	return NULL;
+}
+
+static ax_any *any_move(ax_any *any)
+{
+	CHECK_PARAM_NULL(any);
+
+	ax_pqueue_r src_r = { .any = any };
+	ax_base *base = ax_one_base(src_r.one);
+	ax_pqueue *dst = ax_pool_alloc(ax_base_pool(base), sizeof(ax_pqueue));
+	if (!dst) {
+		ax_base_set_errno(base, AX_ERR_NOMEM);
+		return NULL;
+	}
+
+	memcpy(dst, src_r.pqueue, sizeof *dst);
+	dst->tube.env.one.scope.macro = NULL;
+	dst->tube.env.one.scope.micro = 0;
+
+	ax_pqueue *src = src_r.pqueue;
+	src->heap = NULL;
+	src->slot_handle = NULL;
+	src->handle_slot = NULL;
+	src->size = 0;
+	src->cap = 0;
+	src->nhandle = 0;
+	src->free_handle = NO_HANDLE;
+
+	ax_pqueue_r dst_r = { .pqueue = dst };
+	ax_scope_attach(ax_base_local(base), dst_r.one);
+	return dst_r.any;
+}
+
+static void one_free(ax_one *one)
+{
+	if (!one)
+		return;
+
+	ax_pqueue_r self_r = { .one = one };
+	ax_scope_detach(one);
+	for (size_t i = 0; i < self_r.pqueue->size; i++)
+		slot_free(self_r.pqueue, i);
+	ax_pool_free(self_r.pqueue->heap);
+	ax_pool_free(self_r.pqueue->slot_handle);
+	ax_pool_free(self_r.pqueue->handle_slot);
+	ax_pool_free(one);
+}
+
+static ax_tube *pqueue_construct(ax_base *base, const ax_stuff_trait *elem_tr, ax_bool handled)
+{
+	ax_pqueue *self = ax_pool_alloc(ax_base_pool(base), sizeof(ax_pqueue));
+	if (!self) {
+		ax_base_set_errno(base, AX_ERR_NOMEM);
+		return NULL;
+	}
+
+	ax_pqueue pqueue_init = {
+		.tube = {
+			.tr = &ax_pqueue_tr,
+			.env = {
+				.one = {
+					.base = base,
+					.scope = { NULL }
+				},
+				.elem_tr = elem_tr
+			},
+		},
+		.heap = NULL,
+		.size = 0,
+		.cap = 0,
+		.slot_handle = NULL,
+		.handle_slot = NULL,
+		.nhandle = 0,
+		.free_handle = NO_HANDLE,
+		.handled = handled
+	};
+
+	memcpy(self, &pqueue_init, sizeof pqueue_init);
+	return &self->tube;
+}
+
+ax_tube *__ax_pqueue_construct(ax_base *base, const ax_stuff_trait *elem_tr)
+{
+	CHECK_PARAM_NULL(base);
+	CHECK_PARAM_NULL(elem_tr);
+	CHECK_PARAM_NULL(elem_tr->less);
+	CHECK_PARAM_NULL(elem_tr->copy);
+	CHECK_PARAM_NULL(elem_tr->free);
+	CHECK_PARAM_NULL(elem_tr->init);
+	CHECK_PARAM_NULL(elem_tr->move);
+
+	return pqueue_construct(base, elem_tr, ax_false);
+}
+
+ax_tube *__ax_pqueue_construct_handled(ax_base *base, const ax_stuff_trait *elem_tr)
+{
+	CHECK_PARAM_NULL(base);
+	CHECK_PARAM_NULL(elem_tr);
+	CHECK_PARAM_NULL(elem_tr->less);
+	CHECK_PARAM_NULL(elem_tr->copy);
+	CHECK_PARAM_NULL(elem_tr->free);
+	CHECK_PARAM_NULL(elem_tr->init);
+	CHECK_PARAM_NULL(elem_tr->move);
+
+	return pqueue_construct(base, elem_tr, ax_true);
+}
+
+ax_pqueue_r ax_pqueue_create(ax_scope *scope, const ax_stuff_trait *elem_tr)
+{
+	CHECK_PARAM_NULL(scope);
+	CHECK_PARAM_NULL(elem_tr);
+
+	ax_base *base = ax_one_base(ax_r(scope, scope).one);
+	ax_pqueue_r self_r = { .tube = __ax_pqueue_construct(base, elem_tr) };
+	if (!self_r.one)
+		return self_r;
+	ax_scope_attach(scope, self_r.one);
+	return self_r;
+}
+
+ax_pqueue_r ax_pqueue_create_handled(ax_scope *scope, const ax_stuff_trait *elem_tr)
+{
+	CHECK_PARAM_NULL(scope);
+	CHECK_PARAM_NULL(elem_tr);
+
+	ax_base *base = ax_one_base(ax_r(scope, scope).one);
+	ax_pqueue_r self_r = { .tube = __ax_pqueue_construct_handled(base, elem_tr) };
+	if (!self_r.one)
+		return self_r;
+	ax_scope_attach(scope, self_r.one);
+	return self_r;
+}
@@ -21,7 +21,6 @@
  */
 
 #include <axe/queue.h>
-#include <axe/list.h>
 #include <axe/tube.h>
 #include <axe/base.h>
 #include <axe/pool.h>
@@ -39,12 +38,24 @@
 
 #undef free
 
-#define MIN_SIZE
+#define MIN_CAPACITY 8
 
+/*
+ * Elements live in a circular array of power-of-two capacity, the element
+ * at logical index i is stored in slot (head + i) & mask. A growable queue
+ * doubles the array when it is full, a fixed queue never reallocates and
+ * keeps one slot more than its limit, so that a new element can be built
+ * before the oldest one is overwritten.
+ */
 struct ax_queue_st
 {
 	ax_tube tube;
-	ax_list_r list;
+	ax_byte *ring;
+	size_t mask;
+	size_t head;
+	size_t size;
+	size_t limit;
+	ax_bool overwrite;
 };
 
 static ax_fail tube_push(ax_tube *tube, const void *val);
@@ -71,21 +82,125 @@ const ax_tube_trait ax_queue_tr =
 		.prime = tube_prime
 };
 
+inline static ax_byte *slot_ptr(const ax_queue *self, size_t index)
+{
+	return self->ring + ((self->head + index) & self->mask) * self->tube.env.elem_tr->size;
+}
+
+static void elem_free(const ax_stuff_trait *etr, ax_byte *ptr)
+{
+	if (!etr->trivial_free)
+		etr->free(ptr);
+}
+
+static void ring_clear(ax_queue *self)
+{
+	const ax_stuff_trait *etr = self->tube.env.elem_tr;
+	if (!etr->trivial_free)
+		for (size_t i = 0; i < self->size; i++)
+			etr->free(slot_ptr(self, i));
+	self->head = 0;
+	self->size = 0;
+}
+
+/* Reallocate the ring with capacity slots and move the elements to its front */
+static ax_fail ring_realloc(ax_queue *self, size_t capacity)
+{
+	const ax_stuff_trait *etr = self->tube.env.elem_tr;
+	ax_base *base = ax_one_base(ax_r(queue, self).one);
+	size_t esize = etr->size;
+
+	ax_byte *ring = ax_pool_alloc(ax_base_pool(base), capacity * (esize ? esize : 1));
+	if (!ring) {
+		ax_base_set_errno(base, AX_ERR_NOMEM);
+		return ax_true;
+	}
+
+	if (self->size && etr->trivial_move) {
+		size_t head = self->head & self->mask;
+		size_t first = self->mask + 1 - head;
+		if (first > self->size)
+			first = self->size;
+		memcpy(ring, self->ring + head * esize, first * esize);
+		memcpy(ring + first * esize, self->ring, (self->size - first) * esize);
+	} else {
+		for (size_t i = 0; i < self->size; i++)
+			etr->move(ring + i * esize, slot_ptr(self, i), esize);
+	}
+
+	ax_pool_free(self->ring);
+	self->ring = ring;
+	self->mask = capacity - 1;
+	self->head = 0;
+	return ax_false;
+}
+
+static size_t max_size(const ax_stuff_trait *etr)
+{
+	return ((~(size_t)0) >> 1) / (etr->size ? etr->size : 1);
+}
+
+static size_t capacity_for(size_t size)
+{
+	size_t capacity = MIN_CAPACITY;
+	while (capacity < size)
+		capacity <<= 1;
+	return capacity;
+}
 
 static ax_fail tube_push(ax_tube *tube, const void *val)
 {
 	CHECK_PARAM_NULL(tube);
 
-	ax_queue_cr self_r = { .tube = tube };
-	return ax_list_tr.push(self_r.queue->list.seq, val);
+	ax_queue *self = (ax_queue *)tube;
+	const ax_stuff_trait *etr = tube->env.elem_tr;
+	ax_base *base = ax_one_base(ax_r(tube, tube).one);
+
+	if (self->limit) {
+		if (self->size == self->limit && !self->overwrite) {
+			ax_base_set_errno(base, AX_ERR_FULL);
+			return ax_true;
+		}
+	} else if (!self->ring || self->size > self->mask) {
+		if (self->ring && self->mask + 1 > max_size(etr) / 2) {
+			ax_base_set_errno(base, AX_ERR_FULL);
+			return ax_true;
+		}
+		if (ring_realloc(self, self->ring ? (self->mask + 1) << 1 : MIN_CAPACITY))
+			return ax_true;
+	}
+
+	ax_byte *ptr = slot_ptr(self, self->size);
+	const void *pval = etr->link ? &val : val;
+	ax_fail fail = val
+		? etr->copy(ax_base_pool(base), ptr, pval, etr->size)
+		: etr->init(ax_base_pool(base), ptr, etr->size);
+	if (fail) {
+		ax_base_set_errno(base, AX_ERR_NOMEM);
+		return ax_true;
+	}
+
+	if (self->limit && self->size == self->limit) {
+		elem_free(etr, slot_ptr(self, 0));
+		self->head++;
+	} else
+		self->size++;
+	return ax_false;
 }
 
 static void tube_pop(ax_tube *tube)
 {
 	CHECK_PARAM_NULL(tube);
 
-	ax_queue_cr self_r = { .tube = tube };
-	ax_list_tr.popf(self_r.queue->list.seq);
+	ax_queue *self = (ax_queue *)tube;
+	if (self->size == 0) {
+		ax_base_set_errno(ax_one_base(ax_r(tube, tube).one), AX_ERR_EMPTY);
+		return;
+	}
+
+	elem_free(tube->env.elem_tr, slot_ptr(self, 0));
+	self->head++;
+	self->size--;
 }
 
 static size_t tube_size(const ax_tube *tube)
@@ -93,7 +208,7 @@ static size_t tube_size(const ax_tube *tube)
 	CHECK_PARAM_NULL(tube);
 
 	ax_queue_cr self_r = { .tube = tube };
-	return ax_list_tr.box.size(self_r.queue->list.box);
+	return self_r.queue->size;
 }
 
 static void *tube_prime(const ax_tube *tube)
@@ -101,17 +216,81 @@ static void *tube_prime(const ax_tube *tube)
 	CHECK_PARAM_NULL(tube);
 
 	ax_queue_cr self_r = { .tube = tube };
-	return ax_list_tr.first(self_r.queue->list.seq);
+	ax_assert(self_r.queue->size > 0, "empty");
+	ax_byte *ptr = slot_ptr(self_r.queue, 0);
+	return tube->env.elem_tr->link ? *(void **)ptr : ptr;
 }
 
 static ax_any *any_copy(const ax_any *any)
 {
+	CHECK_PARAM_NULL(any);
+
+	ax_queue_cr src_r = { .any = any };
+	const ax_queue *src = src_r.queue;
+	const ax_stuff_trait *etr = src->tube.env.elem_tr;
+	ax_base *base = ax_one_base(src_r.one);
+	ax_pool *pool = ax_base_pool(base);
+
+	ax_queue_r dst_r = { .tube = src->limit
+		? __ax_queue_construct_fixed(base, etr, src->limit, src->overwrite)
+		: __ax_queue_construct(base, etr) };
+	if (!dst_r.one)
+		return NULL;
+
+	ax_queue *dst = dst_r.queue;
+	if (src->size && !dst->ring && ring_realloc(dst, capacity_for(src->size)))
+		goto fail;
+
+	if (etr->trivial_copy) {
+		for (size_t i = 0; i < src->size; i++)
+			memcpy(slot_ptr(dst, i), slot_ptr(src, i), etr->size);
+		dst->size = src->size;
+	} else {
+		for (; dst->size < src->size; dst->size++) {
+			if (etr->copy(pool, slot_ptr(dst, dst->size), slot_ptr(src, dst->size), etr->size)) {
+				ax_base_set_errno(base, AX_ERR_NOMEM);
+				goto fail;
+			}
+		}
+	}
+
+	ax_scope_attach(ax_base_local(base), dst_r.one);
+	return dst_r.any;
+fail:
+	one_free(dst_r.one);
 	return NULL;
 }
 
 static ax_any *any_move(ax_any *any)
 {
-	return NULL;
+	CHECK_PARAM_NULL(any);
+
+	ax_queue_r src_r = { .any = any };
+	ax_base *base = ax_one_base(src_r.one);
+	ax_queue *dst = ax_pool_alloc(ax_base_pool(base), sizeof(ax_queue));
+	if (!dst) {
+		ax_base_set_errno(base, AX_ERR_NOMEM);
+		return NULL;
+	}
+
+	memcpy(dst, src_r.queue, sizeof *dst);
+	dst->tube.env.one.scope.macro = NULL;
+	dst->tube.env.one.scope.micro = 0;
+
+	ax_queue *src = src_r.queue;
+	src->ring = NULL;
+	src->mask = 0;
+	src->head = 0;
+	src->size = 0;
+	if (src->limit && ring_realloc(src, capacity_for(src->limit + 1))) {
+		ax_pool_free(dst);
+		memcpy(src, dst, sizeof *src);
+		return NULL;
+	}
+
+	ax_queue_r dst_r = { .queue = dst };
+	ax_scope_attach(ax_base_local(base), dst_r.one);
+	return dst_r.any;
 }
 
 static void one_free(ax_one *one)
@@ -121,26 +300,17 @@ static void one_free(ax_one *one)
 
 	ax_queue_r self_r = { .one = one };
 	ax_scope_detach(one);
-	ax_list_tr.box.any.one.free(self_r.queue->list.one);
+	ring_clear(self_r.queue);
+	ax_pool_free(self_r.queue->ring);
 	ax_pool_free(one);
 }
 
-ax_tube *__ax_queue_construct(ax_base *base, const ax_stuff_trait *elem_tr)
+static ax_queue *queue_alloc(ax_base *base, const ax_stuff_trait *elem_tr, size_t limit, ax_bool overwrite)
 {
-	CHECK_PARAM_NULL(base);
-	CHECK_PARAM_NULL(elem_tr);
-
-	ax_pool *pool = ax_base_pool(base);
-
-	ax_tube *self= NULL;
-	ax_seq *list = __ax_list_construct(base, elem_tr);
-	if (!list)
-		goto fail;
-
-	self = ax_pool_alloc(pool, sizeof(ax_queue));
+	ax_queue *self = ax_pool_alloc(ax_base_pool(base), sizeof(ax_queue));
 	if (!self) {
 		ax_base_set_errno(base, AX_ERR_NOMEM);
-		goto fail;
+		return NULL;
 	}
 
 	ax_queue queue_init = {
@@ -154,17 +324,48 @@ ax_tube *__ax_queue_construct(ax_base *base, const ax_stuff_trait *elem_tr)
 				.elem_tr = elem_tr
 			},
 		},
-		.list = {
-			.seq = list
-		}
+		.ring = NULL,
+		.mask = 0,
+		.head = 0,
+		.size = 0,
+		.limit = limit,
+		.overwrite = overwrite
 	};
 
 	memcpy(self, &queue_init, sizeof queue_init);
 	return self;
-fail:
-	ax_one_free(ax_r(seq, list).one);
-	ax_pool_free(self);
-	return NULL;
+}
+
+ax_tube *__ax_queue_construct(ax_base *base, const ax_stuff_trait *elem_tr)
+{
+	CHECK_PARAM_NULL(base);
+	CHECK_PARAM_NULL(elem_tr);
+
+	ax_queue *self = queue_alloc(base, elem_tr, 0, ax_false);
+	return self ? &self->tube : NULL;
+}
+
+ax_tube *__ax_queue_construct_fixed(ax_base *base, const ax_stuff_trait *elem_tr,
+		size_t capacity, ax_bool overwrite)
+{
+	CHECK_PARAM_NULL(base);
+	CHECK_PARAM_NULL(elem_tr);
+	CHECK_PARAM_VALIDITY(capacity, capacity > 0);
+
+	if (capacity >= max_size(elem_tr) / 2) {
+		ax_base_set_errno(base, AX_ERR_FULL);
+		return NULL;
+	}
+
+	ax_queue *self = queue_alloc(base, elem_tr, capacity, overwrite);
+	if (!self)
+		return NULL;
+
+	if (ring_realloc(self, capacity_for(capacity + 1))) {
+		ax_pool_free(self);
+		return NULL;
+	}
+	return &self->tube;
 }
 
 ax_queue_r ax_queue_create(ax_scope *scope, const ax_stuff_trait *elem_tr)
@@ -180,3 +381,38 @@ ax_queue_r ax_queue_create(ax_scope *scope, const ax_stuff_trait *elem_tr)
 	return self_r;
 }
 
+ax_queue_r ax_queue_create_fixed(ax_scope *scope, const ax_stuff_trait *elem_tr,
+		size_t capacity, ax_bool overwrite)
+{
+	CHECK_PARAM_NULL(scope);
+	CHECK_PARAM_NULL(elem_tr);
+
+	ax_base *base = ax_one_base(ax_r(scope, scope).one);
+	ax_queue_r self_r = { .tube = __ax_queue_construct_fixed(base, elem_tr, capacity, overwrite) };
+	if (!self_r.one)
+		return self_r;
+	ax_scope_attach(scope, self_r.one);
+	return self_r;
+}
+
+size_t ax_queue_capacity(const ax_queue *queue)
+{
+	CHECK_PARAM_NULL(queue);
+
+	if (queue->limit)
+		return queue->limit;
+	return queue->ring ? queue->mask + 1 : 0;
+}
+
+ax_fail ax_queue_reserve(ax_queue *queue, size_t size)
+{
+	CHECK_PARAM_NULL(queue);
+
+	if (queue->limit || (queue->ring && size <= queue->mask + 1))
+		return ax_false;
+	if (size > max_size(queue->tube.env.elem_tr) / 2) {
+		ax_base_set_errno(ax_one_base(ax_r(queue, queue).one), AX_ERR_FULL);
+		return ax_true;
+	}
+	return ring_realloc(queue, capacity_for(size));
+}
@@ -0,0 +1,340 @@
+/*
+ * Copyright (c) 2020 Li hsilin <lihsilyn@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#define _DEFAULT_SOURCE
+
+#include <axe/spsc.h>
+#include <axe/tube.h>
+#include <axe/base.h>
+#include <axe/pool.h>
+#include <axe/scope.h>
+#include <axe/any.h>
+#include <axe/error.h>
+
+#include <string.h>
+#include <stdint.h>
+
+#include "check.h"
+#include "waitq.h"
+
+#undef free
+
+#define CACHE_LINE 64
+#define MIN_CAPACITY 2
+
+/*
+ * head is only written by the consumer and tail only by the producer, each
+ * side keeps a stale copy of the other counter and reloads it only when the
+ * tube looks full or empty. The counters grow without bound and are masked
+ * on access, so tail - head is always the number of elements.
+ */
+struct ax_spsc_st
+{
+	ax_tube tube;
+	ax_byte *ring;
+	size_t mask;
+	ax_byte pad0[CACHE_LINE];
+	size_t head;
+	size_t tail_cache;
+	struct waitq pop_wq;
+	ax_byte pad1[CACHE_LINE];
+	size_t tail;
+	size_t head_cache;
+	struct waitq push_wq;
+	ax_byte pad2[CACHE_LINE];
+};
+
+static ax_fail tube_push(ax_tube *tube, const void *val);
+static void    tube_pop(ax_tube *tube);
+static size_t  tube_size(const ax_tube *tube);
+static void   *tube_prime(const ax_tube *tube);
+static ax_any *any_copy(const ax_any *any);
+static ax_any *any_move(ax_any *any);
+static void    one_free(ax_one *one);
+
+const ax_tube_trait ax_spsc_tr =
+{
+		.any = {
+			.one = {
+				.name = AX_SPSC_NAME,
+				.free = one_free,
+			},
+			.copy = any_copy,
+			.move = any_move
+		},
+		.push = tube_push,
+		.pop = tube_pop,
+		.size = tube_size,
+		.prime = tube_prime
+};
+
+inline static ax_byte *slot_ptr(const ax_spsc *self, size_t pos)
+{
+	return self->ring + (pos & self->mask) * self->tube.env.elem_tr->size;
+}
+
+/* Copy n elements between the ring starting at pos and a flat array */
+static void ring_copy(const ax_spsc *self, size_t pos, ax_byte *arr, size_t n, ax_bool to_ring)
+{
+	size_t esize = self->tube.env.elem_tr->size;
+	size_t first = self->mask + 1 - (pos & self->mask);
+	if (first > n)
+		first = n;
+
+	if (to_ring) {
+		memcpy(slot_ptr(self, pos), arr, first * esize);
+		memcpy(self->ring, arr + first * esize, (n - first) * esize);
+	} else {
+		memcpy(arr, slot_ptr(self, pos), first * esize);
+		memcpy(arr + first * esize, self->ring, (n - first) * esize);
+	}
+}
+
+/* Room for up to n elements, from the producer side */
+static size_t push_room(ax_spsc *self, size_t tail, size_t n)
+{
+	size_t room = self->mask + 1 - (tail - self->head_cache);
+	if (room < n) {
+		self->head_cache = __atomic_load_n(&self->head, __ATOMIC_ACQUIRE);
+		room = self->mask + 1 - (tail - self->head_cache);
+	}
+	return room < n ? room : n;
+}
+
+/* Elements ready for up to n pops, from the consumer side */
+static size_t pop_ready(ax_spsc *self, size_t head, size_t n)
+{
+	size_t ready = self->tail_cache - head;
+	if (ready < n) {
+		self->tail_cache = __atomic_load_n(&self->tail, __ATOMIC_ACQUIRE);
+		ready = self->tail_cache - head;
+	}
+	return ready < n ? ready : n;
+}
+
+size_t ax_spsc_push_n(ax_spsc *spsc, const void *arr, size_t n)
+{
+	CHECK_PARAM_NULL(spsc);
+	CHECK_PARAM_NULL(arr);
+
+	size_t tail = __atomic_load_n(&spsc->tail, __ATOMIC_RELAXED);
+	n = push_room(spsc, tail, n);
+	if (!n)
+		return 0;
+
+	ring_copy(spsc, tail, (ax_byte *)arr, n, ax_true);
+	__atomic_store_n(&spsc->tail, tail + n, __ATOMIC_RELEASE);
+	waitq_notify(&spsc->pop_wq);
+	return n;
+}
+
+size_t ax_spsc_pop_n(ax_spsc *spsc, void *arr, size_t n)
+{
+	CHECK_PARAM_NULL(spsc);
+
+	size_t head = __atomic_load_n(&spsc->head, __ATOMIC_RELAXED);
+	n = pop_ready(spsc, head, n);
+	if (!n)
+		return 0;
+
+	if (arr)
+		ring_copy(spsc, head, arr, n, ax_false);
+	__atomic_store_n(&spsc->head, head + n, __ATOMIC_RELEASE);
+	waitq_notify(&spsc->push_wq);
+	return n;
+}
+
+ax_fail ax_spsc_try_push(ax_spsc *spsc, const void *val)
+{
+	return ax_spsc_push_n(spsc, val, 1) == 0;
+}
+
+ax_fail ax_spsc_try_pop(ax_spsc *spsc, void *out)
+{
+	return ax_spsc_pop_n(spsc, out, 1) == 0;
+}
+
+void ax_spsc_push_wait(ax_spsc *spsc, const void *val)
+{
+	for (int i = 0; i < WAITQ_SPIN; i++)
+		if (!ax_spsc_try_push(spsc, val))
+			return;
+
+	for (;;) {
+		uint32_t seq = waitq_prepare(&spsc->push_wq);
+		if (!ax_spsc_try_push(spsc, val)) {
+			waitq_cancel(&spsc->push_wq);
+			return;
+		}
+		waitq_wait(&spsc->push_wq, seq);
+	}
+}
+
+void ax_spsc_pop_wait(ax_spsc *spsc, void *out)
+{
+	for (int i = 0; i < WAITQ_SPIN; i++)
+		if (!ax_spsc_try_pop(spsc, out))
+			return;
+
+	for (;;) {
+		uint32_t seq = waitq_prepare(&spsc->pop_wq);
+		if (!ax_spsc_try_pop(spsc, out)) {
+			waitq_cancel(&spsc->pop_wq);
+			return;
+		}
+		waitq_wait(&spsc->pop_wq, seq);
+	}
+}
+
+size_t ax_spsc_capacity(const ax_spsc *spsc)
+{
+	CHECK_PARAM_NULL(spsc);
+
+	return spsc->mask + 1;
+}
+
+static ax_fail tube_push(ax_tube *tube, const void *val)
+{
+	CHECK_PARAM_NULL(tube);
+
+	return ax_spsc_try_push((ax_spsc *)tube, val);
+}
+
+static void tube_pop(ax_tube *tube)
+{
+	CHECK_PARAM_NULL(tube);
+
+	ax_spsc_try_pop((ax_spsc *)tube, NULL);
+}
+
+static size_t tube_size(const ax_tube *tube)
+{
+	CHECK_PARAM_NULL(tube);
+
+	ax_spsc_cr self_r = { .tube = tube };
+	size_t head = __atomic_load_n(&self_r.spsc->head, __ATOMIC_ACQUIRE);
+	size_t tail = __atomic_load_n(&self_r.spsc->tail, __ATOMIC_ACQUIRE);
+	return tail - head;
+}
+
+static void *tube_prime(const ax_tube *tube)
+{
+	CHECK_PARAM_NULL(tube);
+
+	ax_spsc *self = (ax_spsc *)tube;
+	size_t head = __atomic_load_n(&self->head, __ATOMIC_RELAXED);
+	if (!pop_ready(self, head, 1))
+		return NULL;
+	return slot_ptr(self, head);
+}
+
+static ax_any *any_copy(const ax_any *any)
+{
+	CHECK_PARAM_NULL(any);
+
+	ax_base_set_errno(ax_one_base(ax_cr(any, any).one), AX_ERR_UNSUP);
+	return NULL;
+}
+
+static ax_any *any_move(ax_any *any)
+{
+	CHECK_PARAM_NULL(any);
+
+	ax_base_set_errno(ax_one_base(ax_r(any, any).one), AX_ERR_UNSUP);
+	return NULL;
+}
+
+static void one_free(ax_one *one)
+{
+	if (!one)
+		return;
+
+	ax_spsc_r self_r = { .one = one };
+	ax_scope_detach(one);
+	ax_pool_free(self_r.spsc->ring);
+	ax_pool_free(one);
+}
+
+ax_tube *__ax_spsc_construct(ax_base *base, const ax_stuff_trait *elem_tr, size_t capacity)
+{
+	CHECK_PARAM_NULL(base);
+	CHECK_PARAM_NULL(elem_tr);
+	CHECK_PARAM_VALIDITY(elem_tr, elem_tr->trivial_copy && elem_tr->trivial_free);
+	CHECK_PARAM_VALIDITY(capacity, capacity > 0);
+
+	ax_pool *pool = ax_base_pool(base);
+	size_t esize = elem_tr->size ? elem_tr->size : 1;
+	size_t cap = MIN_CAPACITY;
+	while (cap < capacity) {
+		if (cap > ((~(size_t)0) >> 2) / esize) {
+			ax_base_set_errno(base, AX_ERR_FULL);
+			return NULL;
+		}
+		cap <<= 1;
+	}
+
+	ax_spsc *self = ax_pool_alloc(pool, sizeof(ax_spsc));
+	if (!self) {
+		ax_base_set_errno(base, AX_ERR_NOMEM);
+		return NULL;
+	}
+
+	ax_byte *ring = ax_pool_alloc(pool, cap * esize);
+	if (!ring) {
+		ax_base_set_errno(base, AX_ERR_NOMEM);
+		ax_pool_free(self);
+		return NULL;
+	}
+
+	ax_spsc spsc_init = {
+		.tube = {
+			.tr = &ax_spsc_tr,
+			.env = {
+				.one = {
+					.base = base,
+					.scope = { NULL }
+				},
+				.elem_tr = elem_tr
+			},
+		},
+		.ring = ring,
+		.mask = cap - 1,
+	};
+	waitq_init(&spsc_init.pop_wq);
+	waitq_init(&spsc_init.push_wq);
+
+	memcpy(self, &spsc_init, sizeof spsc_init);
+	return &self->tube;
+}
+
+ax_spsc_r ax_spsc_create(ax_scope *scope, const ax_stuff_trait *elem_tr, size_t capacity)
+{
+	CHECK_PARAM_NULL(scope);
+	CHECK_PARAM_NULL(elem_tr);
+
+	ax_base *base = ax_one_base(ax_r(scope, scope).one);
+	ax_spsc_r self_r = { .tube = __ax_spsc_construct(base, elem_tr, capacity) };
+	if (!self_r.one)
+		return self_r;
+	ax_scope_attach(scope, self_r.one);
+	return self_r;
+}
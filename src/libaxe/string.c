@@ -37,13 +37,12 @@
 #include <stdio.h>
 
 #include "check.h"
-
-#define MIN_SIZE 16
+#include "sbuff.h"
 
 struct ax_string_st
 {
 	ax_str _str;
-	ax_buff_r buff_r;
+	struct sbuff_st sb;
 };
 
 static void    citer_move(ax_citer *it, long i);
@@ -77,6 +76,9 @@ static ax_fail seq_pop(ax_seq *seq);
 static ax_fail seq_trunc(ax_seq *seq, size_t size);
 static ax_iter seq_at(const ax_seq *seq, size_t index);
 static ax_fail seq_insert(ax_seq *seq, ax_iter *it, const void *val);
+static ax_fail seq_insert_range(ax_seq *seq, ax_iter *it, const ax_citer *first, const ax_citer *last);
+static ax_fail seq_insert_arr(ax_seq *seq, ax_iter *it, const void *arr, size_t len);
+static ax_fail seq_erase_range(ax_seq *seq, ax_iter *first, ax_iter *last);
 
 static size_t  box_size(const ax_box* box);
 static size_t  box_maxsize(const ax_box* box);
@@ -104,23 +106,23 @@ ax_bool iter_if_have_value(const ax_citer *it);
 ax_bool iter_if_valid(const ax_citer *it)
 {
 	const ax_string *self = it->owner;
-	const ax_buff *buff = self->buff_r.buff;
-	const ax_byte *ptr = ax_buff_cptr(buff);
+	const struct sbuff_st *buff = &self->sb;
+	const ax_byte *ptr = sbuff_cptr(buff);
 	return ax_citer_norm(it)
 		? (ax_byte *)it->point >= ptr && (ax_byte *)it->point <= ptr
-				+ ax_buff_size(buff, NULL) - sizeof(char)
+				+ sbuff_size(buff) - sizeof(char)
 		: (ax_byte *)it->point >= ptr - sizeof(char)
-				&& (ax_byte *)it->point <= ptr + ax_buff_size(buff, NULL) - 2 * sizeof(char);
+				&& (ax_byte *)it->point <= ptr + sbuff_size(buff) - 2 * sizeof(char);
 
 }
 
 ax_bool iter_if_have_value(const ax_citer *it)
 {
 	const ax_string *self = it->owner;
-	const ax_buff *buff = self->buff_r.buff;
-	const ax_byte *ptr = ax_buff_cptr(buff);
+	const struct sbuff_st *buff = &self->sb;
+	const ax_byte *ptr = sbuff_cptr(buff);
 	return (ax_byte *)it->point >= ptr
-		&& (ax_byte *)it->point <= ptr + ax_buff_size(buff, NULL) - 2 * sizeof(char);
+		&& (ax_byte *)it->point <= ptr + sbuff_size(buff) - 2 * sizeof(char);
 }
 
 #endif
@@ -175,7 +177,7 @@ static void rciter_move(ax_citer *it, long i)
 {
 	CHECK_PARAM_NULL(it);
 	CHECK_PARAM_VALIDITY(it, iter_if_valid(it));
-	it->point = (char *)it->point + i;
+	it->point = (char *)it->point - i;
 	CHECK_PARAM_VALIDITY(i, iter_if_valid(it));
 }
 
@@ -184,7 +186,7 @@ static void rciter_prev(ax_citer *it)
 	CHECK_PARAM_NULL(it);
 
 	CHECK_PARAM_VALIDITY(it, iter_if_valid(it));
-	it->point = (char *)it->point - 1;
+	it->point = (char *)it->point + 1;
 	CHECK_PARAM_VALIDITY(it , iter_if_valid(it));
 }
 
@@ -193,7 +195,7 @@ static void rciter_next(ax_citer *it)
 	CHECK_PARAM_NULL(it);
 
 	CHECK_PARAM_VALIDITY(it , iter_if_valid(it));
-	it->point = (char *)it->point + 1;
+	it->point = (char *)it->point - 1;
 	CHECK_PARAM_VALIDITY(it , iter_if_valid(it));
 }
 
@@ -237,24 +239,34 @@ static ax_fail iter_set(const ax_iter *it, const void *val)
 	return ax_false;
 }
 
+inline static ax_fail buff_adapt(ax_string *self, size_t size)
+{
+	return sbuff_adapt(&self->sb, ax_one_base(ax_r(string, self).one), size);
+}
+
+inline static ax_fail buff_resize(ax_string *self, size_t size)
+{
+	return sbuff_resize(&self->sb, ax_one_base(ax_r(string, self).one), size);
+}
+
 static void iter_erase(ax_iter *it)
 {
 	CHECK_PARAM_NULL(it);
 	CHECK_PARAM_VALIDITY(it, iter_if_have_value(ax_iter_c(it)));
 
 	ax_string *self = it->owner;
-	ax_buff *buff = self->buff_r.buff;
+	struct sbuff_st *buff = &self->sb;
 
-	size_t size = ax_buff_size(buff, NULL);
-	size_t nchar = size / sizeof(char);
-	char *ptr = ax_buff_ptr(buff);
+	size_t size = sbuff_size(buff);
+	char *ptr = sbuff_ptr(buff);
 	size_t off = (char *)it->point - ptr;
 
-	memmove(ptr + off + 1, ptr + off, size - (off + 1) * sizeof(char));
-	ptr[nchar - 2] = '\0';
-	(void)ax_buff_adapt(buff, size - sizeof(char));
+	/* The terminating NUL moves down along with the tail */
+	memmove(ptr + off, ptr + off + 1, size - (off + 1) * sizeof(char));
+	(void)buff_adapt(self, size - sizeof(char));
 
-	it->point = ptr + off + (ax_iter_norm(it) ? 0 : 1);
+	ptr = sbuff_ptr(buff);
+	it->point = ptr + off - (ax_iter_norm(it) ? 0 : 1);
 }
 
 static void one_free(ax_one* one)
@@ -264,7 +276,7 @@ static void one_free(ax_one* one)
 
 	ax_string *self = (ax_string *) one;
 	ax_scope_detach(one);
-	ax_one_free(self->buff_r.one);
+	sbuff_free(&self->sb);
 	ax_pool_free(one);
 }
 
@@ -281,30 +293,25 @@ static ax_any* any_copy(const ax_any* any)
 	ax_base *base = ax_one_base(self_r.one);
 	ax_pool *pool = ax_base_pool(base);
 
-	ax_buff_r new_buf_r = { NULL };
 	ax_string_r new_str_r = { NULL };
 
 	new_str_r.string = ax_pool_alloc(pool, (sizeof(ax_string)));
 	if (!new_str_r.string) {
 		ax_base_set_errno(base, AX_ERR_NOMEM);
-		goto fail;
+		return NULL;
 	}
 
-	new_buf_r.any = ax_any_copy(self_r.string->buff_r.any);
-	if (!new_buf_r.any)
-		goto fail;
-
 	memcpy(new_str_r.string, self_r.string, sizeof(ax_string));
+	if (sbuff_copy(&new_str_r.string->sb, &self_r.string->sb)) {
+		ax_pool_free(new_str_r.string);
+		return NULL;
+	}
 
 	new_str_r.string->_str.env.one.scope.macro = NULL;
 	new_str_r.string->_str.env.one.scope.micro = 0;
 	ax_scope_attach(ax_base_local(base), new_str_r.one);
 
 	return new_str_r.any;
-fail:
-	ax_one_free(new_buf_r.one);
-	ax_one_free(new_str_r.one);
-	return NULL;
 }
 
 static ax_any* any_move(ax_any* any)
@@ -315,31 +322,24 @@ static ax_any* any_move(ax_any* any)
 	ax_base *base = ax_one_base(self_r.one);
 	ax_pool *pool = ax_base_pool(base);
 
-	ax_buff_r new_buf_r = { NULL };
 	ax_string_r new_str_r = { NULL };
 
 	new_str_r.string = ax_pool_alloc(pool, (sizeof(ax_string)));
 	if (!new_str_r.string) {
 		ax_base_set_errno(base, AX_ERR_NOMEM);
-		goto fail;
+		return NULL;
 	}
 
-	new_buf_r.any = ax_any_move(self_r.string->buff_r.any);
-	if (!new_buf_r.any)
-		goto fail;
-
 	memcpy(new_str_r.string, self_r.string, sizeof(ax_string));
+	sbuff_move(&new_str_r.string->sb, &self_r.string->sb);
+	sbuff_resize(&self_r.string->sb, base, sizeof(char));
+	*(char *)sbuff_ptr(&self_r.string->sb) = '\0';
 
 	new_str_r.string->_str.env.one.scope.macro = NULL;
 	new_str_r.string->_str.env.one.scope.micro = 0;
 	ax_scope_attach(ax_base_local(base), new_str_r.one);
 
 	return new_str_r.any;
-fail:
-	ax_one_free(new_buf_r.one);
-	ax_one_free(new_str_r.one);
-	return NULL;
-
 }
 
 static size_t box_size(const ax_box* box)
@@ -347,7 +347,7 @@ static size_t box_size(const ax_box* box)
 	CHECK_PARAM_NULL(box);
 
 	ax_string_cr self_r = { .box = box };
-	size_t bsize = ax_buff_size(self_r.string->buff_r.buff, NULL);
+	size_t bsize = sbuff_size(&self_r.string->sb);
 	return bsize / sizeof(char) - 1;
 }
 
@@ -356,7 +356,7 @@ static size_t box_maxsize(const ax_box* box)
 	CHECK_PARAM_NULL(box);
 
 	ax_string_cr self_r = { .box = box };
-	size_t maxsize = ax_buff_max(self_r.string->buff_r.buff);
+	size_t maxsize = sbuff_max(&self_r.string->sb);
 	return maxsize / sizeof(char) - 1;
 }
 
@@ -368,7 +368,7 @@ static ax_iter box_begin(ax_box* box)
 	return (ax_iter) {
 		.owner = box,
 		.tr = &iter_trait,
-		.point = (ax_byte *)ax_buff_ptr(self_r.string->buff_r.buff)
+		.point = (ax_byte *)sbuff_ptr(&self_r.string->sb)
 	};
 }
 
@@ -377,11 +377,11 @@ static ax_iter box_end(ax_box* box)
 	CHECK_PARAM_NULL(box);
 
 	ax_string_r self_r = { .box = box };
-	ax_buff *buff = self_r.string->buff_r.buff;
+	struct sbuff_st *buff = &self_r.string->sb;
 	return (ax_iter) {
 		.owner = box,
 		.tr = &iter_trait,
-		.point = (ax_byte *)ax_buff_ptr(buff) + ax_buff_size(buff, NULL) - sizeof(char)
+		.point = (ax_byte *)sbuff_ptr(buff) + sbuff_size(buff) - sizeof(char)
 	};
 }
 
@@ -390,11 +390,11 @@ static ax_iter box_rbegin(ax_box* box)
 	CHECK_PARAM_NULL(box);
 
 	ax_string_r self_r = { .box = box };
-	ax_buff *buff = self_r.string->buff_r.buff;
+	struct sbuff_st *buff = &self_r.string->sb;
 	return (ax_iter) {
 		.owner = box,
 		.tr = &riter_trait,
-		.point = (ax_byte *)ax_buff_ptr(buff) + ax_buff_size(buff, NULL) - 2 * sizeof(char)
+		.point = (ax_byte *)sbuff_ptr(buff) + sbuff_size(buff) - 2 * sizeof(char)
 	};
 }
 
@@ -406,7 +406,7 @@ static ax_iter box_rend(ax_box* box)
 	return (ax_iter) {
 		.owner = box,
 		.tr = &riter_trait,
-		.point = (ax_byte *)ax_buff_ptr(self_r.string->buff_r.buff) - sizeof(char)
+		.point = (ax_byte *)sbuff_ptr(&self_r.string->sb) - sizeof(char)
 	};
 }
 
@@ -415,11 +415,11 @@ static void box_clear(ax_box* box)
 	CHECK_PARAM_NULL(box);
 
 	ax_string_r self_r = { .box = (ax_box *)box };
-	ax_buff *buff = self_r.string->buff_r.buff;
+	struct sbuff_st *buff = &self_r.string->sb;
 
-	(void)ax_buff_resize(buff, sizeof(char)); // Always success
+	(void)buff_resize(self_r.string, sizeof(char)); // Always success
 
-	char *ptr = ax_buff_ptr(buff);
+	char *ptr = sbuff_ptr(buff);
 	ptr[0] = '\0';
 }
 
@@ -435,16 +435,16 @@ static ax_fail str_append(ax_str* str, const char *s)
 	CHECK_PARAM_NULL(s);
 
 	ax_string_r self_r = { .str = str };
-	ax_buff *buff = self_r.string->buff_r.buff;
+	struct sbuff_st *buff = &self_r.string->sb;
 
 	size_t append_len = strlen(s) * sizeof(char);
-	size_t old_size = ax_buff_size(buff, NULL);
+	size_t old_size = sbuff_size(buff);
 	size_t new_size = old_size + append_len;
 	
-	if (ax_buff_adapt(buff, new_size))
+	if (buff_adapt(self_r.string, new_size))
 		goto fail;
 
-	char *ptr = ax_buff_ptr(buff);
+	char *ptr = sbuff_ptr(buff);
 	memcpy(ptr + old_size - sizeof(char), s, append_len + sizeof(char));
 	
 	return ax_false;
@@ -465,12 +465,12 @@ static ax_fail str_insert(ax_str* str, size_t start, const char *s)
 	CHECK_PARAM_VALIDITY(start, start < str_length(str));
 	
 	ax_string_r self_r = { .str = str };
-	ax_buff *buff = self_r.string->buff_r.buff;
+	struct sbuff_st *buff = &self_r.string->sb;
 
 	size_t insert_len = strlen(s);
-	size_t old_bsize = ax_buff_size(buff, NULL);
-	ax_buff_adapt(buff, old_bsize + insert_len);
-	char *ptr = ax_buff_ptr(buff);
+	size_t old_bsize = sbuff_size(buff);
+	buff_adapt(self_r.string, old_bsize + insert_len);
+	char *ptr = sbuff_ptr(buff);
 	memmove(ptr + (start + insert_len), ptr + start, old_bsize - start);
 	memcpy(ptr + start, s, insert_len);
 
@@ -482,8 +482,8 @@ static char *str_strz(ax_str* str)
 	CHECK_PARAM_NULL(str);
 
 	ax_string_r self_r = { .str = str };
-	ax_buff *buff = self_r.string->buff_r.buff;
-	return ax_buff_ptr(buff);
+	struct sbuff_st *buff = &self_r.string->sb;
+	return sbuff_ptr(buff);
 }
 
 static int str_comp(const ax_str* str, const char* s)
@@ -492,8 +492,8 @@ static int str_comp(const ax_str* str, const char* s)
 	CHECK_PARAM_NULL(s);
 
 	ax_string_cr self_r = { .str = str };
-	ax_buff *buff = self_r.string->buff_r.buff;
-	char *ptr = (char*) ax_buff_ptr(buff);
+	struct sbuff_st *buff = (struct sbuff_st *)&self_r.string->sb;
+	char *ptr = (char*) sbuff_ptr(buff);
 	return strcmp(ptr, s);
 }
 
@@ -504,7 +504,7 @@ static ax_str *str_substr (const ax_str* str, size_t start, size_t len)
 	CHECK_PARAM_VALIDITY(len, start + len < ax_str_length(str));
 
 	ax_string_cr self_r = { .str = str };
-	ax_buff *buff = self_r.string->buff_r.buff;
+	struct sbuff_st *buff = (struct sbuff_st *)&self_r.string->sb;
 	ax_base *base = ax_one_base(self_r.one);
 
 	ax_string_r ret_r = { NULL };
@@ -513,7 +513,7 @@ static ax_str *str_substr (const ax_str* str, size_t start, size_t len)
 		goto fail;
 	}
 
-	char* buffer = ax_buff_ptr(buff);
+	char* buffer = sbuff_ptr(buff);
 	char back = buffer[start + len];
 	buffer[start + len] = '\0';
 	if (ax_str_append(ret_r.str, buffer + start))
@@ -530,10 +530,10 @@ static ax_seq *str_split (const ax_str* str, const char ch)
 	CHECK_PARAM_NULL(str);
 
 	ax_string_cr self_r = { .str = str };
-	ax_buff *buff = self_r.string->buff_r.buff;
+	struct sbuff_st *buff = (struct sbuff_st *)&self_r.string->sb;
 	ax_base *base = ax_one_base(self_r.one);
 
-	char *buffer = ax_buff_ptr(buff);
+	char *buffer = sbuff_ptr(buff);
 	char *cur = buffer, *head = buffer;
 
 	ax_vector_r ret_r = { NULL };
@@ -588,17 +588,17 @@ static ax_fail seq_insert(ax_seq *seq, ax_iter *it, const void *val)
 		return ax_false;
 
 	ax_string *self = (ax_string *) seq;
-	ax_buff *buff = self->buff_r.buff;
+	struct sbuff_st *buff = &self->sb;
 
-	char *ptr = ax_buff_ptr(buff);
-	size_t old_size = ax_buff_size(self->buff_r.buff, NULL);
+	char *ptr = sbuff_ptr(buff);
+	size_t old_size = sbuff_size(&self->sb);
 
 	long offset = (char *)it->point - ptr; //backup offset before realloc
 
-	if (ax_buff_adapt(self->buff_r.buff, old_size + sizeof(char)))
+	if (buff_adapt(self, old_size + sizeof(char)))
 		return ax_true;
 
-	ptr = ax_buff_ptr(self->buff_r.buff);
+	ptr = sbuff_ptr(&self->sb);
 	it->point = ptr + offset; //restore offset
 
 	size_t nchar = old_size / sizeof(char);
@@ -612,6 +612,128 @@ static ax_fail seq_insert(ax_seq *seq, ax_iter *it, const void *val)
 	return ax_false;
 }
 
+/* Open count chars in front of it with a single resize, the terminating NUL moves along */
+static char *open_gap(ax_string *self, ax_iter *it, size_t count)
+{
+	struct sbuff_st *buff = &self->sb;
+	char *ptr = sbuff_ptr(buff);
+	size_t size = sbuff_size(buff);
+
+	if (count > sbuff_max(buff) - size) {
+		ax_base_set_errno(ax_one_base(ax_r(string, self).one), AX_ERR_FULL);
+		return NULL;
+	}
+
+	long offset = (char *)it->point - ptr;
+	if (buff_adapt(self, size + count * sizeof(char)))
+		return NULL;
+
+	ptr = sbuff_ptr(buff);
+	it->point = ptr + offset;
+
+	char *ins = ptr + offset + (ax_iter_norm(it) ? 0 : 1);
+	memmove(ins + count, ins, ptr + size - ins);
+	return ins;
+}
+
+/* NUL chars would end the string early, they are skipped as seq_insert does */
+static ax_fail seq_insert_range(ax_seq *seq, ax_iter *it, const ax_citer *first, const ax_citer *last)
+{
+	CHECK_PARAM_NULL(seq);
+	CHECK_PARAM_NULL(it);
+	CHECK_PARAM_NULL(first);
+	CHECK_PARAM_NULL(last);
+	CHECK_PARAM_VALIDITY(it, it->owner == seq && iter_if_valid(ax_iter_c(it)));
+	CHECK_PARAM_VALIDITY(first, first->owner != seq && first->owner == last->owner);
+
+	ax_string *self = (ax_string *) seq;
+
+	size_t count = 0;
+	for (ax_citer cur = *first; !ax_citer_equal(&cur, last); ax_citer_next(&cur))
+		count += *(char *)ax_citer_get(&cur) != '\0';
+	if (count == 0)
+		return ax_false;
+
+	char *ins = open_gap(self, it, count);
+	if (!ins)
+		return ax_true;
+
+	size_t i = 0;
+	for (ax_citer cur = *first; i < count; ax_citer_next(&cur)) {
+		char ch = *(char *)ax_citer_get(&cur);
+		if (ch == '\0')
+			continue;
+		ins[ax_iter_norm(it) ? i : count - 1 - i] = ch;
+		i++;
+	}
+
+	if (ax_iter_norm(it))
+		it->point = (char *)it->point + count;
+	return ax_false;
+}
+
+static ax_fail seq_insert_arr(ax_seq *seq, ax_iter *it, const void *arr, size_t len)
+{
+	CHECK_PARAM_NULL(seq);
+	CHECK_PARAM_NULL(it);
+	CHECK_PARAM_VALIDITY(arr, arr || len == 0);
+	CHECK_PARAM_VALIDITY(it, it->owner == seq && iter_if_valid(ax_iter_c(it)));
+
+	ax_string *self = (ax_string *) seq;
+	const char *src = arr;
+
+	size_t count = 0;
+	for (size_t i = 0; i < len; i++)
+		count += src[i] != '\0';
+	if (count == 0)
+		return ax_false;
+
+	char *ins = open_gap(self, it, count);
+	if (!ins)
+		return ax_true;
+
+	if (count == len && ax_iter_norm(it))
+		memcpy(ins, src, len);
+	else
+		for (size_t i = 0, j = 0; i < len; i++)
+			if (src[i] != '\0') {
+				ins[ax_iter_norm(it) ? j : count - 1 - j] = src[i];
+				j++;
+			}
+
+	if (ax_iter_norm(it))
+		it->point = (char *)it->point + count;
+	return ax_false;
+}
+
+static ax_fail seq_erase_range(ax_seq *seq, ax_iter *first, ax_iter *last)
+{
+	CHECK_PARAM_NULL(seq);
+	CHECK_PARAM_NULL(first);
+	CHECK_PARAM_NULL(last);
+	CHECK_PARAM_VALIDITY(first, first->owner == seq && iter_if_valid(ax_iter_c(first)));
+	CHECK_PARAM_VALIDITY(last, last->owner == seq && iter_if_valid(ax_iter_c(last)));
+	CHECK_PARAM_VALIDITY(last, first->tr == last->tr);
+
+	ax_string *self = (ax_string *) seq;
+	char *ptr = sbuff_ptr(&self->sb);
+	size_t size = sbuff_size(&self->sb);
+
+	char *lo = ax_iter_norm(first) ? (char *)first->point : (char *)last->point + 1;
+	char *hi = ax_iter_norm(first) ? (char *)last->point : (char *)first->point + 1;
+	CHECK_PARAM_VALIDITY(last, lo <= hi);
+	if (lo == hi)
+		return ax_false;
+
+	memmove(lo, hi, ptr + size - hi);
+
+	size_t shift = lo - ptr;
+	(void)buff_adapt(self, size - (hi - lo));
+	first->point = (char *)sbuff_ptr(&self->sb) + shift - (ax_iter_norm(first) ? 0 : 1);
+	last->point = first->point;
+	return ax_false;
+}
+
 static ax_fail seq_push(ax_seq *seq, const void *val)
 {
 	CHECK_PARAM_NULL(seq);
@@ -622,13 +744,13 @@ static ax_fail seq_push(ax_seq *seq, const void *val)
 
 	ax_string *self = (ax_string *) seq;
 
-	size_t size = ax_buff_size(self->buff_r.buff, NULL);
+	size_t size = sbuff_size(&self->sb);
 
 	size += sizeof(char);
-	if (ax_buff_adapt(self->buff_r.buff, size))
+	if (buff_adapt(self, size))
 		return ax_true;
 
-	char *ptr = ax_buff_ptr(self->buff_r.buff);
+	char *ptr = sbuff_ptr(&self->sb);
 
 	size_t nchar = size / sizeof(char);
 
@@ -643,8 +765,8 @@ static ax_fail seq_pop(ax_seq *seq)
 	CHECK_PARAM_NULL(seq);
 
 	ax_string *self = (ax_string *) seq;
-	size_t size = ax_buff_size(self->buff_r.buff, NULL);
-	char *ptr = ax_buff_ptr(self->buff_r.buff);
+	size_t size = sbuff_size(&self->sb);
+	char *ptr = sbuff_ptr(&self->sb);
 
 	if (size == sizeof('\0')) {
 		ax_base *base = ax_one_base(ax_r(string, self).one);
@@ -653,7 +775,7 @@ static ax_fail seq_pop(ax_seq *seq)
 	}
 
 	size -= sizeof(char);
-	if (ax_buff_adapt(self->buff_r.buff, size))
+	if (buff_adapt(self, size))
 		return ax_true;
 	size_t nchar = size / sizeof(char);
 	ptr[nchar - 1] = '\0';
@@ -666,8 +788,8 @@ static void seq_invert(ax_seq *seq)
 	CHECK_PARAM_NULL(seq);
 
 	ax_string *self = (ax_string *) seq;
-	size_t size = ax_buff_size(self->buff_r.buff, NULL);
-	char *ptr = ax_buff_ptr(self->buff_r.buff);
+	size_t size = sbuff_size(&self->sb);
+	char *ptr = sbuff_ptr(&self->sb);
 
 	if (size == sizeof('\0'))
 		return;
@@ -686,7 +808,7 @@ static ax_fail seq_trunc(ax_seq *seq, size_t size)
 	CHECK_PARAM_VALIDITY(size, size <= ax_box_maxsize(ax_r(seq, seq).box));
 
 	ax_string_r self_r = { .seq = seq };
-	ax_buff *buff = self_r.string->buff_r.buff;
+	struct sbuff_st *buff = &self_r.string->sb;
 
 	size_t old_size = ax_str_length(self_r.str);
 
@@ -694,9 +816,9 @@ static ax_fail seq_trunc(ax_seq *seq, size_t size)
 		return ax_false;
 
 
-	if (ax_buff_adapt(buff, size + sizeof(char)))
+	if (buff_adapt(self_r.string, size + sizeof(char)))
 		return ax_true;
-	char *ptr = ax_buff_ptr(buff);
+	char *ptr = sbuff_ptr(buff);
 
 	if (size < old_size)
 		ptr[size - 1] =  '\0';
@@ -711,9 +833,9 @@ static ax_iter seq_at(const ax_seq *seq, size_t index)
 	CHECK_PARAM_VALIDITY(index, index <= ax_box_size(ax_cr(seq, seq).box));
 
 	ax_string_cr self_r = { .seq = seq };
-	ax_buff *buff = self_r.string->buff_r.buff;
+	struct sbuff_st *buff = (struct sbuff_st *)&self_r.string->sb;
 
-	char *ptr = ax_buff_ptr(buff);
+	char *ptr = sbuff_ptr(buff);
 
 	ax_iter it = {
 		.owner = (void *)self_r.one,
@@ -721,7 +843,7 @@ static ax_iter seq_at(const ax_seq *seq, size_t index)
 		.point =  ptr + index
 	};
 
-	CHECK_PARAM_VALIDITY(index, iter_if_have_value(ax_iter_c(&it)));
+	CHECK_PARAM_VALIDITY(index, iter_if_valid(ax_iter_c(&it)));
 	return it;
 }
 
@@ -755,6 +877,9 @@ static const ax_str_trait str_trait =
 		.trunc = seq_trunc,
 		.at = seq_at,
 		.insert = seq_insert,
+		.insert_range = seq_insert_range,
+		.insert_arr = seq_insert_arr,
+		.erase_range = seq_erase_range,
 	},
 	.append = str_append,
 	.length = str_length,
@@ -770,7 +895,7 @@ static const ax_iter_trait iter_trait =
 {
 	.ctr = {
 		.norm   = ax_true,
-		.type   = AX_IT_RAND,
+		.type   = AX_IT_CONT,
 		.move   = citer_move,
 		.prev   = citer_prev,
 		.next   = citer_next,
@@ -804,18 +929,13 @@ ax_str *__ax_string_construct(ax_base* base)
 	CHECK_PARAM_NULL(base);
 	
 	ax_string *self = NULL;
-	ax_buff_r buff_r = { NULL };
 
 	self = ax_pool_alloc(ax_base_pool(base), sizeof(ax_string));
 	if (self == NULL) {
 		ax_base_set_errno(base, AX_ERR_NOMEM);
-		goto fail;
+		return NULL;
 	}
 
-	buff_r.any = __ax_buff_construct(base);
-	if (!buff_r.any)
-		goto fail;
-
 	ax_string string_init = {
 		._str = {
 			.tr = &str_trait,
@@ -827,20 +947,13 @@ ax_str *__ax_string_construct(ax_base* base)
 				.elem_tr = ax_stuff_traits(AX_ST_I8)
 			},
 		},
-		.buff_r = buff_r
 	};
-	char zero = '\0';
-	ax_buff_reserve(buff_r.buff, MIN_SIZE * sizeof(char));
-	ax_buff_resize(buff_r.buff, sizeof(char));
-	char *ptr = ax_buff_ptr(buff_r.buff);
-	ptr[0] = zero;
 
 	memcpy(self, &string_init, sizeof string_init);
+	sbuff_init(&self->sb);
+	(void)sbuff_resize(&self->sb, base, sizeof(char)); // Always inline
+	*(char *)sbuff_ptr(&self->sb) = '\0';
 	return ax_r(string, self).str;
-fail:
-	ax_one_free(buff_r.one);
-	ax_pool_free(self);
-	return NULL;
 }
 
 ax_string_r ax_string_create(ax_scope *scope)
@@ -164,22 +164,22 @@ static ax_bool less_i64(const void* p1, const void* p2, size_t size)
 
 static ax_bool less_u8(const void* p1, const void* p2, size_t size)
 {
-	return *(int8_t*) p1 < *(int8_t*) p2;
+	return *(uint8_t*) p1 < *(uint8_t*) p2;
 }
 
 static ax_bool less_u16(const void* p1, const void* p2, size_t size)
 {
-	return *(int16_t*)p1 < *(int16_t*)p2;
+	return *(uint16_t*)p1 < *(uint16_t*)p2;
 }
 
 static ax_bool less_u32(const void* p1, const void* p2, size_t size)
 {
-	return *(int32_t*)p1 < *(int32_t*)p2;
+	return *(uint32_t*)p1 < *(uint32_t*)p2;
 }
 
 static ax_bool less_u64(const void* p1, const void* p2, size_t size)
 {
-	return *(int64_t*)p1 < *(int64_t*)p2;
+	return *(uint64_t*)p1 < *(uint64_t*)p2;
 }
 
 static ax_bool less_f(const void* p1, const void* p2, size_t size)
@@ -352,7 +352,10 @@ static const ax_stuff_trait trait_nil = {
 	.move  = ax_stuff_mem_move,
 	.swap  = ax_stuff_mem_swap,
 	.init  = ax_stuff_mem_init,
-	.link  = ax_false
+	.link  = ax_false,
+	.trivial_copy = ax_true,
+	.trivial_move = ax_true,
+	.trivial_free = ax_true
 };
 
 
@@ -366,7 +369,10 @@ static const ax_stuff_trait trait_i8 = {
 	.move  = ax_stuff_mem_move,
 	.swap  = ax_stuff_mem_swap,
 	.init  = ax_stuff_mem_init,
-	.link  = ax_false
+	.link  = ax_false,
+	.trivial_copy = ax_true,
+	.trivial_move = ax_true,
+	.trivial_free = ax_true
 };
 
 static const ax_stuff_trait trait_i16 = { 
@@ -379,7 +385,10 @@ static const ax_stuff_trait trait_i16 = {
 	.move  = ax_stuff_mem_move,
 	.swap  = ax_stuff_mem_swap,
 	.init  = ax_stuff_mem_init,
-	.link  = ax_false
+	.link  = ax_false,
+	.trivial_copy = ax_true,
+	.trivial_move = ax_true,
+	.trivial_free = ax_true
 };
 
 static const ax_stuff_trait trait_i32 = { 
@@ -392,7 +401,10 @@ static const ax_stuff_trait trait_i32 = {
 	.move  = ax_stuff_mem_move,
 	.swap  = ax_stuff_mem_swap,
 	.init  = ax_stuff_mem_init,
-	.link  = ax_false
+	.link  = ax_false,
+	.trivial_copy = ax_true,
+	.trivial_move = ax_true,
+	.trivial_free = ax_true
 };
 
 static const ax_stuff_trait trait_i64 = { 
@@ -405,7 +417,10 @@ static const ax_stuff_trait trait_i64 = {
 	.move  = ax_stuff_mem_move,
 	.swap  = ax_stuff_mem_swap,
 	.init  = ax_stuff_mem_init,
-	.link  = ax_false
+	.link  = ax_false,
+	.trivial_copy = ax_true,
+	.trivial_move = ax_true,
+	.trivial_free = ax_true
 };
 
 static const ax_stuff_trait trait_u8 = { 
@@ -418,7 +433,10 @@ static const ax_stuff_trait trait_u8 = {
 	.move  = ax_stuff_mem_move,
 	.swap  = ax_stuff_mem_swap,
 	.init  = ax_stuff_mem_init,
-	.link  = ax_false
+	.link  = ax_false,
+	.trivial_copy = ax_true,
+	.trivial_move = ax_true,
+	.trivial_free = ax_true
 };
 
 static const ax_stuff_trait trait_u16 = { 
@@ -431,7 +449,10 @@ static const ax_stuff_trait trait_u16 = {
 	.move  = ax_stuff_mem_move,
 	.swap  = ax_stuff_mem_swap,
 	.init  = ax_stuff_mem_init,
-	.link  = ax_false
+	.link  = ax_false,
+	.trivial_copy = ax_true,
+	.trivial_move = ax_true,
+	.trivial_free = ax_true
 };
 
 static const ax_stuff_trait trait_u32 = { 
@@ -444,7 +465,10 @@ static const ax_stuff_trait trait_u32 = {
 	.move  = ax_stuff_mem_move,
 	.swap  = ax_stuff_mem_swap,
 	.init  = ax_stuff_mem_init,
-	.link  = ax_false
+	.link  = ax_false,
+	.trivial_copy = ax_true,
+	.trivial_move = ax_true,
+	.trivial_free = ax_true
 };
 
 static const ax_stuff_trait trait_u64 = { 
@@ -457,7 +481,10 @@ static const ax_stuff_trait trait_u64 = {
 	.move  = ax_stuff_mem_move,
 	.swap  = ax_stuff_mem_swap,
 	.init  = ax_stuff_mem_init,
-	.link  = ax_false
+	.link  = ax_false,
+	.trivial_copy = ax_true,
+	.trivial_move = ax_true,
+	.trivial_free = ax_true
 };
 
 static const ax_stuff_trait trait_z = { 
@@ -470,7 +497,10 @@ static const ax_stuff_trait trait_z = {
 	.move  = ax_stuff_mem_move,
 	.swap  = ax_stuff_mem_swap,
 	.init  = ax_stuff_mem_init,
-	.link  = ax_false
+	.link  = ax_false,
+	.trivial_copy = ax_true,
+	.trivial_move = ax_true,
+	.trivial_free = ax_true
 };
 
 static const ax_stuff_trait trait_f = { 
@@ -483,7 +513,10 @@ static const ax_stuff_trait trait_f = {
 	.move  = ax_stuff_mem_move,
 	.swap  = ax_stuff_mem_swap,
 	.init  = ax_stuff_mem_init,
-	.link  = ax_false
+	.link  = ax_false,
+	.trivial_copy = ax_true,
+	.trivial_move = ax_true,
+	.trivial_free = ax_true
 };
 
 static const ax_stuff_trait trait_lf = { 
@@ -496,7 +529,10 @@ static const ax_stuff_trait trait_lf = {
 	.move  = ax_stuff_mem_move,
 	.swap  = ax_stuff_mem_swap,
 	.init  = ax_stuff_mem_init,
-	.link  = ax_false
+	.link  = ax_false,
+	.trivial_copy = ax_true,
+	.trivial_move = ax_true,
+	.trivial_free = ax_true
 };
 
 static const ax_stuff_trait trait_ptr= { 
@@ -509,7 +545,10 @@ static const ax_stuff_trait trait_ptr= {
 	.move  = ax_stuff_mem_move,
 	.swap  = ax_stuff_mem_swap,
 	.init  = ax_stuff_mem_init,
-	.link  = ax_false
+	.link  = ax_false,
+	.trivial_copy = ax_true,
+	.trivial_move = ax_true,
+	.trivial_free = ax_true
 };
 
 static const ax_stuff_trait trait_s = { 
@@ -21,8 +21,10 @@
  */
 
 #include <axe/trie.h>
-#include <axe/list.h>
+#include <axe/vector.h>
 #include <axe/base.h>
+#include <axe/error.h>
+#include <string.h>
 
 ax_fail ax_trie_enum(ax_trie *trie, ax_trie_enum_cb_f cb, void *ctx)
 {
@@ -31,21 +33,30 @@ ax_fail ax_trie_enum(ax_trie *trie, ax_trie_enum_cb_f cb, void *ctx)
 	ax_base *base = ax_one_base(self_r.one);
 	
 	ax_stuff_trait iter_tr = {
-		.size = sizeof(ax_iter),
-		.copy = ax_stuff_mem_copy,
-		.init = ax_stuff_mem_init,
-		.free = ax_stuff_mem_free
+		.size  = sizeof(ax_iter),
+		.equal = ax_stuff_mem_equal,
+		.less  = ax_stuff_mem_less,
+		.hash  = ax_stuff_mem_hash,
+		.free  = ax_stuff_mem_free,
+		.copy  = ax_stuff_mem_copy,
+		.move  = ax_stuff_mem_move,
+		.swap  = ax_stuff_mem_swap,
+		.init  = ax_stuff_mem_init,
+		.link  = ax_false,
+		.trivial_copy = ax_true,
+		.trivial_move = ax_true,
+		.trivial_free = ax_true
 	};
 
-	ax_list_r list_r = { NULL };
-	ax_list_r key_r  = { NULL };
+	ax_vector_r stack_r = { NULL };
+	ax_vector_r key_r  = { NULL };
 
-	list_r = ax_list_create(ax_base_local(base), &iter_tr);
-	if (!list_r.one) {
+	stack_r = ax_vector_create(ax_base_local(base), &iter_tr);
+	if (!stack_r.one) {
 		retval = ax_true;
 		goto out;
 	}
-	key_r = ax_list_create(ax_base_local(base), ax_box_elem_tr(self_r.box));
+	key_r = ax_vector_create(ax_base_local(base), ax_trie_key_tr(trie));
 	if (!key_r.one) {
 		retval = ax_true;
 		goto out;
@@ -55,17 +66,17 @@ ax_fail ax_trie_enum(ax_trie *trie, ax_trie_enum_cb_f cb, void *ctx)
 	ax_iter end = ax_box_end(self_r.box);
 	do {
 		if (!ax_iter_equal(&cur, &end)) {
-			if (ax_seq_push(list_r.seq, &cur)) {
+			if (ax_seq_push(stack_r.seq, &cur)) {
 				retval = ax_true;
 				goto out;
 			}
 
-			if (ax_seq_push(list_r.seq, &end)) {
+			if (ax_seq_push(stack_r.seq, &end)) {
 				retval = ax_true;
 				goto out;
 			}
 
-			if (ax_box_size(list_r.box) > 2)
+			if (ax_box_size(stack_r.box) > 2)
 				if (ax_seq_push(key_r.seq, ax_trie_iter_word(&cur))) {
 					retval = ax_true;
 					goto out;
@@ -73,24 +84,94 @@ ax_fail ax_trie_enum(ax_trie *trie, ax_trie_enum_cb_f cb, void *ctx)
 			end = ax_trie_iter_end(&cur); /* Keep this upper */
 			cur = ax_trie_iter_begin(&cur);
 		} else {
-			end = *(ax_iter *)ax_seq_last(list_r.seq);
-			ax_seq_pop(list_r.seq);
-			cur = *(ax_iter *)ax_seq_last(list_r.seq);
-			ax_seq_pop(list_r.seq);
+			end = *(ax_iter *)ax_seq_last(stack_r.seq);
+			ax_seq_pop(stack_r.seq);
+			cur = *(ax_iter *)ax_seq_last(stack_r.seq);
+			ax_seq_pop(stack_r.seq);
 
-			int *val = ax_iter_get(&cur);
 			if (ax_trie_iter_valued(&cur)) {
-				if (cb(trie, key_r.seq, val, ctx))
+				if (cb(trie, key_r.seq, ax_iter_get(&cur), ctx))
 					goto out;
 			}
 
-			ax_seq_pop(key_r.seq);
+			if (ax_box_size(key_r.box))
+				ax_seq_pop(key_r.seq);
 
 			ax_iter_next(&cur);
 		}
-	} while (ax_box_size(list_r.box));
+	} while (ax_box_size(stack_r.box));
 out:
-	ax_one_free(list_r.one);
+	ax_one_free(stack_r.one);
 	ax_one_free(key_r.one);
 	return retval;
 }
+
+ax_fail ax_trie_scan_prefix(const ax_trie *trie, const void *prefix, size_t len, ax_trie_scan_cb_f cb, void *ctx)
+{
+	ax_trie_cr self_r = { trie };
+	ax_base *base = ax_one_base(self_r.one);
+	const ax_stuff_trait *key_tr = ax_trie_key_tr(trie);
+
+	ax_byte key[AX_TRIE_SCAN_MAX * sizeof(void *)];
+	struct { ax_iter cur, end; } stack[AX_TRIE_SCAN_MAX];
+	size_t max = AX_MIN(AX_TRIE_SCAN_MAX, sizeof key / key_tr->size);
+
+	if (len > max) {
+		ax_base_set_errno(base, AX_ERR_TOOLONG);
+		return ax_true;
+	}
+	if (len)
+		memcpy(key, prefix, len * key_tr->size);
+
+	ax_iter it = ax_trie_at_raw(trie, prefix, len);
+	ax_iter end = ax_box_end((ax_box *)self_r.box);
+	if (ax_iter_equal(&it, &end))
+		return ax_false;
+
+	if (ax_trie_iter_valued(&it) && cb(trie, key, len, ax_iter_get(&it), ctx))
+		return ax_false;
+
+	size_t depth = 0;
+	stack[0].cur = ax_trie_iter_begin(&it);
+	stack[0].end = ax_trie_iter_end(&it);
+	for (;;) {
+		ax_iter *cur = &stack[depth].cur;
+		if (ax_iter_equal(cur, &stack[depth].end)) {
+			if (depth == 0)
+				break;
+			depth--;
+			ax_iter_next(&stack[depth].cur);
+			continue;
+		}
+
+		size_t pos = len + depth;
+		if (pos == max) {
+			ax_base_set_errno(base, AX_ERR_TOOLONG);
+			return ax_true;
+		}
+		ax_byte *slot = key + pos * key_tr->size;
+		const void *word = ax_trie_iter_word(cur);
+		if (key_tr->link)
+			memcpy(slot, &word, sizeof word);
+		else
+			memcpy(slot, word, key_tr->size);
+
+		if (ax_trie_iter_valued(cur) && cb(trie, key, pos + 1, ax_iter_get(cur), ctx))
+			return ax_false;
+
+		ax_iter child = ax_trie_iter_begin(cur);
+		ax_iter child_end = ax_trie_iter_end(cur);
+		if (ax_iter_equal(&child, &child_end)) {
+			ax_iter_next(cur);
+			continue;
+		}
+		if (pos + 1 == max) {
+			ax_base_set_errno(base, AX_ERR_TOOLONG);
+			return ax_true;
+		}
+		depth++;
+		stack[depth].cur = child;
+		stack[depth].end = child_end;
+	}
+	return ax_false;
+}
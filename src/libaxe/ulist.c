@@ -0,0 +1,1291 @@
+/*
+ * Copyright (c) 2020 Li hsilin <lihsilyn@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <axe/ulist.h>
+#include <axe/base.h>
+#include <axe/def.h>
+#include <axe/pool.h>
+#include <axe/scope.h>
+#include <axe/any.h>
+#include <axe/iter.h>
+#include <axe/debug.h>
+#include <axe/stuff.h>
+#include <axe/error.h>
+
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#include "check.h"
+
+#undef free
+
+#define NODE_BYTES 256
+#define NODE_MIN_ELEMS 4
+
+/*
+ * Nodes are allocated with an alignment equal to their power-of-two size,
+ * so an iterator point is just the address of the element and the node is
+ * found by masking it. Both end and rend are NULL, like in ax_list.
+ *
+ * A node that drops below a quarter of its capacity is merged into a
+ * neighbour when they fit together, a full node is split in halves unless
+ * the insertion happens at one of its ends.
+ */
+
+struct node_st
+{
+	struct node_st *pre;
+	struct node_st *next;
+	size_t count;
+	ax_byte data[];
+};
+
+struct ax_ulist_st
+{
+	ax_seq _seq;
+	struct node_st *head;
+	struct node_st *tail;
+	size_t size;
+	size_t nnode;
+	size_t node_bytes;
+	size_t node_cap;
+};
+
+static ax_fail seq_push(ax_seq *seq, const void *val);
+static ax_fail seq_pop(ax_seq *seq);
+static ax_fail seq_pushf(ax_seq *seq, const void *val);
+static ax_fail seq_popf(ax_seq *seq);
+static void    seq_invert(ax_seq *seq);
+static ax_fail seq_trunc(ax_seq *seq, size_t size);
+static ax_iter seq_at(const ax_seq *seq, size_t index);
+static void   *seq_last(const ax_seq *seq);
+static void   *seq_first(const ax_seq *seq);
+static ax_fail seq_insert(ax_seq *seq, ax_iter *it, const void *val);
+static ax_fail seq_insert_range(ax_seq *seq, ax_iter *it, const ax_citer *first, const ax_citer *last);
+static ax_fail seq_insert_arr(ax_seq *seq, ax_iter *it, const void *arr, size_t len);
+static ax_fail seq_erase_range(ax_seq *seq, ax_iter *first, ax_iter *last);
+
+static size_t  box_size(const ax_box *box);
+static size_t  box_maxsize(const ax_box *box);
+static ax_iter box_begin(ax_box *box);
+static ax_iter box_end(ax_box *box);
+static ax_iter box_rbegin(ax_box *box);
+static ax_iter box_rend(ax_box *box);
+static void    box_clear(ax_box *box);
+static const ax_stuff_trait *box_elem_tr(const ax_box *box);
+
+static ax_any *any_copy(const ax_any *any);
+static ax_any *any_move(ax_any *any);
+
+static void    one_free(ax_one *one);
+
+static void    citer_move(ax_citer *it, long i);
+static void    citer_prev(ax_citer *it);
+static void    citer_next(ax_citer *it);
+static ax_bool citer_less(const ax_citer *it1, const ax_citer *it2);
+static long    citer_dist(const ax_citer *it1, const ax_citer *it2);
+
+static void    rciter_move(ax_citer *it, long i);
+static void    rciter_prev(ax_citer *it);
+static void    rciter_next(ax_citer *it);
+static ax_bool rciter_less(const ax_citer *it1, const ax_citer *it2);
+static long    rciter_dist(const ax_citer *it1, const ax_citer *it2);
+
+static void   *iter_get(const ax_iter *it);
+static void    iter_erase(ax_iter *it);
+static ax_fail iter_set(const ax_iter *it, const void *val);
+
+inline static ax_byte *elem_ptr(const ax_ulist *self, const struct node_st *node, size_t index)
+{
+	return (ax_byte *)node->data + index * self->_seq.env.elem_tr->size;
+}
+
+inline static void *elem_value(const ax_ulist *self, ax_byte *ptr)
+{
+	return self->_seq.env.elem_tr->link ? *(void **)ptr : ptr;
+}
+
+inline static struct node_st *node_of(const ax_ulist *self, const void *point)
+{
+	return (struct node_st *)((uintptr_t)point & ~(uintptr_t)(self->node_bytes - 1));
+}
+
+inline static size_t offset_of(const ax_ulist *self, const struct node_st *node, const void *point)
+{
+	return ((const ax_byte *)point - node->data) / self->_seq.env.elem_tr->size;
+}
+
+/* Point of the element following the one at off in node, or NULL */
+inline static void *point_next(const ax_ulist *self, const struct node_st *node, size_t off)
+{
+	if (off + 1 < node->count)
+		return elem_ptr(self, node, off + 1);
+	return node->next ? elem_ptr(self, node->next, 0) : NULL;
+}
+
+/* Point of the element preceding the one at off in node, or NULL */
+inline static void *point_prev(const ax_ulist *self, const struct node_st *node, size_t off)
+{
+	if (off > 0)
+		return elem_ptr(self, node, off - 1);
+	return node->pre ? elem_ptr(self, node->pre, node->pre->count - 1) : NULL;
+}
+
+/* Forward index of point, NULL stands for size */
+static size_t point_index(const ax_ulist *self, const void *point)
+{
+	if (!point)
+		return self->size;
+
+	const struct node_st *node = node_of(self, point);
+	size_t index = offset_of(self, node, point);
+	for (const struct node_st *cur = node->pre; cur; cur = cur->pre)
+		index += cur->count;
+	return index;
+}
+
+static void *index_point(const ax_ulist *self, size_t index)
+{
+	if (index >= self->size)
+		return NULL;
+
+	const struct node_st *node;
+	if (index < self->size / 2) {
+		node = self->head;
+		while (index >= node->count) {
+			index -= node->count;
+			node = node->next;
+		}
+	} else {
+		size_t rest = self->size - index;
+		node = self->tail;
+		while (rest > node->count) {
+			rest -= node->count;
+			node = node->pre;
+		}
+		index = node->count - rest;
+	}
+	return elem_ptr(self, node, index);
+}
+
+/* Move n elements between slots of the same or different nodes */
+static void elem_shift(const ax_stuff_trait *etr, ax_byte *dst, ax_byte *src, size_t n)
+{
+	if (etr->trivial_move) {
+		memmove(dst, src, n * etr->size);
+		return;
+	}
+
+	if (dst < src)
+		for (size_t i = 0; i < n; i++)
+			etr->move(dst + i * etr->size, src + i * etr->size, etr->size);
+	else
+		for (size_t i = n; i > 0; i--)
+			etr->move(dst + (i - 1) * etr->size, src + (i - 1) * etr->size, etr->size);
+}
+
+inline static void elem_free(const ax_stuff_trait *etr, ax_byte *ptr)
+{
+	if (!etr->trivial_free)
+		etr->free(ptr);
+}
+
+static ax_fail elem_construct(ax_ulist *self, ax_byte *ptr, const void *val)
+{
+	const ax_stuff_trait *etr = self->_seq.env.elem_tr;
+	ax_base *base = ax_one_base(ax_r(ulist, self).one);
+	ax_pool *pool = ax_base_pool(base);
+
+	const void *pval = etr->link ? &val : val;
+	ax_fail fail = val
+		? etr->copy(pool, ptr, pval, etr->size)
+		: etr->init(pool, ptr, etr->size);
+	if (fail) {
+		ax_base_set_errno(base, AX_ERR_NOMEM);
+		return ax_true;
+	}
+	return ax_false;
+}
+
+static struct node_st *node_new(ax_ulist *self)
+{
+	void *mem = NULL;
+	if (posix_memalign(&mem, self->node_bytes, self->node_bytes)) {
+		ax_base_set_errno(ax_one_base(ax_r(ulist, self).one), AX_ERR_NOMEM);
+		return NULL;
+	}
+
+	struct node_st *node = mem;
+	node->pre = node->next = NULL;
+	node->count = 0;
+	self->nnode++;
+	return node;
+}
+
+static void node_delete(ax_ulist *self, struct node_st *node)
+{
+	free(node);
+	self->nnode--;
+}
+
+/* Link node after pos, or in front of the head when pos is NULL */
+static void node_link(ax_ulist *self, struct node_st *pos, struct node_st *node)
+{
+	struct node_st *next = pos ? pos->next : self->head;
+	node->pre = pos;
+	node->next = next;
+	if (pos)
+		pos->next = node;
+	else
+		self->head = node;
+	if (next)
+		next->pre = node;
+	else
+		self->tail = node;
+}
+
+static void node_unlink(ax_ulist *self, struct node_st *node)
+{
+	if (node->pre)
+		node->pre->next = node->next;
+	else
+		self->head = node->next;
+	if (node->next)
+		node->next->pre = node->pre;
+	else
+		self->tail = node->pre;
+}
+
+/* Open an uninitialized slot in front of element *off of *node, *off may be count */
+static ax_fail slot_open(ax_ulist *self, struct node_st **pnode, size_t *poff)
+{
+	const ax_stuff_trait *etr = self->_seq.env.elem_tr;
+	struct node_st *node = *pnode;
+	size_t off = *poff, cap = self->node_cap;
+
+	if (!node) {
+		if (!(node = node_new(self)))
+			return ax_true;
+		node_link(self, NULL, node);
+		off = 0;
+	} else if (node->count == cap) {
+		if (off == cap && node->next && node->next->count < cap) {
+			node = node->next;
+			off = 0;
+		} else if (off == 0 && node->pre && node->pre->count < cap) {
+			node = node->pre;
+			off = node->count;
+		} else if (off == cap || off == 0) {
+			struct node_st *fresh = node_new(self);
+			if (!fresh)
+				return ax_true;
+			node_link(self, off ? node : node->pre, fresh);
+			node = fresh;
+			off = 0;
+		} else {
+			struct node_st *fresh = node_new(self);
+			if (!fresh)
+				return ax_true;
+			size_t half = cap / 2;
+			elem_shift(etr, fresh->data, elem_ptr(self, node, half), cap - half);
+			fresh->count = cap - half;
+			node->count = half;
+			node_link(self, node, fresh);
+			if (off > half) {
+				node = fresh;
+				off -= half;
+			}
+		}
+	}
+
+	elem_shift(etr, elem_ptr(self, node, off + 1), elem_ptr(self, node, off), node->count - off);
+	node->count++;
+	self->size++;
+	*pnode = node;
+	*poff = off;
+	return ax_false;
+}
+
+/*
+ * Close the slot at off in node, its element must be destroyed already.
+ * Returns the point of the element that followed the slot, or preceded
+ * it when norm is false
+ */
+static void *slot_close(ax_ulist *self, struct node_st *node, size_t off, ax_bool norm)
+{
+	const ax_stuff_trait *etr = self->_seq.env.elem_tr;
+
+	elem_shift(etr, elem_ptr(self, node, off), elem_ptr(self, node, off + 1), node->count - off - 1);
+	node->count--;
+	self->size--;
+
+	if (node->count == 0) {
+		struct node_st *pre = node->pre, *next = node->next;
+		node_unlink(self, node);
+		node_delete(self, node);
+		if (norm)
+			return next ? elem_ptr(self, next, 0) : NULL;
+		return pre ? elem_ptr(self, pre, pre->count - 1) : NULL;
+	}
+
+	if (node->count < self->node_cap / 4) {
+		struct node_st *pre = node->pre, *next = node->next;
+		if (next && node->count + next->count <= self->node_cap) {
+			elem_shift(etr, elem_ptr(self, node, node->count), next->data, next->count);
+			node->count += next->count;
+			node_unlink(self, next);
+			node_delete(self, next);
+		} else if (pre && pre->count + node->count <= self->node_cap) {
+			elem_shift(etr, elem_ptr(self, pre, pre->count), node->data, node->count);
+			off += pre->count;
+			pre->count += node->count;
+			node_unlink(self, node);
+			node_delete(self, node);
+			node = pre;
+		}
+	}
+
+	if (norm)
+		return off < node->count ? elem_ptr(self, node, off) : point_next(self, node, node->count - 1);
+	return point_prev(self, node, off);
+}
+
+static void citer_move(ax_citer *it, long i)
+{
+	CHECK_PARAM_NULL(it);
+
+	const ax_ulist *self = it->owner;
+	size_t index = point_index(self, it->point) + i;
+	ax_assert(index <= self->size, "iterator boundary exceed");
+	it->point = index_point(self, index);
+}
+
+static void citer_prev(ax_citer *it)
+{
+	CHECK_ITERATOR_VALIDITY(it, it->owner && it->tr);
+
+	const ax_ulist *self = it->owner;
+	if (!it->point) {
+		ax_assert(self->tail, "iterator boundary exceed");
+		it->point = elem_ptr(self, self->tail, self->tail->count - 1);
+		return;
+	}
+
+	const struct node_st *node = node_of(self, it->point);
+	ax_assert(node != self->head || it->point != node->data, "iterator boundary exceed");
+	it->point = point_prev(self, node, offset_of(self, node, it->point));
+}
+
+static void citer_next(ax_citer *it)
+{
+	CHECK_ITERATOR_VALIDITY(it, it->owner && it->tr);
+	ax_assert(it->point, "iterator boundary exceed");
+
+	const ax_ulist *self = it->owner;
+	const struct node_st *node = node_of(self, it->point);
+	it->point = point_next(self, node, offset_of(self, node, it->point));
+}
+
+static ax_bool citer_less(const ax_citer *it1, const ax_citer *it2)
+{
+	CHECK_ITER_COMPARABLE(it1, it2);
+
+	const ax_ulist *self = it1->owner;
+	return point_index(self, it1->point) < point_index(self, it2->point);
+}
+
+static long citer_dist(const ax_citer *it1, const ax_citer *it2)
+{
+	CHECK_ITER_COMPARABLE(it1, it2);
+
+	const ax_ulist *self = it1->owner;
+	return (long)(point_index(self, it2->point) - point_index(self, it1->point));
+}
+
+/* Index of a reverse iterator counted from rbegin, NULL stands for size */
+inline static size_t rpoint_index(const ax_ulist *self, const void *point)
+{
+	return point ? self->size - 1 - point_index(self, point) : self->size;
+}
+
+static void rciter_move(ax_citer *it, long i)
+{
+	CHECK_PARAM_NULL(it);
+
+	const ax_ulist *self = it->owner;
+	size_t rindex = rpoint_index(self, it->point) + i;
+	ax_assert(rindex <= self->size, "iterator boundary exceed");
+	it->point = rindex < self->size ? index_point(self, self->size - 1 - rindex) : NULL;
+}
+
+static void rciter_prev(ax_citer *it)
+{
+	CHECK_ITERATOR_VALIDITY(it, it->owner && it->tr);
+
+	const ax_ulist *self = it->owner;
+	if (!it->point) {
+		ax_assert(self->head, "iterator boundary exceed");
+		it->point = self->head->data;
+		return;
+	}
+
+	const struct node_st *node = node_of(self, it->point);
+	it->point = point_next(self, node, offset_of(self, node, it->point));
+	ax_assert(it->point, "iterator boundary exceed");
+}
+
+static void rciter_next(ax_citer *it)
+{
+	CHECK_ITERATOR_VALIDITY(it, it->owner && it->tr);
+	ax_assert(it->point, "iterator boundary exceed");
+
+	const ax_ulist *self = it->owner;
+	const struct node_st *node = node_of(self, it->point);
+	it->point = point_prev(self, node, offset_of(self, node, it->point));
+}
+
+static ax_bool rciter_less(const ax_citer *it1, const ax_citer *it2)
+{
+	CHECK_ITER_COMPARABLE(it1, it2);
+
+	const ax_ulist *self = it1->owner;
+	return rpoint_index(self, it1->point) < rpoint_index(self, it2->point);
+}
+
+static long rciter_dist(const ax_citer *it1, const ax_citer *it2)
+{
+	CHECK_ITER_COMPARABLE(it1, it2);
+
+	const ax_ulist *self = it1->owner;
+	return (long)(rpoint_index(self, it2->point) - rpoint_index(self, it1->point));
+}
+
+static void *iter_get(const ax_iter *it)
+{
+	CHECK_ITERATOR_VALIDITY(it, it->owner && it->tr && it->point);
+
+	return elem_value(it->owner, it->point);
+}
+
+static ax_fail iter_set(const ax_iter *it, const void *val)
+{
+	CHECK_ITERATOR_VALIDITY(it, it->owner && it->tr && it->point);
+
+	ax_ulist *self = (ax_ulist *)it->owner;
+	elem_free(self->_seq.env.elem_tr, it->point);
+	return elem_construct(self, it->point, val);
+}
+
+static void iter_erase(ax_iter *it)
+{
+	CHECK_ITERATOR_VALIDITY(it, it->owner && it->tr && it->point);
+
+	ax_ulist *self = (ax_ulist *)it->owner;
+	struct node_st *node = node_of(self, it->point);
+	elem_free(self->_seq.env.elem_tr, it->point);
+	it->point = slot_close(self, node, offset_of(self, node, it->point), ax_iter_norm(it));
+}
+
+static void one_free(ax_one *one)
+{
+	if (!one)
+		return;
+
+	ax_ulist_r self_r = { .one = one };
+	ax_scope_detach(one);
+	box_clear(self_r.box);
+	ax_pool_free(one);
+}
+
+static void any_dump(const ax_any *any, int ind)
+{
+	printf("not implemented\n");
+}
+
+static ax_any *any_copy(const ax_any *any)
+{
+	CHECK_PARAM_NULL(any);
+
+	ax_ulist_cr self_r = { .any = any };
+	const ax_ulist *self = self_r.ulist;
+	const ax_stuff_trait *etr = self_r.seq->env.elem_tr;
+	ax_base *base = ax_one_base(self_r.one);
+	ax_pool *pool = ax_base_pool(base);
+
+	ax_ulist_r new_r = { .seq = __ax_ulist_construct(base, etr) };
+	if (!new_r.one)
+		return NULL;
+
+	for (const struct node_st *src = self->head; src; src = src->next) {
+		struct node_st *node = node_new(new_r.ulist);
+		if (!node)
+			goto fail;
+		node_link(new_r.ulist, new_r.ulist->tail, node);
+
+		if (etr->trivial_copy) {
+			memcpy(node->data, src->data, src->count * etr->size);
+			node->count = src->count;
+		} else {
+			for (; node->count < src->count; node->count++) {
+				if (etr->copy(pool, elem_ptr(self, node, node->count),
+							elem_ptr(self, src, node->count), etr->size)) {
+					ax_base_set_errno(base, AX_ERR_NOMEM);
+					new_r.ulist->size += node->count;
+					goto fail;
+				}
+			}
+		}
+		new_r.ulist->size += node->count;
+	}
+
+	ax_scope_attach(ax_base_local(base), new_r.one);
+	return new_r.any;
+fail:
+	one_free(new_r.one);
+	return NULL;
+}
+
+static ax_any *any_move(ax_any *any)
+{
+	CHECK_PARAM_NULL(any);
+
+	ax_ulist *self = (ax_ulist *)any;
+	ax_base *base = ax_one_base(ax_r(ulist, self).one);
+	ax_ulist *dest = ax_pool_alloc(ax_base_pool(base), sizeof(ax_ulist));
+	if (!dest) {
+		ax_base_set_errno(base, AX_ERR_NOMEM);
+		return NULL;
+	}
+
+	memcpy(dest, self, sizeof(ax_ulist));
+	self->head = NULL;
+	self->tail = NULL;
+	self->size = 0;
+	self->nnode = 0;
+
+	dest->_seq.env.one.scope.macro = NULL;
+	dest->_seq.env.one.scope.micro = 0;
+	ax_scope_attach(ax_base_local(base), ax_r(ulist, dest).one);
+	return ax_r(ulist, dest).any;
+}
+
+static size_t box_size(const ax_box *box)
+{
+	CHECK_PARAM_NULL(box);
+
+	return ((const ax_ulist *)box)->size;
+}
+
+static size_t box_maxsize(const ax_box *box)
+{
+	CHECK_PARAM_NULL(box);
+
+	const ax_ulist *self = (const ax_ulist *)box;
+	return ((~(size_t)0) >> 1) / self->_seq.env.elem_tr->size;
+}
+
+static ax_iter box_begin(ax_box *box)
+{
+	CHECK_PARAM_NULL(box);
+
+	ax_ulist *self = (ax_ulist *)box;
+	ax_iter it = {
+		.owner = box,
+		.point = self->head ? self->head->data : NULL,
+		.tr = &ax_ulist_tr.box.iter
+	};
+	return it;
+}
+
+static ax_iter box_end(ax_box *box)
+{
+	CHECK_PARAM_NULL(box);
+
+	ax_iter it = {
+		.owner = box,
+		.point = NULL,
+		.tr = &ax_ulist_tr.box.iter
+	};
+	return it;
+}
+
+static ax_iter box_rbegin(ax_box *box)
+{
+	CHECK_PARAM_NULL(box);
+
+	ax_ulist *self = (ax_ulist *)box;
+	ax_iter it = {
+		.owner = box,
+		.point = self->tail ? elem_ptr(self, self->tail, self->tail->count - 1) : NULL,
+		.tr = &ax_ulist_tr.box.riter
+	};
+	return it;
+}
+
+static ax_iter box_rend(ax_box *box)
+{
+	CHECK_PARAM_NULL(box);
+
+	ax_iter it = {
+		.owner = box,
+		.point = NULL,
+		.tr = &ax_ulist_tr.box.riter
+	};
+	return it;
+}
+
+static const ax_stuff_trait *box_elem_tr(const ax_box *box)
+{
+	ax_ulist_cr self_r = { .box = box };
+	return self_r.seq->env.elem_tr;
+}
+
+static void box_clear(ax_box *box)
+{
+	CHECK_PARAM_NULL(box);
+
+	ax_ulist *self = (ax_ulist *)box;
+	const ax_stuff_trait *etr = self->_seq.env.elem_tr;
+
+	struct node_st *node = self->head;
+	while (node) {
+		struct node_st *next = node->next;
+		if (!etr->trivial_free)
+			for (size_t i = 0; i < node->count; i++)
+				etr->free(elem_ptr(self, node, i));
+		node_delete(self, node);
+		node = next;
+	}
+	self->head = self->tail = NULL;
+	self->size = 0;
+}
+
+static ax_fail seq_insert(ax_seq *seq, ax_iter *it, const void *val)
+{
+	CHECK_PARAM_NULL(seq);
+	CHECK_PARAM_NULL(it);
+	CHECK_PARAM_VALIDITY(it, it->owner == seq && it->tr);
+
+	ax_ulist *self = (ax_ulist *)seq;
+	struct node_st *node;
+	size_t off;
+	if (ax_iter_norm(it)) {
+		node = it->point ? node_of(self, it->point) : self->tail;
+		off = it->point ? offset_of(self, node, it->point) : (node ? node->count : 0);
+	} else {
+		node = it->point ? node_of(self, it->point) : self->head;
+		off = it->point ? offset_of(self, node, it->point) + 1 : 0;
+	}
+
+	if (slot_open(self, &node, &off))
+		return ax_true;
+
+	if (elem_construct(self, elem_ptr(self, node, off), val)) {
+		it->point = slot_close(self, node, off, ax_iter_norm(it));
+		return ax_true;
+	}
+
+	it->point = ax_iter_norm(it) ? point_next(self, node, off) : point_prev(self, node, off);
+	return ax_false;
+}
+
+/* A run of fresh nodes linked between before and after, holding uninitialized slots */
+struct gap_st
+{
+	struct node_st *before;
+	struct node_st *after;
+	struct node_st *first;
+	struct node_st *last;
+	ax_bool split;
+};
+
+/* Unlink the gap nodes and join the node split for it back together */
+static void gap_drop(ax_ulist *self, struct gap_st *gap)
+{
+	const ax_stuff_trait *etr = self->_seq.env.elem_tr;
+
+	struct node_st *cur = gap->first;
+	while (cur) {
+		struct node_st *next = cur == gap->last ? NULL : cur->next;
+		node_unlink(self, cur);
+		node_delete(self, cur);
+		cur = next;
+	}
+
+	if (gap->split) {
+		struct node_st *before = gap->before, *after = gap->after;
+		elem_shift(etr, elem_ptr(self, before, before->count), after->data, after->count);
+		before->count += after->count;
+		node_unlink(self, after);
+		node_delete(self, after);
+	}
+}
+
+/* Open count slots in front of it, splitting its node once and filling fresh nodes up */
+static ax_fail gap_open(ax_ulist *self, const ax_iter *it, size_t count, struct gap_st *gap)
+{
+	const ax_stuff_trait *etr = self->_seq.env.elem_tr;
+	struct node_st *node;
+	size_t off;
+	if (ax_iter_norm(it)) {
+		node = it->point ? node_of(self, it->point) : self->tail;
+		off = it->point ? offset_of(self, node, it->point) : (node ? node->count : 0);
+	} else {
+		node = it->point ? node_of(self, it->point) : self->head;
+		off = it->point ? offset_of(self, node, it->point) + 1 : 0;
+	}
+
+	gap->first = gap->last = NULL;
+	gap->split = ax_false;
+	if (!node) {
+		gap->before = gap->after = NULL;
+	} else if (off == 0) {
+		gap->before = node->pre;
+		gap->after = node;
+	} else if (off == node->count) {
+		gap->before = node;
+		gap->after = node->next;
+	} else {
+		struct node_st *tail = node_new(self);
+		if (!tail)
+			return ax_true;
+		elem_shift(etr, tail->data, elem_ptr(self, node, off), node->count - off);
+		tail->count = node->count - off;
+		node->count = off;
+		node_link(self, node, tail);
+		gap->before = node;
+		gap->after = tail;
+		gap->split = ax_true;
+	}
+
+	struct node_st *pos = gap->before;
+	for (size_t rest = count; rest; ) {
+		struct node_st *fresh = node_new(self);
+		if (!fresh) {
+			gap->last = pos;
+			gap_drop(self, gap);
+			return ax_true;
+		}
+		fresh->count = rest < self->node_cap ? rest : self->node_cap;
+		rest -= fresh->count;
+		node_link(self, pos, fresh);
+		if (!gap->first)
+			gap->first = fresh;
+		pos = fresh;
+	}
+	gap->last = pos;
+	self->size += count;
+	return ax_false;
+}
+
+/* Take the next slot of a gap cursor, walking forward from the first node or backward from the last */
+static ax_byte *gap_step(const ax_ulist *self, struct node_st **pnode, size_t *poff, ax_bool norm)
+{
+	if (norm) {
+		if (*poff == (*pnode)->count) {
+			*pnode = (*pnode)->next;
+			*poff = 0;
+		}
+		return elem_ptr(self, *pnode, (*poff)++);
+	}
+
+	if (*poff == 0) {
+		*pnode = (*pnode)->pre;
+		*poff = (*pnode)->count;
+	}
+	return elem_ptr(self, *pnode, --*poff);
+}
+
+/* Destroy the filled slots of a gap opened for a failed insert, then drop it */
+static void gap_close(ax_ulist *self, struct gap_st *gap, size_t count, size_t filled, ax_bool norm)
+{
+	const ax_stuff_trait *etr = self->_seq.env.elem_tr;
+	struct node_st *node = norm ? gap->first : gap->last;
+	size_t off = norm ? 0 : node->count;
+	for (size_t i = 0; i < filled; i++)
+		elem_free(etr, gap_step(self, &node, &off, norm));
+	self->size -= count;
+	gap_drop(self, gap);
+}
+
+/* Merge the filled gap with its neighbours where they fit, and move it past the inserted run */
+static void gap_settle(ax_ulist *self, ax_iter *it, struct gap_st *gap)
+{
+	const ax_stuff_trait *etr = self->_seq.env.elem_tr;
+	struct node_st *before = gap->before, *after = gap->after, *first = gap->first, *last = gap->last;
+	size_t bcount = before ? before->count : 0;
+
+	if (before && before->count + first->count <= self->node_cap) {
+		elem_shift(etr, elem_ptr(self, before, before->count), first->data, first->count);
+		before->count += first->count;
+		if (last == first)
+			last = before;
+		node_unlink(self, first);
+		node_delete(self, first);
+	}
+
+	void *follow = after ? after->data : NULL;
+	if (after && last->count + after->count <= self->node_cap) {
+		follow = elem_ptr(self, last, last->count);
+		elem_shift(etr, follow, after->data, after->count);
+		last->count += after->count;
+		node_unlink(self, after);
+		node_delete(self, after);
+	}
+
+	if (ax_iter_norm(it))
+		it->point = follow;
+	else
+		it->point = before ? elem_ptr(self, before, bcount - 1) : NULL;
+}
+
+static ax_fail seq_insert_range(ax_seq *seq, ax_iter *it, const ax_citer *first, const ax_citer *last)
+{
+	CHECK_PARAM_NULL(seq);
+	CHECK_PARAM_NULL(it);
+	CHECK_PARAM_NULL(first);
+	CHECK_PARAM_NULL(last);
+	CHECK_PARAM_VALIDITY(it, it->owner == seq && it->tr);
+	CHECK_PARAM_VALIDITY(first, first->owner != seq && first->owner == last->owner);
+
+	ax_ulist *self = (ax_ulist *)seq;
+	const ax_stuff_trait *etr = seq->env.elem_tr;
+	ax_base *base = ax_one_base(ax_r(ulist, self).one);
+	ax_pool *pool = ax_base_pool(base);
+
+	size_t count = 0;
+	for (ax_citer cur = *first; !ax_citer_equal(&cur, last); ax_citer_next(&cur))
+		count++;
+	if (count == 0)
+		return ax_false;
+
+	struct gap_st gap;
+	if (gap_open(self, it, count, &gap))
+		return ax_true;
+
+	struct node_st *node = ax_iter_norm(it) ? gap.first : gap.last;
+	size_t off = ax_iter_norm(it) ? 0 : node->count, i = 0;
+	for (ax_citer cur = *first; i < count; ax_citer_next(&cur), i++) {
+		const void *val = ax_citer_get(&cur);
+		const void *pval = etr->link ? &val : val;
+		if (etr->copy(pool, gap_step(self, &node, &off, ax_iter_norm(it)), pval, etr->size)) {
+			ax_base_set_errno(base, AX_ERR_NOMEM);
+			gap_close(self, &gap, count, i, ax_iter_norm(it));
+			return ax_true;
+		}
+	}
+
+	gap_settle(self, it, &gap);
+	return ax_false;
+}
+
+static ax_fail seq_insert_arr(ax_seq *seq, ax_iter *it, const void *arr, size_t len)
+{
+	CHECK_PARAM_NULL(seq);
+	CHECK_PARAM_NULL(it);
+	CHECK_PARAM_VALIDITY(arr, arr || len == 0);
+	CHECK_PARAM_VALIDITY(it, it->owner == seq && it->tr);
+
+	ax_ulist *self = (ax_ulist *)seq;
+	const ax_stuff_trait *etr = seq->env.elem_tr;
+	ax_base *base = ax_one_base(ax_r(ulist, self).one);
+	ax_pool *pool = ax_base_pool(base);
+
+	if (len == 0)
+		return ax_false;
+
+	struct gap_st gap;
+	if (gap_open(self, it, len, &gap))
+		return ax_true;
+
+	struct node_st *node = ax_iter_norm(it) ? gap.first : gap.last;
+	size_t off = ax_iter_norm(it) ? 0 : node->count;
+	for (size_t i = 0; i < len; i++) {
+		const ax_byte *src = (const ax_byte *)arr + i * etr->size;
+		if (etr->copy(pool, gap_step(self, &node, &off, ax_iter_norm(it)), src, etr->size)) {
+			ax_base_set_errno(base, AX_ERR_NOMEM);
+			gap_close(self, &gap, len, i, ax_iter_norm(it));
+			return ax_true;
+		}
+	}
+
+	gap_settle(self, it, &gap);
+	return ax_false;
+}
+
+/* Forward point following a reverse iterator point, rend stands before the head */
+inline static void *rpoint_after(const ax_ulist *self, const void *point)
+{
+	if (!point)
+		return self->head ? self->head->data : NULL;
+	const struct node_st *node = node_of(self, point);
+	return point_next(self, node, offset_of(self, node, point));
+}
+
+static ax_fail seq_erase_range(ax_seq *seq, ax_iter *first, ax_iter *last)
+{
+	CHECK_PARAM_NULL(seq);
+	CHECK_PARAM_NULL(first);
+	CHECK_PARAM_NULL(last);
+	CHECK_PARAM_VALIDITY(first, first->owner == seq && first->tr);
+	CHECK_PARAM_VALIDITY(last, last->owner == seq && last->tr);
+	CHECK_PARAM_VALIDITY(last, first->tr == last->tr);
+
+	ax_ulist *self = (ax_ulist *)seq;
+	const ax_stuff_trait *etr = seq->env.elem_tr;
+
+	void *lo = ax_iter_norm(first) ? first->point : rpoint_after(self, last->point);
+	void *hi = ax_iter_norm(first) ? last->point : rpoint_after(self, first->point);
+	CHECK_PARAM_VALIDITY(last, point_index(self, lo) <= point_index(self, hi));
+	if (lo == hi)
+		return ax_false;
+
+	struct node_st *a = node_of(self, lo), *b = hi ? node_of(self, hi) : NULL, *pre = a->pre;
+	size_t off_a = offset_of(self, a, lo), off_b = b ? offset_of(self, b, hi) : 0;
+
+	if (a == b) {
+		for (size_t i = off_a; i < off_b; i++)
+			elem_free(etr, elem_ptr(self, a, i));
+		elem_shift(etr, elem_ptr(self, a, off_a), elem_ptr(self, a, off_b), a->count - off_b);
+		a->count -= off_b - off_a;
+		self->size -= off_b - off_a;
+	} else {
+		for (size_t i = off_a; i < a->count; i++)
+			elem_free(etr, elem_ptr(self, a, i));
+		self->size -= a->count - off_a;
+		a->count = off_a;
+
+		struct node_st *cur = a->next;
+		while (cur != b) {
+			struct node_st *next = cur->next;
+			for (size_t i = 0; i < cur->count; i++)
+				elem_free(etr, elem_ptr(self, cur, i));
+			self->size -= cur->count;
+			node_unlink(self, cur);
+			node_delete(self, cur);
+			cur = next;
+		}
+
+		if (b) {
+			for (size_t i = 0; i < off_b; i++)
+				elem_free(etr, elem_ptr(self, b, i));
+			elem_shift(etr, b->data, elem_ptr(self, b, off_b), b->count - off_b);
+			b->count -= off_b;
+			self->size -= off_b;
+		}
+	}
+
+	struct node_st *next = a->next;
+	if (next && a->count + next->count <= self->node_cap) {
+		elem_shift(etr, elem_ptr(self, a, a->count), next->data, next->count);
+		a->count += next->count;
+		node_unlink(self, next);
+		node_delete(self, next);
+	}
+
+	void *follow;
+	if (a->count == 0) {
+		node_unlink(self, a);
+		node_delete(self, a);
+		follow = NULL;
+	} else {
+		follow = off_a < a->count ? elem_ptr(self, a, off_a) : point_next(self, a, a->count - 1);
+	}
+
+	if (ax_iter_norm(first))
+		first->point = follow;
+	else
+		first->point = off_a ? elem_ptr(self, a, off_a - 1) : (pre ? elem_ptr(self, pre, pre->count - 1) : NULL);
+	last->point = first->point;
+	return ax_false;
+}
+
+static ax_fail seq_push(ax_seq *seq, const void *val)
+{
+	CHECK_PARAM_NULL(seq);
+
+	ax_ulist *self = (ax_ulist *)seq;
+	struct node_st *node = self->tail;
+	size_t off = node ? node->count : 0;
+	if (slot_open(self, &node, &off))
+		return ax_true;
+
+	if (elem_construct(self, elem_ptr(self, node, off), val)) {
+		slot_close(self, node, off, ax_true);
+		return ax_true;
+	}
+	return ax_false;
+}
+
+static ax_fail seq_pop(ax_seq *seq)
+{
+	CHECK_PARAM_NULL(seq);
+
+	ax_ulist *self = (ax_ulist *)seq;
+	if (self->size == 0) {
+		ax_base_set_errno(ax_one_base(ax_r(ulist, self).one), AX_ERR_EMPTY);
+		return ax_true;
+	}
+
+	struct node_st *node = self->tail;
+	elem_free(seq->env.elem_tr, elem_ptr(self, node, node->count - 1));
+	slot_close(self, node, node->count - 1, ax_true);
+	return ax_false;
+}
+
+static ax_fail seq_pushf(ax_seq *seq, const void *val)
+{
+	CHECK_PARAM_NULL(seq);
+
+	ax_ulist *self = (ax_ulist *)seq;
+	struct node_st *node = self->head;
+	size_t off = 0;
+	if (slot_open(self, &node, &off))
+		return ax_true;
+
+	if (elem_construct(self, elem_ptr(self, node, off), val)) {
+		slot_close(self, node, off, ax_true);
+		return ax_true;
+	}
+	return ax_false;
+}
+
+static ax_fail seq_popf(ax_seq *seq)
+{
+	CHECK_PARAM_NULL(seq);
+
+	ax_ulist *self = (ax_ulist *)seq;
+	if (self->size == 0) {
+		ax_base_set_errno(ax_one_base(ax_r(ulist, self).one), AX_ERR_EMPTY);
+		return ax_true;
+	}
+
+	elem_free(seq->env.elem_tr, self->head->data);
+	slot_close(self, self->head, 0, ax_true);
+	return ax_false;
+}
+
+static void seq_invert(ax_seq *seq)
+{
+	CHECK_PARAM_NULL(seq);
+
+	ax_ulist *self = (ax_ulist *)seq;
+	const ax_stuff_trait *etr = seq->env.elem_tr;
+
+	struct node_st *node = self->head;
+	while (node) {
+		struct node_st *next = node->next;
+		for (size_t left = 0, right = node->count; left + 1 < right; left++, right--)
+			etr->swap(elem_ptr(self, node, left), elem_ptr(self, node, right - 1), etr->size);
+		node->next = node->pre;
+		node->pre = next;
+		node = next;
+	}
+
+	node = self->head;
+	self->head = self->tail;
+	self->tail = node;
+}
+
+static ax_fail seq_trunc(ax_seq *seq, size_t size)
+{
+	CHECK_PARAM_NULL(seq);
+	CHECK_PARAM_VALIDITY(size, size <= box_maxsize(ax_r(seq, seq).box));
+
+	ax_ulist *self = (ax_ulist *)seq;
+
+	while (self->size > size)
+		(void)seq_pop(seq);
+
+	while (self->size < size)
+		if (seq_push(seq, NULL))
+			return ax_true;
+
+	return ax_false;
+}
+
+static ax_iter seq_at(const ax_seq *seq, size_t index)
+{
+	CHECK_PARAM_NULL(seq);
+	CHECK_PARAM_VALIDITY(index, index <= ((const ax_ulist *)seq)->size);
+
+	ax_iter it = {
+		.owner = (void *)seq,
+		.tr = &ax_ulist_tr.box.iter,
+		.point = index_point((const ax_ulist *)seq, index)
+	};
+	return it;
+}
+
+static void *seq_last(const ax_seq *seq)
+{
+	CHECK_PARAM_NULL(seq);
+
+	const ax_ulist *self = (const ax_ulist *)seq;
+	ax_assert(self->size > 0, "empty");
+	return elem_value(self, elem_ptr(self, self->tail, self->tail->count - 1));
+}
+
+static void *seq_first(const ax_seq *seq)
+{
+	CHECK_PARAM_NULL(seq);
+
+	const ax_ulist *self = (const ax_ulist *)seq;
+	ax_assert(self->size > 0, "empty");
+	return elem_value(self, self->head->data);
+}
+
+const ax_seq_trait ax_ulist_tr =
+{
+	.box = {
+		.any = {
+			.one = {
+				.name = AX_ULIST_NAME,
+				.free = one_free,
+			},
+			.dump = any_dump,
+			.copy = any_copy,
+			.move = any_move
+		},
+		.iter = {
+			.ctr = {
+				.norm = ax_true,
+				.type = AX_IT_BID,
+				.move = citer_move,
+				.next = citer_next,
+				.prev = citer_prev,
+				.less = citer_less,
+				.dist = citer_dist,
+			},
+			.get = iter_get,
+			.set = iter_set,
+			.erase = iter_erase
+		},
+		.riter = {
+			.ctr = {
+				.norm = ax_false,
+				.type = AX_IT_BID,
+				.move = rciter_move,
+				.next = rciter_next,
+				.prev = rciter_prev,
+				.less = rciter_less,
+				.dist = rciter_dist,
+			},
+			.get = iter_get,
+			.set = iter_set,
+			.erase = iter_erase
+		},
+
+		.size = box_size,
+		.maxsize = box_maxsize,
+
+		.begin = box_begin,
+		.end = box_end,
+		.rbegin = box_rbegin,
+		.rend = box_rend,
+
+		.clear = box_clear,
+		.elem_tr = box_elem_tr
+	},
+	.push = seq_push,
+	.pop = seq_pop,
+	.pushf = seq_pushf,
+	.popf = seq_popf,
+	.invert = seq_invert,
+	.trunc = seq_trunc,
+	.insert = seq_insert,
+	.insert_range = seq_insert_range,
+	.insert_arr = seq_insert_arr,
+	.erase_range = seq_erase_range,
+	.at = seq_at,
+	.first = seq_first,
+	.last = seq_last,
+};
+
+size_t ax_ulist_footprint(const ax_ulist *ulist)
+{
+	CHECK_PARAM_NULL(ulist);
+
+	return ulist->nnode * ulist->node_bytes;
+}
+
+ax_seq *__ax_ulist_construct(ax_base *base, const ax_stuff_trait *elem_tr)
+{
+	CHECK_PARAM_NULL(base);
+	CHECK_PARAM_NULL(elem_tr);
+	CHECK_PARAM_NULL(elem_tr->copy);
+	CHECK_PARAM_NULL(elem_tr->free);
+	CHECK_PARAM_NULL(elem_tr->init);
+	CHECK_PARAM_NULL(elem_tr->move);
+	CHECK_PARAM_NULL(elem_tr->swap);
+	CHECK_PARAM_VALIDITY(elem_tr, elem_tr->size > 0);
+
+	ax_ulist *self = ax_pool_alloc(ax_base_pool(base), sizeof(ax_ulist));
+	if (!self) {
+		ax_base_set_errno(base, AX_ERR_NOMEM);
+		return NULL;
+	}
+
+	size_t header = offsetof(struct node_st, data), node_bytes = NODE_BYTES;
+	while ((node_bytes - header) / elem_tr->size < NODE_MIN_ELEMS)
+		node_bytes <<= 1;
+
+	ax_ulist ulist_init = {
+		._seq = {
+			.tr = &ax_ulist_tr,
+			.env = {
+				.one = {
+					.base = base,
+					.scope = { NULL }
+				},
+				.elem_tr = elem_tr
+			},
+		},
+		.head = NULL,
+		.tail = NULL,
+		.size = 0,
+		.nnode = 0,
+		.node_bytes = node_bytes,
+		.node_cap = (node_bytes - header) / elem_tr->size
+	};
+
+	memcpy(self, &ulist_init, sizeof ulist_init);
+	return ax_r(ulist, self).seq;
+}
+
+ax_ulist_r ax_ulist_create(ax_scope *scope, const ax_stuff_trait *elem_tr)
+{
+	CHECK_PARAM_NULL(scope);
+	CHECK_PARAM_NULL(elem_tr);
+
+	ax_base *base = ax_one_base(ax_r(scope, scope).one);
+	ax_ulist_r self_r = { .seq = __ax_ulist_construct(base, elem_tr) };
+	if (!self_r.one)
+		return self_r;
+	ax_scope_attach(scope, self_r.one);
+	return self_r;
+}
@@ -40,6 +40,7 @@
 #include <stdarg.h>
 
 #include "check.h"
+#include "sbuff.h"
 
 #undef free
 
@@ -48,7 +49,7 @@
 struct ax_vector_st
 {
 	ax_seq _seq;
-	ax_buff *buff;
+	struct sbuff_st sb;
 };
 
 static ax_fail seq_push(ax_seq *seq, const void *val);
@@ -60,6 +61,9 @@ static void   *seq_last(const ax_seq *seq);
 static void   *seq_first(const ax_seq *seq);
 
 static ax_fail seq_insert(ax_seq *seq, ax_iter *it, const void *val);
+static ax_fail seq_insert_range(ax_seq *seq, ax_iter *it, const ax_citer *first, const ax_citer *last);
+static ax_fail seq_insert_arr(ax_seq *seq, ax_iter *it, const void *arr, size_t len);
+static ax_fail seq_erase_range(ax_seq *seq, ax_iter *first, ax_iter *last);
 
 static size_t  box_size(const ax_box *box);
 static size_t  box_maxsize(const ax_box *box);
@@ -95,8 +99,8 @@ static inline ax_bool iter_if_valid(const ax_citer *it)
 
 	const ax_vector *self = it->owner;
 	const ax_stuff_trait *etr = self->_seq.env.elem_tr;
-	ax_byte *ptr = ax_buff_ptr(self->buff);
-	size_t size = ax_buff_size(self->buff, NULL);
+	const ax_byte *ptr = sbuff_cptr(&self->sb);
+	size_t size = sbuff_size(&self->sb);
 
 	return  (ax_citer_norm(it)
 		? ((ax_byte *)it->point >= ptr && (ax_byte *)it->point <= ptr + size)
@@ -107,12 +111,54 @@ static inline ax_bool iter_if_valid(const ax_citer *it)
 static inline ax_bool iter_if_have_value(const ax_citer *it)
 {
 	const ax_vector *self = it->owner;
-	const ax_byte *ptr = ax_buff_ptr(self->buff);
-	size_t size = ax_buff_size(self->buff, NULL);
+	const ax_byte *ptr = sbuff_cptr(&self->sb);
+	size_t size = sbuff_size(&self->sb);
 	return (ax_byte *)it->point >= ptr && (ax_byte *)it->point < ptr + size;
 }
 #endif
 
+inline static ax_fail buff_adapt(ax_vector *self, size_t size)
+{
+	return sbuff_adapt(&self->sb, ax_one_base(ax_r(vector, self).one), size);
+}
+
+inline static ax_fail buff_resize(ax_vector *self, size_t size)
+{
+	return sbuff_resize(&self->sb, ax_one_base(ax_r(vector, self).one), size);
+}
+
+/* Relocate size bytes of elements from src to dst, the ranges may overlap */
+static void elem_shift(const ax_stuff_trait *etr, ax_byte *dst, ax_byte *src, size_t size)
+{
+	if (etr->trivial_move) {
+		memmove(dst, src, size);
+		return;
+	}
+	if (dst < src)
+		for (size_t off = 0; off < size; off += etr->size)
+			etr->move(dst + off, src + off, etr->size);
+	else
+		for (size_t off = size; off != 0; off -= etr->size)
+			etr->move(dst + off - etr->size, src + off - etr->size, etr->size);
+}
+
+static void elem_free(const ax_stuff_trait *etr, ax_byte *ptr, size_t size)
+{
+	if (etr->trivial_free)
+		return;
+	for (size_t off = 0; off < size; off += etr->size)
+		etr->free(ptr + off);
+}
+
+inline static ax_fail elem_copy(const ax_stuff_trait *etr, ax_pool *pool, void *dst, const void *src)
+{
+	if (etr->trivial_copy) {
+		memcpy(dst, src, etr->size);
+		return ax_false;
+	}
+	return etr->copy(pool, dst, src, etr->size);
+}
+
 static void citer_move(ax_citer *it, long i)
 {
 	CHECK_PARAM_NULL(it);
@@ -240,19 +286,18 @@ static void iter_erase(ax_iter *it)
 
 	ax_vector *self = (ax_vector_r) { (void*)it->owner }.vector;
 	const ax_stuff_trait *etr = self->_seq.env.elem_tr;
-	ax_byte *ptr = ax_buff_ptr(self->buff);
-	size_t size = ax_buff_size(self->buff, NULL);
+	ax_byte *ptr = sbuff_ptr(&self->sb);
+	size_t size = sbuff_size(&self->sb);
 	 
-	etr->free(it->point);
+	elem_free(etr, it->point, etr->size);
 
-	ax_byte *end = ptr + size - etr->size;
-	for (ax_byte *p = it->point ; p < end ; p += etr->size)
-		etr->move(p, p + etr->size, etr->size);
+	ax_byte *next = (ax_byte *)it->point + etr->size;
+	elem_shift(etr, it->point, next, ptr + size - next);
 
 	size_t shift = (ax_byte*)it->point - ptr;
-	(void)ax_buff_adapt(self->buff, size - etr->size);
+	(void)buff_adapt(self, size - etr->size);
 	if(!ax_iter_norm(it))
-		it->point = (ax_byte *)ax_buff_ptr(self->buff) + shift - etr->size;
+		it->point = (ax_byte *)sbuff_ptr(&self->sb) + shift - etr->size;
 }
 
 static void one_free(ax_one *one)
@@ -263,7 +308,7 @@ static void one_free(ax_one *one)
 	ax_vector_r self_r = { .one = one };
 	ax_scope_detach(one);
 	box_clear(self_r.box);
-	ax_one_free(ax_r(buff, self_r.vector->buff).one);
+	sbuff_free(&self_r.vector->sb);
 	ax_pool_free(one);
 }
 
@@ -280,19 +325,29 @@ static ax_any *any_copy(const ax_any *any)
 	ax_base *base = ax_one_base(self_r.one);
 	ax_pool *pool = ax_base_pool(base);
 	ax_vector *new_vector = NULL;
-	ax_buff *new_buff = NULL;
 
 	new_vector = ax_pool_alloc(pool, (sizeof(ax_vector)));
 	if (!new_vector) {
 		ax_base_set_errno(base, AX_ERR_NOMEM);
-		goto fail;
+		return NULL;
 	}
 	memcpy(new_vector, self_r.vector, sizeof(ax_vector));
-	new_buff = (ax_buff *)ax_any_copy(ax_r(buff, self_r.vector->buff).any);
-	if (!new_buff)
+	if (sbuff_copy(&new_vector->sb, &self_r.vector->sb))
 		goto fail;
 
-	new_vector->buff = new_buff;
+	const ax_stuff_trait *etr = self_r.seq->env.elem_tr;
+	if (!etr->trivial_copy) {
+		ax_byte *src = sbuff_ptr(&self_r.vector->sb), *dst = sbuff_ptr(&new_vector->sb);
+		size_t size = sbuff_size(&new_vector->sb);
+		for (size_t off = 0; off < size; off += etr->size) {
+			if (etr->copy(pool, dst + off, src + off, etr->size)) {
+				ax_base_set_errno(base, AX_ERR_NOMEM);
+				elem_free(etr, dst, off);
+				sbuff_free(&new_vector->sb);
+				goto fail;
+			}
+		}
+	}
 
 	new_vector->_seq.env.one.scope.macro = NULL;
 	new_vector->_seq.env.one.scope.micro = 0;
@@ -300,7 +355,6 @@ static ax_any *any_copy(const ax_any *any)
 	return ax_r(vector, new_vector).any;
 fail:
 	ax_pool_free(new_vector);
-	ax_one_free(ax_r(buff, new_buff).one);
 	return NULL;
 }
 
@@ -311,32 +365,21 @@ static ax_any *any_move(ax_any *any)
 	ax_vector *self = (ax_vector*)any;
 	ax_base *base = ax_one_base(ax_r(vector, self).one);
 	ax_pool *pool = ax_base_pool(base);
-	ax_buff *dst_buff= NULL;
 	ax_vector *dest = NULL;
 
 	dest = ax_pool_alloc(pool, (sizeof(ax_vector)));
 	if (!dest) {
 		ax_base_set_errno(base, AX_ERR_NOMEM);
-		goto fail;
+		return NULL;
 	}
 	memcpy(dest, self, sizeof(ax_vector));
-
-	dst_buff = (ax_buff *)ax_any_move(ax_r(buff, self->buff).any);
-	if (!dst_buff)
-		goto fail;
-
-	dest->buff = dst_buff;
+	sbuff_move(&dest->sb, &self->sb);
 
 	dest->_seq.env.one.scope.macro = NULL;
 	dest->_seq.env.one.scope.micro = 0;
 	ax_scope_attach(ax_base_local(base), ax_r(vector, dest).one);
 
 	return ax_r(vector, dest).any;
-fail:
-	ax_pool_free(dest);
-	ax_one_free(ax_r(buff, dst_buff).one);
-	return NULL;
-
 }
 
 static size_t box_size(const ax_box *box)
@@ -344,13 +387,13 @@ static size_t box_size(const ax_box *box)
 	CHECK_PARAM_NULL(box);
 
 	const ax_vector *self = (const ax_vector*)box;
-	return ax_buff_size(self->buff, NULL) / self->_seq.env.elem_tr->size;
+	return sbuff_size(&self->sb) / self->_seq.env.elem_tr->size;
 }
 
 static size_t box_maxsize(const ax_box *box)
 {
 	const ax_vector *self = (const ax_vector*)box;
-	return ax_buff_max(self->buff) / self->_seq.env.elem_tr->size;
+	return sbuff_max(&self->sb) / self->_seq.env.elem_tr->size;
 }
 
 static ax_iter box_begin(ax_box *box)
@@ -360,7 +403,7 @@ static ax_iter box_begin(ax_box *box)
 	ax_vector_r self_r = { .box = box };
 	ax_iter it = {
 		.owner = (void*)box,
-		.point = ax_buff_ptr(self_r.vector->buff),
+		.point = sbuff_ptr(&self_r.vector->sb),
 		.tr = &ax_vector_tr.box.iter
 	};
 	return it;
@@ -373,7 +416,7 @@ static ax_iter box_end(ax_box *box)
 	ax_vector_r self_r = { .box = box };
 	ax_iter it = {
 		.owner = (void*)box,
-		.point = (ax_byte *)ax_buff_ptr(self_r.vector->buff) + ax_buff_size(self_r.vector->buff, NULL),
+		.point = (ax_byte *)sbuff_ptr(&self_r.vector->sb) + sbuff_size(&self_r.vector->sb),
 		.tr = &ax_vector_tr.box.iter
 	};
 	return it;
@@ -386,8 +429,8 @@ static ax_iter box_rbegin(ax_box *box)
 	ax_vector_r self_r = { .box = box };
 	ax_iter it = {
 		.owner = (void*)box,
-		.point = (ax_byte *)ax_buff_ptr(self_r.vector->buff)
-			+ ax_buff_size(self_r.vector->buff, NULL) - self_r.seq->env.elem_tr->size,
+		.point = (ax_byte *)sbuff_ptr(&self_r.vector->sb)
+			+ sbuff_size(&self_r.vector->sb) - self_r.seq->env.elem_tr->size,
 		.tr = &ax_vector_tr.box.riter
 	};
 	return it;
@@ -400,7 +443,7 @@ static ax_iter box_rend(ax_box *box)
 	ax_vector_r self_r = { .box = box};
 	ax_iter it = {
 		.owner = (void *)box,
-		.point = (ax_byte *)ax_buff_ptr(self_r.vector->buff) - self_r.seq->env.elem_tr->size,
+		.point = (ax_byte *)sbuff_ptr(&self_r.vector->sb) - self_r.seq->env.elem_tr->size,
 		.tr = &ax_vector_tr.box.riter
 	};
 	return it;
@@ -418,14 +461,11 @@ static void box_clear(ax_box *box)
 	ax_vector *self = (ax_vector *)box;
 
 	const ax_stuff_trait *etr = self->_seq.env.elem_tr;
-	ax_byte *ptr = ax_buff_ptr(self->buff);
-	size_t size = ax_buff_size(self->buff, NULL);
+	ax_byte *ptr = sbuff_ptr(&self->sb);
+	size_t size = sbuff_size(&self->sb);
 
-	ax_byte *end = ptr + size;
-	for (ax_byte *p = ptr ; p < end ; p += etr->size) {
-		etr->free(p);
-	}
-	ax_buff_adapt(self->buff, 0);
+	elem_free(etr, ptr, size);
+	buff_adapt(self, 0);
 }
 
 static ax_fail seq_insert(ax_seq *seq, ax_iter *it, const void *val)
@@ -438,30 +478,28 @@ static ax_fail seq_insert(ax_seq *seq, ax_iter *it, const void *val)
 	const ax_stuff_trait *etr = seq->env.elem_tr;
 	ax_base *base = ax_one_base(ax_r(vector, self).one);
 	ax_pool *pool = ax_base_pool(base);
-	ax_byte *ptr = ax_buff_ptr(self->buff);
-	size_t size = ax_buff_size(self->buff, NULL);
+	ax_byte *ptr = sbuff_ptr(&self->sb);
+	size_t size = sbuff_size(&self->sb);
 
 	long offset = (ax_byte *)it->point - ptr; //backup offset before realloc
 
-	if (ax_buff_adapt(self->buff, size + etr->size))
+	if (buff_adapt(self, size + etr->size))
 		return ax_true;
 
-	ptr = ax_buff_ptr(self->buff);
+	ptr = sbuff_ptr(&self->sb);
 	it->point = ptr + offset; //restore offset
 
-	void *ins = ax_iter_norm(it) ? it->point : ((ax_byte*)it->point + etr->size);
-	void *end = ptr + size;
-	for (ax_byte *p = end ; p != ins ; p -= etr->size) {
-		etr->move(p, p - etr->size, etr->size);
-	}
+	ax_byte *ins = ax_iter_norm(it) ? it->point : ((ax_byte*)it->point + etr->size);
+	elem_shift(etr, ins + etr->size, ins, ptr + size - ins);
 
 	const void *pval = etr->link ? &val : val;
 	ax_fail fail = (val != NULL)
-		? etr->copy(pool, ins, pval, etr->size)
+		? elem_copy(etr, pool, ins, pval)
 		: etr->init(pool, ins, etr->size);
 	if (fail) {
 		ax_base_set_errno(base, AX_ERR_NOMEM);
-		ax_buff_resize(self->buff, size);
+		elem_shift(etr, ins, ins + etr->size, ptr + size - ins);
+		buff_resize(self, size);
 		return ax_true;
 	}
 
@@ -470,6 +508,161 @@ static ax_fail seq_insert(ax_seq *seq, ax_iter *it, const void *val)
 	return ax_false;
 }
 
+/* Grow by count elements with one resize and one memmove, return the gap */
+static ax_byte *open_gap(ax_vector *self, ax_iter *it, size_t count)
+{
+	const ax_stuff_trait *etr = self->_seq.env.elem_tr;
+	ax_base *base = ax_one_base(ax_r(vector, self).one);
+	ax_byte *ptr = sbuff_ptr(&self->sb);
+	size_t size = sbuff_size(&self->sb);
+
+	if (count > (ax_box_maxsize(ax_r(vector, self).box) - size / etr->size)) {
+		ax_base_set_errno(base, AX_ERR_FULL);
+		return NULL;
+	}
+
+	long offset = (ax_byte *)it->point - ptr;
+	if (buff_adapt(self, size + count * etr->size))
+		return NULL;
+
+	ptr = sbuff_ptr(&self->sb);
+	it->point = ptr + offset;
+
+	ax_byte *ins = ax_iter_norm(it) ? it->point : ((ax_byte*)it->point + etr->size);
+	elem_shift(etr, ins + count * etr->size, ins, ptr + size - ins);
+	return ins;
+}
+
+/* Undo open_gap after filled elements of the gap have been constructed */
+static void close_gap(ax_vector *self, ax_iter *it, ax_byte *ins, size_t count, size_t filled)
+{
+	const ax_stuff_trait *etr = self->_seq.env.elem_tr;
+	ax_byte *ptr = sbuff_ptr(&self->sb);
+	size_t size = sbuff_size(&self->sb);
+
+	if (ax_iter_norm(it))
+		elem_free(etr, ins, filled * etr->size);
+	else
+		elem_free(etr, ins + (count - filled) * etr->size, filled * etr->size);
+
+	ax_byte *tail = ins + count * etr->size;
+	elem_shift(etr, ins, tail, ptr + size - tail);
+	buff_resize(self, size - count * etr->size);
+}
+
+static ax_fail seq_insert_range(ax_seq *seq, ax_iter *it, const ax_citer *first, const ax_citer *last)
+{
+	CHECK_PARAM_NULL(seq);
+	CHECK_PARAM_NULL(it);
+	CHECK_PARAM_NULL(first);
+	CHECK_PARAM_NULL(last);
+	CHECK_PARAM_VALIDITY(it, it->owner == seq && iter_if_valid(ax_iter_c(it)));
+	CHECK_PARAM_VALIDITY(first, first->owner != seq && first->owner == last->owner);
+
+	ax_vector *self = (ax_vector *) seq;
+	const ax_stuff_trait *etr = seq->env.elem_tr;
+	ax_base *base = ax_one_base(ax_r(vector, self).one);
+	ax_pool *pool = ax_base_pool(base);
+
+	size_t count = 0;
+	for (ax_citer cur = *first; !ax_citer_equal(&cur, last); ax_citer_next(&cur))
+		count++;
+	if (count == 0)
+		return ax_false;
+
+	ax_byte *ins = open_gap(self, it, count);
+	if (!ins)
+		return ax_true;
+
+	size_t i = 0;
+	for (ax_citer cur = *first; i < count; ax_citer_next(&cur), i++) {
+		const void *val = ax_citer_get(&cur);
+		const void *pval = etr->link ? &val : val;
+		ax_byte *dst = ins + (ax_iter_norm(it) ? i : count - 1 - i) * etr->size;
+		if (elem_copy(etr, pool, dst, pval)) {
+			ax_base_set_errno(base, AX_ERR_NOMEM);
+			close_gap(self, it, ins, count, i);
+			return ax_true;
+		}
+	}
+
+	if(ax_iter_norm(it))
+		it->point = (ax_byte*)it->point + count * etr->size;
+	return ax_false;
+}
+
+static ax_fail seq_insert_arr(ax_seq *seq, ax_iter *it, const void *arr, size_t len)
+{
+	CHECK_PARAM_NULL(seq);
+	CHECK_PARAM_NULL(it);
+	CHECK_PARAM_VALIDITY(arr, arr || len == 0);
+	CHECK_PARAM_VALIDITY(it, it->owner == seq && iter_if_valid(ax_iter_c(it)));
+
+	ax_vector *self = (ax_vector *) seq;
+	const ax_stuff_trait *etr = seq->env.elem_tr;
+	ax_base *base = ax_one_base(ax_r(vector, self).one);
+	ax_pool *pool = ax_base_pool(base);
+
+	if (len == 0)
+		return ax_false;
+
+	ax_byte *ins = open_gap(self, it, len);
+	if (!ins)
+		return ax_true;
+
+	if (etr->trivial_copy && ax_iter_norm(it)) {
+		memcpy(ins, arr, len * etr->size);
+		it->point = (ax_byte*)it->point + len * etr->size;
+		return ax_false;
+	}
+
+	for (size_t i = 0; i < len; i++) {
+		const ax_byte *src = (const ax_byte *)arr + i * etr->size;
+		ax_byte *dst = ins + (ax_iter_norm(it) ? i : len - 1 - i) * etr->size;
+		if (etr->copy(pool, dst, src, etr->size)) {
+			ax_base_set_errno(base, AX_ERR_NOMEM);
+			close_gap(self, it, ins, len, i);
+			return ax_true;
+		}
+	}
+
+	if(ax_iter_norm(it))
+		it->point = (ax_byte*)it->point + len * etr->size;
+	return ax_false;
+}
+
+static ax_fail seq_erase_range(ax_seq *seq, ax_iter *first, ax_iter *last)
+{
+	CHECK_PARAM_NULL(seq);
+	CHECK_PARAM_NULL(first);
+	CHECK_PARAM_NULL(last);
+	CHECK_PARAM_VALIDITY(first, first->owner == seq && iter_if_valid(ax_iter_c(first)));
+	CHECK_PARAM_VALIDITY(last, last->owner == seq && iter_if_valid(ax_iter_c(last)));
+	CHECK_PARAM_VALIDITY(last, first->tr == last->tr);
+
+	ax_vector *self = (ax_vector *) seq;
+	const ax_stuff_trait *etr = seq->env.elem_tr;
+	ax_byte *ptr = sbuff_ptr(&self->sb);
+	size_t size = sbuff_size(&self->sb);
+
+	ax_byte *lo = ax_iter_norm(first) ? first->point : (ax_byte *)last->point + etr->size;
+	ax_byte *hi = ax_iter_norm(first) ? last->point : (ax_byte *)first->point + etr->size;
+	CHECK_PARAM_VALIDITY(last, lo <= hi);
+	if (lo == hi)
+		return ax_false;
+
+	elem_free(etr, lo, hi - lo);
+	elem_shift(etr, lo, hi, ptr + size - hi);
+
+	size_t shift = lo - ptr;
+	(void)buff_adapt(self, size - (hi - lo));
+	first->point = (ax_byte *)sbuff_ptr(&self->sb) + shift;
+	if (!ax_iter_norm(first))
+		first->point = (ax_byte *)first->point - etr->size;
+	last->point = first->point;
+	return ax_false;
+}
+
 static ax_fail seq_push(ax_seq *seq, const void *val)
 {
 	CHECK_PARAM_NULL(seq);
@@ -479,20 +672,20 @@ static ax_fail seq_push(ax_seq *seq, const void *val)
 	ax_base *base = ax_one_base(ax_r(vector, self).one);
 	ax_pool *pool = ax_base_pool(base);
 
-	size_t size = ax_buff_size(self->buff, NULL);
+	size_t size = sbuff_size(&self->sb);
 
-	if (ax_buff_adapt(self->buff, size + etr->size))
+	if (buff_adapt(self, size + etr->size))
 		return ax_true;
 
 	const void *pval = seq->env.elem_tr->link ? &val: val;
-	ax_byte *ptr = ax_buff_ptr(self->buff);
+	ax_byte *ptr = sbuff_ptr(&self->sb);
 
 	ax_fail fail = (val != NULL)
-		? etr->copy(pool, ptr + size, pval, etr->size)
+		? elem_copy(etr, pool, ptr + size, pval)
 		: etr->init(pool, ptr + size, etr->size);
 	if (fail) {
 		ax_base_set_errno(base, AX_ERR_NOMEM);
-		ax_buff_resize(self->buff, size);
+		buff_resize(self, size);
 		return ax_true;
 	}
 
@@ -505,17 +698,17 @@ static ax_fail seq_pop(ax_seq *seq)
 
 	ax_vector *self = (ax_vector *) seq;
 	const ax_stuff_trait *etr = seq->env.elem_tr;
-	size_t size = ax_buff_size(self->buff, NULL);
-	ax_byte *ptr = ax_buff_ptr(self->buff);
+	size_t size = sbuff_size(&self->sb);
+	ax_byte *ptr = sbuff_ptr(&self->sb);
 
 	if (size == 0) {
 		ax_base *base = ax_one_base(ax_r(vector, self).one);
 		ax_base_set_errno(base, AX_ERR_EMPTY);
 		return ax_false;
 	}
-	seq->env.elem_tr->free(ptr + size - etr->size);
+	elem_free(etr, ptr + size - etr->size, etr->size);
 
-	if (ax_buff_adapt(self->buff, size - etr->size))
+	if (buff_adapt(self, size - etr->size))
 		return ax_true;
 	return ax_false;
 }
@@ -526,8 +719,8 @@ static void seq_invert(ax_seq *seq)
 
 	ax_vector *self = (ax_vector *) seq;
 	const ax_stuff_trait *etr = self->_seq.env.elem_tr;
-	size_t size = ax_buff_size(self->buff, NULL);
-	ax_byte *ptr = ax_buff_ptr(self->buff);
+	size_t size = sbuff_size(&self->sb);
+	ax_byte *ptr = sbuff_ptr(&self->sb);
 
 	if (size == 0)
 		return;
@@ -550,7 +743,7 @@ static ax_fail seq_trunc(ax_seq *seq, size_t size)
 
 	ax_vector *self = (ax_vector *) seq;
 	const ax_stuff_trait *etr = seq->env.elem_tr;
-	size_t old_size = ax_buff_size(self->buff, NULL);
+	size_t old_size = sbuff_size(&self->sb);
 
 
 	size *= etr->size;
@@ -559,21 +752,22 @@ static ax_fail seq_trunc(ax_seq *seq, size_t size)
 		return ax_false;
 
 	if (size < old_size) {
-		ax_byte *ptr = ax_buff_ptr(self->buff);
-		for (size_t off = size; off <= old_size; off += etr->size) {
-			etr->free(ptr + off);
-		}
-		if (ax_buff_adapt(self->buff, size))
+		ax_byte *ptr = sbuff_ptr(&self->sb);
+		elem_free(etr, ptr + size, old_size - size);
+		if (buff_adapt(self, size))
 			return ax_true;
 	} else {
 		ax_base *base = ax_one_base(self_r.one);
 		ax_pool *pool = ax_base_pool(base);
-		if (ax_buff_adapt(self->buff, size))
+		if (buff_adapt(self, size))
 			return ax_true;
-		ax_byte *ptr = ax_buff_ptr(self->buff);
+		ax_byte *ptr = sbuff_ptr(&self->sb);
 
-		for (size_t off = old_size; off < size ; off += etr->size) {
-			etr->init(pool, ptr + off, etr->size);
+		if (etr->trivial_copy)
+			memset(ptr + old_size, 0, size - old_size);
+		else {
+			for (size_t off = old_size; off < size ; off += etr->size)
+				etr->init(pool, ptr + off, etr->size);
 		}
 	}
 	return ax_false;
@@ -586,7 +780,7 @@ static ax_iter seq_at(const ax_seq *seq, size_t index)
 
 	ax_vector *self = (ax_vector *) seq;
 	const ax_stuff_trait *etr = seq->env.elem_tr;
-	ax_byte *ptr = ax_buff_ptr(self->buff);
+	ax_byte *ptr = sbuff_ptr(&self->sb);
 
 	ax_iter it = {
 		.owner = self,
@@ -603,7 +797,7 @@ static void *seq_last(const ax_seq *seq)
 
 	ax_vector_cr self_r = { .seq = seq };
 
-	return (ax_byte *)ax_buff_ptr(self_r.vector->buff) + ax_buff_size(self_r.vector->buff, NULL) - self_r.vector->_seq.env.elem_tr->size;
+	return (ax_byte *)sbuff_cptr(&self_r.vector->sb) + sbuff_size(&self_r.vector->sb) - self_r.vector->_seq.env.elem_tr->size;
 }
 
 static void *seq_first(const ax_seq *seq)
@@ -613,7 +807,7 @@ static void *seq_first(const ax_seq *seq)
 	
 	ax_vector_cr self_r = { .seq = seq };
 
-	return (ax_byte *)ax_buff_ptr(self_r.vector->buff);
+	return (ax_byte *)sbuff_cptr(&self_r.vector->sb);
 }
 
 const ax_seq_trait ax_vector_tr =
@@ -632,7 +826,7 @@ const ax_seq_trait ax_vector_tr =
 		.iter = {
 			.ctr = {
 				.norm = ax_true,
-				.type = AX_IT_RAND,
+				.type = AX_IT_CONT,
 				.move = citer_move,
 				.next = citer_next,
 				.prev = citer_prev,
@@ -680,6 +874,9 @@ const ax_seq_trait ax_vector_tr =
 	.last = seq_last,
 	.first = seq_first,
 	.insert = seq_insert,
+	.insert_range = seq_insert_range,
+	.insert_arr = seq_insert_arr,
+	.erase_range = seq_erase_range,
 };
 
 ax_seq *__ax_vector_construct(ax_base *base,const ax_stuff_trait *elem_tr)
@@ -693,19 +890,14 @@ ax_seq *__ax_vector_construct(ax_base *base,const ax_stuff_trait *elem_tr)
 	CHECK_PARAM_NULL(elem_tr->move);
 	CHECK_PARAM_NULL(elem_tr->swap);
 
-	ax_buff *buff = NULL;
 	ax_seq *seq = NULL;
 
 	seq = ax_pool_alloc(ax_base_pool(base), sizeof(ax_vector));
 	if (!seq) {
 		ax_base_set_errno(base, AX_ERR_NOMEM);
-		goto fail;
+		return NULL;
 	}
 
-	buff = (ax_buff *)__ax_buff_construct(base);
-	if (!buff)
-		goto fail;
-
 	ax_vector vec_init = {
 		._seq = {
 			.tr = &ax_vector_tr,
@@ -717,16 +909,11 @@ ax_seq *__ax_vector_construct(ax_base *base,const ax_stuff_trait *elem_tr)
 				.elem_tr = elem_tr
 			},
 		},
-		
-		.buff = buff
 	};
 
 	memcpy(seq, &vec_init, sizeof vec_init);
+	sbuff_init(&((ax_vector *)seq)->sb);
 	return seq;
-fail:
-	ax_pool_free(seq);
-	ax_one_free(ax_r(buff, buff).one);
-	return NULL;
 }
 
 ax_vector_r ax_vector_create(ax_scope *scope, const ax_stuff_trait *elem_tr)
@@ -746,5 +933,5 @@ void *ax_vector_buffer(ax_vector *vector)
 {
 	CHECK_PARAM_NULL(vector);
 
-	return ax_buff_ptr(vector->buff);
+	return sbuff_ptr(&vector->sb);
 }
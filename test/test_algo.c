@@ -1,11 +1,15 @@
+#define _POSIX_C_SOURCE 200809L
+
 #include "assist.h"
 
 #include "axe/algo.h"
 #include "axe/iter.h"
 #include "axe/vector.h"
 #include "axe/list.h"
+#include "axe/deque.h"
 #include "axe/pred.h"
 #include "axe/oper.h"
+#include "axe/exec.h"
 #include "axe/base.h"
 
 #include "axut.h"
@@ -15,6 +19,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <math.h>
 #include <time.h>
 
 static void all_any_none_of(axut_runner *r)
@@ -310,6 +315,1268 @@ static void sort_time(axut_runner *r) {
 
 }
 
+enum { PAT_RANDOM, PAT_SORTED, PAT_REVERSED, PAT_FEW_UNIQUE, PAT_ORGAN_PIPE, PAT_COUNT };
+
+static const char *pattern_name[] = { "random", "sorted", "reversed", "few unique", "organ pipe" };
+
+static int32_t pattern_value(int pattern, int i, int n)
+{
+	switch (pattern) {
+		case PAT_RANDOM: return rand();
+		case PAT_SORTED: return i;
+		case PAT_REVERSED: return n - i;
+		case PAT_FEW_UNIQUE: return rand() % 4;
+		case PAT_ORGAN_PIPE: return i < n / 2 ? i : n - i;
+	}
+	return 0;
+}
+
+static void sort(axut_runner *r)
+{
+	ax_base *base = ax_base_create();
+	ax_pred pred = ax_pred_binary_make(ax_oper_for(AX_ST_I32)->le, NULL, NULL, NULL);
+	srand(21);
+
+	const int sizes[] = { 0, 1, 2, 3, 30, 200, 5000 };
+	for (int pattern = 0; pattern < PAT_COUNT; pattern++) {
+		for (int k = 0; k < sizeof sizes / sizeof sizes[0]; k++) {
+			int n = sizes[k];
+			ax_seq *seqs[] = {
+				ax_vector_create(ax_base_local(base), ax_stuff_traits(AX_ST_I32)).seq,
+				ax_list_create(ax_base_local(base), ax_stuff_traits(AX_ST_I32)).seq,
+			};
+			int64_t sum = 0;
+			for (int i = 0; i < n; i++) {
+				int32_t val = pattern_value(pattern, i, n);
+				sum += val;
+				ax_seq_push(seqs[0], &val);
+				ax_seq_push(seqs[1], &val);
+			}
+			for (int s = 0; s < 2; s++) {
+				ax_iter first = ax_box_begin(ax_r(seq, seqs[s]).box);
+				ax_iter last = ax_box_end(ax_r(seq, seqs[s]).box);
+				axut_assert(r, !ax_sort(&first, &last));
+				axut_assert(r, ax_sorted(ax_iter_c(&first), ax_iter_c(&last), &pred));
+				int64_t sorted_sum = 0;
+				ax_box_cforeach(ax_r(seq, seqs[s]).box, const int32_t *, v)
+					sorted_sum += *v;
+				axut_assert(r, sorted_sum == sum);
+			}
+		}
+	}
+
+	ax_vector_r vec_r = ax_vector_create(ax_base_local(base), ax_stuff_traits(AX_ST_S));
+	const char *words[] = { "pear", "fig", "apple", "plum", "date", "cherry" };
+	for (int i = 0; i < 6; i++)
+		ax_seq_push(vec_r.seq, words[i]);
+	ax_iter first = ax_box_begin(vec_r.box), last = ax_box_end(vec_r.box);
+	ax_sort(&first, &last);
+	const char *sorted[] = { "apple", "cherry", "date", "fig", "pear", "plum" };
+	int i = 0;
+	ax_box_cforeach(vec_r.box, const char *, s)
+		axut_assert_str_equal(r, sorted[i++], s);
+
+	ax_base_destroy(base);
+}
+
+static int cmp_str(const void *p1, const void *p2)
+{
+	return strcmp(*(char **)p1, *(char **)p2);
+}
+
+/* Reordering a list of link values goes through its iter_set */
+static void list_string(axut_runner *r)
+{
+	const int n = 300;
+	ax_base *base = ax_base_create();
+	ax_list_r list_r = ax_list_create(ax_base_local(base), ax_stuff_traits(AX_ST_S));
+	ax_vector_r out_r = ax_vector_create(ax_base_local(base), ax_stuff_traits(AX_ST_S));
+	char (*words)[8] = malloc(n * sizeof *words);
+	char **ref = malloc(n * sizeof *ref);
+	srand(41);
+	for (int i = 0; i < n; i++) {
+		sprintf(words[i], "w%04d", rand() % 1000);
+		ref[i] = words[i];
+	}
+	qsort(ref, n, sizeof *ref, cmp_str);
+
+	for (int op = 0; op < 5; op++) {
+		ax_box_clear(list_r.box);
+		for (int i = 0; i < n; i++)
+			ax_seq_push(list_r.seq, words[i]);
+		ax_iter first = ax_box_begin(list_r.box), last = ax_box_end(list_r.box);
+		ax_iter mid = ax_seq_at(list_r.seq, 50);
+		int sorted = n;
+		switch (op) {
+			case 0:
+				axut_assert(r, !ax_sort(&first, &last));
+				break;
+			case 1:
+				axut_assert(r, !ax_merge_sort(&first, &last));
+				break;
+			case 2:
+				axut_assert(r, !ax_nth_element(&first, &mid, &last, NULL));
+				sorted = 0;
+				break;
+			case 3:
+				axut_assert(r, !ax_partial_sort(&first, &mid, &last, NULL));
+				sorted = 50;
+				break;
+			case 4:
+				ax_box_clear(out_r.box);
+				axut_assert(r, !ax_top_k(ax_iter_c(&first), ax_iter_c(&last), out_r.seq, 50, NULL));
+				sorted = 0;
+				break;
+		}
+
+		int i = 0;
+		char **rest = malloc(n * sizeof *rest);
+		ax_box_foreach(list_r.box, char *, str) {
+			axut_assert(r, i >= sorted || strcmp(ref[i], str) == 0);
+			rest[i++] = str;
+		}
+		axut_assert_int_equal(r, n, i);
+
+		/* Whatever the order, the elements are the same */
+		qsort(rest, n, sizeof *rest, cmp_str);
+		for (i = 0; i < n; i++)
+			axut_assert_str_equal(r, ref[i], rest[i]);
+		free(rest);
+
+		if (op == 2)
+			axut_assert_str_equal(r, ref[50], ax_iter_get(&mid));
+		if (op == 4) {
+			i = 0;
+			ax_box_foreach(out_r.box, char *, str)
+				axut_assert_str_equal(r, ref[i++], str);
+			axut_assert_int_equal(r, 50, i);
+		}
+	}
+
+	free(words);
+	free(ref);
+	ax_base_destroy(base);
+}
+
+static void bench_sort(axut_runner *r)
+{
+	const int n = 0x3FFFF;
+	ax_base *base = ax_base_create();
+	ax_pred pred = ax_pred_binary_make(ax_oper_for(AX_ST_I32)->le, NULL, NULL, NULL);
+	int32_t *arr = malloc(n * sizeof *arr);
+	srand(22);
+
+	for (int pattern = 0; pattern < PAT_COUNT; pattern++) {
+		for (int i = 0; i < n; i++)
+			arr[i] = pattern_value(pattern, i, n);
+
+		ax_vector_r vec_r = ax_vector_create(ax_base_local(base), ax_stuff_traits(AX_ST_I32));
+		ax_seq_trunc(vec_r.seq, n);
+		memcpy(ax_vector_buffer(vec_r.vector), arr, n * sizeof *arr);
+		ax_iter first = ax_box_begin(vec_r.box), last = ax_box_end(vec_r.box);
+		clock_t time_before = clock();
+		ax_sort(&first, &last);
+		//printf("ax_sort %s: %lfs\n", pattern_name[pattern], (double)(clock()-time_before) / CLOCKS_PER_SEC);
+		axut_assert(r, ax_sorted(ax_iter_c(&first), ax_iter_c(&last), &pred));
+
+		memcpy(ax_vector_buffer(vec_r.vector), arr, n * sizeof *arr);
+		time_before = clock();
+		ax_merge_sort(&first, &last);
+		//printf("ax_merge_sort %s: %lfs\n", pattern_name[pattern], (double)(clock()-time_before) / CLOCKS_PER_SEC);
+
+		memcpy(ax_vector_buffer(vec_r.vector), arr, n * sizeof *arr);
+		time_before = clock();
+		qsort(ax_vector_buffer(vec_r.vector), n, sizeof *arr, qsort_compare_cb);
+		//printf("qsort %s: %lfs\n", pattern_name[pattern], (double)(clock()-time_before) / CLOCKS_PER_SEC);
+		(void)pattern_name;
+
+		ax_one_free(vec_r.one);
+	}
+
+	free(arr);
+	ax_base_destroy(base);
+}
+
+static ax_bool seq_same(ax_seq *seq1, ax_seq *seq2)
+{
+	const ax_stuff_trait *etr = ax_box_elem_tr(ax_r(seq, seq1).box);
+	if (ax_box_size(ax_r(seq, seq1).box) != ax_box_size(ax_r(seq, seq2).box))
+		return ax_false;
+	ax_iter it1 = ax_box_begin(ax_r(seq, seq1).box), end = ax_box_end(ax_r(seq, seq1).box);
+	ax_iter it2 = ax_box_begin(ax_r(seq, seq2).box);
+	for (; !ax_iter_equal(&it1, &end); ax_iter_next(&it1), ax_iter_next(&it2))
+		if (!etr->equal(ax_iter_get(&it1), ax_iter_get(&it2), etr->size))
+			return ax_false;
+	return ax_true;
+}
+
+static ax_bool less_i32_high(const void *p1, const void *p2, size_t size)
+{
+	return *(int32_t *)p1 >> 8 < *(int32_t *)p2 >> 8;
+}
+
+static ax_bool less_i64_high(const void *p1, const void *p2, size_t size)
+{
+	return *(int64_t *)p1 >> 8 < *(int64_t *)p2 >> 8;
+}
+
+/* Every length up to 40 with duplicates, on a builtin, a custom and a link trait */
+static void lower_bound(axut_runner *r)
+{
+	ax_base *base = ax_base_create();
+	ax_stuff_trait high = *ax_stuff_traits(AX_ST_I32);
+	high.less = less_i32_high;
+	const ax_stuff_trait *trs[] = { ax_stuff_traits(AX_ST_I32), &high };
+
+	for (int t = 0; t < 2; t++) {
+		int shift = t ? 8 : 0;
+		ax_seq *seqs[] = {
+			ax_vector_create(ax_base_local(base), trs[t]).seq,
+			ax_deque_create(ax_base_local(base), trs[t]).seq,
+		};
+		for (int s = 0; s < 2; s++) {
+			for (int32_t n = 0; n <= 40; n++) {
+				ax_box_clear(ax_r(seq, seqs[s]).box);
+				for (int32_t i = 0; i < n; i++) {
+					int32_t val = (i / 2 * 2 + 1) << shift;
+					ax_seq_push(seqs[s], &val);
+				}
+				ax_citer first = ax_box_cbegin(ax_r(seq, seqs[s]).box);
+				ax_citer last = ax_box_cend(ax_r(seq, seqs[s]).box);
+				for (int32_t key = 0; key <= n + 1; key++) {
+					int32_t val = key << shift;
+					ax_citer it = first;
+					ax_lower_bound(&it, &last, &val);
+					int32_t expect = key / 2 * 2;
+					axut_assert_int_equal(r, expect < n ? expect : n,
+							ax_citer_dist(&first, &it));
+				}
+			}
+		}
+	}
+
+	ax_vector_r strs = ax_vector_create(ax_base_local(base), ax_stuff_traits(AX_ST_S));
+	const char *words[] = { "apple", "fig", "fig", "pear" };
+	for (int i = 0; i < 4; i++)
+		ax_seq_push(strs.seq, words[i]);
+	const char *keys[] = { "", "apple", "banana", "fig", "plum" };
+	const long pos[] = { 0, 0, 1, 1, 4 };
+	ax_citer first = ax_box_cbegin(strs.box), last = ax_box_cend(strs.box);
+	for (int i = 0; i < 5; i++) {
+		ax_citer it = first;
+		ax_lower_bound(&it, &last, keys[i]);
+		axut_assert_int_equal(r, pos[i], ax_citer_dist(&first, &it));
+	}
+
+	ax_base_destroy(base);
+}
+
+/* Run every specialized algorithm on a vector and on a deque holding the same values */
+static void contiguous_type(axut_runner *r, const ax_stuff_trait *etr, int type)
+{
+	const int n = 3000;
+	ax_base *base = ax_base_create();
+	ax_seq *seqs[2] = {
+		ax_vector_create(ax_base_local(base), etr).seq,
+		ax_deque_create(ax_base_local(base), etr).seq,
+	};
+	ax_seq *outs[2] = {
+		ax_vector_create(ax_base_local(base), etr).seq,
+		ax_deque_create(ax_base_local(base), etr).seq,
+	};
+
+	for (int i = 0; i < n; i++) {
+		ax_stuff val;
+		switch (type) {
+			case AX_ST_U8: val.u8 = rand(); break;
+			case AX_ST_I32: val.i32 = rand() % 1000 - 500; break;
+			case AX_ST_I64: val.i64 = rand(); break;
+			case AX_ST_LF: val.lf = rand() / 3.0; break;
+		}
+		ax_seq_push(seqs[0], &val);
+		ax_seq_push(seqs[1], &val);
+	}
+
+	ax_stuff pivot;
+	ax_iter mid = ax_seq_at(seqs[0], n / 3);
+	memcpy(&pivot, ax_iter_get(&mid), etr->size);
+	ax_pred lt = ax_pred_binary_make(ax_oper_for(type)->lt, NULL, &pivot, NULL);
+	ax_pred inc = ax_pred_binary_make(ax_oper_for(type)->add, NULL, &pivot, NULL);
+
+	long found[2], bound[2];
+	size_t count[2];
+	ax_bool hit[2];
+	for (int s = 0; s < 2; s++) {
+		ax_box *box = ax_r(seq, seqs[s]).box;
+		ax_iter first = ax_box_begin(box), last = ax_box_end(box);
+
+		count[s] = ax_count_if(ax_iter_c(&first), ax_iter_c(&last), &lt);
+		ax_iter it = first;
+		ax_find_if_not(ax_iter_c(&it), ax_iter_c(&last), &lt);
+		found[s] = ax_iter_dist(&first, &it);
+
+		ax_seq_trunc(outs[s], n);
+		ax_iter out = ax_box_begin(ax_r(seq, outs[s]).box);
+		ax_transform(ax_iter_c(&first), ax_iter_c(&last), &out, &inc);
+
+		axut_assert(r, !ax_sort(&first, &last));
+		it = first;
+		ax_binary_search_if_not(ax_iter_c(&it), ax_iter_c(&last), &lt);
+		bound[s] = ax_iter_dist(&first, &it);
+		it = first;
+		ax_binary_search(ax_iter_c(&it), ax_iter_c(&last), &pivot);
+		hit[s] = !ax_iter_equal(&it, &last) && etr->equal(ax_iter_get(&it), &pivot, etr->size);
+	}
+	axut_assert_uint_equal(r, count[0], count[1]);
+	axut_assert_int_equal(r, found[0], found[1]);
+	axut_assert_int_equal(r, bound[0], bound[1]);
+	axut_assert(r, hit[0] && hit[1]);
+	axut_assert(r, seq_same(seqs[0], seqs[1]));
+	axut_assert(r, seq_same(outs[0], outs[1]));
+
+	for (int s = 0; s < 2; s++) {
+		ax_box *box = ax_r(seq, outs[s]).box;
+		ax_iter first = ax_box_begin(box), last = ax_box_end(box);
+		ax_iter half = ax_seq_at(outs[s], n / 2);
+		ax_sort(&first, &half);
+		ax_sort(&half, &last);
+		ax_iter dest = ax_box_begin(ax_r(seq, seqs[s]).box);
+		ax_merge(ax_iter_c(&first), ax_iter_c(&half), ax_iter_c(&half), ax_iter_c(&last), &dest);
+		ax_iter end = ax_box_end(ax_r(seq, seqs[s]).box);
+		axut_assert(r, ax_iter_equal(&dest, &end));
+	}
+	axut_assert(r, seq_same(seqs[0], seqs[1]));
+	ax_iter first = ax_box_begin(ax_r(seq, seqs[0]).box), last = ax_box_end(ax_r(seq, seqs[0]).box);
+	ax_pred le = ax_pred_binary_make(ax_oper_for(type)->le, NULL, NULL, NULL);
+	axut_assert(r, ax_sorted(ax_iter_c(&first), ax_iter_c(&last), &le));
+
+	ax_base_destroy(base);
+}
+
+static void contiguous(axut_runner *r)
+{
+	srand(23);
+	contiguous_type(r, ax_stuff_traits(AX_ST_U8), AX_ST_U8);
+	contiguous_type(r, ax_stuff_traits(AX_ST_I32), AX_ST_I32);
+	contiguous_type(r, ax_stuff_traits(AX_ST_LF), AX_ST_LF);
+
+	/* A trait with its own less goes through the generic contiguous path */
+	ax_stuff_trait high = *ax_stuff_traits(AX_ST_I64);
+	high.less = less_i64_high;
+	ax_base *base = ax_base_create();
+	ax_vector_r vec_r = ax_vector_create(ax_base_local(base), &high);
+	ax_list_r list_r = ax_list_create(ax_base_local(base), &high);
+	for (int i = 0; i < 2000; i++) {
+		int64_t val = rand() % 0x10000;
+		ax_seq_push(vec_r.seq, &val);
+		ax_seq_push(list_r.seq, &val);
+	}
+	ax_iter first = ax_box_begin(vec_r.box), last = ax_box_end(vec_r.box);
+	ax_sort(&first, &last);
+	first = ax_box_begin(list_r.box), last = ax_box_end(list_r.box);
+	ax_list_sort(list_r.list);
+	int64_t prev = -1, sum[2] = { 0 };
+	ax_box_cforeach(vec_r.box, const int64_t *, v) {
+		axut_assert(r, prev >> 8 <= *v >> 8);
+		prev = *v;
+		sum[0] += *v;
+	}
+	ax_box_cforeach(list_r.box, const int64_t *, v)
+		sum[1] += *v;
+	axut_assert(r, sum[0] == sum[1]);
+
+	/* Link elements are moved in place by the trait */
+	ax_vector_r str_r = ax_vector_create(ax_base_local(base), ax_stuff_traits(AX_ST_S));
+	char buf[16];
+	for (int i = 0; i < 500; i++) {
+		sprintf(buf, "%d", rand() % 1000);
+		ax_seq_push(str_r.seq, buf);
+	}
+	first = ax_box_begin(str_r.box), last = ax_box_end(str_r.box);
+	ax_sort(&first, &last);
+	const char *prev_str = "";
+	ax_box_cforeach(str_r.box, const char *, s) {
+		axut_assert(r, strcmp(prev_str, s) <= 0);
+		prev_str = s;
+	}
+
+	ax_base_destroy(base);
+}
+
+static double bench_run(int algo, ax_seq *seq, ax_seq *out, int type)
+{
+	ax_box *box = ax_r(seq, seq).box;
+	ax_iter first = ax_box_begin(box), last = ax_box_end(box);
+	int32_t pivot = 0x4000;
+	ax_pred lt = ax_pred_binary_make(ax_oper_for(type)->lt, NULL, &pivot, NULL);
+	ax_pred inc = ax_pred_binary_make(ax_oper_for(type)->add, NULL, &pivot, NULL);
+	clock_t time_before = clock();
+	switch (algo) {
+		case 0:
+			ax_sort(&first, &last);
+			break;
+		case 1: {
+			ax_pred never = ax_pred_binary_make(ax_oper_for(type)->lt, NULL, &(int32_t) { INT32_MIN }, NULL);
+			ax_find_if(ax_iter_c(&first), ax_iter_c(&last), &never);
+			break;
+		}
+		case 2:
+			ax_count_if(ax_iter_c(&first), ax_iter_c(&last), &lt);
+			break;
+		case 3: {
+			ax_iter dest = ax_box_begin(ax_r(seq, out).box);
+			ax_transform(ax_iter_c(&first), ax_iter_c(&last), &dest, &inc);
+			break;
+		}
+		case 4: {
+			ax_iter half = ax_seq_at(seq, ax_box_size(box) / 2);
+			ax_iter dest = ax_box_begin(ax_r(seq, out).box);
+			ax_merge(ax_iter_c(&first), ax_iter_c(&half), ax_iter_c(&half), ax_iter_c(&last), &dest);
+			break;
+		}
+		case 5:
+			for (int32_t i = 0; i < 0x10000; i++) {
+				ax_iter it = first;
+				ax_binary_search(ax_iter_c(&it), ax_iter_c(&last), &i);
+			}
+			break;
+	}
+	return (double)(clock() - time_before) / CLOCKS_PER_SEC;
+}
+
+/* Operators of another size than the elements must not take their batch kernels */
+static void batch_mixed_size(axut_runner *r)
+{
+	ax_base *base = ax_base_create();
+	ax_exec *exec = ax_exec_create(2);
+	ax_vector_r wide_r = ax_vector_create(ax_base_local(base), ax_stuff_traits(AX_ST_I64));
+	ax_vector_r narrow_r = ax_vector_create(ax_base_local(base), ax_stuff_traits(AX_ST_I32));
+	ax_vector_r flags_r = ax_vector_create(ax_base_local(base), ax_stuff_traits(AX_ST_U8));
+
+	for (int i = 0; i < 1000; i++) {
+		int64_t val = i;
+		ax_seq_push(wide_r.seq, &val);
+		ax_seq_push(flags_r.seq, &(uint8_t) { 9 });
+	}
+	for (int i = 0; i < 100; i++)
+		ax_seq_push(narrow_r.seq, &(int32_t) { i * 256 + 1 });
+
+	/* Each operator reads the low part of an element, little endian assumed */
+	int32_t pivot = 500;
+	int8_t zero = 0;
+	ax_pred lt = ax_pred_binary_make(ax_oper_for(AX_ST_I32)->lt, NULL, &pivot, NULL);
+	ax_pred ne = ax_pred_binary_make(ax_oper_for(AX_ST_I8)->ne, NULL, &zero, NULL);
+
+	ax_iter first = ax_box_begin(wide_r.box), last = ax_box_end(wide_r.box);
+	axut_assert_uint_equal(r, 500, ax_count_if(ax_iter_c(&first), ax_iter_c(&last), &lt));
+	axut_assert_uint_equal(r, 500, ax_par_count_if(ax_iter_c(&first), ax_iter_c(&last), &lt, exec));
+	ax_iter it = first;
+	ax_find_if_not(ax_iter_c(&it), ax_iter_c(&last), &lt);
+	axut_assert_int_equal(r, 500, ax_iter_dist(&first, &it));
+
+	ax_iter out = ax_box_begin(flags_r.box);
+	ax_transform(ax_iter_c(&first), ax_iter_c(&last), &out, &lt);
+	const uint8_t *flags = ax_vector_buffer(flags_r.vector);
+	for (int i = 0; i < 1000; i++)
+		axut_assert_int_equal(r, i < 500, flags[i]);
+
+	first = ax_box_begin(narrow_r.box), last = ax_box_end(narrow_r.box);
+	axut_assert_uint_equal(r, 100, ax_count_if(ax_iter_c(&first), ax_iter_c(&last), &ne));
+	axut_assert(r, ax_all_of(ax_iter_c(&first), ax_iter_c(&last), &ne));
+
+	ax_exec_destroy(exec);
+	ax_base_destroy(base);
+}
+
+static void bench_contiguous(axut_runner *r)
+{
+	const int n = 0x100000;
+	const char *algo_name[] = { "sort", "find_if", "count_if", "transform", "merge", "binary_search" };
+	ax_base *base = ax_base_create();
+	ax_seq *seqs[2] = {
+		ax_deque_create(ax_base_local(base), ax_stuff_traits(AX_ST_I32)).seq,
+		ax_vector_create(ax_base_local(base), ax_stuff_traits(AX_ST_I32)).seq,
+	};
+	ax_seq *outs[2] = {
+		ax_deque_create(ax_base_local(base), ax_stuff_traits(AX_ST_I32)).seq,
+		ax_vector_create(ax_base_local(base), ax_stuff_traits(AX_ST_I32)).seq,
+	};
+
+	srand(24);
+	for (int i = 0; i < n; i++) {
+		int32_t val = rand() % 0x8000;
+		ax_seq_push(seqs[0], &val);
+		ax_seq_push(seqs[1], &val);
+	}
+	for (int s = 0; s < 2; s++)
+		ax_seq_trunc(outs[s], n);
+
+	//printf("%-14s %10s %10s %8s\n", "algorithm", "deque", "vector", "speedup");
+	for (int algo = 0; algo < 6; algo++) {
+		double time[2];
+		for (int s = 0; s < 2; s++)
+			time[s] = bench_run(algo, seqs[s], outs[s], AX_ST_I32);
+		//printf("%-14s %9.4lfs %9.4lfs %7.1lfx\n", algo_name[algo], time[0], time[1], time[0] / time[1]);
+		(void)time;
+		(void)algo_name;
+	}
+	axut_assert(r, seq_same(seqs[0], seqs[1]));
+	axut_assert(r, seq_same(outs[0], outs[1]));
+
+	ax_base_destroy(base);
+}
+
+static double wall_time(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void par_sort(axut_runner *r)
+{
+	const int n = 100000;
+	ax_base *base = ax_base_create();
+	ax_stuff_trait high = *ax_stuff_traits(AX_ST_I32);
+	high.less = less_i32_high;
+	ax_seq *seqs[] = {
+		ax_vector_create(ax_base_local(base), ax_stuff_traits(AX_ST_I32)).seq,
+		ax_vector_create(ax_base_local(base), &high).seq,
+		ax_deque_create(ax_base_local(base), ax_stuff_traits(AX_ST_I32)).seq,
+		ax_vector_create(ax_base_local(base), ax_stuff_traits(AX_ST_S)).seq,
+	};
+	const int nseq = sizeof seqs / sizeof *seqs;
+	ax_exec *exec = ax_exec_create(3);
+
+	/* Pools made per call for nthreads up to 7, then one pool shared by every call */
+	srand(25);
+	for (unsigned nthreads = 0; nthreads <= 9; nthreads += nthreads ? 2 : 1) {
+		for (int s = 0; s < nseq; s++) {
+			ax_box_clear(ax_r(seq, seqs[s]).box);
+			int64_t sum = 0;
+			for (int i = 0; i < n; i++) {
+				int32_t val = rand() % (n / 4);
+				sum += val;
+				if (s == nseq - 1) {
+					char buf[16];
+					sprintf(buf, "%08d", val);
+					ax_seq_push(seqs[s], buf);
+				} else
+					ax_seq_push(seqs[s], &val);
+			}
+			ax_iter first = ax_box_begin(ax_r(seq, seqs[s]).box), last = ax_box_end(ax_r(seq, seqs[s]).box);
+			if (nthreads > 7)
+				axut_assert(r, !ax_par_sort_exec(&first, &last, exec));
+			else
+				axut_assert(r, !ax_par_sort(&first, &last, nthreads));
+
+			int64_t sorted_sum = 0;
+			int32_t prev = -1;
+			for (ax_iter it = first; !ax_iter_equal(&it, &last); ax_iter_next(&it)) {
+				int32_t val = s == nseq - 1 ? atoi(ax_iter_get(&it)) : *(int32_t *)ax_iter_get(&it);
+				int32_t key = s == 1 ? val >> 8 : val;
+				axut_assert(r, (s == 1 ? prev >> 8 : prev) <= key);
+				prev = val;
+				sorted_sum += val;
+			}
+			axut_assert(r, sorted_sum == sum);
+		}
+	}
+
+	ax_exec_destroy(exec);
+	ax_base_destroy(base);
+}
+
+static void bench_par_sort(axut_runner *r)
+{
+	const int n = 0x400000;
+	ax_base *base = ax_base_create();
+	ax_pred pred = ax_pred_binary_make(ax_oper_for(AX_ST_I32)->le, NULL, NULL, NULL);
+	int32_t *arr = malloc(n * sizeof *arr);
+	srand(26);
+	for (int i = 0; i < n; i++)
+		arr[i] = rand();
+
+	ax_vector_r vec_r = ax_vector_create(ax_base_local(base), ax_stuff_traits(AX_ST_I32));
+	ax_seq_trunc(vec_r.seq, n);
+	ax_iter first = ax_box_begin(vec_r.box), last = ax_box_end(vec_r.box);
+	for (unsigned nthreads = 1; nthreads <= 8; nthreads *= 2) {
+		memcpy(ax_vector_buffer(vec_r.vector), arr, n * sizeof *arr);
+		double time_before = wall_time();
+		ax_par_sort(&first, &last, nthreads);
+		//printf("ax_par_sort %u threads: %lfs\n", nthreads, wall_time() - time_before);
+		(void)time_before;
+		axut_assert(r, ax_sorted(ax_iter_c(&first), ax_iter_c(&last), &pred));
+	}
+
+	/* A pool kept across calls pays for its threads once */
+	ax_exec *exec = ax_exec_create(7);
+	for (int round = 0; round < 4; round++) {
+		memcpy(ax_vector_buffer(vec_r.vector), arr, n * sizeof *arr);
+		double time_before = wall_time();
+		ax_par_sort_exec(&first, &last, exec);
+		//printf("ax_par_sort_exec round %d: %lfs\n", round, wall_time() - time_before);
+		(void)time_before;
+		axut_assert(r, ax_sorted(ax_iter_c(&first), ax_iter_c(&last), &pred));
+	}
+	ax_exec_destroy(exec);
+
+	memcpy(ax_vector_buffer(vec_r.vector), arr, n * sizeof *arr);
+	double time_before = wall_time();
+	ax_merge_sort(&first, &last);
+	//printf("ax_merge_sort: %lfs\n", wall_time() - time_before);
+	(void)time_before;
+
+	free(arr);
+	ax_base_destroy(base);
+}
+
+static void radix_sort_type(axut_runner *r, int type, ax_bool cont)
+{
+	const int n = 5000;
+	ax_base *base = ax_base_create();
+	const ax_stuff_trait *etr = ax_stuff_traits(type);
+	ax_seq *seq = cont
+		? ax_vector_create(ax_base_local(base), etr).seq
+		: ax_deque_create(ax_base_local(base), etr).seq;
+	ax_seq *ref = ax_vector_create(ax_base_local(base), etr).seq;
+
+	for (int i = 0; i < n; i++) {
+		ax_stuff val;
+		int64_t x = (int64_t)rand() * rand() - (int64_t)RAND_MAX * RAND_MAX / 2;
+		switch (type) {
+			case AX_ST_I8: val.i8 = x; break;
+			case AX_ST_U16: val.u16 = x; break;
+			case AX_ST_I32: val.i32 = x; break;
+			case AX_ST_U64: val.u64 = x; break;
+			case AX_ST_F: val.f = x / 1000.0f; break;
+			case AX_ST_LF: val.lf = i % 7 ? x / 3.0 : -0.0; break;
+		}
+		ax_seq_push(seq, &val);
+		ax_seq_push(ref, &val);
+	}
+
+	ax_iter first = ax_box_begin(ax_r(seq, seq).box), last = ax_box_end(ax_r(seq, seq).box);
+	axut_assert(r, !ax_radix_sort(&first, &last, NULL, 0));
+	ax_pred le = ax_pred_binary_make(ax_oper_for(type)->le, NULL, NULL, NULL);
+	axut_assert(r, ax_sorted(ax_iter_c(&first), ax_iter_c(&last), &le));
+
+	first = ax_box_begin(ax_r(seq, ref).box), last = ax_box_end(ax_r(seq, ref).box);
+	ax_sort(&first, &last);
+	axut_assert(r, seq_same(seq, ref));
+
+	ax_base_destroy(base);
+}
+
+static void radix_sort(axut_runner *r)
+{
+	const int types[] = { AX_ST_I8, AX_ST_U16, AX_ST_I32, AX_ST_U64, AX_ST_F, AX_ST_LF };
+	srand(27);
+	for (int i = 0; i < sizeof types / sizeof *types; i++) {
+		axut_assert(r, ax_radix_sortable(ax_stuff_traits(types[i])));
+		radix_sort_type(r, types[i], ax_true);
+		radix_sort_type(r, types[i], ax_false);
+	}
+	axut_assert(r, !ax_radix_sortable(ax_stuff_traits(AX_ST_PTR)));
+
+	/* Strings with shared prefixes, empty strings and duplicates */
+	ax_base *base = ax_base_create();
+	ax_seq *seqs[] = {
+		ax_vector_create(ax_base_local(base), ax_stuff_traits(AX_ST_S)).seq,
+		ax_deque_create(ax_base_local(base), ax_stuff_traits(AX_ST_S)).seq,
+		ax_vector_create(ax_base_local(base), ax_stuff_traits(AX_ST_S)).seq,
+	};
+	char buf[80];
+	for (int i = 0; i < 3000; i++) {
+		int len = rand() % 40;
+		for (int j = 0; j < len; j++)
+			buf[j] = j < 20 && i % 3 ? 'x' : 'a' + rand() % 3;
+		buf[len] = '\0';
+		for (int s = 0; s < 3; s++)
+			ax_seq_push(seqs[s], buf);
+	}
+
+	int64_t scratch[3000 * 2];
+	for (int s = 0; s < 3; s++) {
+		ax_iter first = ax_box_begin(ax_r(seq, seqs[s]).box), last = ax_box_end(ax_r(seq, seqs[s]).box);
+		if (s == 2)
+			ax_sort(&first, &last);
+		else
+			axut_assert(r, !ax_radix_sort(&first, &last, s ? NULL : scratch, sizeof scratch));
+	}
+	ax_iter it0 = ax_box_begin(ax_r(seq, seqs[0]).box), it1 = ax_box_begin(ax_r(seq, seqs[1]).box);
+	ax_iter end = ax_box_end(ax_r(seq, seqs[0]).box);
+	ax_box_cforeach(ax_r(seq, seqs[2]).box, const char *, s) {
+		axut_assert_str_equal(r, s, ax_iter_get(&it0));
+		axut_assert_str_equal(r, s, ax_iter_get(&it1));
+		ax_iter_next(&it0);
+		ax_iter_next(&it1);
+	}
+	axut_assert(r, ax_iter_equal(&it0, &end));
+
+	ax_base_destroy(base);
+}
+
+static void bench_radix_sort(axut_runner *r)
+{
+	const int n = 0x100000;
+	ax_base *base = ax_base_create();
+	srand(28);
+
+	const int types[] = { AX_ST_I32, AX_ST_LF, AX_ST_S };
+	for (int t = 0; t < 3; t++) {
+		ax_seq *seqs[2];
+		for (int s = 0; s < 2; s++)
+			seqs[s] = ax_vector_create(ax_base_local(base), ax_stuff_traits(types[t])).seq;
+		for (int i = 0; i < n; i++) {
+			int32_t x = rand();
+			double lf = x / 7.0 - 1e8;
+			char buf[16];
+			sprintf(buf, "%d", x);
+			for (int s = 0; s < 2; s++)
+				ax_seq_push(seqs[s], types[t] == AX_ST_I32 ? (void *)&x : types[t] == AX_ST_LF ? (void *)&lf : buf);
+		}
+
+		double time[2];
+		for (int s = 0; s < 2; s++) {
+			ax_iter first = ax_box_begin(ax_r(seq, seqs[s]).box), last = ax_box_end(ax_r(seq, seqs[s]).box);
+			clock_t time_before = clock();
+			if (s)
+				ax_radix_sort(&first, &last, NULL, 0);
+			else
+				ax_sort(&first, &last);
+			time[s] = (double)(clock() - time_before) / CLOCKS_PER_SEC;
+		}
+		//printf("type %d: ax_sort %lfs, ax_radix_sort %lfs\n", types[t], time[0], time[1]);
+		(void)time;
+		if (types[t] != AX_ST_S)
+			axut_assert(r, seq_same(seqs[0], seqs[1]));
+	}
+
+	ax_base_destroy(base);
+}
+
+/* Same as the built-in lt of int32_t, but has no batch kernel */
+static int32_t iter_i32(const ax_iter *it)
+{
+	return ax_box_elem_tr(it->owner)->link ? atoi(ax_iter_get(it)) : *(int32_t *)ax_iter_get(it);
+}
+
+static void seq_fill(ax_seq *seq, const int32_t *arr, int n)
+{
+	ax_box_clear(ax_r(seq, seq).box);
+	for (int i = 0; i < n; i++) {
+		char buf[16];
+		sprintf(buf, "%08d", arr[i]);
+		ax_seq_push(seq, ax_box_elem_tr(ax_r(seq, seq).box)->link ? (void *)buf : (void *)(arr + i));
+	}
+}
+
+/* Check [first, last) holds ref at nth, ref[0, nth) in order before it if sorted, and nothing out of place */
+static ax_bool check_arranged(ax_seq *seq, const int32_t *ref, int n, int k, ax_bool sorted, ax_bool desc)
+{
+	ax_iter it = ax_box_begin(ax_r(seq, seq).box), last = ax_box_end(ax_r(seq, seq).box);
+	for (int i = 0; i < n; i++, ax_iter_next(&it)) {
+		int j = sorted && i < k ? i : k;
+		int32_t val = iter_i32(&it), exp = ref[desc ? n - 1 - j : j];
+		if (i == j ? val != exp : (i < k) == desc ? val < exp : val > exp)
+			return ax_false;
+	}
+	return ax_iter_equal(&it, &last);
+}
+
+static void selection(axut_runner *r)
+{
+	ax_base *base = ax_base_create();
+	ax_seq *seqs[] = {
+		ax_vector_create(ax_base_local(base), ax_stuff_traits(AX_ST_I32)).seq,
+		ax_list_create(ax_base_local(base), ax_stuff_traits(AX_ST_I32)).seq,
+		ax_vector_create(ax_base_local(base), ax_stuff_traits(AX_ST_S)).seq,
+		ax_deque_create(ax_base_local(base), ax_stuff_traits(AX_ST_S)).seq,
+	};
+	const int nseq = sizeof seqs / sizeof *seqs;
+	ax_seq *out[] = {
+		ax_vector_create(ax_base_local(base), ax_stuff_traits(AX_ST_I32)).seq,
+		ax_vector_create(ax_base_local(base), ax_stuff_traits(AX_ST_S)).seq,
+	};
+	ax_pred gt = ax_pred_binary_make(ax_oper_for(AX_ST_I32)->gt, NULL, NULL, NULL);
+	srand(29);
+
+	const int sizes[] = { 1, 2, 3, 30, 200, 5000 };
+	int32_t *arr = malloc(5000 * sizeof *arr), *ref = malloc(5000 * sizeof *ref);
+	for (int pattern = 0; pattern < PAT_COUNT; pattern++) {
+		for (int z = 0; z < sizeof sizes / sizeof *sizes; z++) {
+			int n = sizes[z];
+			for (int i = 0; i < n; i++)
+				arr[i] = ref[i] = pattern_value(pattern, i, n) % 100000000;
+			qsort(ref, n, sizeof *ref, qsort_compare_cb);
+
+			const int ks[] = { 0, n / 3, n - 1 };
+			for (int s = 0; s < nseq; s++) {
+				ax_box *box = ax_r(seq, seqs[s]).box;
+				for (int j = 0; j < 3; j++) {
+					int k = ks[j];
+					seq_fill(seqs[s], arr, n);
+					ax_iter first = ax_box_begin(box), last = ax_box_end(box), nth = ax_seq_at(seqs[s], k);
+					axut_assert(r, !ax_nth_element(&first, &nth, &last, NULL));
+					axut_assert(r, check_arranged(seqs[s], ref, n, k, ax_false, ax_false));
+
+					seq_fill(seqs[s], arr, n);
+					first = ax_box_begin(box), last = ax_box_end(box), nth = ax_seq_at(seqs[s], k);
+					axut_assert(r, !ax_partial_sort(&first, &nth, &last, NULL));
+					axut_assert(r, check_arranged(seqs[s], ref, n, k, ax_true, ax_false));
+
+					/* k + 1 elements, or all of them and no more when asked for extra */
+					ax_seq *dst = out[s >= 2];
+					ax_box_clear(ax_r(seq, dst).box);
+					size_t want = j == 2 ? n + 5 : k + 1;
+					axut_assert(r, !ax_top_k(ax_iter_c(&first), ax_iter_c(&last), dst, want, NULL));
+					axut_assert_uint_equal(r, want < n ? want : n, ax_box_size(ax_r(seq, dst).box));
+					int i = 0;
+					for (ax_iter it = ax_box_begin(ax_r(seq, dst).box); i < want && i < n; ax_iter_next(&it), i++)
+						axut_assert_int_equal(r, ref[i], iter_i32(&it));
+				}
+
+				/* Descending by a predicate, only for the int32 sequences */
+				if (s >= 2)
+					continue;
+				int k = n / 2;
+				seq_fill(seqs[s], arr, n);
+				ax_iter first = ax_box_begin(box), last = ax_box_end(box), nth = ax_seq_at(seqs[s], k);
+				axut_assert(r, !ax_nth_element(&first, &nth, &last, &gt));
+				axut_assert(r, check_arranged(seqs[s], ref, n, k, ax_false, ax_true));
+				axut_assert(r, !ax_partial_sort(&first, &nth, &last, &gt));
+				axut_assert(r, check_arranged(seqs[s], ref, n, k, ax_true, ax_true));
+
+				ax_box_clear(ax_r(seq, out[0]).box);
+				axut_assert(r, !ax_top_k(ax_iter_c(&first), ax_iter_c(&last), out[0], 10, &gt));
+				int i = 0;
+				ax_box_cforeach(ax_r(seq, out[0]).box, const int32_t *, v)
+					axut_assert_int_equal(r, ref[n - 1 - i++], *v);
+				axut_assert_int_equal(r, n < 10 ? n : 10, i);
+			}
+		}
+	}
+
+	/* Empty ranges and k of zero */
+	ax_box_clear(ax_r(seq, seqs[0]).box);
+	ax_iter first = ax_box_begin(ax_r(seq, seqs[0]).box), last = ax_box_end(ax_r(seq, seqs[0]).box);
+	axut_assert(r, !ax_nth_element(&first, &last, &last, NULL));
+	axut_assert(r, !ax_partial_sort(&first, &last, &last, NULL));
+	ax_box_clear(ax_r(seq, out[0]).box);
+	axut_assert(r, !ax_top_k(ax_iter_c(&first), ax_iter_c(&last), out[0], 3, NULL));
+	seq_fill(seqs[0], arr, 10);
+	first = ax_box_begin(ax_r(seq, seqs[0]).box), last = ax_box_end(ax_r(seq, seqs[0]).box);
+	axut_assert(r, !ax_top_k(ax_iter_c(&first), ax_iter_c(&last), out[0], 0, NULL));
+	axut_assert_uint_equal(r, 0, ax_box_size(ax_r(seq, out[0]).box));
+
+	free(arr);
+	free(ref);
+	ax_base_destroy(base);
+}
+
+static void bench_selection(axut_runner *r)
+{
+	const int n = 0x400000, k = 100;
+	ax_base *base = ax_base_create();
+	int32_t *arr = malloc(n * sizeof *arr);
+	srand(30);
+	for (int i = 0; i < n; i++)
+		arr[i] = rand();
+
+	ax_vector_r vec_r = ax_vector_create(ax_base_local(base), ax_stuff_traits(AX_ST_I32));
+	ax_vector_r top_r = ax_vector_create(ax_base_local(base), ax_stuff_traits(AX_ST_I32));
+	ax_seq_trunc(vec_r.seq, n);
+	ax_iter first = ax_box_begin(vec_r.box), last = ax_box_end(vec_r.box);
+	ax_iter mid = ax_seq_at(vec_r.seq, n / 2), front = ax_seq_at(vec_r.seq, k);
+
+	memcpy(ax_vector_buffer(vec_r.vector), arr, n * sizeof *arr);
+	double time_before = wall_time();
+	ax_sort(&first, &last);
+	//printf("ax_sort: %lfs\n", wall_time() - time_before);
+	int32_t median = *(int32_t *)ax_iter_get(&mid), kth = *(int32_t *)ax_iter_get(&front);
+
+	memcpy(ax_vector_buffer(vec_r.vector), arr, n * sizeof *arr);
+	time_before = wall_time();
+	ax_nth_element(&first, &mid, &last, NULL);
+	//printf("ax_nth_element median: %lfs\n", wall_time() - time_before);
+	axut_assert_int_equal(r, median, *(int32_t *)ax_iter_get(&mid));
+
+	memcpy(ax_vector_buffer(vec_r.vector), arr, n * sizeof *arr);
+	time_before = wall_time();
+	ax_partial_sort(&first, &front, &last, NULL);
+	//printf("ax_partial_sort %d: %lfs\n", k, wall_time() - time_before);
+	axut_assert_int_equal(r, kth, *(int32_t *)ax_iter_get(&front));
+
+	memcpy(ax_vector_buffer(vec_r.vector), arr, n * sizeof *arr);
+	time_before = wall_time();
+	ax_top_k(ax_iter_c(&first), ax_iter_c(&last), top_r.seq, k, NULL);
+	//printf("ax_top_k %d: %lfs\n", k, wall_time() - time_before);
+	axut_assert_uint_equal(r, k, ax_box_size(top_r.box));
+	ax_iter back = ax_seq_at(top_r.seq, k - 1);
+	axut_assert(r, *(int32_t *)ax_iter_get(&back) <= kth);
+	(void)time_before;
+
+	free(arr);
+	ax_base_destroy(base);
+}
+
+static ax_bool less_i64_key(const void *p1, const void *p2, size_t size)
+{
+	return *(int64_t *)p1 >> 32 < *(int64_t *)p2 >> 32;
+}
+
+static ax_bool less_str_head(const void *p1, const void *p2, size_t size)
+{
+	return **(char **)p1 < **(char **)p2;
+}
+
+/* Keys of n elements laid out as nrun sorted runs, or in the order of pattern when nrun is 0 */
+static int64_t run_key(int pattern, int nrun, int i, int n)
+{
+	if (!nrun)
+		return pattern_value(pattern, i, n) % 1000;
+	int len = (n + nrun - 1) / nrun;
+	return (int64_t)(i % len) * 1000 / len + i / len % 3;
+}
+
+static void stable_sort(axut_runner *r)
+{
+	ax_base *base = ax_base_create();
+	ax_stuff_trait key_tr = *ax_stuff_traits(AX_ST_I64);
+	key_tr.less = less_i64_key;
+	ax_pred le = ax_pred_binary_make(ax_oper_for(AX_ST_I64)->le, NULL, NULL, NULL);
+	ax_seq *seqs[] = {
+		ax_vector_create(ax_base_local(base), &key_tr).seq,
+		ax_list_create(ax_base_local(base), &key_tr).seq,
+	};
+	srand(31);
+
+	/* The low half holds the position, so a stable result is ascending as a whole */
+	const int sizes[] = { 0, 1, 2, 31, 32, 33, 200, 5000, 40000 };
+	for (int pattern = 0; pattern < PAT_COUNT + 3; pattern++) {
+		int nrun = pattern < PAT_COUNT ? 0 : (int[]){ 2, 7, 64 }[pattern - PAT_COUNT];
+		for (int z = 0; z < sizeof sizes / sizeof *sizes; z++) {
+			int n = sizes[z];
+			for (int s = 0; s < 2; s++) {
+				ax_box_clear(ax_r(seq, seqs[s]).box);
+				for (int i = 0; i < n; i++) {
+					int64_t val = run_key(pattern, nrun, i, n) << 32 | i;
+					ax_seq_push(seqs[s], &val);
+				}
+				ax_iter first = ax_box_begin(ax_r(seq, seqs[s]).box), last = ax_box_end(ax_r(seq, seqs[s]).box);
+				axut_assert(r, !ax_merge_sort(&first, &last));
+				axut_assert(r, ax_sorted(ax_iter_c(&first), ax_iter_c(&last), &le));
+				axut_assert_uint_equal(r, n, ax_box_size(ax_r(seq, seqs[s]).box));
+			}
+		}
+	}
+
+	/* Link values, ordered by the first character only */
+	ax_stuff_trait head_tr = *ax_stuff_traits(AX_ST_S);
+	head_tr.less = less_str_head;
+	ax_seq *strs[] = {
+		ax_vector_create(ax_base_local(base), &head_tr).seq,
+		ax_deque_create(ax_base_local(base), &head_tr).seq,
+	};
+	for (int s = 0; s < 2; s++) {
+		char buf[16];
+		for (int i = 0; i < 3000; i++) {
+			sprintf(buf, "%c%06d", 'a' + rand() % 5, i);
+			ax_seq_push(strs[s], buf);
+		}
+		ax_iter first = ax_box_begin(ax_r(seq, strs[s]).box), last = ax_box_end(ax_r(seq, strs[s]).box);
+		axut_assert(r, !ax_merge_sort(&first, &last));
+		const char *prev = "";
+		ax_box_cforeach(ax_r(seq, strs[s]).box, const char *, str) {
+			axut_assert(r, strcmp(prev, str) < 0);
+			prev = str;
+		}
+	}
+
+	ax_base_destroy(base);
+}
+
+/* -0.0 equals +0.0, so the signs of the zeros keep their original order */
+static void stable_zero(axut_runner *r)
+{
+	const int n = 3000;
+	ax_base *base = ax_base_create();
+	ax_seq *seqs[] = {
+		ax_vector_create(ax_base_local(base), ax_stuff_traits(AX_ST_F)).seq,
+		ax_vector_create(ax_base_local(base), ax_stuff_traits(AX_ST_LF)).seq,
+		ax_deque_create(ax_base_local(base), ax_stuff_traits(AX_ST_LF)).seq,
+	};
+	char *signs = malloc(n);
+	int nzero = 0;
+
+	srand(49);
+	for (int i = 0; i < n; i++) {
+		double val = rand() % 5 - 2;
+		if (val == 0) {
+			signs[nzero] = rand() % 2;
+			val = signs[nzero++] ? -0.0 : 0.0;
+		}
+		float fval = val;
+		ax_seq_push(seqs[0], &fval);
+		ax_seq_push(seqs[1], &val);
+		ax_seq_push(seqs[2], &val);
+	}
+
+	for (int s = 0; s < 3; s++) {
+		ax_iter first = ax_box_begin(ax_r(seq, seqs[s]).box), last = ax_box_end(ax_r(seq, seqs[s]).box);
+		if (s == 2)
+			axut_assert(r, !ax_radix_sort(&first, &last, NULL, 0));
+		else
+			axut_assert(r, !ax_merge_sort(&first, &last));
+
+		int z = 0;
+		double prev = -HUGE_VAL;
+		for (ax_iter it = first; !ax_iter_equal(&it, &last); ax_iter_next(&it)) {
+			double val = s ? *(double *)ax_iter_get(&it) : *(float *)ax_iter_get(&it);
+			axut_assert(r, prev <= val);
+			prev = val;
+			if (val == 0)
+				axut_assert_int_equal(r, signs[z++], !!signbit(val));
+		}
+		axut_assert_int_equal(r, nzero, z);
+	}
+
+	free(signs);
+	ax_base_destroy(base);
+}
+
+static void bench_stable_sort(axut_runner *r)
+{
+	const int n = 0x100000;
+	ax_base *base = ax_base_create();
+	ax_stuff_trait key_tr = *ax_stuff_traits(AX_ST_I64);
+	key_tr.less = less_i64_key;
+	ax_vector_r vec_r = ax_vector_create(ax_base_local(base), &key_tr);
+	ax_seq_trunc(vec_r.seq, n);
+	int64_t *arr = malloc(n * sizeof *arr);
+	srand(32);
+
+	const char *name[] = { "random", "sorted", "16 runs", "sorted + 1%" };
+	for (int k = 0; k < 4; k++) {
+		for (int i = 0; i < n; i++) {
+			int64_t key = k == 0 ? rand() : k == 2 ? run_key(0, 16, i, n) : i;
+			arr[i] = key << 32 | i;
+		}
+		for (int i = 0; k == 3 && i < n / 100; i++)
+			arr[rand() % n] = (int64_t)rand() << 32;
+
+		memcpy(ax_vector_buffer(vec_r.vector), arr, n * sizeof *arr);
+		ax_iter first = ax_box_begin(vec_r.box), last = ax_box_end(vec_r.box);
+		double time_before = wall_time();
+		ax_merge_sort(&first, &last);
+		//printf("ax_merge_sort %s: %lfs\n", name[k], wall_time() - time_before);
+
+		memcpy(ax_vector_buffer(vec_r.vector), arr, n * sizeof *arr);
+		time_before = wall_time();
+		ax_sort(&first, &last);
+		//printf("ax_sort %s: %lfs\n", name[k], wall_time() - time_before);
+		(void)time_before, (void)name;
+	}
+
+	free(arr);
+	ax_base_destroy(base);
+}
+
+static void lt_i32(void *out, const void *in1, const void *in2, void *arg)
+{
+	*(ax_bool *)out = *(const int32_t *)in1 < *(const int32_t *)in2;
+}
+
+static void add_i32(void *out, const void *in1, const void *in2, void *arg)
+{
+	*(int32_t *)out = *(const int32_t *)in1 + *(const int32_t *)in2;
+}
+
+static void bench_batch(axut_runner *r)
+{
+	const int n = 0x400000;
+	ax_base *base = ax_base_create();
+	ax_vector_r src = ax_vector_create(ax_base_local(base), ax_stuff_traits(AX_ST_I32));
+	ax_vector_r dst = ax_vector_create(ax_base_local(base), ax_stuff_traits(AX_ST_I32));
+	ax_seq_trunc(src.seq, n);
+	ax_seq_trunc(dst.seq, n);
+	int32_t *arr = ax_vector_buffer(src.vector);
+	srand(48);
+	for (int i = 0; i < n; i++)
+		arr[i] = rand() % 1000;
+	ax_iter first = ax_box_begin(src.box), last = ax_box_end(src.box), out = ax_box_begin(dst.box);
+
+	int32_t pivot = 500, one = 1;
+	ax_pred preds[][2] = {
+		{
+			ax_pred_binary_make(lt_i32, NULL, &pivot, NULL),
+			ax_pred_binary_make(add_i32, NULL, &one, NULL),
+		},
+		{
+			ax_pred_binary_make(ax_oper_for(AX_ST_I32)->lt, NULL, &pivot, NULL),
+			ax_pred_binary_make(ax_oper_for(AX_ST_I32)->add, NULL, &one, NULL),
+		},
+	};
+	const char *names[] = { "scalar", "batch" };
+
+	size_t count[2];
+	for (int k = 0; k < 2; k++) {
+		double time_before = wall_time();
+		count[k] = ax_count_if(ax_iter_c(&first), ax_iter_c(&last), &preds[k][0]);
+		//printf("ax_count_if %s: %lfs\n", names[k], wall_time() - time_before);
+
+		time_before = wall_time();
+		ax_transform(ax_iter_c(&first), ax_iter_c(&last), &out, &preds[k][1]);
+		//printf("ax_transform %s: %lfs\n", names[k], wall_time() - time_before);
+		(void)time_before;
+		(void)names;
+	}
+	axut_assert_uint_equal(r, count[0], count[1]);
+	for (int i = 0; i < n; i++)
+		axut_assert(r, ((int32_t *)ax_vector_buffer(dst.vector))[i] == arr[i] + 1);
+
+	ax_base_destroy(base);
+}
+
+static void half_i32(void *out, const void *in, void *arg)
+{
+	*(double *)out = *(const int32_t *)in * 0.5;
+}
+
+static void par_algo(axut_runner *r)
+{
+	const int n = 100003;
+	ax_base *base = ax_base_create();
+	ax_exec *exec = ax_exec_create(3);
+	ax_seq *seqs[] = {
+		ax_vector_create(ax_base_local(base), ax_stuff_traits(AX_ST_I32)).seq,
+		ax_deque_create(ax_base_local(base), ax_stuff_traits(AX_ST_I32)).seq,
+		ax_list_create(ax_base_local(base), ax_stuff_traits(AX_ST_I32)).seq,
+	};
+	ax_seq *outs[] = {
+		ax_vector_create(ax_base_local(base), ax_stuff_traits(AX_ST_I32)).seq,
+		ax_deque_create(ax_base_local(base), ax_stuff_traits(AX_ST_I32)).seq,
+		ax_list_create(ax_base_local(base), ax_stuff_traits(AX_ST_I32)).seq,
+	};
+
+	int32_t pivot = 500, one = 1, absent = -1, seven = 7;
+	ax_pred lt = ax_pred_binary_make(ax_oper_for(AX_ST_I32)->lt, NULL, &pivot, NULL);
+	ax_pred inc = ax_pred_binary_make(ax_oper_for(AX_ST_I32)->add, NULL, &one, NULL);
+	ax_pred add = ax_pred_binary_make(ax_oper_for(AX_ST_I32)->add, NULL, NULL, NULL);
+	ax_pred addf = ax_pred_binary_make(ax_oper_for(AX_ST_LF)->add, NULL, NULL, NULL);
+	ax_pred half = ax_pred_unary_make(half_i32, NULL, NULL);
+	ax_pred never = ax_pred_binary_make(ax_oper_for(AX_ST_I32)->eq, NULL, &absent, NULL);
+	ax_pred is_seven = ax_pred_binary_make(ax_oper_for(AX_ST_I32)->eq, NULL, &seven, NULL);
+
+	srand(46);
+	for (int s = 0; s < 3; s++) {
+		for (int i = 0; i < n; i++) {
+			int32_t val = rand() % 1000;
+			ax_seq_push(seqs[s], &val);
+			ax_seq_push(outs[s], &absent);
+		}
+		ax_iter begin = ax_box_begin(ax_r(seq, seqs[s]).box), end = ax_box_end(ax_r(seq, seqs[s]).box);
+		const ax_citer first = *ax_iter_c(&begin), last = *ax_iter_c(&end);
+
+		axut_assert_uint_equal(r, ax_count_if(&first, &last, &lt), ax_par_count_if(&first, &last, &lt, exec));
+		axut_assert(r, ax_par_any_of(&first, &last, &lt, exec));
+		axut_assert(r, !ax_par_all_of(&first, &last, &lt, exec));
+		axut_assert(r, ax_par_none_of(&first, &last, &never, exec));
+		axut_assert(r, !ax_par_any_of(&first, &last, &never, exec));
+
+		/* The leftmost of many matches, then a single one near the end */
+		ax_citer found = first, expect = first;
+		ax_par_find_if(&found, &last, &is_seven, exec);
+		ax_find_if(&expect, &last, &is_seven);
+		axut_assert(r, ax_citer_equal(&found, &expect));
+		ax_iter near_end = ax_box_end(ax_r(seq, seqs[s]).box);
+		for (int i = 0; i < 3; i++)
+			ax_iter_prev(&near_end);
+		ax_iter_set(&near_end, &absent);
+		found = first;
+		ax_par_find_if(&found, &last, &never, exec);
+		axut_assert(r, ax_citer_equal(&found, ax_iter_c(&near_end)));
+		axut_assert(r, ax_par_any_of(&first, &last, &never, exec));
+		ax_iter_set(&near_end, &(int32_t) { 0 });
+
+		int32_t acc = 0, par_acc = 0;
+		ax_reduce(&first, &last, &acc, &add);
+		ax_par_reduce(&first, &last, &par_acc, &add, exec);
+		axut_assert_int_equal(r, acc, par_acc);
+
+		double lf = 0, par_lf = 0;
+		ax_transform_reduce(&first, &last, &lf, sizeof lf, &half, &addf);
+		ax_par_transform_reduce(&first, &last, &par_lf, sizeof par_lf, &half, &addf, exec);
+		axut_assert(r, lf == par_lf && lf == acc * 0.5);
+
+		ax_iter out = ax_box_begin(ax_r(seq, outs[s]).box);
+		ax_par_transform(&first, &last, &out, &inc, exec);
+		ax_citer it = first;
+		for (ax_iter o = out; !ax_citer_equal(&it, &last); ax_citer_next(&it), ax_iter_next(&o))
+			axut_assert_int_equal(r, *(int32_t *)ax_citer_get(&it) + 1, *(int32_t *)ax_iter_get(&o));
+
+		ax_iter out_end = ax_box_end(ax_r(seq, outs[s]).box);
+		ax_par_generate(&out, &out_end, &seven, exec);
+		axut_assert_uint_equal(r, n, ax_par_count_if(ax_iter_c(&out), ax_iter_c(&out_end), &is_seven, exec));
+	}
+
+	ax_exec_destroy(exec);
+	ax_base_destroy(base);
+}
+
+static void bench_par_algo(axut_runner *r)
+{
+	const int n = 0x400000;
+	ax_base *base = ax_base_create();
+	ax_vector_r vec_r = ax_vector_create(ax_base_local(base), ax_stuff_traits(AX_ST_F));
+	ax_seq_trunc(vec_r.seq, n);
+	float *arr = ax_vector_buffer(vec_r.vector);
+	srand(47);
+	for (int i = 0; i < n; i++)
+		arr[i] = (float)(rand() % 1000) / 1000;
+	ax_iter begin = ax_box_begin(vec_r.box), end = ax_box_end(vec_r.box);
+	const ax_citer first = *ax_iter_c(&begin), last = *ax_iter_c(&end);
+
+	float bound = 2, scale = 1.5f;
+	ax_pred add = ax_pred_binary_make(ax_oper_for(AX_ST_F)->add, NULL, NULL, NULL);
+	ax_pred above = ax_pred_binary_make(ax_oper_for(AX_ST_F)->gt, NULL, &bound, NULL);
+	ax_pred mul = ax_pred_binary_make(ax_oper_for(AX_ST_F)->mul, NULL, &scale, NULL);
+
+	float sum = 0;
+	double time_before = wall_time();
+	ax_reduce(&first, &last, &sum, &add);
+	//printf("ax_reduce: %lfs\n", wall_time() - time_before);
+
+	for (unsigned nworkers = 1; nworkers <= 8; nworkers *= 2) {
+		ax_exec *exec = ax_exec_create(nworkers);
+		float par_sum = 0;
+		time_before = wall_time();
+		ax_par_reduce(&first, &last, &par_sum, &add, exec);
+		//printf("ax_par_reduce %u workers: %lfs\n", nworkers, wall_time() - time_before);
+		axut_assert(r, par_sum > sum * 0.99 && par_sum < sum * 1.01);
+
+		time_before = wall_time();
+		ax_par_transform_reduce(&first, &last, &par_sum, sizeof par_sum, &mul, &add, exec);
+		//printf("ax_par_transform_reduce %u workers: %lfs\n", nworkers, wall_time() - time_before);
+
+		/* The only match is in the first chunk, the other chunks give up early */
+		arr[n / 100] = 3;
+		time_before = wall_time();
+		axut_assert(r, ax_par_any_of(&first, &last, &above, exec));
+		//printf("ax_par_any_of %u workers, early match: %lfs\n", nworkers, wall_time() - time_before);
+		arr[n / 100] = 0;
+		time_before = wall_time();
+		axut_assert(r, !ax_par_any_of(&first, &last, &above, exec));
+		//printf("ax_par_any_of %u workers, no match: %lfs\n", nworkers, wall_time() - time_before);
+		(void)time_before;
+
+		ax_exec_destroy(exec);
+	}
+
+	ax_base_destroy(base);
+}
+
 axut_suite *suite_for_algo(ax_base *base)
 {
 	axut_suite* suite = axut_suite_create(ax_base_local(base), "algo");
@@ -321,8 +1588,27 @@ axut_suite *suite_for_algo(ax_base *base)
 	axut_suite_add(suite, merge_sort, 0);
 	axut_suite_add(suite, sort_time, 0);
 	axut_suite_add(suite, binary_search, 0);
+	axut_suite_add(suite, lower_bound, 0);
 	axut_suite_add(suite, binary_search_if_not, 0);
 	axut_suite_add(suite, insertion_sort, 0);
+	axut_suite_add(suite, sort, 0);
+	axut_suite_add(suite, list_string, 0);
+	axut_suite_add(suite, bench_sort, 0);
+	axut_suite_add(suite, contiguous, 0);
+	axut_suite_add(suite, batch_mixed_size, 0);
+	axut_suite_add(suite, bench_contiguous, 0);
+	axut_suite_add(suite, par_sort, 0);
+	axut_suite_add(suite, bench_par_sort, 0);
+	axut_suite_add(suite, radix_sort, 0);
+	axut_suite_add(suite, bench_radix_sort, 0);
+	axut_suite_add(suite, selection, 0);
+	axut_suite_add(suite, bench_selection, 0);
+	axut_suite_add(suite, stable_sort, 0);
+	axut_suite_add(suite, stable_zero, 0);
+	axut_suite_add(suite, bench_stable_sort, 0);
+	axut_suite_add(suite, bench_batch, 0);
+	axut_suite_add(suite, par_algo, 0);
+	axut_suite_add(suite, bench_par_algo, 0);
 
 	return suite;
 }
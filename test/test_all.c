@@ -17,6 +17,16 @@ extern axut_suite *suite_for_btrie(ax_base *base);
 extern axut_suite *suite_for_seq(ax_base *base);
 extern axut_suite *suite_for_stack(ax_base *base);
 extern axut_suite *suite_for_queue(ax_base *base);
+extern axut_suite *suite_for_pavl(ax_base *base);
+extern axut_suite *suite_for_art(ax_base *base);
+extern axut_suite *suite_for_datrie(ax_base *base);
+extern axut_suite *suite_for_deque(ax_base *base);
+extern axut_suite *suite_for_spsc(ax_base *base);
+extern axut_suite *suite_for_mpmc(ax_base *base);
+extern axut_suite *suite_for_pqueue(ax_base *base);
+extern axut_suite *suite_for_ulist(ax_base *base);
+extern axut_suite *suite_for_exec(ax_base *base);
+extern axut_suite *suite_for_eytzinger(ax_base *base);
 
 
 int main()
@@ -38,6 +48,16 @@ int main()
 	axut_runner_add(r, suite_for_btrie(base));
 	axut_runner_add(r, suite_for_stack(base));
 	axut_runner_add(r, suite_for_queue(base));
+	axut_runner_add(r, suite_for_pavl(base));
+	axut_runner_add(r, suite_for_art(base));
+	axut_runner_add(r, suite_for_datrie(base));
+	axut_runner_add(r, suite_for_deque(base));
+	axut_runner_add(r, suite_for_spsc(base));
+	axut_runner_add(r, suite_for_mpmc(base));
+	axut_runner_add(r, suite_for_pqueue(base));
+	axut_runner_add(r, suite_for_ulist(base));
+	axut_runner_add(r, suite_for_exec(base));
+	axut_runner_add(r, suite_for_eytzinger(base));
 
 	axut_runner_run(r);
 
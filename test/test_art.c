@@ -0,0 +1,653 @@
+#include "axe/art.h"
+#include "axe/btrie.h"
+#include "axe/list.h"
+#include "axe/vector.h"
+#include "axe/string.h"
+
+#include "axut.h"
+
+#include <stdarg.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+struct check_table_st
+{
+	int index;
+	struct {
+		char *key;
+		int value;
+	} table[32];
+};
+
+struct enum_context_st {
+	axut_runner *runner;
+	struct check_table_st *check_table;
+};
+
+static void seq_to_path(const ax_seq *seq, char * path)
+{
+	strcpy(path, "/");
+	ax_box_cforeach(ax_cr(seq, seq).box, const int *, val) {
+			char num[32];
+			sprintf(num, "%d/", *val);
+			strcat(path, num);
+	}
+}
+
+static ax_bool iterator_enum_cb(ax_trie *trie, const ax_seq *key, const void *val, void *ctx)
+{
+	struct enum_context_st *ectx = ctx;
+	char path[1024];
+	seq_to_path(key, path);
+	char *ex_key = ectx->check_table->table[ectx->check_table->index].key;
+	int ex_value = ectx->check_table->table[ectx->check_table->index].value;
+	axut_assert_str_equal(ectx->runner, ex_key, path);
+	axut_assert_int_equal(ectx->runner, ex_value, *(int *)val);
+	ectx->check_table->index ++;
+	return ax_false;
+}
+
+static void put_i32(ax_trie *trie, ax_seq *key, int value, const char *fmt, ...)
+{
+	int32_t word;
+	va_list ap;
+	va_start(ap, fmt);
+	ax_box_clear(ax_r(seq, key).box);
+	for (const char *p = fmt; *p; p++) {
+		word = va_arg(ap, int);
+		ax_seq_push(key, &word);
+	}
+	va_end(ap);
+	ax_trie_put(trie, key, &value);
+}
+
+static ax_art_r make_test_art(ax_base *base)
+{
+	ax_art_r art = ax_art_create(ax_base_local(base),
+			ax_stuff_traits(AX_ST_I32),
+			ax_stuff_traits(AX_ST_I32));
+
+	ax_list_r key = ax_list_create(ax_base_local(base),
+			ax_stuff_traits(AX_ST_I32));
+
+	put_i32(art.trie, key.seq, 111, "...", 1, 1, 1);
+	put_i32(art.trie, key.seq, 121, "...", 1, 2, 1);
+	put_i32(art.trie, key.seq, 1,   ".",   1);
+	put_i32(art.trie, key.seq, 112, "...", 1, 1, 2);
+	put_i32(art.trie, key.seq, 0,   "");
+	put_i32(art.trie, key.seq, 211, "...", 2, 1, 1);
+	put_i32(art.trie, key.seq, 11,  "..",  1, 1);
+
+	return art;
+}
+
+static void create(axut_runner *r)
+{
+	ax_base *base = axut_runner_arg(r);
+	ax_art_r art = ax_art_create(ax_base_local(base),
+			ax_stuff_traits(AX_ST_I32), ax_stuff_traits(AX_ST_I32));
+	axut_assert_uint_equal(r, ax_box_size(art.box), 0);
+	ax_iter begin = ax_box_begin(art.box), end = ax_box_end(art.box);
+	axut_assert(r, ax_iter_equal(&begin, &end));
+}
+
+static void trie_put(axut_runner *r)
+{
+	ax_base *base = axut_runner_arg(r);
+	int d = ax_base_enter(base);
+
+	ax_art_r art = make_test_art(base);
+	axut_assert_uint_equal(r, ax_box_size(art.box), 7);
+
+	ax_list_r key = ax_list_create(ax_base_local(base), ax_trie_key_tr(art.trie));
+	put_i32(art.trie, key.seq, -1, "..", 1, 1);
+	axut_assert_uint_equal(r, ax_box_size(art.box), 7);
+	axut_assert_int_equal(r, -1, *(int32_t*)ax_trie_get(art.trie, key.seq));
+
+	ax_base_leave(base, d);
+}
+
+static void trie_get(axut_runner *r)
+{
+	ax_base *base = axut_runner_arg(r);
+	int d = ax_base_enter(base);
+
+	ax_art_r art = make_test_art(base);
+	ax_list_r key = ax_list_create(ax_base_local(base), ax_trie_key_tr(art.trie));
+
+	ax_seq_pushl(key.seq, "i32x3", 1, 1, 1);
+	axut_assert_int_equal(r, 111, *(int32_t*)ax_trie_get(art.trie, key.seq));
+
+	ax_box_clear(key.box);
+	ax_seq_pushl(key.seq, "i32x3", 1, 2, 1);
+	axut_assert_int_equal(r, 121, *(int32_t*)ax_trie_get(art.trie, key.seq));
+
+	ax_box_clear(key.box);
+	ax_seq_pushl(key.seq, "i32x1", 1);
+	axut_assert_int_equal(r, 1, *(int32_t*)ax_trie_get(art.trie, key.seq));
+
+	ax_box_clear(key.box);
+	axut_assert_int_equal(r, 0, *(int32_t*)ax_trie_get(art.trie, key.seq));
+
+	ax_box_clear(key.box);
+	ax_seq_pushl(key.seq, "i32x2", 1, 2);
+	axut_assert(r, ax_trie_get(art.trie, key.seq) == NULL);
+
+	ax_box_clear(key.box);
+	ax_seq_pushl(key.seq, "i32x4", 1, 1, 1, 1);
+	axut_assert(r, ax_trie_get(art.trie, key.seq) == NULL);
+
+	ax_base_leave(base, d);
+}
+
+static void trie_at(axut_runner *r)
+{
+	ax_base *base = axut_runner_arg(r);
+	int d = ax_base_enter(base);
+
+	ax_art_r art = make_test_art(base);
+	ax_list_r key = ax_list_create(ax_base_local(base), ax_trie_key_tr(art.trie));
+	ax_iter it, end = ax_box_end(art.box);
+
+	ax_seq_pushl(key.seq, "i32x3", 1, 1, 2);
+	it = ax_trie_at(art.trie, key.seq);
+	axut_assert_int_equal(r, 112, *(int32_t*)ax_iter_get(&it));
+
+	ax_box_clear(key.box);
+	ax_seq_pushl(key.seq, "i32x2", 1, 2);
+	it = ax_trie_at(art.trie, key.seq);
+	axut_assert(r, !ax_iter_equal(&it, &end));
+	axut_assert(r, !ax_trie_iter_valued(&it));
+
+	ax_box_clear(key.box);
+	ax_seq_pushl(key.seq, "i32x4", 1, 1, 1, 1);
+	it = ax_trie_at(art.trie, key.seq);
+	axut_assert(r, ax_iter_equal(&it, &end));
+
+	ax_base_leave(base, d);
+}
+
+static void trie_exist(axut_runner *r)
+{
+	ax_base *base = axut_runner_arg(r);
+	int d = ax_base_enter(base);
+
+	ax_art_r art = make_test_art(base);
+	ax_list_r key = ax_list_create(ax_base_local(base), ax_trie_key_tr(art.trie));
+
+	axut_assert(r, ax_trie_exist(art.trie, key.seq));
+
+	ax_seq_pushl(key.seq, "i32x2", 1, 1);
+	axut_assert(r, ax_trie_exist(art.trie, key.seq));
+
+	ax_box_clear(key.box);
+	ax_seq_pushl(key.seq, "i32x3", 2, 1, 1);
+	axut_assert(r, ax_trie_exist(art.trie, key.seq));
+
+	ax_box_clear(key.box);
+	ax_seq_pushl(key.seq, "i32x2", 2, 1);
+	axut_assert(r, !ax_trie_exist(art.trie, key.seq));
+
+	ax_box_clear(key.box);
+	ax_seq_pushl(key.seq, "i32x3", 1, 2, 2);
+	axut_assert(r, !ax_trie_exist(art.trie, key.seq));
+
+	ax_base_leave(base, d);
+}
+
+static void trie_erase(axut_runner *r)
+{
+	ax_base *base = axut_runner_arg(r);
+	int d = ax_base_enter(base);
+
+	ax_art_r art = make_test_art(base);
+	ax_list_r key = ax_list_create(ax_base_local(base), ax_trie_key_tr(art.trie));
+
+	ax_seq_pushl(key.seq, "i32x2", 1, 1);
+	axut_assert(r, ax_trie_erase(art.trie, key.seq));
+	axut_assert(r, !ax_trie_exist(art.trie, key.seq));
+	axut_assert_uint_equal(r, 6, ax_box_size(art.box));
+
+	ax_box_clear(key.box);
+	ax_seq_pushl(key.seq, "i32x3", 1, 1, 1);
+	axut_assert(r, ax_trie_exist(art.trie, key.seq));
+
+	ax_box_clear(key.box);
+	ax_seq_pushl(key.seq, "i32x3", 2, 1, 1);
+	axut_assert(r, ax_trie_erase(art.trie, key.seq));
+	axut_assert_uint_equal(r, 5, ax_box_size(art.box));
+
+	ax_box_clear(key.box);
+	ax_seq_pushl(key.seq, "i32x1", 2);
+	axut_assert(r, !ax_trie_erase(art.trie, key.seq));
+
+	ax_box_clear(key.box);
+	axut_assert(r, ax_trie_erase(art.trie, key.seq));
+	axut_assert(r, !ax_trie_exist(art.trie, key.seq));
+	axut_assert_uint_equal(r, 4, ax_box_size(art.box));
+
+	ax_base_leave(base, d);
+}
+
+static void trie_prune(axut_runner *r)
+{
+	ax_base *base = axut_runner_arg(r);
+	int d = ax_base_enter(base);
+
+	ax_art_r art;
+	ax_list_r key = ax_list_create(ax_base_local(base), ax_stuff_traits(AX_ST_I32));
+
+	art = make_test_art(base);
+	ax_seq_pushl(key.seq, "i32x3", 1, 1, 1);
+	ax_trie_prune(art.trie, key.seq);
+	axut_assert(r, !ax_trie_exist(art.trie, key.seq));
+	axut_assert_uint_equal(r, 6, ax_box_size(art.box));
+
+	art = make_test_art(base);
+	ax_box_clear(key.box);
+	ax_seq_pushl(key.seq, "i32x2", 1, 1);
+	ax_trie_prune(art.trie, key.seq);
+	axut_assert_uint_equal(r, 4, ax_box_size(art.box));
+
+	art = make_test_art(base);
+	ax_box_clear(key.box);
+	ax_seq_pushl(key.seq, "i32x1", 1);
+	ax_trie_prune(art.trie, key.seq);
+	axut_assert_uint_equal(r, 2, ax_box_size(art.box));
+	ax_box_clear(key.box);
+	ax_seq_pushl(key.seq, "i32x3", 2, 1, 1);
+	axut_assert(r, ax_trie_exist(art.trie, key.seq));
+
+	art = make_test_art(base);
+	ax_box_clear(key.box);
+	ax_trie_prune(art.trie, key.seq);
+	axut_assert_uint_equal(r, 0, ax_box_size(art.box));
+	axut_assert(r, !ax_trie_exist(art.trie, key.seq));
+
+	ax_base_leave(base, d);
+}
+
+struct scan_context_st {
+	axut_runner *runner;
+	struct check_table_st *check_table;
+};
+
+static ax_bool scan_cb(const ax_trie *trie, const void *key, size_t len, const void *val, void *ctx)
+{
+	struct scan_context_st *sctx = ctx;
+	char path[1024] = "/";
+	for (size_t i = 0; i < len; i++)
+		sprintf(path + strlen(path), "%d/", ((const int32_t *)key)[i]);
+	struct check_table_st *table = sctx->check_table;
+	axut_assert_str_equal(sctx->runner, table->table[table->index].key, path);
+	axut_assert_int_equal(sctx->runner, table->table[table->index].value, *(int *)val);
+	table->index ++;
+	return table->table[table->index].key == NULL;
+}
+
+static void scan_prefix(axut_runner *r)
+{
+	ax_base *base = axut_runner_arg(r);
+	int d = ax_base_enter(base);
+
+	ax_art_r art = make_test_art(base);
+
+	struct check_table_st data = {
+		.index = 0,
+		.table = {
+			{ "/1/", 1 },
+			{ "/1/1/", 11 },
+			{ "/1/1/1/", 111 },
+			{ "/1/1/2/", 112 },
+			{ "/1/2/1/", 121 },
+		}
+	};
+	struct scan_context_st scanctx = { .runner = r, .check_table = &data };
+	axut_assert(r, !ax_trie_scan_prefix(art.trie, (int32_t[]) { 1 }, 1, scan_cb, &scanctx));
+	axut_assert_int_equal(r, 5, data.index);
+
+	struct check_table_st all = {
+		.index = 0,
+		.table = {
+			{ "/", 0 },
+			{ "/1/", 1 },
+			{ "/1/1/", 11 },
+		}
+	};
+	scanctx.check_table = &all;
+	axut_assert(r, !ax_trie_scan_prefix(art.trie, NULL, 0, scan_cb, &scanctx));
+	axut_assert_int_equal(r, 3, all.index);
+
+	scanctx.check_table = NULL;
+	axut_assert(r, !ax_trie_scan_prefix(art.trie, (int32_t[]) { 3 }, 1, scan_cb, &scanctx));
+
+	int32_t deep[AX_TRIE_SCAN_MAX + 1] = { 0 };
+	int value = 0;
+	ax_trie_put_raw(art.trie, deep, AX_TRIE_SCAN_MAX + 1, &value);
+	axut_assert(r, ax_trie_scan_prefix(art.trie, deep, 2, scan_cb, &scanctx));
+
+	ax_base_leave(base, d);
+}
+
+static void longest_prefix(axut_runner *r)
+{
+	ax_base *base = axut_runner_arg(r);
+	int d = ax_base_enter(base);
+
+	ax_art_r art = make_test_art(base);
+	ax_iter it, end = ax_box_end(art.box);
+	size_t len;
+
+	it = ax_trie_longest_prefix(art.trie, (int32_t[]) { 1, 1, 3 }, 3, &len);
+	axut_assert_int_equal(r, 11, *(int32_t*)ax_iter_get(&it));
+	axut_assert_uint_equal(r, 2, len);
+
+	it = ax_trie_longest_prefix(art.trie, (int32_t[]) { 1, 2, 1, 5 }, 4, &len);
+	axut_assert_int_equal(r, 121, *(int32_t*)ax_iter_get(&it));
+	axut_assert_uint_equal(r, 3, len);
+
+	it = ax_trie_longest_prefix(art.trie, (int32_t[]) { 1, 2 }, 2, &len);
+	axut_assert_int_equal(r, 1, *(int32_t*)ax_iter_get(&it));
+	axut_assert_uint_equal(r, 1, len);
+
+	it = ax_trie_longest_prefix(art.trie, (int32_t[]) { 3 }, 1, &len);
+	axut_assert_int_equal(r, 0, *(int32_t*)ax_iter_get(&it));
+	axut_assert_uint_equal(r, 0, len);
+
+	ax_trie_erase_raw(art.trie, NULL, 0);
+	it = ax_trie_longest_prefix(art.trie, (int32_t[]) { 3 }, 1, &len);
+	axut_assert(r, ax_iter_equal(&it, &end));
+	axut_assert_uint_equal(r, 0, len);
+
+	ax_base_leave(base, d);
+}
+
+static void trie_rekey(axut_runner *r)
+{
+	ax_base *base = axut_runner_arg(r);
+	int d = ax_base_enter(base);
+
+	ax_art_r art = make_test_art(base);
+	ax_list_r from = ax_list_create(ax_base_local(base), ax_trie_key_tr(art.trie));
+	ax_list_r to = ax_list_create(ax_base_local(base), ax_trie_key_tr(art.trie));
+
+	ax_seq_pushl(from.seq, "i32x3", 1, 1, 1);
+	ax_seq_pushl(to.seq, "i32x2", 3, 3);
+	axut_assert(r, !ax_trie_rekey(art.trie, from.seq, to.seq));
+	axut_assert(r, !ax_trie_exist(art.trie, from.seq));
+	axut_assert_int_equal(r, 111, *(int32_t*)ax_trie_get(art.trie, to.seq));
+	axut_assert_uint_equal(r, 7, ax_box_size(art.box));
+
+	axut_assert(r, ax_trie_rekey(art.trie, from.seq, to.seq));
+
+	ax_base_leave(base, d);
+}
+
+static void trie_raw(axut_runner *r)
+{
+	ax_base *base = axut_runner_arg(r);
+	int d = ax_base_enter(base);
+
+	ax_art_r art = make_test_art(base);
+	int32_t key[] = { 1, 1, 2 };
+	int value = 1211;
+	ax_iter it, end = ax_box_end(art.box);
+
+	axut_assert_int_equal(r, 112, *(int32_t*)ax_trie_get_raw(art.trie, key, 3));
+	axut_assert_int_equal(r, 11, *(int32_t*)ax_trie_get_raw(art.trie, key, 2));
+	axut_assert_int_equal(r, 0, *(int32_t*)ax_trie_get_raw(art.trie, NULL, 0));
+
+	it = ax_trie_at_raw(art.trie, (int32_t[]) { 1, 2 }, 2);
+	axut_assert(r, !ax_iter_equal(&it, &end));
+	axut_assert(r, !ax_trie_exist_raw(art.trie, (int32_t[]) { 1, 2 }, 2));
+
+	axut_assert(r, !ax_trie_put_raw(art.trie, (int32_t[]) { 1, 2, 1, 1 }, 4, &value));
+	axut_assert_uint_equal(r, 8, ax_box_size(art.box));
+	axut_assert_int_equal(r, 1211, *(int32_t*)ax_trie_get_raw(art.trie, (int32_t[]) { 1, 2, 1, 1 }, 4));
+
+	axut_assert(r, ax_trie_erase_raw(art.trie, key, 3));
+	axut_assert(r, !ax_trie_exist_raw(art.trie, key, 3));
+	axut_assert_uint_equal(r, 7, ax_box_size(art.box));
+
+	ax_string_r skey = ax_string_create(ax_base_local(base));
+	ax_art_r sart = ax_art_create(ax_base_local(base),
+			ax_box_elem_tr(skey.box), ax_stuff_traits(AX_ST_I32));
+	ax_trie_put_raw(sart.trie, "/api/v1/users", 13, &value);
+	ax_str_append(skey.str, "/api/v1/users");
+	axut_assert_int_equal(r, 1211, *(int32_t*)ax_trie_get(sart.trie, skey.seq));
+	axut_assert(r, ax_trie_exist_raw(sart.trie, "/api/v1/users", 13));
+	axut_assert(r, !ax_trie_exist_raw(sart.trie, "/api/v1/user", 12));
+
+	ax_base_leave(base, d);
+}
+
+static void iterater(axut_runner *r)
+{
+	ax_base *base = axut_runner_arg(r);
+	int d = ax_base_enter(base);
+
+	ax_art_r art = make_test_art(base);
+
+	struct check_table_st data = {
+		.index = 0,
+		.table = {
+			{ "/1/1/1/", 111 },
+			{ "/1/1/2/", 112 },
+			{ "/1/1/", 11 },
+			{ "/1/2/1/", 121 },
+			{ "/1/", 1 },
+			{ "/2/1/1/", 211 },
+			{ "/", 0 },
+			{ "", 0 },
+		}
+	};
+
+	struct enum_context_st enumctx = {
+		.check_table = &data,
+		.runner = r,
+	};
+	ax_trie_enum(art.trie, iterator_enum_cb, &enumctx);
+	axut_assert_int_equal(r, 7, data.index);
+
+	ax_base_leave(base, d);
+}
+
+static void iter_walk(axut_runner *r)
+{
+	ax_base *base = axut_runner_arg(r);
+	int d = ax_base_enter(base);
+
+	ax_art_r art = ax_art_create(ax_base_local(base),
+			ax_stuff_traits(AX_ST_I32), ax_stuff_traits(AX_ST_I32));
+	ax_list_r key = ax_list_create(ax_base_local(base), ax_trie_key_tr(art.trie));
+	ax_iter it, child, end, parent;
+
+	put_i32(art.trie, key.seq, 5678, "....", 5, 6, 7, 8);
+	put_i32(art.trie, key.seq, 59, "..", 5, 9);
+
+	ax_box_clear(key.box);
+	ax_seq_pushl(key.seq, "i32x1", 5);
+	it = ax_trie_at(art.trie, key.seq);
+	axut_assert(r, !ax_trie_iter_valued(&it));
+	axut_assert_int_equal(r, 5, *(int32_t*)ax_trie_iter_word(&it));
+
+	child = ax_trie_iter_begin(&it);
+	end = ax_trie_iter_end(&it);
+	axut_assert_int_equal(r, 6, *(int32_t*)ax_trie_iter_word(&child));
+	ax_iter_next(&child);
+	axut_assert_int_equal(r, 9, *(int32_t*)ax_trie_iter_word(&child));
+	axut_assert(r, ax_trie_iter_valued(&child));
+	axut_assert_int_equal(r, 59, *(int32_t*)ax_iter_get(&child));
+	ax_iter_next(&child);
+	axut_assert(r, ax_iter_equal(&child, &end));
+
+	ax_box_clear(key.box);
+	ax_seq_pushl(key.seq, "i32x3", 5, 6, 7);
+	it = ax_trie_at(art.trie, key.seq);
+	axut_assert_int_equal(r, 7, *(int32_t*)ax_trie_iter_word(&it));
+	axut_assert(r, art.trie->tr->it_parent(ax_iter_c(&it), &parent));
+	axut_assert_int_equal(r, 6, *(int32_t*)ax_trie_iter_word(&parent));
+
+	child = ax_trie_iter_begin(&it);
+	axut_assert_int_equal(r, 8, *(int32_t*)ax_trie_iter_word(&child));
+	axut_assert(r, !ax_iter_set(&child, &(int){ 8765 }));
+
+	ax_box_clear(key.box);
+	ax_seq_pushl(key.seq, "i32x4", 5, 6, 7, 8);
+	axut_assert_int_equal(r, 8765, *(int32_t*)ax_trie_get(art.trie, key.seq));
+
+	it = ax_trie_at(art.trie, key.seq);
+	ax_iter_erase(&it);
+	axut_assert_uint_equal(r, 1, ax_box_size(art.box));
+	axut_assert(r, !ax_trie_exist(art.trie, key.seq));
+
+	ax_base_leave(base, d);
+}
+
+static void make_word(char *buf, unsigned i)
+{
+	buf[0] = (char)(i % 255 + 1);
+	sprintf(buf + 1, "%x", i * 2654435761u);
+}
+
+static void char_key(axut_runner *r)
+{
+	ax_base *base = axut_runner_arg(r);
+	int d = ax_base_enter(base);
+
+	const unsigned count = 5000;
+	char word[32];
+
+	ax_string_r key = ax_string_create(ax_base_local(base));
+	ax_art_r art = ax_art_create(ax_base_local(base),
+			ax_box_elem_tr(key.box), ax_stuff_traits(AX_ST_U32));
+
+	for (unsigned i = 0; i < count; i++) {
+		make_word(word, i);
+		ax_box_clear(key.box);
+		ax_str_append(key.str, word);
+		axut_assert(r, !ax_trie_put(art.trie, key.seq, &i));
+	}
+	axut_assert_uint_equal(r, count, ax_box_size(art.box));
+
+	ax_art_r copy = { .any = ax_any_copy(art.any) };
+	axut_assert_uint_equal(r, count, ax_box_size(copy.box));
+
+	for (unsigned i = 0; i < count; i += 2) {
+		make_word(word, i);
+		ax_box_clear(key.box);
+		ax_str_append(key.str, word);
+		axut_assert(r, ax_trie_erase(art.trie, key.seq));
+	}
+	axut_assert_uint_equal(r, count / 2, ax_box_size(art.box));
+
+	for (unsigned i = 0; i < count; i++) {
+		make_word(word, i);
+		ax_box_clear(key.box);
+		ax_str_append(key.str, word);
+		const unsigned *val = ax_trie_get(art.trie, key.seq);
+		axut_assert(r, (i % 2) ? val && *val == i : val == NULL);
+		val = ax_trie_get(copy.trie, key.seq);
+		axut_assert(r, val && *val == i);
+	}
+
+	for (unsigned i = 1; i < count; i += 2) {
+		make_word(word, i);
+		ax_box_clear(key.box);
+		ax_str_append(key.str, word);
+		axut_assert(r, ax_trie_erase(art.trie, key.seq));
+	}
+	axut_assert_uint_equal(r, 0, ax_box_size(art.box));
+	ax_iter begin = ax_box_begin(art.box), end = ax_box_end(art.box);
+	axut_assert(r, ax_iter_equal(&begin, &end));
+
+	ax_base_leave(base, d);
+}
+
+static void make_url(char *buf, unsigned i)
+{
+	static const char *hosts[] = { "example.com", "example.org", "libaxe.dev", "mirror.example.net" };
+	sprintf(buf, "https://%s/%s/%u/item-%u.html", hosts[i % 4],
+			(i & 8) ? "archive" : "docs", (i * 7919u) % 997, i);
+}
+
+static double bench_trie(ax_trie *trie, ax_string *key, void (*make)(char *, unsigned), unsigned count)
+{
+	char word[128];
+	clock_t time_before = clock();
+	for (unsigned i = 0; i < count; i++) {
+		make(word, i);
+		ax_box_clear(ax_r(string, key).box);
+		ax_str_append(ax_r(string, key).str, word);
+		ax_trie_put(trie, ax_r(string, key).seq, &i);
+	}
+	for (unsigned i = 0; i < count; i++) {
+		make(word, i);
+		ax_box_clear(ax_r(string, key).box);
+		ax_str_append(ax_r(string, key).str, word);
+		ax_trie_get(trie, ax_r(string, key).seq);
+	}
+	return (double)(clock() - time_before) / CLOCKS_PER_SEC;
+}
+
+static void bench_time(axut_runner *r)
+{
+	ax_base *base = axut_runner_arg(r);
+	int d = ax_base_enter(base);
+
+	const unsigned count = 0x4000;
+	ax_string_r key = ax_string_create(ax_base_local(base));
+	const ax_stuff_trait *ktr = ax_box_elem_tr(key.box), *vtr = ax_stuff_traits(AX_ST_U32);
+
+	struct {
+		const char *name;
+		void (*make)(char *, unsigned);
+	} sets[] = { { "url", make_url }, { "word", make_word } };
+
+	for (int i = 0; i < sizeof sets / sizeof *sets; i++) {
+		ax_art_r art = ax_art_create(ax_base_local(base), ktr, vtr);
+		ax_btrie_r btrie = ax_btrie_create(ax_base_local(base), ktr, vtr);
+		double t_art = bench_trie(art.trie, key.string, sets[i].make, count);
+		double t_btrie = bench_trie(btrie.trie, key.string, sets[i].make, count);
+		//printf("%s keys: ax_art spent %lfs, ax_btrie spent %lfs\n", sets[i].name, t_art, t_btrie);
+		(void)t_art, (void)t_btrie;
+		axut_assert_uint_equal(r, ax_box_size(art.box), ax_box_size(btrie.box));
+	}
+
+	ax_base_leave(base, d);
+}
+
+static void clean(axut_runner *r)
+{
+	ax_base *base = axut_runner_arg(r);
+	ax_base_destroy(base);
+}
+
+axut_suite *suite_for_art(ax_base *base)
+{
+	axut_suite *suite = axut_suite_create(ax_base_local(base), "art");
+
+	ax_base *base1 = ax_base_create();
+	axut_suite_set_arg(suite, base1);
+
+	axut_suite_add(suite, create, 0);
+	axut_suite_add(suite, trie_put, 1);
+	axut_suite_add(suite, trie_get, 1);
+	axut_suite_add(suite, trie_exist, 2);
+	axut_suite_add(suite, trie_at, 2);
+	axut_suite_add(suite, trie_erase, 2);
+	axut_suite_add(suite, trie_prune, 2);
+	axut_suite_add(suite, scan_prefix, 2);
+	axut_suite_add(suite, longest_prefix, 2);
+	axut_suite_add(suite, trie_rekey, 2);
+	axut_suite_add(suite, trie_raw, 2);
+	axut_suite_add(suite, iterater, 2);
+	axut_suite_add(suite, iter_walk, 2);
+	axut_suite_add(suite, char_key, 3);
+	axut_suite_add(suite, bench_time, 4);
+
+	axut_suite_add(suite, clean, 0xFF);
+	return suite;
+}
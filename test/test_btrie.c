@@ -430,6 +430,139 @@ static void trie_prune(axut_runner *r)
 	ax_base_leave(base, d);
 }
 
+static void trie_raw(axut_runner *r)
+{
+	ax_base *base = axut_runner_arg(r);
+
+	int d = ax_base_enter(base);
+
+	ax_btrie_r btrie = make_test_btrie(base);
+	int32_t key[] = { 1, 1, 2 };
+	int value = 1211;
+	ax_iter it, end = ax_box_end(btrie.box);
+
+	axut_assert_int_equal(r, 112, *(int32_t*)ax_trie_get_raw(btrie.trie, key, 3));
+	axut_assert_int_equal(r, 11, *(int32_t*)ax_trie_get_raw(btrie.trie, key, 2));
+	axut_assert_int_equal(r, 0, *(int32_t*)ax_trie_get_raw(btrie.trie, NULL, 0));
+	axut_assert(r, ax_trie_exist_raw(btrie.trie, key, 1));
+
+	it = ax_trie_at_raw(btrie.trie, (int32_t[]) { 1, 2 }, 2);
+	axut_assert(r, !ax_iter_equal(&it, &end));
+	axut_assert(r, !ax_trie_exist_raw(btrie.trie, (int32_t[]) { 1, 2 }, 2));
+
+	axut_assert(r, !ax_trie_put_raw(btrie.trie, (int32_t[]) { 1, 2, 1, 1 }, 4, &value));
+	axut_assert_uint_equal(r, 8, ax_box_size(btrie.box));
+	axut_assert_int_equal(r, 1211, *(int32_t*)ax_trie_get_raw(btrie.trie, (int32_t[]) { 1, 2, 1, 1 }, 4));
+
+	axut_assert(r, ax_trie_erase_raw(btrie.trie, key, 3));
+	axut_assert(r, !ax_trie_exist_raw(btrie.trie, key, 3));
+	axut_assert_uint_equal(r, 7, ax_box_size(btrie.box));
+
+	ax_btrie_r strie = ax_btrie_create(ax_base_local(base),
+			ax_stuff_traits(AX_ST_S), ax_stuff_traits(AX_ST_I32));
+	const char *path[] = { "usr", "local", "lib" };
+	ax_trie_put_raw(strie.trie, path, 3, &value);
+	axut_assert_int_equal(r, 1211, *(int32_t*)ax_trie_get_raw(strie.trie, (const char *[]) { "usr", "local", "lib" }, 3));
+	axut_assert(r, !ax_trie_exist_raw(strie.trie, path, 2));
+
+	ax_base_leave(base, d);
+}
+
+struct scan_context_st {
+	axut_runner *runner;
+	struct check_table_st *check_table;
+};
+
+static ax_bool scan_cb(const ax_trie *trie, const void *key, size_t len, const void *val, void *ctx)
+{
+	struct scan_context_st *sctx = ctx;
+	char path[1024] = "/";
+	for (size_t i = 0; i < len; i++)
+		sprintf(path + strlen(path), "%d/", ((const int32_t *)key)[i]);
+	struct check_table_st *table = sctx->check_table;
+	axut_assert_str_equal(sctx->runner, table->table[table->index].key, path);
+	axut_assert_int_equal(sctx->runner, table->table[table->index].value, *(int *)val);
+	table->index ++;
+	return table->table[table->index].key == NULL;
+}
+
+static void scan_prefix(axut_runner *r)
+{
+	ax_base *base = axut_runner_arg(r);
+	int d = ax_base_enter(base);
+
+	ax_btrie_r btrie = make_test_btrie(base);
+
+	struct check_table_st data = {
+		.index = 0,
+		.table = {
+			{ "/1/", 1 },
+			{ "/1/1/", 11 },
+			{ "/1/1/1/", 111 },
+			{ "/1/1/2/", 112 },
+			{ "/1/2/1/", 121 },
+		}
+	};
+	struct scan_context_st scanctx = { .runner = r, .check_table = &data };
+	axut_assert(r, !ax_trie_scan_prefix(btrie.trie, (int32_t[]) { 1 }, 1, scan_cb, &scanctx));
+	axut_assert_int_equal(r, 5, data.index);
+
+	struct check_table_st all = {
+		.index = 0,
+		.table = {
+			{ "/", 0 },
+			{ "/1/", 1 },
+			{ "/1/1/", 11 },
+		}
+	};
+	scanctx.check_table = &all;
+	axut_assert(r, !ax_trie_scan_prefix(btrie.trie, NULL, 0, scan_cb, &scanctx));
+	axut_assert_int_equal(r, 3, all.index);
+
+	scanctx.check_table = NULL;
+	axut_assert(r, !ax_trie_scan_prefix(btrie.trie, (int32_t[]) { 3 }, 1, scan_cb, &scanctx));
+
+	int32_t deep[AX_TRIE_SCAN_MAX + 1] = { 0 };
+	int value = 0;
+	ax_trie_put_raw(btrie.trie, deep, AX_TRIE_SCAN_MAX + 1, &value);
+	axut_assert(r, ax_trie_scan_prefix(btrie.trie, deep, 2, scan_cb, &scanctx));
+
+	ax_base_leave(base, d);
+}
+
+static void longest_prefix(axut_runner *r)
+{
+	ax_base *base = axut_runner_arg(r);
+	int d = ax_base_enter(base);
+
+	ax_btrie_r btrie = make_test_btrie(base);
+	ax_iter it, end = ax_box_end(btrie.box);
+	size_t len;
+
+	it = ax_trie_longest_prefix(btrie.trie, (int32_t[]) { 1, 1, 3 }, 3, &len);
+	axut_assert_int_equal(r, 11, *(int32_t*)ax_iter_get(&it));
+	axut_assert_uint_equal(r, 2, len);
+
+	it = ax_trie_longest_prefix(btrie.trie, (int32_t[]) { 1, 2, 1, 5 }, 4, &len);
+	axut_assert_int_equal(r, 121, *(int32_t*)ax_iter_get(&it));
+	axut_assert_uint_equal(r, 3, len);
+
+	it = ax_trie_longest_prefix(btrie.trie, (int32_t[]) { 1, 2 }, 2, &len);
+	axut_assert_int_equal(r, 1, *(int32_t*)ax_iter_get(&it));
+	axut_assert_uint_equal(r, 1, len);
+
+	it = ax_trie_longest_prefix(btrie.trie, (int32_t[]) { 3 }, 1, &len);
+	axut_assert_int_equal(r, 0, *(int32_t*)ax_iter_get(&it));
+	axut_assert_uint_equal(r, 0, len);
+
+	ax_trie_erase_raw(btrie.trie, NULL, 0);
+	it = ax_trie_longest_prefix(btrie.trie, (int32_t[]) { 3 }, 1, &len);
+	axut_assert(r, ax_iter_equal(&it, &end));
+	axut_assert_uint_equal(r, 0, len);
+
+	ax_base_leave(base, d);
+}
+
 static void trie_rekey(axut_runner *r)
 {
 	ax_base *base = axut_runner_arg(r);
@@ -455,6 +588,9 @@ axut_suite *suite_for_btrie(ax_base *base)
 	axut_suite_add(suite, trie_exist, 2);
 	axut_suite_add(suite, trie_at, 2);
 	axut_suite_add(suite, trie_prune, 2);
+	axut_suite_add(suite, trie_raw, 2);
+	axut_suite_add(suite, scan_prefix, 2);
+	axut_suite_add(suite, longest_prefix, 2);
 	axut_suite_add(suite, trie_rekey, 2);
 	axut_suite_add(suite, iterater, 2);
 
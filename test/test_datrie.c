@@ -0,0 +1,290 @@
+#include "axe/datrie.h"
+#include "axe/btrie.h"
+#include "axe/art.h"
+#include "axe/list.h"
+#include "axe/string.h"
+
+#include "axut.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+struct check_table_st
+{
+	int index;
+	struct {
+		char *key;
+		int value;
+	} table[32];
+};
+
+struct scan_context_st {
+	axut_runner *runner;
+	struct check_table_st *check_table;
+};
+
+static ax_btrie_r make_test_btrie(ax_base *base)
+{
+	ax_btrie_r btrie = ax_btrie_create(ax_base_local(base),
+			ax_stuff_traits(AX_ST_I32),
+			ax_stuff_traits(AX_ST_I32));
+
+	ax_trie_put_raw(btrie.trie, (int32_t[]) { 1, 1, 1 }, 3, &(int) { 111 });
+	ax_trie_put_raw(btrie.trie, (int32_t[]) { 1, 2, 1 }, 3, &(int) { 121 });
+	ax_trie_put_raw(btrie.trie, (int32_t[]) { 1 }, 1, &(int) { 1 });
+	ax_trie_put_raw(btrie.trie, (int32_t[]) { 1, 1, 2 }, 3, &(int) { 112 });
+	ax_trie_put_raw(btrie.trie, NULL, 0, &(int) { 0 });
+	ax_trie_put_raw(btrie.trie, (int32_t[]) { 2, 1, 1 }, 3, &(int) { 211 });
+	ax_trie_put_raw(btrie.trie, (int32_t[]) { 1, 1 }, 2, &(int) { 11 });
+	return btrie;
+}
+
+static ax_bool scan_cb(const ax_datrie *datrie, const void *key, size_t len, const void *val, void *ctx)
+{
+	struct scan_context_st *sctx = ctx;
+	char path[1024] = "/";
+	for (size_t i = 0; i < len; i++)
+		sprintf(path + strlen(path), "%d/", ((const int32_t *)key)[i]);
+	struct check_table_st *table = sctx->check_table;
+	axut_assert_str_equal(sctx->runner, table->table[table->index].key, path);
+	axut_assert_int_equal(sctx->runner, table->table[table->index].value, *(int *)val);
+	table->index ++;
+	return table->table[table->index].key == NULL;
+}
+
+static void check_dataset(axut_runner *r, const ax_datrie *datrie)
+{
+	axut_assert_uint_equal(r, 7, ax_datrie_size(datrie));
+
+	axut_assert_int_equal(r, 111, *(int32_t*)ax_datrie_get(datrie, (int32_t[]) { 1, 1, 1 }, 3));
+	axut_assert_int_equal(r, 121, *(int32_t*)ax_datrie_get(datrie, (int32_t[]) { 1, 2, 1 }, 3));
+	axut_assert_int_equal(r, 11, *(int32_t*)ax_datrie_get(datrie, (int32_t[]) { 1, 1 }, 2));
+	axut_assert_int_equal(r, 211, *(int32_t*)ax_datrie_get(datrie, (int32_t[]) { 2, 1, 1 }, 3));
+	axut_assert_int_equal(r, 0, *(int32_t*)ax_datrie_get(datrie, NULL, 0));
+	axut_assert(r, !ax_datrie_get(datrie, (int32_t[]) { 1, 2 }, 2));
+	axut_assert(r, !ax_datrie_get(datrie, (int32_t[]) { 1, 1, 1, 1 }, 4));
+	axut_assert(r, !ax_datrie_get(datrie, (int32_t[]) { 3 }, 1));
+}
+
+static void freeze(axut_runner *r)
+{
+	ax_base *base = axut_runner_arg(r);
+	int d = ax_base_enter(base);
+
+	ax_btrie_r btrie = make_test_btrie(base);
+	ax_datrie_r datrie = ax_trie_freeze(ax_base_local(base), btrie.trie);
+	axut_assert(r, datrie.one != NULL);
+	check_dataset(r, datrie.datrie);
+
+	ax_art_r art = ax_art_create(ax_base_local(base),
+			ax_stuff_traits(AX_ST_I32), ax_stuff_traits(AX_ST_I32));
+	datrie = ax_trie_freeze(ax_base_local(base), art.trie);
+	axut_assert_uint_equal(r, 0, ax_datrie_size(datrie.datrie));
+	axut_assert(r, !ax_datrie_get(datrie.datrie, NULL, 0));
+
+	ax_base_leave(base, d);
+}
+
+static void scan_prefix(axut_runner *r)
+{
+	ax_base *base = axut_runner_arg(r);
+	int d = ax_base_enter(base);
+
+	ax_btrie_r btrie = make_test_btrie(base);
+	ax_datrie_r datrie = ax_trie_freeze(ax_base_local(base), btrie.trie);
+
+	struct check_table_st data = {
+		.index = 0,
+		.table = {
+			{ "/1/", 1 },
+			{ "/1/1/", 11 },
+			{ "/1/1/1/", 111 },
+			{ "/1/1/2/", 112 },
+			{ "/1/2/1/", 121 },
+		}
+	};
+	struct scan_context_st scanctx = { .runner = r, .check_table = &data };
+	axut_assert(r, !ax_datrie_scan_prefix(datrie.datrie, (int32_t[]) { 1 }, 1, scan_cb, &scanctx));
+	axut_assert_int_equal(r, 5, data.index);
+
+	struct check_table_st all = {
+		.index = 0,
+		.table = {
+			{ "/", 0 },
+			{ "/1/", 1 },
+			{ "/1/1/", 11 },
+			{ "/1/1/1/", 111 },
+			{ "/1/1/2/", 112 },
+			{ "/1/2/1/", 121 },
+			{ "/2/1/1/", 211 },
+		}
+	};
+	scanctx.check_table = &all;
+	axut_assert(r, !ax_datrie_scan_prefix(datrie.datrie, NULL, 0, scan_cb, &scanctx));
+	axut_assert_int_equal(r, 7, all.index);
+
+	scanctx.check_table = NULL;
+	axut_assert(r, !ax_datrie_scan_prefix(datrie.datrie, (int32_t[]) { 3 }, 1, scan_cb, &scanctx));
+
+	ax_base_leave(base, d);
+}
+
+static void longest_prefix(axut_runner *r)
+{
+	ax_base *base = axut_runner_arg(r);
+	int d = ax_base_enter(base);
+
+	ax_btrie_r btrie = make_test_btrie(base);
+	ax_datrie_r datrie = ax_trie_freeze(ax_base_local(base), btrie.trie);
+	size_t len;
+
+	axut_assert_int_equal(r, 11, *(int32_t*)ax_datrie_longest_prefix(datrie.datrie, (int32_t[]) { 1, 1, 3 }, 3, &len));
+	axut_assert_uint_equal(r, 2, len);
+	axut_assert_int_equal(r, 121, *(int32_t*)ax_datrie_longest_prefix(datrie.datrie, (int32_t[]) { 1, 2, 1, 5 }, 4, &len));
+	axut_assert_uint_equal(r, 3, len);
+	axut_assert_int_equal(r, 0, *(int32_t*)ax_datrie_longest_prefix(datrie.datrie, (int32_t[]) { 3 }, 1, &len));
+	axut_assert_uint_equal(r, 0, len);
+
+	ax_trie_erase_raw(btrie.trie, NULL, 0);
+	datrie = ax_trie_freeze(ax_base_local(base), btrie.trie);
+	axut_assert(r, !ax_datrie_longest_prefix(datrie.datrie, (int32_t[]) { 3 }, 1, &len));
+	axut_assert_uint_equal(r, 0, len);
+
+	ax_base_leave(base, d);
+}
+
+static void image(axut_runner *r)
+{
+	ax_base *base = axut_runner_arg(r);
+	int d = ax_base_enter(base);
+
+	ax_btrie_r btrie = make_test_btrie(base);
+	ax_datrie_r datrie = ax_trie_freeze(ax_base_local(base), btrie.trie);
+
+	size_t size;
+	const void *img = ax_datrie_image(datrie.datrie, &size);
+	uint64_t *buf = malloc(size);
+	memcpy(buf, img, size);
+	ax_one_free(datrie.one);
+	ax_one_free(btrie.one);
+
+	ax_datrie_r loaded = ax_datrie_load(ax_base_local(base), buf, size);
+	axut_assert(r, loaded.one != NULL);
+	check_dataset(r, loaded.datrie);
+	ax_one_free(loaded.one);
+
+	axut_assert(r, ax_datrie_load(ax_base_local(base), buf, size - 8).one == NULL);
+	buf[0] ^= 1;
+	axut_assert(r, ax_datrie_load(ax_base_local(base), buf, size).one == NULL);
+
+	free(buf);
+	ax_base_leave(base, d);
+}
+
+static void make_word(char *buf, unsigned i)
+{
+	buf[0] = (char)(i % 255 + 1);
+	sprintf(buf + 1, "%x", i * 2654435761u);
+}
+
+static void char_key(axut_runner *r)
+{
+	ax_base *base = axut_runner_arg(r);
+	int d = ax_base_enter(base);
+
+	const unsigned count = 5000;
+	char word[32];
+
+	ax_string_r key = ax_string_create(ax_base_local(base));
+	ax_art_r art = ax_art_create(ax_base_local(base),
+			ax_box_elem_tr(key.box), ax_stuff_traits(AX_ST_U32));
+
+	for (unsigned i = 0; i < count; i++) {
+		make_word(word, i);
+		ax_trie_put_raw(art.trie, word, strlen(word), &i);
+	}
+
+	ax_datrie_r datrie = ax_trie_freeze(ax_base_local(base), art.trie);
+	axut_assert_uint_equal(r, count, ax_datrie_size(datrie.datrie));
+
+	for (unsigned i = 0; i < count; i++) {
+		make_word(word, i);
+		const unsigned *val = ax_datrie_get(datrie.datrie, word, strlen(word));
+		axut_assert(r, val && *val == i);
+		const unsigned *expect = ax_trie_get_raw(art.trie, word, strlen(word) - 1);
+		val = ax_datrie_get(datrie.datrie, word, strlen(word) - 1);
+		axut_assert(r, expect ? val && *val == *expect : val == NULL);
+	}
+
+	ax_base_leave(base, d);
+}
+
+static void make_url(char *buf, unsigned i)
+{
+	static const char *hosts[] = { "example.com", "example.org", "libaxe.dev", "mirror.example.net" };
+	sprintf(buf, "https://%s/%s/%u/item-%u.html", hosts[i % 4],
+			(i & 8) ? "archive" : "docs", (i * 7919u) % 997, i);
+}
+
+static void bench_time(axut_runner *r)
+{
+	ax_base *base = axut_runner_arg(r);
+	int d = ax_base_enter(base);
+
+	const unsigned count = 0x4000;
+	char word[128];
+	clock_t time_before;
+
+	ax_string_r key = ax_string_create(ax_base_local(base));
+	ax_btrie_r btrie = ax_btrie_create(ax_base_local(base),
+			ax_box_elem_tr(key.box), ax_stuff_traits(AX_ST_U32));
+	for (unsigned i = 0; i < count; i++) {
+		make_url(word, i);
+		ax_trie_put_raw(btrie.trie, word, strlen(word), &i);
+	}
+	ax_datrie_r datrie = ax_trie_freeze(ax_base_local(base), btrie.trie);
+
+	size_t found = 0;
+	time_before = clock();
+	for (unsigned i = 0; i < count; i++) {
+		make_url(word, i);
+		found += !!ax_trie_get_raw(btrie.trie, word, strlen(word));
+	}
+	//printf("ax_btrie get spent %lfs\n", (double)(clock()-time_before) / CLOCKS_PER_SEC );
+
+	time_before = clock();
+	for (unsigned i = 0; i < count; i++) {
+		make_url(word, i);
+		found += !!ax_datrie_get(datrie.datrie, word, strlen(word));
+	}
+	//printf("ax_datrie get spent %lfs\n", (double)(clock()-time_before) / CLOCKS_PER_SEC );
+	axut_assert_uint_equal(r, count * 2, found);
+
+	ax_base_leave(base, d);
+}
+
+static void clean(axut_runner *r)
+{
+	ax_base *base = axut_runner_arg(r);
+	ax_base_destroy(base);
+}
+
+axut_suite *suite_for_datrie(ax_base *base)
+{
+	axut_suite *suite = axut_suite_create(ax_base_local(base), "datrie");
+
+	ax_base *base1 = ax_base_create();
+	axut_suite_set_arg(suite, base1);
+
+	axut_suite_add(suite, freeze, 0);
+	axut_suite_add(suite, scan_prefix, 1);
+	axut_suite_add(suite, longest_prefix, 1);
+	axut_suite_add(suite, image, 1);
+	axut_suite_add(suite, char_key, 2);
+	axut_suite_add(suite, bench_time, 3);
+
+	axut_suite_add(suite, clean, 0xFF);
+	return suite;
+}
@@ -0,0 +1,337 @@
+#include "assist.h"
+
+#include "axe/deque.h"
+#include "axe/list.h"
+#include "axe/vector.h"
+#include "axe/algo.h"
+#include "axe/base.h"
+
+#include "axut.h"
+
+#include <assert.h>
+#include <setjmp.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+static void create(axut_runner *r)
+{
+	ax_base* base = ax_base_create();
+	ax_deque_r deq_r = ax_deque_create(ax_base_local(base), ax_stuff_traits(AX_ST_I32));
+	axut_assert(r, deq_r.any != NULL);
+	axut_assert(r, ax_box_size(deq_r.box) == 0);
+
+	deq_r = ax_deque_init(ax_base_local(base), "i32x3", 1, 2, 3);
+	int32_t table[] = {1, 2, 3};
+	axut_assert(r, seq_equal_array(deq_r.seq, table, sizeof table));
+
+	ax_base_destroy(base);
+}
+
+static void push_pop(axut_runner *r)
+{
+	ax_base* base = ax_base_create();
+	ax_deque_r deq_r = ax_deque_create(ax_base_local(base), ax_stuff_traits(AX_ST_I32));
+	const int count = 5000;
+
+	for (int i = 0; i < count; i++) {
+		int v = -i - 1;
+		ax_seq_push(deq_r.seq, &i);
+		ax_seq_pushf(deq_r.seq, &v);
+	}
+	axut_assert(r, ax_box_size(deq_r.box) == 2 * count);
+	for (int i = 0; i < 2 * count; i++) {
+		ax_iter it = ax_seq_at(deq_r.seq, i);
+		axut_assert(r, *(int32_t *)ax_iter_get(&it) == i - count);
+	}
+	axut_assert(r, *(int32_t *)ax_seq_first(deq_r.seq) == -count);
+	axut_assert(r, *(int32_t *)ax_seq_last(deq_r.seq) == count - 1);
+
+	for (int i = 0; i < count; i++) {
+		axut_assert(r, *(int32_t *)ax_seq_first(deq_r.seq) == i - count);
+		ax_seq_popf(deq_r.seq);
+		axut_assert(r, *(int32_t *)ax_seq_last(deq_r.seq) == count - i - 1);
+		ax_seq_pop(deq_r.seq);
+	}
+	axut_assert(r, ax_box_size(deq_r.box) == 0);
+
+	/* Drift as a FIFO for a while */
+	for (int i = 0; i < 100000; i++) {
+		ax_seq_push(deq_r.seq, &i);
+		if (i >= 10) {
+			axut_assert(r, *(int32_t *)ax_seq_first(deq_r.seq) == i - 10);
+			ax_seq_popf(deq_r.seq);
+		}
+	}
+	axut_assert(r, ax_box_size(deq_r.box) == 10);
+
+	ax_base_destroy(base);
+}
+
+static void stable(axut_runner *r)
+{
+	ax_base* base = ax_base_create();
+	ax_deque_r deq_r = ax_deque_init(ax_base_local(base), "i32x1", 0);
+	int32_t *first = ax_seq_first(deq_r.seq);
+
+	for (int i = 1; i < 10000; i++) {
+		ax_seq_push(deq_r.seq, &i);
+		ax_seq_pushf(deq_r.seq, &i);
+	}
+	ax_iter it = ax_seq_at(deq_r.seq, 9999);
+	axut_assert(r, ax_iter_get(&it) == first);
+	axut_assert(r, *first == 0);
+
+	ax_base_destroy(base);
+}
+
+static void iter(axut_runner *r)
+{
+	ax_base* base = ax_base_create();
+	ax_deque_r deq_r = ax_deque_create(ax_base_local(base), ax_stuff_traits(AX_ST_I32));
+	for (int i = 0; i < 300; i++)
+		ax_seq_pushf(deq_r.seq, &i);
+	ax_seq_invert(deq_r.seq);
+
+	int i = 0;
+	ax_box_cforeach(deq_r.box, const int32_t *, v)
+		axut_assert(r, *v == i++);
+	axut_assert(r, i == 300);
+
+	ax_iter cur = ax_box_rbegin(deq_r.box), last = ax_box_rend(deq_r.box);
+	while (!ax_iter_equal(&cur, &last)) {
+		axut_assert(r, *(int32_t *)ax_iter_get(&cur) == --i);
+		ax_iter_next(&cur);
+	}
+	axut_assert(r, i == 0);
+
+	ax_iter first = ax_box_begin(deq_r.box), end = ax_box_end(deq_r.box);
+	axut_assert(r, ax_iter_dist(&first, &end) == 300);
+	ax_iter_move(&first, 150);
+	axut_assert(r, *(int32_t *)ax_iter_get(&first) == 150);
+	axut_assert(r, ax_iter_less(&first, &end));
+
+	ax_base_destroy(base);
+}
+
+static void insert_erase(axut_runner *r)
+{
+	int ins;
+	ax_base* base = ax_base_create();
+	ax_deque_r deq_r = ax_deque_init(ax_base_local(base), "i32x2", 1, 2);
+
+	ax_iter it = ax_box_begin(deq_r.box);
+	ins = 3;
+	ax_seq_insert(deq_r.seq, &it, &ins);
+	ins = 4;
+	ax_seq_insert(deq_r.seq, &it, &ins);
+	it = ax_box_end(deq_r.box);
+	ins = 5;
+	ax_seq_insert(deq_r.seq, &it, &ins);
+	int32_t table1[] = {3, 4, 1, 2, 5};
+	axut_assert(r, seq_equal_array(deq_r.seq, table1, sizeof table1));
+
+	it = ax_box_rbegin(deq_r.box);
+	ins = 6;
+	ax_seq_insert(deq_r.seq, &it, &ins);
+	it = ax_box_rend(deq_r.box);
+	ins = 7;
+	ax_seq_insert(deq_r.seq, &it, &ins);
+	int32_t table2[] = {7, 3, 4, 1, 2, 5, 6};
+	axut_assert(r, seq_equal_array(deq_r.seq, table2, sizeof table2));
+
+	it = ax_seq_at(deq_r.seq, 1);
+	ax_iter_erase(&it);
+	axut_assert(r, *(int32_t *)ax_iter_get(&it) == 4);
+	it = ax_seq_at(deq_r.seq, 4);
+	ax_iter_erase(&it);
+	axut_assert(r, *(int32_t *)ax_iter_get(&it) == 6);
+	int32_t table3[] = {7, 4, 1, 2, 6};
+	axut_assert(r, seq_equal_array(deq_r.seq, table3, sizeof table3));
+
+	ax_seq_trunc(deq_r.seq, 2);
+	int32_t table4[] = {7, 4};
+	axut_assert(r, seq_equal_array(deq_r.seq, table4, sizeof table4));
+	ax_seq_trunc(deq_r.seq, 3);
+	int32_t table5[] = {7, 4, 0};
+	axut_assert(r, seq_equal_array(deq_r.seq, table5, sizeof table5));
+
+	ax_base_destroy(base);
+}
+
+static void range(axut_runner *r)
+{
+	ax_base* base = ax_base_create();
+	ax_deque_r deq_r = ax_deque_init(ax_base_local(base), "i32x2", 1, 2);
+	ax_vector_r src_r = ax_vector_init(ax_base_local(base), "i32x3", 7, 8, 9);
+
+	int32_t arr[] = {3, 4};
+	ax_iter it = ax_box_begin(deq_r.box);
+	ax_iter_next(&it);
+	axut_assert(r, !ax_seq_insert_arr(deq_r.seq, &it, arr, 2));
+	int32_t table1[] = {1, 3, 4, 2};
+	axut_assert(r, seq_equal_array(deq_r.seq, table1, sizeof table1));
+	axut_assert(r, *(int32_t *)ax_iter_get(&it) == 2);
+
+	ax_iter first = ax_box_begin(src_r.box), last = ax_box_end(src_r.box);
+	axut_assert(r, !ax_seq_append_range(deq_r.seq, ax_iter_c(&first), ax_iter_c(&last)));
+	int32_t table2[] = {1, 3, 4, 2, 7, 8, 9};
+	axut_assert(r, seq_equal_array(deq_r.seq, table2, sizeof table2));
+
+	it = ax_box_rend(deq_r.box);
+	axut_assert(r, !ax_seq_insert_range(deq_r.seq, &it, ax_iter_c(&first), ax_iter_c(&last)));
+	int32_t table3[] = {9, 8, 7, 1, 3, 4, 2, 7, 8, 9};
+	axut_assert(r, seq_equal_array(deq_r.seq, table3, sizeof table3));
+
+	first = ax_seq_at(deq_r.seq, 2);
+	last = ax_seq_at(deq_r.seq, 5);
+	axut_assert(r, !ax_seq_erase_range(deq_r.seq, &first, &last));
+	int32_t table4[] = {9, 8, 4, 2, 7, 8, 9};
+	axut_assert(r, seq_equal_array(deq_r.seq, table4, sizeof table4));
+	axut_assert(r, *(int32_t *)ax_iter_get(&first) == 4);
+	axut_assert(r, ax_iter_equal(&first, &last));
+
+	first = ax_box_rbegin(deq_r.box);
+	last = ax_box_rbegin(deq_r.box);
+	ax_iter_move(&last, 2);
+	axut_assert(r, !ax_seq_erase_range(deq_r.seq, &first, &last));
+	int32_t table5[] = {9, 8, 4, 2, 7};
+	axut_assert(r, seq_equal_array(deq_r.seq, table5, sizeof table5));
+	axut_assert(r, *(int32_t *)ax_iter_get(&first) == 7);
+
+	/* Random ranges across chunks, on both ends, against a plain array */
+	const int max = 2000;
+	int32_t *ref = malloc(max * 2 * sizeof *ref), *buf = malloc(max * sizeof *buf);
+	int n = 0;
+	ax_box_clear(deq_r.box);
+	srand(34);
+	for (int step = 0; step < 400; step++) {
+		int pos = rand() % (n + 1), len = rand() % 300;
+		ax_bool norm = rand() % 2;
+		if (n + len > max || (step % 3 == 0 && n)) {
+			len = rand() % (n - pos + 1);
+			first = ax_seq_at(deq_r.seq, pos);
+			last = ax_seq_at(deq_r.seq, pos + len);
+			if (!norm) {
+				first = ax_box_rbegin(deq_r.box), last = ax_box_rbegin(deq_r.box);
+				ax_iter_move(&first, n - pos - len);
+				ax_iter_move(&last, n - pos);
+			}
+			axut_assert(r, !ax_seq_erase_range(deq_r.seq, &first, &last));
+			memmove(ref + pos, ref + pos + len, (n - pos - len) * sizeof *ref);
+			n -= len;
+			it = ax_iter_norm(&first) ? ax_box_begin(deq_r.box) : ax_box_rbegin(deq_r.box);
+			axut_assert_int_equal(r, norm ? pos : n - pos, ax_iter_dist(&it, &first));
+		} else {
+			for (int i = 0; i < len; i++)
+				buf[i] = step * 1000 + i;
+			if (norm)
+				it = ax_seq_at(deq_r.seq, pos);
+			else {
+				it = ax_box_rbegin(deq_r.box);
+				ax_iter_move(&it, n - pos);
+			}
+			axut_assert(r, !ax_seq_insert_arr(deq_r.seq, &it, buf, len));
+			memmove(ref + pos + len, ref + pos, (n - pos) * sizeof *ref);
+			for (int i = 0; i < len; i++)
+				ref[pos + i] = norm ? buf[i] : buf[len - 1 - i];
+			n += len;
+			if (norm && pos + len < n)
+				axut_assert_int_equal(r, ref[pos + len], *(int32_t *)ax_iter_get(&it));
+			if (!norm && pos > 0)
+				axut_assert_int_equal(r, ref[pos - 1], *(int32_t *)ax_iter_get(&it));
+		}
+		axut_assert(r, seq_equal_array(deq_r.seq, ref, n * sizeof *ref));
+	}
+	free(ref);
+	free(buf);
+
+	ax_deque_r str_r = ax_deque_create(ax_base_local(base), ax_stuff_traits(AX_ST_S));
+	const char *strs[] = {"a", "b", "c", "d"};
+	axut_assert(r, !ax_seq_append_arr(str_r.seq, strs, 4));
+	first = ax_seq_at(str_r.seq, 1);
+	last = ax_seq_at(str_r.seq, 3);
+	axut_assert(r, !ax_seq_erase_range(str_r.seq, &first, &last));
+	axut_assert(r, !ax_seq_insert_arr(str_r.seq, &first, strs, 1));
+	int i = 0;
+	const char *expect[] = {"a", "a", "d"};
+	ax_box_cforeach(str_r.box, const char *, s)
+		axut_assert_str_equal(r, expect[i++], s);
+	axut_assert_int_equal(r, 3, i);
+
+	ax_base_destroy(base);
+}
+
+static void any_copy_move(axut_runner *r)
+{
+	ax_base* base = ax_base_create();
+	ax_deque_r deq_r = ax_deque_create(ax_base_local(base), ax_stuff_traits(AX_ST_S));
+	char buf[16];
+	for (int i = 0; i < 1000; i++) {
+		sprintf(buf, "%d", i);
+		ax_seq_push(deq_r.seq, buf);
+	}
+
+	ax_deque_r copy_r = { .any = ax_any_copy(deq_r.any) };
+	ax_box_clear(deq_r.box);
+	axut_assert(r, ax_box_size(copy_r.box) == 1000);
+	int i = 0;
+	ax_box_cforeach(copy_r.box, const char *, s) {
+		sprintf(buf, "%d", i++);
+		axut_assert_str_equal(r, buf, s);
+	}
+
+	ax_deque_r moved_r = { .any = ax_any_move(copy_r.any) };
+	axut_assert(r, ax_box_size(copy_r.box) == 0);
+	axut_assert(r, ax_box_size(moved_r.box) == 1000);
+	axut_assert_str_equal(r, "999", ax_seq_last(moved_r.seq));
+	ax_seq_push(copy_r.seq, "again");
+	axut_assert_str_equal(r, "again", ax_seq_first(copy_r.seq));
+
+	ax_base_destroy(base);
+}
+
+static void bench_time(axut_runner *r)
+{
+	const int count = 1000000, window = 64;
+	ax_base* base = ax_base_create();
+	ax_seq *seqs[] = {
+		ax_deque_create(ax_base_local(base), ax_stuff_traits(AX_ST_I64)).seq,
+		ax_list_create(ax_base_local(base), ax_stuff_traits(AX_ST_I64)).seq,
+	};
+
+	for (int s = 0; s < 2; s++) {
+		clock_t time_before = clock();
+		for (int64_t i = 0; i < count; i++) {
+			ax_seq_push(seqs[s], &i);
+			if (i >= window)
+				ax_seq_popf(seqs[s]);
+		}
+		//printf("%s fifo: %lfs\n", s ? "list" : "deque", (double)(clock()-time_before) / CLOCKS_PER_SEC);
+		axut_assert(r, ax_box_size(ax_r(seq, seqs[s]).box) == window);
+
+		time_before = clock();
+		for (int64_t i = 0; i < count; i++)
+			ax_seq_pushf(seqs[s], &i);
+		//printf("%s pushf: %lfs\n", s ? "list" : "deque", (double)(clock()-time_before) / CLOCKS_PER_SEC);
+	}
+
+	ax_base_destroy(base);
+}
+
+axut_suite *suite_for_deque(ax_base *base)
+{
+	axut_suite* suite = axut_suite_create(ax_base_local(base), "deque");
+
+	axut_suite_add(suite, create, 0);
+	axut_suite_add(suite, push_pop, 0);
+	axut_suite_add(suite, stable, 0);
+	axut_suite_add(suite, iter, 0);
+	axut_suite_add(suite, insert_erase, 0);
+	axut_suite_add(suite, range, 0);
+	axut_suite_add(suite, any_copy_move, 0);
+	axut_suite_add(suite, bench_time, 0);
+
+	return suite;
+}
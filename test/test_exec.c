@@ -0,0 +1,211 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "axe/exec.h"
+#include "axe/base.h"
+
+#include "axut.h"
+
+#include <assert.h>
+#include <setjmp.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+
+struct fib
+{
+	ax_exec *exec;
+	unsigned n;
+	uint64_t result;
+};
+
+static double wall_time(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void count_task(void *arg)
+{
+	__atomic_fetch_add((uint64_t *)arg, 1, __ATOMIC_RELAXED);
+}
+
+static void empty_task(void *arg)
+{
+}
+
+/* Fork one half, run the other, then join */
+static void fib_task(void *arg)
+{
+	struct fib *f = arg;
+	if (f->n < 2) {
+		f->result = f->n;
+		return;
+	}
+
+	struct fib a = { .exec = f->exec, .n = f->n - 1 }, b = { .exec = f->exec, .n = f->n - 2 };
+	ax_task_group group;
+	ax_task_group_init(&group, f->exec);
+	ax_task_group_spawn(&group, fib_task, &a);
+	fib_task(&b);
+	ax_task_group_wait(&group);
+	f->result = a.result + b.result;
+}
+
+static void sum_range(size_t begin, size_t end, void *arg)
+{
+	uint64_t sum = 0;
+	for (size_t i = begin; i < end; i++)
+		sum += i;
+	__atomic_fetch_add((uint64_t *)arg, sum, __ATOMIC_RELAXED);
+}
+
+static void mark_range(size_t begin, size_t end, void *arg)
+{
+	ax_byte *mark = arg;
+	for (size_t i = begin; i < end; i++)
+		mark[i]++;
+}
+
+struct identity
+{
+	ax_exec *exec;
+	int self;
+	ax_base *base;
+};
+
+static void identity_task(void *arg)
+{
+	struct identity *id = arg;
+	id->self = ax_exec_self(id->exec);
+	id->base = ax_exec_base(id->exec);
+}
+
+static void create(axut_runner *r)
+{
+	ax_exec *exec = ax_exec_create(3);
+	axut_assert(r, exec != NULL);
+	axut_assert_uint_equal(r, 3, ax_exec_workers(exec));
+	axut_assert_int_equal(r, -1, ax_exec_self(exec));
+	axut_assert(r, ax_exec_base(exec) == NULL);
+
+	struct identity id = { .exec = exec };
+	ax_task_group group;
+	ax_task_group_init(&group, exec);
+	ax_task_group_spawn(&group, identity_task, &id);
+	ax_task_group_wait(&group);
+	axut_assert(r, id.self == -1 || (id.self >= 0 && id.self < 3));
+	axut_assert(r, (id.self < 0) == (id.base == NULL));
+	ax_exec_destroy(exec);
+
+	exec = ax_exec_create(0);
+	axut_assert(r, exec != NULL);
+	axut_assert(r, ax_exec_workers(exec) > 0);
+	ax_exec_destroy(exec);
+}
+
+static void spawn(axut_runner *r)
+{
+	const uint64_t count = 100000;
+	ax_exec *exec = ax_exec_create(4);
+
+	uint64_t done = 0;
+	ax_task_group group;
+	ax_task_group_init(&group, exec);
+	for (uint64_t i = 0; i < count; i++)
+		ax_task_group_spawn(&group, count_task, &done);
+	ax_task_group_wait(&group);
+	axut_assert_uint_equal(r, count, done);
+
+	ax_exec_stat stat;
+	ax_exec_stat_get(exec, &stat);
+	axut_assert_uint_equal(r, count, stat.executed);
+
+	/* Destroying finishes tasks nobody waits for */
+	done = 0;
+	for (uint64_t i = 0; i < 1000; i++)
+		ax_task_group_spawn(&group, count_task, &done);
+	ax_exec_destroy(exec);
+	axut_assert_uint_equal(r, 1000, done);
+}
+
+static void nested(axut_runner *r)
+{
+	ax_exec *exec = ax_exec_create(4);
+
+	struct fib f = { .exec = exec, .n = 20 };
+	ax_task_group group;
+	ax_task_group_init(&group, exec);
+	ax_task_group_spawn(&group, fib_task, &f);
+	ax_task_group_wait(&group);
+	axut_assert_uint_equal(r, 6765, f.result);
+
+	ax_exec_destroy(exec);
+}
+
+static void parallel_for(axut_runner *r)
+{
+	const size_t count = 1000003;
+	ax_exec *exec = ax_exec_create(4);
+
+	uint64_t sum = 0;
+	ax_exec_parallel_for(exec, 0, count, 0, sum_range, &sum);
+	axut_assert_uint_equal(r, (uint64_t)count * (count - 1) / 2, sum);
+
+	ax_byte *mark = calloc(count, 1);
+	ax_exec_parallel_for(exec, 10, count, 1000, mark_range, mark);
+	ax_exec_parallel_for(exec, 5, 5, 0, mark_range, mark);
+	for (size_t i = 0; i < count; i++)
+		axut_assert(r, mark[i] == (i >= 10));
+	free(mark);
+
+	ax_exec_destroy(exec);
+}
+
+static void bench_time(axut_runner *r)
+{
+	const uint64_t count = 200000;
+
+	for (unsigned nworkers = 1; nworkers <= 8; nworkers *= 2) {
+		ax_exec *exec = ax_exec_create(nworkers);
+
+		ax_task_group group;
+		ax_task_group_init(&group, exec);
+		double time_before = wall_time();
+		for (uint64_t i = 0; i < count; i++)
+			ax_task_group_spawn(&group, empty_task, NULL);
+		ax_task_group_wait(&group);
+		double time = wall_time() - time_before;
+		//printf("exec %u workers, external spawn: %.2lf Mtasks/s\n", nworkers, count / time / 1e6);
+
+		struct fib f = { .exec = exec, .n = 22 };
+		time_before = wall_time();
+		ax_task_group_spawn(&group, fib_task, &f);
+		ax_task_group_wait(&group);
+		time = wall_time() - time_before;
+		axut_assert_uint_equal(r, 17711, f.result);
+
+		ax_exec_stat stat;
+		ax_exec_stat_get(exec, &stat);
+		//printf("exec %u workers, fork/join: %.2lf Mtasks/s, %.1lf%% stolen, %lu failed steals\n", nworkers,
+		//		(stat.executed - count) / time / 1e6, 100.0 * stat.stolen / stat.executed, (unsigned long)stat.steal_failed);
+		(void)time;
+
+		ax_exec_destroy(exec);
+	}
+}
+
+axut_suite *suite_for_exec(ax_base *base)
+{
+	axut_suite *suite = axut_suite_create(ax_base_local(base), "exec");
+
+	axut_suite_add(suite, create, 0);
+	axut_suite_add(suite, spawn, 0);
+	axut_suite_add(suite, nested, 0);
+	axut_suite_add(suite, parallel_for, 0);
+	axut_suite_add(suite, bench_time, 0);
+
+	return suite;
+}
@@ -0,0 +1,146 @@
+#include "axe/eytzinger.h"
+#include "axe/algo.h"
+#include "axe/vector.h"
+#include "axe/list.h"
+#include "axe/deque.h"
+#include "axe/base.h"
+
+#include "axut.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+static ax_bool less_i64_high(const void *p1, const void *p2, size_t size)
+{
+	return *(int64_t *)p1 >> 8 < *(int64_t *)p2 >> 8;
+}
+
+/* Values 1, 1, 3, 3, 5, ... so that every key has a known first position */
+static void search(axut_runner *r)
+{
+	ax_base *base = ax_base_create();
+	ax_stuff_trait high = *ax_stuff_traits(AX_ST_I64);
+	high.less = less_i64_high;
+	const ax_stuff_trait *trs[] = { ax_stuff_traits(AX_ST_I64), &high };
+
+	for (int t = 0; t < 2; t++) {
+		int shift = t ? 8 : 0;
+		ax_seq *seqs[] = {
+			ax_vector_create(ax_base_local(base), trs[t]).seq,
+			ax_list_create(ax_base_local(base), trs[t]).seq,
+		};
+		for (int s = 0; s < 2; s++) {
+			for (int64_t n = 0; n <= 70; n++) {
+				ax_box_clear(ax_r(seq, seqs[s]).box);
+				for (int64_t i = 0; i < n; i++) {
+					int64_t val = (i / 2 * 2 + 1) << shift;
+					ax_seq_push(seqs[s], &val);
+				}
+				ax_citer first = ax_box_cbegin(ax_r(seq, seqs[s]).box);
+				ax_citer last = ax_box_cend(ax_r(seq, seqs[s]).box);
+				ax_eytzinger_r eyt = ax_eytzinger_create(ax_base_local(base), &first, &last);
+				axut_assert_uint_equal(r, n, ax_eytzinger_size(eyt.eytzinger));
+
+				int64_t keys[80];
+				size_t out[80];
+				for (int64_t key = 0; key <= n + 1; key++) {
+					keys[key] = key << shift;
+					int64_t expect = key / 2 * 2;
+					axut_assert_uint_equal(r, expect < n ? expect : n,
+							ax_eytzinger_lower_bound(eyt.eytzinger, keys + key));
+				}
+				ax_eytzinger_lower_bound_n(eyt.eytzinger, keys, n + 2, out);
+				for (int64_t key = 0; key <= n + 1; key++)
+					axut_assert_uint_equal(r, ax_eytzinger_lower_bound(eyt.eytzinger, keys + key), out[key]);
+				ax_one_free(eyt.one);
+			}
+		}
+	}
+
+	ax_base_destroy(base);
+}
+
+static void string(axut_runner *r)
+{
+	ax_base *base = ax_base_create();
+	ax_deque_r deq = ax_deque_create(ax_base_local(base), ax_stuff_traits(AX_ST_S));
+	const char *words[] = { "apple", "cherry", "fig", "fig", "pear", "plum" };
+	for (int i = 0; i < 6; i++)
+		ax_seq_push(deq.seq, words[i]);
+
+	ax_citer first = ax_box_cbegin(deq.box), last = ax_box_cend(deq.box);
+	ax_eytzinger_r eyt = ax_eytzinger_create(ax_base_local(base), &first, &last);
+
+	/* The index keeps its own copies */
+	ax_box_clear(deq.box);
+
+	const char *keys[] = { "", "apple", "banana", "fig", "grape", "plum", "zoo" };
+	const size_t pos[] = { 0, 0, 1, 2, 4, 5, 6 };
+	size_t out[7];
+	for (int i = 0; i < 7; i++)
+		axut_assert_uint_equal(r, pos[i], ax_eytzinger_lower_bound(eyt.eytzinger, keys[i]));
+	ax_eytzinger_lower_bound_n(eyt.eytzinger, keys, 7, out);
+	for (int i = 0; i < 7; i++)
+		axut_assert_uint_equal(r, pos[i], out[i]);
+
+	ax_base_destroy(base);
+}
+
+static void bench_search(axut_runner *r)
+{
+	const int n = 0x400000, nq = 0x100000;
+	ax_base *base = ax_base_create();
+	ax_vector_r vec = ax_vector_create(ax_base_local(base), ax_stuff_traits(AX_ST_I32));
+	for (int32_t i = 0; i < n; i++) {
+		int32_t val = i * 2;
+		ax_seq_push(vec.seq, &val);
+	}
+	int32_t *keys = malloc(nq * sizeof *keys);
+	size_t *pos = malloc(nq * sizeof *pos), *out = malloc(nq * sizeof *out);
+	srand(5);
+	for (int i = 0; i < nq; i++)
+		keys[i] = ((unsigned)rand() * 31 + rand()) % (2 * n + 2);
+
+	ax_citer first = ax_box_cbegin(vec.box), last = ax_box_cend(vec.box);
+	clock_t time_before = clock();
+	for (int i = 0; i < nq; i++) {
+		ax_citer it = first;
+		ax_lower_bound(&it, &last, keys + i);
+		pos[i] = ax_citer_dist(&first, &it);
+	}
+	//printf("lower_bound: %lfs\n", (double)(clock()-time_before) / CLOCKS_PER_SEC);
+
+	time_before = clock();
+	ax_eytzinger_r eyt = ax_eytzinger_create(ax_base_local(base), &first, &last);
+	//printf("eytzinger build: %lfs\n", (double)(clock()-time_before) / CLOCKS_PER_SEC);
+
+	time_before = clock();
+	for (int i = 0; i < nq; i++)
+		out[i] = ax_eytzinger_lower_bound(eyt.eytzinger, keys + i);
+	//printf("eytzinger: %lfs\n", (double)(clock()-time_before) / CLOCKS_PER_SEC);
+	axut_assert(r, memcmp(pos, out, nq * sizeof *pos) == 0);
+
+	memset(out, 0, nq * sizeof *out);
+	time_before = clock();
+	ax_eytzinger_lower_bound_n(eyt.eytzinger, keys, nq, out);
+	//printf("eytzinger batch: %lfs\n", (double)(clock()-time_before) / CLOCKS_PER_SEC);
+	axut_assert(r, memcmp(pos, out, nq * sizeof *pos) == 0);
+
+	free(keys);
+	free(pos);
+	free(out);
+	ax_base_destroy(base);
+}
+
+axut_suite *suite_for_eytzinger(ax_base *base)
+{
+	axut_suite *suite = axut_suite_create(ax_base_local(base), "eytzinger");
+
+	axut_suite_add(suite, search, 0);
+	axut_suite_add(suite, string, 0);
+	axut_suite_add(suite, bench_search, 0);
+
+	return suite;
+}
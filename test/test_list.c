@@ -1,5 +1,6 @@
 #include "axe/iter.h"
 #include "axe/list.h"
+#include "axe/vector.h"
 #include "axe/algo.h"
 #include "axe/base.h"
 
@@ -10,6 +11,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <time.h>
 
 static ax_bool seq_equal_array(ax_seq *seq, void *arr, size_t mem_size)
 {
@@ -129,6 +131,36 @@ static void riter(axut_runner *r)
 }
 
 
+static void iter_erase(axut_runner *r)
+{
+	ax_base* base = ax_base_create();
+	ax_list_r list_r = ax_list_init(ax_base_local(base), "i32x4", 1, 2, 3, 4);
+
+	ax_iter it = ax_seq_at(list_r.seq, 3);
+	ax_iter_erase(&it);
+	axut_assert(r, ax_box_size(list_r.box) == 3);
+	ax_iter end = ax_box_end(list_r.box);
+	axut_assert(r, ax_iter_equal(&it, &end));
+
+	it = ax_box_rbegin(list_r.box);
+	ax_iter_next(&it);
+	ax_iter_next(&it);
+	ax_iter_erase(&it);
+	axut_assert(r, ax_box_size(list_r.box) == 2);
+	ax_iter rend = ax_box_rend(list_r.box);
+	axut_assert(r, ax_iter_equal(&it, &rend));
+
+	int32_t table[] = {2, 3};
+	axut_assert(r, seq_equal_array(list_r.seq, table, sizeof table));
+
+	it = ax_box_begin(list_r.box);
+	while (ax_box_size(list_r.box))
+		ax_iter_erase(&it);
+	axut_assert(r, seq_equal_array(list_r.seq, NULL, 0));
+
+	ax_base_destroy(base);
+}
+
 static void seq_insert(axut_runner *r)
 {
 	int ins;
@@ -184,6 +216,94 @@ static void seq_insert_for_riter(axut_runner *r)
 	ax_base_destroy(base);
 }
 
+static void seq_range(axut_runner *r)
+{
+	ax_base* base = ax_base_create();
+	ax_list_r self_r = ax_list_init(ax_base_local(base), "i32x2", 1, 2);
+	ax_vector_r src_r = ax_vector_init(ax_base_local(base), "i32x3", 7, 8, 9);
+
+	int32_t arr[] = {3, 4};
+	ax_iter it = ax_box_begin(self_r.box);
+	ax_iter_next(&it);
+	axut_assert(r, !ax_seq_insert_arr(self_r.seq, &it, arr, 2));
+	int32_t table1[] = {1, 3, 4, 2};
+	axut_assert(r, seq_equal_array(self_r.seq, table1, sizeof table1));
+	axut_assert(r, *(int32_t *)ax_iter_get(&it) == 2);
+
+	ax_iter first = ax_box_begin(src_r.box), last = ax_box_end(src_r.box);
+	axut_assert(r, !ax_seq_append_range(self_r.seq, ax_iter_c(&first), ax_iter_c(&last)));
+	int32_t table2[] = {1, 3, 4, 2, 7, 8, 9};
+	axut_assert(r, seq_equal_array(self_r.seq, table2, sizeof table2));
+
+	it = ax_box_rbegin(self_r.box);
+	axut_assert(r, !ax_seq_insert_range(self_r.seq, &it, ax_iter_c(&first), ax_iter_c(&last)));
+	int32_t table3[] = {1, 3, 4, 2, 7, 8, 9, 9, 8, 7};
+	axut_assert(r, seq_equal_array(self_r.seq, table3, sizeof table3));
+
+	axut_assert(r, !ax_seq_insert_arr(self_r.seq, &it, arr, 0));
+	axut_assert(r, !ax_seq_insert_range(self_r.seq, &it, ax_iter_c(&first), ax_iter_c(&first)));
+	axut_assert(r, ax_box_size(self_r.box) == 10);
+
+	ax_base_destroy(base);
+}
+
+static void seq_erase_range(axut_runner *r)
+{
+	ax_base* base = ax_base_create();
+	ax_list_r self_r = ax_list_init(ax_base_local(base), "i32x6", 1, 2, 3, 4, 5, 6);
+
+	ax_iter first = ax_box_begin(self_r.box), last = ax_box_begin(self_r.box);
+	ax_iter_next(&first);
+	ax_iter_next(&last);
+	ax_iter_next(&last);
+	ax_iter_next(&last);
+	axut_assert(r, !ax_seq_erase_range(self_r.seq, &first, &last));
+	int32_t table1[] = {1, 4, 5, 6};
+	axut_assert(r, seq_equal_array(self_r.seq, table1, sizeof table1));
+	axut_assert(r, *(int32_t *)ax_iter_get(&first) == 4);
+	axut_assert(r, ax_iter_equal(&first, &last));
+
+	first = ax_box_rbegin(self_r.box);
+	last = ax_box_rbegin(self_r.box);
+	ax_iter_next(&last);
+	ax_iter_next(&last);
+	axut_assert(r, !ax_seq_erase_range(self_r.seq, &first, &last));
+	int32_t table2[] = {1, 4};
+	axut_assert(r, seq_equal_array(self_r.seq, table2, sizeof table2));
+	axut_assert(r, *(int32_t *)ax_iter_get(&first) == 4);
+
+	first = ax_box_begin(self_r.box);
+	last = ax_box_end(self_r.box);
+	axut_assert(r, !ax_seq_erase_range(self_r.seq, &first, &last));
+	axut_assert(r, ax_box_size(self_r.box) == 0);
+
+	ax_base_destroy(base);
+}
+
+static void seq_range_link(axut_runner *r)
+{
+	ax_base* base = ax_base_create();
+	ax_list_r self_r = ax_list_create(ax_base_local(base), ax_stuff_traits(AX_ST_S));
+
+	const char *arr[] = {"a", "b", "c", "d"};
+	axut_assert(r, !ax_seq_append_arr(self_r.seq, arr, 4));
+	axut_assert(r, ax_box_size(self_r.box) == 4);
+
+	ax_iter first = ax_box_begin(self_r.box), last = ax_box_end(self_r.box);
+	ax_iter_next(&first);
+	ax_iter_prev(&last);
+	axut_assert(r, !ax_seq_erase_range(self_r.seq, &first, &last));
+
+	int i = 0;
+	const char *expect[] = {"a", "d"};
+	ax_box_cforeach(self_r.box, const char *, s) {
+		axut_assert(r, strcmp(s, expect[i++]) == 0);
+	}
+	axut_assert(r, i == 2);
+
+	ax_base_destroy(base);
+}
+
 static void any_move(axut_runner *r)
 {
 	ax_base* base = ax_base_create();
@@ -261,6 +381,267 @@ static void seq_invert(axut_runner *r)
 	ax_base_destroy(base);
 }
 
+/* Order by the high half only, the low half records the original position */
+static ax_bool less_high(const void *p1, const void *p2, size_t size)
+{
+	return *(int64_t *)p1 >> 32 < *(int64_t *)p2 >> 32;
+}
+
+static void sort(axut_runner *r)
+{
+	const int count = 5000;
+	ax_base* base = ax_base_create();
+	ax_stuff_trait tr = *ax_stuff_traits(AX_ST_I64);
+	tr.less = less_high;
+	ax_list_r list_r = ax_list_create(ax_base_local(base), &tr);
+
+	ax_list_sort(list_r.list);
+	axut_assert(r, ax_box_size(list_r.box) == 0);
+
+	srand(9);
+	for (int64_t i = 0; i < count; i++) {
+		int64_t val = (int64_t)(rand() % 100) << 32 | i;
+		ax_seq_push(list_r.seq, &val);
+	}
+	ax_list_sort(list_r.list);
+	axut_assert(r, ax_box_size(list_r.box) == count);
+
+	int64_t prev = -1;
+	int n = 0;
+	ax_box_cforeach(list_r.box, const int64_t *, v) {
+		axut_assert(r, prev < *v);
+		prev = *v;
+		n++;
+	}
+	axut_assert(r, n == count);
+
+	ax_iter cur = ax_box_rbegin(list_r.box), last = ax_box_rend(list_r.box);
+	while (!ax_iter_equal(&cur, &last)) {
+		axut_assert(r, *(int64_t *)ax_iter_get(&cur) == prev);
+		ax_iter_next(&cur);
+		if (!ax_iter_equal(&cur, &last))
+			prev = *(int64_t *)ax_iter_get(&cur);
+		n--;
+	}
+	axut_assert(r, n == 0);
+
+	ax_base_destroy(base);
+}
+
+static void splice(axut_runner *r)
+{
+	ax_base* base = ax_base_create();
+	ax_list_r list1 = ax_list_init(ax_base_local(base), "i32x4", 1, 2, 3, 4);
+	ax_list_r list2 = ax_list_init(ax_base_local(base), "i32x3", 5, 6, 7);
+
+	ax_iter it = ax_seq_at(list1.seq, 1);
+	ax_iter first = ax_seq_at(list2.seq, 1), last = ax_box_end(list2.box);
+	ax_list_splice(&it, list2.list, &first, &last);
+	int32_t table1[] = {1, 6, 7, 2, 3, 4}, table2[] = {5};
+	axut_assert(r, seq_equal_array(list1.seq, table1, sizeof table1));
+	axut_assert(r, seq_equal_array(list2.seq, table2, sizeof table2));
+	axut_assert(r, ax_box_size(list1.box) == 6);
+	axut_assert(r, ax_box_size(list2.box) == 1);
+
+	/* Within one list */
+	it = ax_box_begin(list1.box);
+	first = ax_seq_at(list1.seq, 3);
+	last = ax_seq_at(list1.seq, 5);
+	ax_list_splice(&it, list1.list, &first, &last);
+	int32_t table3[] = {2, 3, 1, 6, 7, 4};
+	axut_assert(r, seq_equal_array(list1.seq, table3, sizeof table3));
+	axut_assert(r, ax_box_size(list1.box) == 6);
+
+	/* Whole list after the last element through a reverse iterator */
+	it = ax_box_rbegin(list2.box);
+	first = ax_box_begin(list1.box);
+	last = ax_box_end(list1.box);
+	ax_list_splice(&it, list1.list, &first, &last);
+	int32_t table4[] = {5, 2, 3, 1, 6, 7, 4};
+	axut_assert(r, seq_equal_array(list2.seq, table4, sizeof table4));
+	axut_assert(r, ax_box_size(list1.box) == 0);
+	axut_assert(r, ax_box_size(list2.box) == 7);
+
+	/* Into an empty list */
+	it = ax_box_end(list1.box);
+	first = ax_seq_at(list2.seq, 6);
+	last = ax_box_end(list2.box);
+	ax_list_splice(&it, list2.list, &first, &last);
+	int32_t table5[] = {4};
+	axut_assert(r, seq_equal_array(list1.seq, table5, sizeof table5));
+	axut_assert(r, ax_box_size(list2.box) == 6);
+
+	ax_base_destroy(base);
+}
+
+static void merge(axut_runner *r)
+{
+	ax_base* base = ax_base_create();
+	ax_stuff_trait tr = *ax_stuff_traits(AX_ST_I64);
+	tr.less = less_high;
+	ax_list_r list1 = ax_list_create(ax_base_local(base), &tr);
+	ax_list_r list2 = ax_list_create(ax_base_local(base), &tr);
+
+	int64_t keys1[] = {1, 3, 3, 8}, keys2[] = {0, 3, 9};
+	for (int i = 0; i < 4; i++) {
+		int64_t val = keys1[i] << 32 | 1;
+		ax_seq_push(list1.seq, &val);
+	}
+	for (int i = 0; i < 3; i++) {
+		int64_t val = keys2[i] << 32 | 2;
+		ax_seq_push(list2.seq, &val);
+	}
+
+	ax_list_merge(list1.list, list2.list);
+	int64_t table[] = {
+		0LL << 32 | 2, 1LL << 32 | 1, 3LL << 32 | 1, 3LL << 32 | 1,
+		3LL << 32 | 2, 8LL << 32 | 1, 9LL << 32 | 2
+	};
+	axut_assert(r, seq_equal_array(list1.seq, table, sizeof table));
+	axut_assert(r, ax_box_size(list1.box) == 7);
+	axut_assert(r, ax_box_size(list2.box) == 0);
+
+	ax_list_merge(list2.list, list1.list);
+	axut_assert(r, seq_equal_array(list2.seq, table, sizeof table));
+	axut_assert(r, ax_box_size(list1.box) == 0);
+
+	ax_base_destroy(base);
+}
+
+static void bench_sort(axut_runner *r)
+{
+	const int count = 100000;
+	ax_base* base = ax_base_create();
+	ax_list_r list1 = ax_list_create(ax_base_local(base), ax_stuff_traits(AX_ST_I32));
+	ax_list_r list2 = ax_list_create(ax_base_local(base), ax_stuff_traits(AX_ST_I32));
+	srand(4);
+	for (int i = 0; i < count; i++) {
+		int32_t val = rand();
+		ax_seq_push(list1.seq, &val);
+		ax_seq_push(list2.seq, &val);
+	}
+
+	clock_t time_before = clock();
+	ax_list_sort(list1.list);
+	//printf("ax_list_sort: %lfs\n", (double)(clock()-time_before) / CLOCKS_PER_SEC);
+
+	ax_iter first = ax_box_begin(list2.box), last = ax_box_end(list2.box);
+	time_before = clock();
+	ax_merge_sort(&first, &last);
+	//printf("ax_merge_sort: %lfs\n", (double)(clock()-time_before) / CLOCKS_PER_SEC);
+
+	ax_iter cur1 = ax_box_begin(list1.box), cur2 = ax_box_begin(list2.box), end1 = ax_box_end(list1.box);
+	while (!ax_iter_equal(&cur1, &end1)) {
+		axut_assert(r, *(int32_t *)ax_iter_get(&cur1) == *(int32_t *)ax_iter_get(&cur2));
+		ax_iter_next(&cur1);
+		ax_iter_next(&cur2);
+	}
+
+	ax_base_destroy(base);
+}
+
+/* Positions cached by ax_seq_at must follow every kind of change */
+static void seq_at(axut_runner *r)
+{
+	const int count = 2000;
+	ax_base* base = ax_base_create();
+	ax_list_r list_r = ax_list_create(ax_base_local(base), ax_stuff_traits(AX_ST_I32));
+	int32_t *ref = malloc(count * 2 * sizeof *ref);
+	int size = 0;
+
+	srand(6);
+	for (int round = 0; round < 2; round++) {
+		ax_list_set_indexed(list_r.list, round);
+		for (int step = 0; step < count * 4; step++) {
+			int32_t val = step;
+			int pos = rand() % (size + 1);
+			switch (rand() % 6) {
+				case 0:
+					ax_seq_push(list_r.seq, &val);
+					ref[size++] = val;
+					break;
+				case 1:
+					ax_seq_pushf(list_r.seq, &val);
+					memmove(ref + 1, ref, size++ * sizeof *ref);
+					ref[0] = val;
+					break;
+				case 2:
+					if (size && size < count) {
+						ax_seq_popf(list_r.seq);
+						memmove(ref, ref + 1, --size * sizeof *ref);
+					}
+					break;
+				case 3:
+					if (size > count) {
+						ax_seq_pop(list_r.seq);
+						size--;
+					}
+					break;
+				case 4: {
+					ax_iter it = ax_seq_at(list_r.seq, pos);
+					ax_seq_insert(list_r.seq, &it, &val);
+					memmove(ref + pos + 1, ref + pos, (size++ - pos) * sizeof *ref);
+					ref[pos] = val;
+					break;
+				}
+				case 5:
+					if (pos < size) {
+						ax_iter it = ax_seq_at(list_r.seq, pos);
+						ax_iter_erase(&it);
+						memmove(ref + pos, ref + pos + 1, (--size - pos) * sizeof *ref);
+					}
+					break;
+			}
+			for (int k = 0; k < 3 && size; k++) {
+				int i = rand() % size;
+				ax_iter it = ax_seq_at(list_r.seq, i);
+				axut_assert_int_equal(r, ref[i], *(int32_t *)ax_iter_get(&it));
+			}
+		}
+		axut_assert_uint_equal(r, size, ax_box_size(list_r.box));
+		ax_iter it = ax_seq_at(list_r.seq, size);
+		axut_assert(r, it.point == NULL);
+	}
+
+	free(ref);
+	ax_base_destroy(base);
+}
+
+static void bench_at(axut_runner *r)
+{
+	const int count = 100000, nrand = 20000;
+	ax_base* base = ax_base_create();
+	ax_list_r list_r = ax_list_create(ax_base_local(base), ax_stuff_traits(AX_ST_I32));
+	for (int32_t i = 0; i < count; i++)
+		ax_seq_push(list_r.seq, &i);
+
+	srand(8);
+	int *index = malloc(nrand * sizeof *index);
+	for (int i = 0; i < nrand; i++)
+		index[i] = rand() % count;
+
+	for (int indexed = 0; indexed < 2; indexed++) {
+		ax_list_set_indexed(list_r.list, indexed);
+
+		clock_t time_before = clock();
+		for (int i = 0; i < count; i++) {
+			ax_iter it = ax_seq_at(list_r.seq, i);
+			axut_assert(r, *(int32_t *)ax_iter_get(&it) == i);
+		}
+		//printf("list%s sequential at: %lfs\n", indexed ? " indexed" : "", (double)(clock()-time_before) / CLOCKS_PER_SEC);
+
+		time_before = clock();
+		for (int i = 0; i < nrand; i++) {
+			ax_iter it = ax_seq_at(list_r.seq, index[i]);
+			axut_assert(r, *(int32_t *)ax_iter_get(&it) == index[i]);
+		}
+		//printf("list%s random at: %lfs\n", indexed ? " indexed" : "", (double)(clock()-time_before) / CLOCKS_PER_SEC);
+	}
+
+	free(index);
+	ax_base_destroy(base);
+}
+
 axut_suite* suite_for_list(ax_base *base)
 {
 	axut_suite *suite = axut_suite_create(ax_base_local(base), "list");
@@ -269,12 +650,22 @@ axut_suite* suite_for_list(ax_base *base)
 	axut_suite_add(suite, push, 0);
 	axut_suite_add(suite, iter, 0);
 	axut_suite_add(suite, riter, 0);
+	axut_suite_add(suite, iter_erase, 0);
 	axut_suite_add(suite, seq_insert, 0);
 	axut_suite_add(suite, seq_insert_for_riter, 0);
+	axut_suite_add(suite, seq_range, 0);
+	axut_suite_add(suite, seq_erase_range, 0);
+	axut_suite_add(suite, seq_range_link, 0);
 	axut_suite_add(suite, seq_trunc, 0);
 	axut_suite_add(suite, seq_invert, 0);
 	axut_suite_add(suite, any_move, 0);
 	axut_suite_add(suite, any_copy, 0);
+	axut_suite_add(suite, sort, 0);
+	axut_suite_add(suite, splice, 0);
+	axut_suite_add(suite, merge, 0);
+	axut_suite_add(suite, bench_sort, 0);
+	axut_suite_add(suite, seq_at, 0);
+	axut_suite_add(suite, bench_at, 0);
 
 	return suite;
 }
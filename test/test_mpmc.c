@@ -0,0 +1,198 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "axe/mpmc.h"
+#include "axe/base.h"
+#include "axe/error.h"
+
+#include "axut.h"
+
+#include <assert.h>
+#include <setjmp.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <pthread.h>
+
+#define MAX_THREADS 4
+#define STOP UINT64_MAX
+
+struct worker
+{
+	ax_mpmc *mpmc;
+	uint64_t id;
+	uint64_t count;
+	size_t batch;
+	uint64_t sum;
+	ax_bool bad;
+};
+
+static double wall_time(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* Values are tagged with the producer id in the high bits */
+static void *producer(void *arg)
+{
+	struct worker *w = arg;
+	uint64_t buf[64];
+	for (uint64_t i = 0; i < w->count; ) {
+		size_t n = w->count - i < w->batch ? w->count - i : w->batch;
+		for (size_t j = 0; j < n; j++)
+			buf[j] = w->id << 40 | (i + j);
+		size_t done = n > 1 ? ax_mpmc_push_n(w->mpmc, buf, n) : 0;
+		if (!done) {
+			ax_mpmc_push_wait(w->mpmc, buf);
+			done = 1;
+		}
+		i += done;
+	}
+	return NULL;
+}
+
+/* Values of one producer must arrive in order at each consumer */
+static void *consumer(void *arg)
+{
+	struct worker *w = arg;
+	uint64_t buf[64], last[MAX_THREADS];
+	for (int i = 0; i < MAX_THREADS; i++)
+		last[i] = STOP;
+
+	for (;;) {
+		size_t n = w->batch > 1 ? ax_mpmc_pop_n(w->mpmc, buf, w->batch) : 0;
+		if (!n) {
+			ax_mpmc_pop_wait(w->mpmc, buf);
+			n = 1;
+		}
+		for (size_t j = 0; j < n; j++) {
+			if (buf[j] == STOP) {
+				/* A batch may have taken the markers of other consumers */
+				for (j++; j < n; j++)
+					ax_mpmc_push_wait(w->mpmc, buf + j);
+				return NULL;
+			}
+			uint64_t id = buf[j] >> 40, seq = buf[j] & (((uint64_t)1 << 40) - 1);
+			if (id >= MAX_THREADS || (last[id] != STOP && seq <= last[id]))
+				w->bad = ax_true;
+			else
+				last[id] = seq;
+			w->sum += seq;
+			w->count++;
+		}
+	}
+}
+
+/* Run np producers and nc consumers, returns seconds or a negative value on mismatch */
+static double transfer(ax_mpmc *mpmc, int np, int nc, uint64_t count, size_t batch)
+{
+	struct worker prods[MAX_THREADS], conss[MAX_THREADS];
+	pthread_t pt[MAX_THREADS], ct[MAX_THREADS];
+
+	double time_before = wall_time();
+	for (int i = 0; i < nc; i++) {
+		conss[i] = (struct worker) { .mpmc = mpmc, .batch = batch };
+		pthread_create(ct + i, NULL, consumer, conss + i);
+	}
+	for (int i = 0; i < np; i++) {
+		prods[i] = (struct worker) { .mpmc = mpmc, .id = i, .count = count, .batch = batch };
+		pthread_create(pt + i, NULL, producer, prods + i);
+	}
+	for (int i = 0; i < np; i++)
+		pthread_join(pt[i], NULL);
+
+	/* Stop markers may be taken by a consumer only after all data before them */
+	uint64_t stop = STOP;
+	for (int i = 0; i < nc; i++)
+		ax_mpmc_push_wait(mpmc, &stop);
+	for (int i = 0; i < nc; i++)
+		pthread_join(ct[i], NULL);
+	double time = wall_time() - time_before;
+
+	uint64_t total = 0, sum = 0;
+	for (int i = 0; i < nc; i++) {
+		if (conss[i].bad)
+			return -1;
+		total += conss[i].count;
+		sum += conss[i].sum;
+	}
+	if (total != count * np || sum != count * (count - 1) / 2 * np)
+		return -1;
+	return time;
+}
+
+static void operate(axut_runner *r)
+{
+	ax_base* base = ax_base_create();
+	ax_mpmc_r mpmc = ax_mpmc_create(ax_base_local(base), ax_stuff_traits(AX_ST_I16), 3);
+	axut_assert_uint_equal(r, 4, ax_mpmc_capacity(mpmc.mpmc));
+
+	int16_t val;
+	axut_assert(r, ax_mpmc_try_pop(mpmc.mpmc, &val));
+	axut_assert(r, ax_tube_prime(mpmc.tube) == NULL);
+	for (int16_t i = 0; i < 4; i++)
+		axut_assert(r, !ax_tube_push(mpmc.tube, &i));
+	axut_assert(r, ax_mpmc_try_push(mpmc.mpmc, &val));
+	axut_assert_uint_equal(r, 4, ax_tube_size(mpmc.tube));
+
+	axut_assert_int_equal(r, 0, *(int16_t *)ax_tube_prime(mpmc.tube));
+	ax_tube_pop(mpmc.tube);
+	axut_assert(r, !ax_mpmc_try_pop(mpmc.mpmc, &val));
+	axut_assert_int_equal(r, 1, val);
+
+	int16_t arr[4] = { 4, 5, 6 }, out[4];
+	axut_assert_uint_equal(r, 2, ax_mpmc_push_n(mpmc.mpmc, arr, 3));
+	axut_assert_uint_equal(r, 4, ax_mpmc_pop_n(mpmc.mpmc, out, 4));
+	for (int16_t i = 0; i < 4; i++)
+		axut_assert_int_equal(r, i + 2, out[i]);
+	axut_assert_uint_equal(r, 0, ax_mpmc_pop_n(mpmc.mpmc, out, 4));
+	axut_assert_uint_equal(r, 0, ax_tube_size(mpmc.tube));
+
+	ax_base_destroy(base);
+}
+
+static void threads(axut_runner *r)
+{
+	ax_base* base = ax_base_create();
+	ax_mpmc_r mpmc = ax_mpmc_create(ax_base_local(base), ax_stuff_traits(AX_ST_U64), 16);
+
+	axut_assert(r, transfer(mpmc.mpmc, 1, 1, 50000, 1) >= 0);
+	axut_assert(r, transfer(mpmc.mpmc, 3, 2, 20000, 1) >= 0);
+	axut_assert(r, transfer(mpmc.mpmc, 2, 3, 20000, 8) >= 0);
+	axut_assert_uint_equal(r, 0, ax_tube_size(mpmc.tube));
+
+	ax_base_destroy(base);
+}
+
+static void bench_time(axut_runner *r)
+{
+	const uint64_t count = 200000;
+	ax_base* base = ax_base_create();
+	ax_mpmc_r mpmc = ax_mpmc_create(ax_base_local(base), ax_stuff_traits(AX_ST_U64), 1024);
+
+	for (int np = 1; np <= MAX_THREADS; np *= 2) {
+		for (int nc = 1; nc <= MAX_THREADS; nc *= 2) {
+			for (size_t batch = 1; batch <= 32; batch *= 32) {
+				double time = transfer(mpmc.mpmc, np, nc, count, batch);
+				axut_assert(r, time >= 0);
+				//printf("mpmc %dp/%dc batch %zu: %.1lf Mops/s\n", np, nc, batch, count * np / time / 1e6);
+			}
+		}
+	}
+
+	ax_base_destroy(base);
+}
+
+axut_suite *suite_for_mpmc(ax_base *base)
+{
+	axut_suite *suite = axut_suite_create(ax_base_local(base), "mpmc");
+
+	axut_suite_add(suite, operate, 0);
+	axut_suite_add(suite, threads, 0);
+	axut_suite_add(suite, bench_time, 0);
+
+	return suite;
+}
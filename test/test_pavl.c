@@ -0,0 +1,169 @@
+#include "axut.h"
+
+#include "axe/pavl.h"
+#include "axe/iter.h"
+#include "axe/base.h"
+
+#include <stdio.h>
+
+#define N 200
+
+static void insert(axut_runner *r)
+{
+	ax_base *base = axut_runner_arg(r);
+	ax_pavl_r pavl_r = ax_pavl_create(ax_base_local(base), ax_stuff_traits(AX_ST_I32),
+			ax_stuff_traits(AX_ST_I32));
+	for (int32_t k = 0; k < N; k++) {
+		int32_t v = (k * 7) % N;
+		int32_t *ret = ax_map_put(pavl_r.map, &v, &k);
+		axut_assert(r, *ret == k);
+	}
+	axut_assert_uint_equal(r, N, ax_box_size(pavl_r.box));
+
+	int32_t i = 0;
+	ax_map_foreach(pavl_r.map, const int32_t *, key, int32_t *, val) {
+		axut_assert(r, *key == i++);
+		axut_assert(r, (*val * 7) % N == *key);
+	}
+
+	i = N - 1;
+	ax_iter it = ax_box_rbegin(pavl_r.box), end = ax_box_rend(pavl_r.box);
+	while (!ax_iter_equal(&it, &end)) {
+		axut_assert(r, *(int32_t *)ax_map_iter_key(&it) == i--);
+		ax_iter_next(&it);
+	}
+
+	ax_iter first = ax_box_begin(pavl_r.box), last = ax_box_end(pavl_r.box);
+	ax_iter_prev(&last);
+	axut_assert(r, ax_iter_dist(&first, &last) == N - 1);
+}
+
+static void snapshot(axut_runner *r)
+{
+	ax_base *base = axut_runner_arg(r);
+	ax_pavl_r pavl_r = ax_pavl_create(ax_base_local(base), ax_stuff_traits(AX_ST_I32),
+			ax_stuff_traits(AX_ST_I32));
+	for (int32_t k = 0; k < N; k++)
+		ax_map_put(pavl_r.map, &k, &k);
+
+	ax_pavl_r snap_r = { .any = ax_any_copy(pavl_r.any) };
+	axut_assert_uint_equal(r, N, ax_box_size(snap_r.box));
+
+	for (int32_t k = 0; k < N; k += 2)
+		ax_map_erase(pavl_r.map, &k);
+	for (int32_t k = 1, v = -1; k < N; k += 2)
+		ax_map_put(pavl_r.map, &k, &v);
+
+	axut_assert_uint_equal(r, N / 2, ax_box_size(pavl_r.box));
+	ax_map_foreach(pavl_r.map, const int32_t *, key, int32_t *, val) {
+		axut_assert(r, *key % 2 == 1);
+		axut_assert(r, *val == -1);
+	}
+
+	int32_t i = 0;
+	ax_map_foreach(snap_r.map, const int32_t *, key, int32_t *, val) {
+		axut_assert(r, *key == i);
+		axut_assert(r, *val == i);
+		i++;
+	}
+	axut_assert(r, i == N);
+
+	ax_one_free(pavl_r.one);
+	for (int32_t k = 0; k < N; k++)
+		axut_assert(r, *(int32_t *)ax_map_get(snap_r.map, &k) == k);
+}
+
+static void iter_set(axut_runner *r)
+{
+	ax_base *base = axut_runner_arg(r);
+	ax_pavl_r pavl_r = ax_pavl_create(ax_base_local(base), ax_stuff_traits(AX_ST_I32),
+			ax_stuff_traits(AX_ST_I32));
+	for (int32_t k = 0; k < N; k++)
+		ax_map_put(pavl_r.map, &k, &k);
+
+	ax_pavl_r snap_r = { .any = ax_any_copy(pavl_r.any) };
+
+	ax_iter it = ax_box_begin(pavl_r.box), end = ax_box_end(pavl_r.box);
+	while (!ax_iter_equal(&it, &end)) {
+		int32_t v = *(int32_t *)ax_iter_get(&it) + N;
+		ax_iter_set(&it, &v);
+		axut_assert(r, *(int32_t *)ax_iter_get(&it) == v);
+		ax_iter_next(&it);
+	}
+
+	for (int32_t k = 0; k < N; k++) {
+		axut_assert(r, *(int32_t *)ax_map_get(pavl_r.map, &k) == k + N);
+		axut_assert(r, *(int32_t *)ax_map_get(snap_r.map, &k) == k);
+	}
+}
+
+static void erase(axut_runner *r)
+{
+	ax_base *base = axut_runner_arg(r);
+	ax_pavl_r pavl_r = ax_pavl_create(ax_base_local(base), ax_stuff_traits(AX_ST_I32),
+			ax_stuff_traits(AX_ST_I32));
+	for (int32_t k = 0; k < N; k++)
+		ax_map_put(pavl_r.map, &k, &k);
+
+	ax_pavl_r snap_r = { .any = ax_any_copy(pavl_r.any) };
+
+	ax_iter it = ax_box_begin(pavl_r.box), end = ax_box_end(pavl_r.box);
+	int32_t i = 0;
+	while (!ax_iter_equal(&it, &end)) {
+		axut_assert(r, *(int32_t *)ax_map_iter_key(&it) == i++);
+		ax_iter_erase(&it);
+	}
+	axut_assert_uint_equal(r, 0, ax_box_size(pavl_r.box));
+	axut_assert_uint_equal(r, N, ax_box_size(snap_r.box));
+
+	int32_t k = N;
+	axut_assert(r, ax_map_erase(snap_r.map, &k));
+	ax_box_clear(snap_r.box);
+	axut_assert_uint_equal(r, 0, ax_box_size(snap_r.box));
+}
+
+static void string_key(axut_runner *r)
+{
+	ax_base *base = axut_runner_arg(r);
+	ax_pavl_r pavl_r = ax_pavl_create(ax_base_local(base), ax_stuff_traits(AX_ST_S),
+			ax_stuff_traits(AX_ST_I32));
+	char buf[16];
+	for (int32_t k = 0; k < N; k++) {
+		sprintf(buf, "%03d", k);
+		ax_map_put(pavl_r.map, buf, &k);
+	}
+
+	ax_pavl_r snap_r = { .any = ax_any_copy(pavl_r.any) };
+	for (int32_t k = 0; k < N; k += 3) {
+		sprintf(buf, "%03d", k);
+		ax_map_erase(pavl_r.map, buf);
+	}
+
+	for (int32_t k = 0; k < N; k++) {
+		sprintf(buf, "%03d", k);
+		axut_assert(r, ax_map_exist(pavl_r.map, buf) == (k % 3 != 0));
+		axut_assert(r, *(int32_t *)ax_map_get(snap_r.map, buf) == k);
+	}
+}
+
+static void clean(axut_runner *r)
+{
+	ax_base *base = axut_runner_arg(r);
+	ax_base_destroy(base);
+}
+
+axut_suite* suite_for_pavl(ax_base *base)
+{
+	axut_suite *suite = axut_suite_create(ax_base_local(base), "pavl");
+
+	axut_suite_set_arg(suite, ax_base_create());
+
+	axut_suite_add(suite, insert, 0);
+	axut_suite_add(suite, snapshot, 0);
+	axut_suite_add(suite, iter_set, 0);
+	axut_suite_add(suite, erase, 0);
+	axut_suite_add(suite, string_key, 0);
+	axut_suite_add(suite, clean, 0xFF);
+
+	return suite;
+}
@@ -0,0 +1,181 @@
+#include "axe/pqueue.h"
+#include "axe/avl.h"
+#include "axe/map.h"
+#include "axe/any.h"
+#include "axe/base.h"
+#include "axe/error.h"
+
+#include "axut.h"
+
+#include <assert.h>
+#include <setjmp.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define N 1000
+
+static void operate(axut_runner *r)
+{
+	ax_base* base = ax_base_create();
+	ax_pqueue_r pq = ax_pqueue_create(ax_base_local(base), ax_stuff_traits(AX_ST_I32));
+	axut_assert_uint_equal(r, 0, ax_tube_size(pq.tube));
+
+	srand(7);
+	int32_t count[N] = { 0 };
+	for (int i = 0; i < N * 4; i++) {
+		int32_t val = rand() % N;
+		count[val]++;
+		axut_assert(r, !ax_tube_push(pq.tube, &val));
+	}
+	axut_assert_uint_equal(r, N * 4, ax_tube_size(pq.tube));
+
+	for (int32_t val = 0; val < N; val++) {
+		while (count[val]--) {
+			axut_assert_int_equal(r, val, *(int32_t *)ax_tube_prime(pq.tube));
+			ax_tube_pop(pq.tube);
+		}
+	}
+	axut_assert_uint_equal(r, 0, ax_tube_size(pq.tube));
+
+	ax_tube_pop(pq.tube);
+	axut_assert(r, ax_base_errno(base) == AX_ERR_EMPTY);
+
+	ax_base_destroy(base);
+}
+
+static void string(axut_runner *r)
+{
+	ax_base* base = ax_base_create();
+	ax_pqueue_r pq = ax_pqueue_create(ax_base_local(base), ax_stuff_traits(AX_ST_S));
+	const char *words[] = { "pear", "apple", "fig", "plum", "cherry", "date" };
+	for (int i = 0; i < 6; i++)
+		ax_tube_push(pq.tube, words[i]);
+
+	ax_pqueue_r copy = { .any = ax_any_copy(pq.any) };
+	ax_pqueue_r moved = { .any = ax_any_move(pq.any) };
+	axut_assert_uint_equal(r, 0, ax_tube_size(pq.tube));
+
+	const char *sorted[] = { "apple", "cherry", "date", "fig", "pear", "plum" };
+	ax_tube *tubes[] = { copy.tube, moved.tube };
+	for (int t = 0; t < 2; t++) {
+		for (int i = 0; i < 6; i++) {
+			axut_assert_str_equal(r, sorted[i], ax_tube_prime(tubes[t]));
+			ax_tube_pop(tubes[t]);
+		}
+		axut_assert_uint_equal(r, 0, ax_tube_size(tubes[t]));
+	}
+
+	ax_base_destroy(base);
+}
+
+static void handle(axut_runner *r)
+{
+	ax_base* base = ax_base_create();
+	ax_pqueue_r pq = ax_pqueue_create_handled(ax_base_local(base), ax_stuff_traits(AX_ST_I32));
+
+	/* Compare against a brute force table, absent entries hold -1 */
+	int32_t key[N];
+	ax_pqueue_handle hd[N];
+	for (int i = 0; i < N; i++)
+		key[i] = -1;
+
+	srand(11);
+	for (int step = 0; step < N * 20; step++) {
+		int i = rand() % N;
+		int32_t val = rand() % (N * 10);
+		if (key[i] < 0) {
+			axut_assert(r, !ax_pqueue_push_handle(pq.pqueue, &val, hd + i));
+			key[i] = val;
+		} else if (step % 3 == 0) {
+			ax_pqueue_erase(pq.pqueue, hd[i]);
+			key[i] = -1;
+			continue;
+		} else {
+			val = key[i] - rand() % 100;
+			axut_assert(r, !ax_pqueue_update(pq.pqueue, hd[i], &val));
+			key[i] = val;
+		}
+		axut_assert_int_equal(r, key[i], *(int32_t *)ax_pqueue_get(pq.pqueue, hd[i]));
+
+		if (step % 7 == 0) {
+			int least = -1;
+			for (int j = 0; j < N; j++)
+				if (key[j] >= 0 && (least < 0 || key[j] < key[least]))
+					least = j;
+			axut_assert_int_equal(r, key[least], *(int32_t *)ax_tube_prime(pq.tube));
+			ax_pqueue_handle h = ax_pqueue_prime_handle(pq.pqueue);
+			int j = 0;
+			while (key[j] < 0 || hd[j] != h)
+				j++;
+			axut_assert_int_equal(r, key[least], key[j]);
+			ax_tube_pop(pq.tube);
+			key[j] = -1;
+		}
+	}
+
+	size_t live = 0;
+	for (int i = 0; i < N; i++)
+		live += key[i] >= 0;
+	axut_assert_uint_equal(r, live, ax_tube_size(pq.tube));
+
+	ax_pqueue_r copy = { .any = ax_any_copy(pq.any) };
+	for (int i = 0; i < N; i++)
+		if (key[i] >= 0)
+			axut_assert_int_equal(r, key[i], *(int32_t *)ax_pqueue_get(copy.pqueue, hd[i]));
+
+	ax_base_destroy(base);
+}
+
+static void bench_time(axut_runner *r)
+{
+	const int count = 200000;
+	ax_base* base = ax_base_create();
+	int32_t *keys = malloc(count * sizeof *keys);
+	for (int i = 0; i < count; i++)
+		keys[i] = i;
+	srand(3);
+	for (int i = count - 1; i > 0; i--) {
+		int j = rand() % (i + 1);
+		int32_t tmp = keys[i];
+		keys[i] = keys[j];
+		keys[j] = tmp;
+	}
+
+	ax_pqueue_r pq = ax_pqueue_create(ax_base_local(base), ax_stuff_traits(AX_ST_I32));
+	clock_t time_before = clock();
+	for (int i = 0; i < count; i++)
+		ax_tube_push(pq.tube, keys + i);
+	for (int i = 0; i < count; i++) {
+		axut_assert(r, *(int32_t *)ax_tube_prime(pq.tube) == i);
+		ax_tube_pop(pq.tube);
+	}
+	//printf("pqueue: %lfs\n", (double)(clock()-time_before) / CLOCKS_PER_SEC);
+
+	ax_avl_r avl = ax_avl_create(ax_base_local(base), ax_stuff_traits(AX_ST_I32), ax_stuff_traits(AX_ST_I32));
+	time_before = clock();
+	for (int i = 0; i < count; i++)
+		ax_map_put(avl.map, keys + i, keys + i);
+	for (int i = 0; i < count; i++) {
+		ax_iter it = ax_box_begin(avl.box);
+		axut_assert(r, *(int32_t *)ax_map_iter_key(&it) == i);
+		ax_iter_erase(&it);
+	}
+	//printf("avl: %lfs\n", (double)(clock()-time_before) / CLOCKS_PER_SEC);
+
+	free(keys);
+	ax_base_destroy(base);
+}
+
+axut_suite *suite_for_pqueue(ax_base *base)
+{
+	axut_suite *suite = axut_suite_create(ax_base_local(base), "pqueue");
+
+	axut_suite_add(suite, operate, 0);
+	axut_suite_add(suite, string, 0);
+	axut_suite_add(suite, handle, 0);
+	axut_suite_add(suite, bench_time, 0);
+
+	return suite;
+}
@@ -6,6 +6,8 @@
 #include <assert.h>
 #include <setjmp.h>
 #include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
 
 static void pred_unary(axut_runner *r)
 {
@@ -44,12 +46,149 @@ static void pred_binary(axut_runner *r)
 
 }
 
+#define BATCH_N 333
+
+/* Scalar and batch function of one member, boolean if it yields ax_bool */
+struct member
+{
+	const char *name;
+	size_t offset;
+	size_t batch_offset;
+	ax_bool boolean;
+	ax_bool unary;
+};
+
+#define MEMBER(_name, _boolean, _unary) \
+	{ #_name, offsetof(ax_operset, _name), offsetof(ax_batch_operset, _name), _boolean, _unary }
+
+static const struct member members[] = {
+	MEMBER(add, ax_false, ax_false), MEMBER(sub, ax_false, ax_false),
+	MEMBER(mul, ax_false, ax_false), MEMBER(div, ax_false, ax_false),
+	MEMBER(mod, ax_false, ax_false), MEMBER(and, ax_true, ax_false),
+	MEMBER(or, ax_true, ax_false), MEMBER(not, ax_true, ax_true),
+	MEMBER(bit_and, ax_false, ax_false), MEMBER(bit_or, ax_false, ax_false),
+	MEMBER(bit_not, ax_false, ax_true), MEMBER(bit_xor, ax_false, ax_false),
+	MEMBER(gt, ax_true, ax_false), MEMBER(ge, ax_true, ax_false),
+	MEMBER(lt, ax_true, ax_false), MEMBER(le, ax_true, ax_false),
+	MEMBER(eq, ax_true, ax_false), MEMBER(ne, ax_true, ax_false),
+};
+
+static void fill(void *arr, int type, size_t n)
+{
+	for (size_t i = 0; i < n; i++) {
+		/* Small positive values, divisors are never zero and signed division never overflows */
+		int val = rand() % 9 + 1;
+		switch (type) {
+			case AX_ST_I8: ((int8_t *)arr)[i] = val; break;
+			case AX_ST_I32: ((int32_t *)arr)[i] = val; break;
+			case AX_ST_U16: ((uint16_t *)arr)[i] = val; break;
+			case AX_ST_U64: ((uint64_t *)arr)[i] = val; break;
+			case AX_ST_F: ((float *)arr)[i] = val; break;
+			case AX_ST_LF: ((double *)arr)[i] = val; break;
+		}
+	}
+}
+
+static void pred_batch(axut_runner *r)
+{
+	const int types[] = { AX_ST_I8, AX_ST_I32, AX_ST_U16, AX_ST_U64, AX_ST_F, AX_ST_LF };
+	const size_t sizes[] = { 1, 4, 2, 8, 4, 8 };
+	uint64_t in1[BATCH_N], in2[BATCH_N], out[BATCH_N], expect[BATCH_N];
+
+	srand(47);
+	for (int t = 0; t < sizeof types / sizeof *types; t++) {
+		const ax_operset *set = ax_oper_for(types[t]);
+		const ax_batch_operset *batch_set = ax_oper_batch_for(types[t]);
+		axut_assert(r, batch_set != NULL);
+		fill(in1, types[t], BATCH_N);
+		fill(in2, types[t], BATCH_N);
+
+		for (int m = 0; m < sizeof members / sizeof *members; m++) {
+			if (members[m].unary ? !*(ax_unary_f *)((char *)set + members[m].offset)
+					: !*(ax_binary_f *)((char *)set + members[m].offset))
+				continue;
+			size_t osize = members[m].boolean ? sizeof(ax_bool) : sizes[t], found_size, found_in;
+			ax_byte *a = (ax_byte *)in1, *b = (ax_byte *)in2;
+
+			if (members[m].unary) {
+				ax_unary_f f = *(ax_unary_f *)((char *)set + members[m].offset);
+				ax_unary_batch_f bf = *(ax_unary_batch_f *)((char *)batch_set + members[m].batch_offset);
+				axut_assert(r, ax_oper_unary_batch(f, &found_in, &found_size) == bf);
+				axut_assert_uint_equal(r, sizes[t], found_in);
+				axut_assert_uint_equal(r, osize, found_size);
+
+				ax_pred pred = ax_pred_unary_make(f, NULL, NULL);
+				for (int i = 0; i < BATCH_N; i++)
+					ax_pred_do(&pred, (ax_byte *)expect + i * osize, a + i * sizes[t], NULL);
+				pred = ax_pred_unary_batch_make(f, bf, NULL, NULL);
+				ax_pred_do_n(&pred, out, a, NULL, BATCH_N);
+				axut_assert(r, memcmp(out, expect, BATCH_N * osize) == 0);
+				continue;
+			}
+
+			ax_binary_f f = *(ax_binary_f *)((char *)set + members[m].offset);
+			ax_binary_batch_f bf = *(ax_binary_batch_f *)((char *)batch_set + members[m].batch_offset);
+			axut_assert(r, ax_oper_binary_batch(f, &found_in, &found_size) == bf);
+			axut_assert_uint_equal(r, sizes[t], found_in);
+			axut_assert_uint_equal(r, osize, found_size);
+
+			/* Both inputs free, then the first bound, then the second */
+			for (int bind = 0; bind < 3; bind++) {
+				ax_pred pred = ax_pred_binary_make(f, bind == 1 ? a : NULL, bind == 2 ? b : NULL, NULL);
+				for (int i = 0; i < BATCH_N; i++) {
+					ax_byte *o = (ax_byte *)expect + i * osize;
+					if (bind == 0)
+						ax_pred_do(&pred, o, a + i * sizes[t], b + i * sizes[t]);
+					else
+						ax_pred_do(&pred, o, (bind == 1 ? b : a) + i * sizes[t], NULL);
+				}
+				pred = ax_pred_binary_batch_make(f, bf, bind == 1 ? a : NULL, bind == 2 ? b : NULL, NULL);
+				ax_pred_do_n(&pred, out, bind == 1 ? b : a, bind == 0 ? b : NULL, BATCH_N);
+				axut_assert(r, memcmp(out, expect, BATCH_N * osize) == 0);
+			}
+		}
+	}
+
+	axut_assert(r, ax_oper_binary_batch(NULL, NULL, NULL) == NULL);
+	axut_assert(r, ax_oper_batch_for(AX_ST_S) == NULL);
+}
+
+static void odd_n(void *out, const void *in, size_t n, void *arg)
+{
+	for (size_t i = 0; i < n; i++)
+		((ax_bool *)out)[i] = ((const int32_t *)in)[i] & 1;
+	(*(int *)arg)++;
+}
+
+static void odd(void *out, const void *in, void *arg)
+{
+	odd_n(out, in, 1, arg);
+}
+
+static void pred_batch_user(axut_runner *r)
+{
+	int calls = 0;
+	int32_t in[5] = { 1, 2, 3, 4, 5 };
+	ax_bool out[5];
+	ax_pred pred = ax_pred_unary_batch_make(odd, odd_n, NULL, &calls);
+	ax_pred_do_n(&pred, out, in, NULL, 5);
+	axut_assert_int_equal(r, 1, calls);
+	for (int i = 0; i < 5; i++)
+		axut_assert_int_equal(r, i % 2 == 0, out[i]);
+
+	pred = ax_pred_unary_make(odd, NULL, &calls);
+	axut_assert(r, pred.batch.u == NULL);
+	axut_assert(r, ax_oper_unary_batch(odd, NULL, NULL) == NULL);
+}
+
 axut_suite *suite_for_pred(ax_base *base)
 {
 	axut_suite *suite = axut_suite_create(ax_base_local(base), "pred");
 
 	axut_suite_add(suite, pred_unary, 0);
 	axut_suite_add(suite, pred_binary, 0);
+	axut_suite_add(suite, pred_batch, 0);
+	axut_suite_add(suite, pred_batch_user, 0);
 
 	return suite;
 }
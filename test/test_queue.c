@@ -1,4 +1,8 @@
 #include "axe/queue.h"
+#include "axe/list.h"
+#include "axe/deque.h"
+#include "axe/any.h"
+#include "axe/error.h"
 
 #include "axut.h"
 
@@ -7,6 +11,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <time.h>
 
 static void create(axut_runner *r)
 {
@@ -39,6 +44,120 @@ static void operate(axut_runner *r)
 	axut_assert_uint_equal(r, 0, ax_tube_size(queue.tube));
 }
 
+static void wrap_grow(axut_runner *r)
+{
+	ax_base* base = ax_base_create();
+	ax_queue_r queue = ax_queue_create(ax_base_local(base), ax_stuff_traits(AX_ST_I32));
+
+	int32_t in = 0, out = 0;
+	for (int round = 0; round < 10; round++) {
+		for (int i = 0; i < 5 + round * 3; i++, in++)
+			ax_tube_push(queue.tube, &in);
+		for (int i = 0; i < 4 + round * 2; i++, out++) {
+			axut_assert_int_equal(r, out, *(int32_t *)ax_tube_prime(queue.tube));
+			ax_tube_pop(queue.tube);
+		}
+	}
+	axut_assert_uint_equal(r, in - out, ax_tube_size(queue.tube));
+	axut_assert(r, ax_queue_capacity(queue.queue) >= ax_tube_size(queue.tube));
+	for (; out < in; out++) {
+		axut_assert_int_equal(r, out, *(int32_t *)ax_tube_prime(queue.tube));
+		ax_tube_pop(queue.tube);
+	}
+	axut_assert_uint_equal(r, 0, ax_tube_size(queue.tube));
+
+	axut_assert(r, !ax_queue_reserve(queue.queue, 1000));
+	axut_assert(r, ax_queue_capacity(queue.queue) == 1024);
+
+	ax_base_destroy(base);
+}
+
+static void fixed(axut_runner *r)
+{
+	ax_base* base = ax_base_create();
+	ax_queue_r queue = ax_queue_create_fixed(ax_base_local(base), ax_stuff_traits(AX_ST_I32), 5, ax_false);
+	axut_assert_uint_equal(r, 5, ax_queue_capacity(queue.queue));
+
+	for (int32_t i = 0; i < 5; i++)
+		axut_assert(r, !ax_tube_push(queue.tube, &i));
+	int32_t val = 5;
+	axut_assert(r, ax_tube_push(queue.tube, &val));
+	axut_assert(r, ax_base_errno(base) == AX_ERR_FULL);
+	axut_assert_uint_equal(r, 5, ax_tube_size(queue.tube));
+	axut_assert_int_equal(r, 0, *(int32_t *)ax_tube_prime(queue.tube));
+
+	ax_tube_pop(queue.tube);
+	axut_assert(r, !ax_tube_push(queue.tube, &val));
+	for (int32_t i = 1; i <= 5; i++) {
+		axut_assert_int_equal(r, i, *(int32_t *)ax_tube_prime(queue.tube));
+		ax_tube_pop(queue.tube);
+	}
+
+	ax_base_destroy(base);
+}
+
+static void overwrite(axut_runner *r)
+{
+	ax_base* base = ax_base_create();
+	ax_queue_r queue = ax_queue_create_fixed(ax_base_local(base), ax_stuff_traits(AX_ST_S), 3, ax_true);
+	char buf[16];
+	for (int i = 0; i < 10; i++) {
+		sprintf(buf, "%d", i);
+		axut_assert(r, !ax_tube_push(queue.tube, buf));
+	}
+	axut_assert_uint_equal(r, 3, ax_tube_size(queue.tube));
+
+	ax_queue_r copy = { .any = ax_any_copy(queue.any) };
+	ax_queue_r moved = { .any = ax_any_move(queue.any) };
+	axut_assert_uint_equal(r, 0, ax_tube_size(queue.tube));
+	axut_assert_uint_equal(r, 3, ax_queue_capacity(queue.queue));
+
+	ax_tube *tubes[] = { copy.tube, moved.tube };
+	for (int t = 0; t < 2; t++) {
+		for (int i = 7; i < 10; i++) {
+			sprintf(buf, "%d", i);
+			axut_assert_str_equal(r, buf, ax_tube_prime(tubes[t]));
+			ax_tube_pop(tubes[t]);
+		}
+		axut_assert_uint_equal(r, 0, ax_tube_size(tubes[t]));
+	}
+
+	ax_base_destroy(base);
+}
+
+static void bench_time(axut_runner *r)
+{
+	const int count = 1000000, window = 64;
+	ax_base* base = ax_base_create();
+	ax_queue_r queue = ax_queue_create(ax_base_local(base), ax_stuff_traits(AX_ST_I64));
+
+	clock_t time_before = clock();
+	for (int64_t i = 0; i < count; i++) {
+		ax_tube_push(queue.tube, &i);
+		if (i >= window)
+			ax_tube_pop(queue.tube);
+	}
+	//printf("ring fifo: %lfs\n", (double)(clock()-time_before) / CLOCKS_PER_SEC);
+	axut_assert_uint_equal(r, window, ax_tube_size(queue.tube));
+
+	ax_seq *seqs[] = {
+		ax_deque_create(ax_base_local(base), ax_stuff_traits(AX_ST_I64)).seq,
+		ax_list_create(ax_base_local(base), ax_stuff_traits(AX_ST_I64)).seq,
+	};
+	for (int s = 0; s < 2; s++) {
+		time_before = clock();
+		for (int64_t i = 0; i < count; i++) {
+			ax_seq_push(seqs[s], &i);
+			if (i >= window)
+				ax_seq_popf(seqs[s]);
+		}
+		//printf("%s fifo: %lfs\n", s ? "list" : "deque", (double)(clock()-time_before) / CLOCKS_PER_SEC);
+		axut_assert(r, ax_box_size(ax_r(seq, seqs[s]).box) == window);
+	}
+
+	ax_base_destroy(base);
+}
+
 static void clean(axut_runner *r)
 {
 	ax_base *base = axut_runner_arg(r);
@@ -54,6 +173,10 @@ axut_suite *suite_for_queue(ax_base *base)
 
 	axut_suite_add(suite, create, 0);
 	axut_suite_add(suite, operate, 1);
+	axut_suite_add(suite, wrap_grow, 1);
+	axut_suite_add(suite, fixed, 1);
+	axut_suite_add(suite, overwrite, 1);
+	axut_suite_add(suite, bench_time, 1);
 
 	axut_suite_add(suite, clean, 0xFF);
 	return suite;
@@ -0,0 +1,176 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "axe/spsc.h"
+#include "axe/base.h"
+#include "axe/error.h"
+
+#include "axut.h"
+
+#include <assert.h>
+#include <setjmp.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <pthread.h>
+
+struct transfer
+{
+	ax_spsc *in, *out;
+	int64_t count;
+	int64_t batch;
+	ax_bool bad;
+};
+
+static double wall_time(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void *producer(void *arg)
+{
+	struct transfer *t = arg;
+	int64_t buf[64];
+	for (int64_t i = 0; i < t->count; ) {
+		if (t->batch == 1) {
+			ax_spsc_push_wait(t->out, &i);
+			i++;
+			continue;
+		}
+		int64_t n = t->count - i < t->batch ? t->count - i : t->batch;
+		for (int64_t j = 0; j < n; j++)
+			buf[j] = i + j;
+		int64_t done = ax_spsc_push_n(t->out, buf, n);
+		if (!done) {
+			ax_spsc_push_wait(t->out, &i);
+			done = 1;
+		}
+		i += done;
+	}
+	return NULL;
+}
+
+static void *consumer(void *arg)
+{
+	struct transfer *t = arg;
+	int64_t buf[64], expect = 0;
+	while (expect < t->count) {
+		int64_t n = t->batch == 1 ? 0 : ax_spsc_pop_n(t->in, buf, t->batch);
+		if (!n) {
+			ax_spsc_pop_wait(t->in, buf);
+			n = 1;
+		}
+		for (int64_t j = 0; j < n; j++)
+			if (buf[j] != expect++)
+				t->bad = ax_true;
+	}
+	return NULL;
+}
+
+static void *echo(void *arg)
+{
+	struct transfer *t = arg;
+	int64_t val;
+	for (int64_t i = 0; i < t->count; i++) {
+		ax_spsc_pop_wait(t->in, &val);
+		ax_spsc_push_wait(t->out, &val);
+	}
+	return NULL;
+}
+
+static void operate(axut_runner *r)
+{
+	ax_base* base = ax_base_create();
+	ax_spsc_r spsc = ax_spsc_create(ax_base_local(base), ax_stuff_traits(AX_ST_I32), 5);
+	axut_assert_uint_equal(r, 8, ax_spsc_capacity(spsc.spsc));
+	axut_assert(r, ax_tube_prime(spsc.tube) == NULL);
+
+	int32_t val;
+	axut_assert(r, ax_spsc_try_pop(spsc.spsc, &val));
+	for (int32_t i = 0; i < 8; i++)
+		axut_assert(r, !ax_spsc_try_push(spsc.spsc, &i));
+	axut_assert(r, ax_spsc_try_push(spsc.spsc, &val));
+	axut_assert_uint_equal(r, 8, ax_tube_size(spsc.tube));
+
+	axut_assert_int_equal(r, 0, *(int32_t *)ax_tube_prime(spsc.tube));
+	ax_tube_pop(spsc.tube);
+	axut_assert(r, !ax_spsc_try_pop(spsc.spsc, &val));
+	axut_assert_int_equal(r, 1, val);
+
+	int32_t arr[8] = { 8, 9, 10, 11, 12 }, out[8];
+	axut_assert_uint_equal(r, 2, ax_spsc_push_n(spsc.spsc, arr, 5));
+	axut_assert_uint_equal(r, 8, ax_spsc_pop_n(spsc.spsc, out, 8));
+	for (int32_t i = 0; i < 8; i++)
+		axut_assert_int_equal(r, i + 2, out[i]);
+	axut_assert_uint_equal(r, 0, ax_spsc_pop_n(spsc.spsc, out, 8));
+
+	ax_base_destroy(base);
+}
+
+static void threads(axut_runner *r)
+{
+	ax_base* base = ax_base_create();
+	ax_spsc_r spsc = ax_spsc_create(ax_base_local(base), ax_stuff_traits(AX_ST_I64), 64);
+
+	for (int batch = 1; batch <= 16; batch += 15) {
+		struct transfer t = { .in = spsc.spsc, .out = spsc.spsc, .count = 100000, .batch = batch };
+		pthread_t prod, cons;
+		pthread_create(&cons, NULL, consumer, &t);
+		pthread_create(&prod, NULL, producer, &t);
+		pthread_join(prod, NULL);
+		pthread_join(cons, NULL);
+		axut_assert(r, !t.bad);
+		axut_assert_uint_equal(r, 0, ax_tube_size(spsc.tube));
+	}
+
+	ax_base_destroy(base);
+}
+
+static void bench_time(axut_runner *r)
+{
+	const int64_t count = 1000000;
+	ax_base* base = ax_base_create();
+	ax_spsc_r spsc = ax_spsc_create(ax_base_local(base), ax_stuff_traits(AX_ST_I64), 1024);
+
+	for (int batch = 1; batch <= 64; batch *= 8) {
+		struct transfer t = { .in = spsc.spsc, .out = spsc.spsc, .count = count, .batch = batch };
+		pthread_t prod, cons;
+		double time_before = wall_time();
+		pthread_create(&cons, NULL, consumer, &t);
+		pthread_create(&prod, NULL, producer, &t);
+		pthread_join(prod, NULL);
+		pthread_join(cons, NULL);
+		//printf("spsc batch %d: %.1lf Mops/s\n", batch, count / (wall_time() - time_before) / 1e6);
+		axut_assert(r, !t.bad);
+	}
+
+	ax_spsc_r back = ax_spsc_create(ax_base_local(base), ax_stuff_traits(AX_ST_I64), 2);
+	struct transfer t = { .in = spsc.spsc, .out = back.spsc, .count = 20000 };
+	pthread_t peer;
+	pthread_create(&peer, NULL, echo, &t);
+	double time_before = wall_time();
+	for (int64_t i = 0; i < t.count; i++) {
+		int64_t val;
+		ax_spsc_push_wait(spsc.spsc, &i);
+		ax_spsc_pop_wait(back.spsc, &val);
+		axut_assert(r, val == i);
+	}
+	//printf("spsc round trip: %.2lfus\n", (wall_time() - time_before) / t.count * 1e6);
+	pthread_join(peer, NULL);
+
+	ax_base_destroy(base);
+}
+
+axut_suite *suite_for_spsc(ax_base *base)
+{
+	axut_suite *suite = axut_suite_create(ax_base_local(base), "spsc");
+
+	axut_suite_add(suite, operate, 0);
+	axut_suite_add(suite, threads, 0);
+	axut_suite_add(suite, bench_time, 0);
+
+	return suite;
+}
@@ -1,6 +1,7 @@
 #include "axe/iter.h"
 #include "axe/string.h"
 #include "axe/seq.h"
+#include "axe/vector.h"
 #include "axe/base.h"
 
 #include "axut.h"
@@ -54,6 +55,143 @@ static void split(axut_runner *r)
 
 }
 
+static void spill(axut_runner *r)
+{
+	ax_base *base = axut_runner_arg(r);
+	ax_string_r str_r = ax_string_create(ax_base_local(base));
+	char expect[256] = "";
+
+	ax_str_append(str_r.str, "short");
+	strcat(expect, "short");
+	ax_string_r copy_r = { .any = ax_any_copy(str_r.any) };
+	axut_assert(r, strcmp(ax_str_strz(copy_r.str), "short") == 0);
+
+	for (int i = 0; i < 20; i++) {
+		ax_str_append(str_r.str, "0123456789");
+		strcat(expect, "0123456789");
+		axut_assert(r, strcmp(ax_str_strz(str_r.str), expect) == 0);
+	}
+	axut_assert(r, strcmp(ax_str_strz(copy_r.str), "short") == 0);
+
+	copy_r.any = ax_any_copy(str_r.any);
+	axut_assert(r, strcmp(ax_str_strz(copy_r.str), expect) == 0);
+	ax_string_r moved_r = { .any = ax_any_move(str_r.any) };
+	axut_assert(r, strcmp(ax_str_strz(moved_r.str), expect) == 0);
+	axut_assert(r, ax_str_length(str_r.str) == 0);
+	ax_str_append(str_r.str, "again");
+	axut_assert(r, strcmp(ax_str_strz(str_r.str), "again") == 0);
+	axut_assert(r, strcmp(ax_str_strz(moved_r.str), expect) == 0);
+}
+
+static void riter_erase(axut_runner *r)
+{
+	ax_base *base = axut_runner_arg(r);
+	ax_string_r str_r = ax_string_create(ax_base_local(base));
+	ax_str_append(str_r.str, "abcdef");
+
+	char buf[8];
+	int i = 0;
+	ax_iter it = ax_box_rbegin(str_r.box), end = ax_box_rend(str_r.box);
+	for (; !ax_iter_equal(&it, &end); ax_iter_next(&it))
+		buf[i++] = *(char *)ax_iter_get(&it);
+	buf[i] = '\0';
+	axut_assert_str_equal(r, "fedcba", buf);
+
+	it = ax_box_rbegin(str_r.box);
+	ax_iter_move(&it, 2);
+	axut_assert_int_equal(r, 'd', *(char *)ax_iter_get(&it));
+	ax_iter_erase(&it);
+	axut_assert_str_equal(r, "abcef", ax_str_strz(str_r.str));
+	axut_assert_int_equal(r, 'c', *(char *)ax_iter_get(&it));
+
+	it = ax_seq_at(str_r.seq, 1);
+	ax_iter_erase(&it);
+	axut_assert_str_equal(r, "acef", ax_str_strz(str_r.str));
+	axut_assert_int_equal(r, 'c', *(char *)ax_iter_get(&it));
+	axut_assert_uint_equal(r, 4, ax_str_length(str_r.str));
+}
+
+static void seq_range(axut_runner *r)
+{
+	ax_base *base = axut_runner_arg(r);
+	ax_string_r str_r = ax_string_create(ax_base_local(base));
+	ax_str_append(str_r.str, "hello");
+
+	ax_iter it = ax_seq_at(str_r.seq, 2);
+	axut_assert(r, !ax_seq_insert_arr(str_r.seq, &it, "XY", 2));
+	axut_assert_str_equal(r, "heXYllo", ax_str_strz(str_r.str));
+	axut_assert_int_equal(r, 'l', *(char *)ax_iter_get(&it));
+
+	/* NUL chars of the source are skipped, the terminator stays in place */
+	ax_vector_r src_r = ax_vector_create(ax_base_local(base), ax_stuff_traits(AX_ST_I8));
+	axut_assert(r, !ax_seq_append_arr(src_r.seq, "a\0bc", 4));
+	ax_iter first = ax_box_begin(src_r.box), last = ax_box_end(src_r.box);
+	axut_assert(r, !ax_seq_append_range(str_r.seq, ax_iter_c(&first), ax_iter_c(&last)));
+	axut_assert_str_equal(r, "heXYlloabc", ax_str_strz(str_r.str));
+	axut_assert_uint_equal(r, 10, ax_str_length(str_r.str));
+
+	it = ax_box_rend(str_r.box);
+	axut_assert(r, !ax_seq_insert_range(str_r.seq, &it, ax_iter_c(&first), ax_iter_c(&last)));
+	axut_assert_str_equal(r, "cbaheXYlloabc", ax_str_strz(str_r.str));
+
+	first = ax_seq_at(str_r.seq, 3);
+	last = ax_seq_at(str_r.seq, 7);
+	axut_assert(r, !ax_seq_erase_range(str_r.seq, &first, &last));
+	axut_assert_str_equal(r, "cballoabc", ax_str_strz(str_r.str));
+	axut_assert_int_equal(r, 'l', *(char *)ax_iter_get(&first));
+	axut_assert(r, ax_iter_equal(&first, &last));
+
+	first = ax_box_rbegin(str_r.box);
+	last = ax_box_rbegin(str_r.box);
+	ax_iter_move(&last, 3);
+	axut_assert(r, !ax_seq_erase_range(str_r.seq, &first, &last));
+	axut_assert_str_equal(r, "cballo", ax_str_strz(str_r.str));
+	axut_assert_int_equal(r, 'o', *(char *)ax_iter_get(&first));
+
+	/* Random edits across the inline storage limit, against a plain array */
+	char ref[1024], buf[128];
+	int n = 6;
+	strcpy(ref, "cballo");
+	srand(31);
+	for (int step = 0; step < 300; step++) {
+		int pos = rand() % (n + 1), len = rand() % 100;
+		ax_bool norm = rand() % 2;
+		if (n + len >= (int)sizeof ref || (step % 3 == 0 && n)) {
+			len = rand() % (n - pos + 1);
+			first = ax_seq_at(str_r.seq, pos);
+			last = ax_seq_at(str_r.seq, pos + len);
+			if (!norm) {
+				first = ax_box_rbegin(str_r.box), last = ax_box_rbegin(str_r.box);
+				ax_iter_move(&first, n - pos - len);
+				ax_iter_move(&last, n - pos);
+			}
+			axut_assert(r, !ax_seq_erase_range(str_r.seq, &first, &last));
+			memmove(ref + pos, ref + pos + len, n - pos - len + 1);
+			n -= len;
+		} else {
+			for (int i = 0; i < len; i++)
+				buf[i] = 'a' + (step + i) % 26;
+			if (norm)
+				it = ax_seq_at(str_r.seq, pos);
+			else {
+				it = ax_box_rbegin(str_r.box);
+				ax_iter_move(&it, n - pos);
+			}
+			axut_assert(r, !ax_seq_insert_arr(str_r.seq, &it, buf, len));
+			memmove(ref + pos + len, ref + pos, n - pos + 1);
+			for (int i = 0; i < len; i++)
+				ref[pos + i] = norm ? buf[i] : buf[len - 1 - i];
+			n += len;
+			if (norm && pos + len < n)
+				axut_assert_int_equal(r, ref[pos + len], *(char *)ax_iter_get(&it));
+			if (!norm && pos > 0)
+				axut_assert_int_equal(r, ref[pos - 1], *(char *)ax_iter_get(&it));
+		}
+		axut_assert_str_equal(r, ref, ax_str_strz(str_r.str));
+		axut_assert_uint_equal(r, n, ax_str_length(str_r.str));
+	}
+}
+
 static void cleanup(axut_runner *r)
 {
 	ax_base *base = axut_runner_arg(r);
@@ -70,6 +208,9 @@ axut_suite *suite_for_string(ax_base *base)
 	axut_suite_add(suite, create, 0);
 	axut_suite_add(suite, append, 0);
 	axut_suite_add(suite, split, 0);
+	axut_suite_add(suite, spill, 0);
+	axut_suite_add(suite, riter_erase, 0);
+	axut_suite_add(suite, seq_range, 0);
 	axut_suite_add(suite, cleanup, 0xFF);
 
 	return suite;
@@ -0,0 +1,391 @@
+#include "assist.h"
+
+#include "axe/ulist.h"
+#include "axe/list.h"
+#include "axe/algo.h"
+#include "axe/base.h"
+
+#include "axut.h"
+
+#include <assert.h>
+#include <setjmp.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+static void create(axut_runner *r)
+{
+	ax_base* base = ax_base_create();
+	ax_ulist_r ul_r = ax_ulist_create(ax_base_local(base), ax_stuff_traits(AX_ST_I32));
+	axut_assert(r, ul_r.any != NULL);
+	axut_assert(r, ax_box_size(ul_r.box) == 0);
+	axut_assert_uint_equal(r, 0, ax_ulist_footprint(ul_r.ulist));
+
+	ul_r = ax_ulist_init(ax_base_local(base), "i32x3", 1, 2, 3);
+	int32_t table[] = {1, 2, 3};
+	axut_assert(r, seq_equal_array(ul_r.seq, table, sizeof table));
+
+	ax_base_destroy(base);
+}
+
+static void push_pop(axut_runner *r)
+{
+	ax_base* base = ax_base_create();
+	ax_ulist_r ul_r = ax_ulist_create(ax_base_local(base), ax_stuff_traits(AX_ST_I32));
+	const int count = 5000;
+
+	for (int i = 0; i < count; i++) {
+		int v = -i - 1;
+		ax_seq_push(ul_r.seq, &i);
+		ax_seq_pushf(ul_r.seq, &v);
+	}
+	axut_assert(r, ax_box_size(ul_r.box) == 2 * count);
+	for (int i = 0; i < 2 * count; i += 7) {
+		ax_iter it = ax_seq_at(ul_r.seq, i);
+		axut_assert(r, *(int32_t *)ax_iter_get(&it) == i - count);
+	}
+	axut_assert(r, *(int32_t *)ax_seq_first(ul_r.seq) == -count);
+	axut_assert(r, *(int32_t *)ax_seq_last(ul_r.seq) == count - 1);
+
+	for (int i = 0; i < count; i++) {
+		axut_assert(r, *(int32_t *)ax_seq_first(ul_r.seq) == i - count);
+		ax_seq_popf(ul_r.seq);
+		axut_assert(r, *(int32_t *)ax_seq_last(ul_r.seq) == count - i - 1);
+		ax_seq_pop(ul_r.seq);
+	}
+	axut_assert(r, ax_box_size(ul_r.box) == 0);
+	axut_assert_uint_equal(r, 0, ax_ulist_footprint(ul_r.ulist));
+
+	ax_base_destroy(base);
+}
+
+static void iter(axut_runner *r)
+{
+	ax_base* base = ax_base_create();
+	ax_ulist_r ul_r = ax_ulist_create(ax_base_local(base), ax_stuff_traits(AX_ST_I32));
+	for (int i = 0; i < 300; i++)
+		ax_seq_pushf(ul_r.seq, &i);
+	ax_seq_invert(ul_r.seq);
+
+	int i = 0;
+	ax_box_cforeach(ul_r.box, const int32_t *, v)
+		axut_assert(r, *v == i++);
+	axut_assert(r, i == 300);
+
+	ax_iter cur = ax_box_rbegin(ul_r.box), last = ax_box_rend(ul_r.box);
+	while (!ax_iter_equal(&cur, &last)) {
+		axut_assert(r, *(int32_t *)ax_iter_get(&cur) == --i);
+		ax_iter_next(&cur);
+	}
+	axut_assert(r, i == 0);
+
+	ax_iter first = ax_box_begin(ul_r.box), end = ax_box_end(ul_r.box);
+	axut_assert(r, ax_iter_dist(&first, &end) == 300);
+	ax_iter_move(&first, 150);
+	axut_assert(r, *(int32_t *)ax_iter_get(&first) == 150);
+	axut_assert(r, ax_iter_less(&first, &end));
+	ax_iter_prev(&end);
+	axut_assert(r, *(int32_t *)ax_iter_get(&end) == 299);
+
+	ax_base_destroy(base);
+}
+
+static void insert_erase(axut_runner *r)
+{
+	int ins;
+	ax_base* base = ax_base_create();
+	ax_ulist_r ul_r = ax_ulist_init(ax_base_local(base), "i32x2", 1, 2);
+
+	ax_iter it = ax_box_begin(ul_r.box);
+	ins = 3;
+	ax_seq_insert(ul_r.seq, &it, &ins);
+	ins = 4;
+	ax_seq_insert(ul_r.seq, &it, &ins);
+	it = ax_box_end(ul_r.box);
+	ins = 5;
+	ax_seq_insert(ul_r.seq, &it, &ins);
+	int32_t table1[] = {3, 4, 1, 2, 5};
+	axut_assert(r, seq_equal_array(ul_r.seq, table1, sizeof table1));
+
+	it = ax_box_rbegin(ul_r.box);
+	ins = 6;
+	ax_seq_insert(ul_r.seq, &it, &ins);
+	it = ax_box_rend(ul_r.box);
+	ins = 7;
+	ax_seq_insert(ul_r.seq, &it, &ins);
+	int32_t table2[] = {7, 3, 4, 1, 2, 5, 6};
+	axut_assert(r, seq_equal_array(ul_r.seq, table2, sizeof table2));
+
+	it = ax_seq_at(ul_r.seq, 1);
+	ax_iter_erase(&it);
+	axut_assert(r, *(int32_t *)ax_iter_get(&it) == 4);
+	it = ax_seq_at(ul_r.seq, 4);
+	ax_iter_erase(&it);
+	axut_assert(r, *(int32_t *)ax_iter_get(&it) == 6);
+	int32_t table3[] = {7, 4, 1, 2, 6};
+	axut_assert(r, seq_equal_array(ul_r.seq, table3, sizeof table3));
+
+	ax_seq_trunc(ul_r.seq, 2);
+	int32_t table4[] = {7, 4};
+	axut_assert(r, seq_equal_array(ul_r.seq, table4, sizeof table4));
+	ax_seq_trunc(ul_r.seq, 3);
+	int32_t table5[] = {7, 4, 0};
+	axut_assert(r, seq_equal_array(ul_r.seq, table5, sizeof table5));
+
+	ax_base_destroy(base);
+}
+
+/* Splits and merges of nodes checked against a plain array */
+static void random_edit(axut_runner *r)
+{
+	const int count = 4000;
+	ax_base* base = ax_base_create();
+	ax_ulist_r ul_r = ax_ulist_create(ax_base_local(base), ax_stuff_traits(AX_ST_I32));
+	int32_t *ref = malloc(count * 2 * sizeof *ref);
+	int size = 0;
+
+	srand(5);
+	for (int step = 0; step < count * 4; step++) {
+		int pos = rand() % (size + 1);
+		ax_bool norm = rand() % 2;
+		ax_iter it = norm
+			? ax_seq_at(ul_r.seq, pos)
+			: (pos == 0 ? ax_box_rend(ul_r.box) : ax_box_rbegin(ul_r.box));
+		if (!norm && pos)
+			ax_iter_move(&it, size - pos);
+
+		/* A reverse iterator at pos stands for the element before pos */
+		if (size < count && (size == 0 || rand() % 3)) {
+			int32_t val = step;
+			ax_seq_insert(ul_r.seq, &it, &val);
+			memmove(ref + pos + 1, ref + pos, (size - pos) * sizeof *ref);
+			ref[pos] = val;
+			size++;
+			if (norm && pos + 1 < size)
+				axut_assert_int_equal(r, ref[pos + 1], *(int32_t *)ax_iter_get(&it));
+			if (!norm && pos > 0)
+				axut_assert_int_equal(r, ref[pos - 1], *(int32_t *)ax_iter_get(&it));
+		} else if (size && (norm ? pos < size : pos > 0)) {
+			int at = norm ? pos : pos - 1;
+			ax_iter_erase(&it);
+			memmove(ref + at, ref + at + 1, (size - at - 1) * sizeof *ref);
+			size--;
+			if (norm && at < size)
+				axut_assert_int_equal(r, ref[at], *(int32_t *)ax_iter_get(&it));
+			if (!norm && at > 0)
+				axut_assert_int_equal(r, ref[at - 1], *(int32_t *)ax_iter_get(&it));
+		}
+
+		if (step % 97 == 0)
+			axut_assert(r, seq_equal_array(ul_r.seq, ref, size * sizeof *ref));
+	}
+	axut_assert(r, seq_equal_array(ul_r.seq, ref, size * sizeof *ref));
+
+	free(ref);
+	ax_base_destroy(base);
+}
+
+static void range(axut_runner *r)
+{
+	ax_base* base = ax_base_create();
+	ax_ulist_r ul_r = ax_ulist_init(ax_base_local(base), "i32x2", 1, 2);
+	ax_list_r src_r = ax_list_init(ax_base_local(base), "i32x3", 7, 8, 9);
+
+	int32_t arr[] = {3, 4};
+	ax_iter it = ax_box_begin(ul_r.box);
+	ax_iter_next(&it);
+	axut_assert(r, !ax_seq_insert_arr(ul_r.seq, &it, arr, 2));
+	int32_t table1[] = {1, 3, 4, 2};
+	axut_assert(r, seq_equal_array(ul_r.seq, table1, sizeof table1));
+	axut_assert(r, *(int32_t *)ax_iter_get(&it) == 2);
+
+	ax_iter first = ax_box_begin(src_r.box), last = ax_box_end(src_r.box);
+	axut_assert(r, !ax_seq_append_range(ul_r.seq, ax_iter_c(&first), ax_iter_c(&last)));
+	int32_t table2[] = {1, 3, 4, 2, 7, 8, 9};
+	axut_assert(r, seq_equal_array(ul_r.seq, table2, sizeof table2));
+
+	it = ax_box_rend(ul_r.box);
+	axut_assert(r, !ax_seq_insert_range(ul_r.seq, &it, ax_iter_c(&first), ax_iter_c(&last)));
+	int32_t table3[] = {9, 8, 7, 1, 3, 4, 2, 7, 8, 9};
+	axut_assert(r, seq_equal_array(ul_r.seq, table3, sizeof table3));
+	axut_assert(r, it.point == NULL);
+
+	first = ax_seq_at(ul_r.seq, 2);
+	last = ax_seq_at(ul_r.seq, 5);
+	axut_assert(r, !ax_seq_erase_range(ul_r.seq, &first, &last));
+	int32_t table4[] = {9, 8, 4, 2, 7, 8, 9};
+	axut_assert(r, seq_equal_array(ul_r.seq, table4, sizeof table4));
+	axut_assert(r, *(int32_t *)ax_iter_get(&first) == 4);
+	axut_assert(r, ax_iter_equal(&first, &last));
+
+	first = ax_box_rbegin(ul_r.box);
+	last = ax_box_rbegin(ul_r.box);
+	ax_iter_move(&last, 2);
+	axut_assert(r, !ax_seq_erase_range(ul_r.seq, &first, &last));
+	int32_t table5[] = {9, 8, 4, 2, 7};
+	axut_assert(r, seq_equal_array(ul_r.seq, table5, sizeof table5));
+	axut_assert(r, *(int32_t *)ax_iter_get(&first) == 7);
+
+	/* Random ranges spanning many nodes, mixed with single edits, against a plain array */
+	const int max = 3000;
+	int32_t *ref = malloc(max * 2 * sizeof *ref), *buf = malloc(max * sizeof *buf);
+	int n = 0;
+	ax_box_clear(ul_r.box);
+	srand(38);
+	for (int step = 0; step < 600; step++) {
+		int pos = rand() % (n + 1), len = rand() % 400;
+		ax_bool norm = rand() % 2;
+		if (n + len > max || (step % 3 == 0 && n)) {
+			len = rand() % (n - pos + 1);
+			first = ax_seq_at(ul_r.seq, pos);
+			last = ax_seq_at(ul_r.seq, pos + len);
+			if (!norm) {
+				first = ax_box_rbegin(ul_r.box), last = ax_box_rbegin(ul_r.box);
+				ax_iter_move(&first, n - pos - len);
+				ax_iter_move(&last, n - pos);
+			}
+			axut_assert(r, !ax_seq_erase_range(ul_r.seq, &first, &last));
+			memmove(ref + pos, ref + pos + len, (n - pos - len) * sizeof *ref);
+			n -= len;
+			it = ax_iter_norm(&first) ? ax_box_begin(ul_r.box) : ax_box_rbegin(ul_r.box);
+			axut_assert_int_equal(r, norm ? pos : n - pos, ax_iter_dist(&it, &first));
+		} else if (step % 5 == 1) {
+			int32_t val = -step;
+			it = ax_seq_at(ul_r.seq, pos);
+			ax_seq_insert(ul_r.seq, &it, &val);
+			memmove(ref + pos + 1, ref + pos, (n - pos) * sizeof *ref);
+			ref[pos] = val;
+			n++;
+		} else {
+			for (int i = 0; i < len; i++)
+				buf[i] = step * 1000 + i;
+			if (norm)
+				it = ax_seq_at(ul_r.seq, pos);
+			else {
+				it = ax_box_rbegin(ul_r.box);
+				ax_iter_move(&it, n - pos);
+			}
+			axut_assert(r, !ax_seq_insert_arr(ul_r.seq, &it, buf, len));
+			memmove(ref + pos + len, ref + pos, (n - pos) * sizeof *ref);
+			for (int i = 0; i < len; i++)
+				ref[pos + i] = norm ? buf[i] : buf[len - 1 - i];
+			n += len;
+			if (norm && pos + len < n)
+				axut_assert_int_equal(r, ref[pos + len], *(int32_t *)ax_iter_get(&it));
+			if (!norm && pos > 0)
+				axut_assert_int_equal(r, ref[pos - 1], *(int32_t *)ax_iter_get(&it));
+		}
+		axut_assert(r, seq_equal_array(ul_r.seq, ref, n * sizeof *ref));
+	}
+	free(ref);
+	free(buf);
+
+	ax_ulist_r str_r = ax_ulist_create(ax_base_local(base), ax_stuff_traits(AX_ST_S));
+	ax_list_r strsrc_r = ax_list_create(ax_base_local(base), ax_stuff_traits(AX_ST_S));
+	const char *strs[] = {"a", "b", "c", "d"};
+	axut_assert(r, !ax_seq_append_arr(str_r.seq, strs, 4));
+	axut_assert(r, !ax_seq_append_arr(strsrc_r.seq, strs + 2, 2));
+	first = ax_seq_at(str_r.seq, 1);
+	last = ax_seq_at(str_r.seq, 3);
+	axut_assert(r, !ax_seq_erase_range(str_r.seq, &first, &last));
+	axut_assert(r, !ax_seq_insert_arr(str_r.seq, &first, strs, 1));
+	first = ax_box_begin(strsrc_r.box);
+	last = ax_box_end(strsrc_r.box);
+	axut_assert(r, !ax_seq_append_range(str_r.seq, ax_iter_c(&first), ax_iter_c(&last)));
+	int i = 0;
+	const char *expect[] = {"a", "a", "d", "c", "d"};
+	ax_box_cforeach(str_r.box, const char *, s)
+		axut_assert_str_equal(r, expect[i++], s);
+	axut_assert_int_equal(r, 5, i);
+
+	ax_base_destroy(base);
+}
+
+static void any_copy_move(axut_runner *r)
+{
+	ax_base* base = ax_base_create();
+	ax_ulist_r ul_r = ax_ulist_create(ax_base_local(base), ax_stuff_traits(AX_ST_S));
+	char buf[16];
+	for (int i = 0; i < 1000; i++) {
+		sprintf(buf, "%d", i);
+		ax_seq_push(ul_r.seq, buf);
+	}
+
+	ax_ulist_r copy_r = { .any = ax_any_copy(ul_r.any) };
+	ax_box_clear(ul_r.box);
+	axut_assert(r, ax_box_size(copy_r.box) == 1000);
+	int i = 0;
+	ax_box_cforeach(copy_r.box, const char *, s) {
+		sprintf(buf, "%d", i++);
+		axut_assert_str_equal(r, buf, s);
+	}
+
+	ax_ulist_r moved_r = { .any = ax_any_move(copy_r.any) };
+	axut_assert(r, ax_box_size(copy_r.box) == 0);
+	axut_assert(r, ax_box_size(moved_r.box) == 1000);
+	axut_assert_str_equal(r, "999", ax_seq_last(moved_r.seq));
+	ax_seq_push(copy_r.seq, "again");
+	axut_assert_str_equal(r, "again", ax_seq_first(copy_r.seq));
+
+	ax_base_destroy(base);
+}
+
+static void bench_time(axut_runner *r)
+{
+	const int count = 1000000;
+	ax_base* base = ax_base_create();
+	ax_ulist_r ul_r = ax_ulist_create(ax_base_local(base), ax_stuff_traits(AX_ST_I32));
+	ax_list_r list_r = ax_list_create(ax_base_local(base), ax_stuff_traits(AX_ST_I32));
+	ax_seq *seqs[] = { ul_r.seq, list_r.seq };
+
+	for (int s = 0; s < 2; s++) {
+		const char *name = s ? "list" : "ulist";
+		clock_t time_before = clock();
+		for (int32_t i = 0; i < count; i++)
+			ax_seq_push(seqs[s], &i);
+		//printf("%s push: %lfs\n", name, (double)(clock()-time_before) / CLOCKS_PER_SEC);
+
+		time_before = clock();
+		int64_t sum = 0;
+		for (int k = 0; k < 10; k++)
+			ax_box_cforeach(ax_r(seq, seqs[s]).box, const int32_t *, v)
+				sum += *v;
+		//printf("%s traverse x10: %lfs\n", name, (double)(clock()-time_before) / CLOCKS_PER_SEC);
+		axut_assert(r, sum == (int64_t)count * (count - 1) / 2 * 10);
+
+		/* Insert and erase around the middle through a held iterator */
+		ax_iter it = ax_seq_at(seqs[s], count / 2);
+		time_before = clock();
+		for (int32_t i = 0; i < count; i++) {
+			ax_seq_insert(seqs[s], &it, &i);
+			if (i % 4 == 0)
+				ax_iter_erase(&it);
+		}
+		//printf("%s middle insert: %lfs\n", name, (double)(clock()-time_before) / CLOCKS_PER_SEC);
+		axut_assert(r, ax_box_size(ax_r(seq, seqs[s]).box) == count / 4 * 7);
+	}
+
+	/* A list node carries two links beside the value, plus pool bookkeeping */
+	size_t list_bytes = ax_box_size(ul_r.box) * (2 * sizeof(void *) + sizeof(int32_t));
+	//printf("ulist footprint: %zu bytes, list at least: %zu bytes\n", ax_ulist_footprint(ul_r.ulist), list_bytes);
+	axut_assert(r, ax_ulist_footprint(ul_r.ulist) < list_bytes);
+
+	ax_base_destroy(base);
+}
+
+axut_suite *suite_for_ulist(ax_base *base)
+{
+	axut_suite* suite = axut_suite_create(ax_base_local(base), "ulist");
+
+	axut_suite_add(suite, create, 0);
+	axut_suite_add(suite, push_pop, 0);
+	axut_suite_add(suite, iter, 0);
+	axut_suite_add(suite, insert_erase, 0);
+	axut_suite_add(suite, random_edit, 0);
+	axut_suite_add(suite, range, 0);
+	axut_suite_add(suite, any_copy_move, 0);
+	axut_suite_add(suite, bench_time, 0);
+
+	return suite;
+}
@@ -12,6 +12,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <time.h>
 
 static void create(axut_runner *r)
 {
@@ -175,6 +176,94 @@ static void seq_insert_for_riter(axut_runner *r)
 	ax_base_destroy(base);
 }
 
+static void seq_range(axut_runner *r)
+{
+	ax_base* base = ax_base_create();
+	ax_vector_r self_r = ax_vector_init(ax_base_local(base), "i32x2", 1, 2);
+	ax_vector_r src_r = ax_vector_init(ax_base_local(base), "i32x3", 7, 8, 9);
+
+	int32_t arr[] = {3, 4};
+	ax_iter it = ax_box_begin(self_r.box);
+	ax_iter_next(&it);
+	axut_assert(r, !ax_seq_insert_arr(self_r.seq, &it, arr, 2));
+	int32_t table1[] = {1, 3, 4, 2};
+	axut_assert(r, seq_equal_array(self_r.seq, table1, sizeof table1));
+	axut_assert(r, *(int32_t *)ax_iter_get(&it) == 2);
+
+	ax_iter first = ax_box_begin(src_r.box), last = ax_box_end(src_r.box);
+	axut_assert(r, !ax_seq_append_range(self_r.seq, ax_iter_c(&first), ax_iter_c(&last)));
+	int32_t table2[] = {1, 3, 4, 2, 7, 8, 9};
+	axut_assert(r, seq_equal_array(self_r.seq, table2, sizeof table2));
+
+	it = ax_box_rbegin(self_r.box);
+	axut_assert(r, !ax_seq_insert_range(self_r.seq, &it, ax_iter_c(&first), ax_iter_c(&last)));
+	int32_t table3[] = {1, 3, 4, 2, 7, 8, 9, 9, 8, 7};
+	axut_assert(r, seq_equal_array(self_r.seq, table3, sizeof table3));
+
+	axut_assert(r, !ax_seq_insert_arr(self_r.seq, &it, arr, 0));
+	axut_assert(r, !ax_seq_insert_range(self_r.seq, &it, ax_iter_c(&first), ax_iter_c(&first)));
+	axut_assert(r, ax_box_size(self_r.box) == 10);
+
+	ax_base_destroy(base);
+}
+
+static void seq_erase_range(axut_runner *r)
+{
+	ax_base* base = ax_base_create();
+	ax_vector_r self_r = ax_vector_init(ax_base_local(base), "i32x6", 1, 2, 3, 4, 5, 6);
+
+	ax_iter first = ax_box_begin(self_r.box), last = ax_box_begin(self_r.box);
+	ax_iter_next(&first);
+	ax_iter_next(&last);
+	ax_iter_next(&last);
+	ax_iter_next(&last);
+	axut_assert(r, !ax_seq_erase_range(self_r.seq, &first, &last));
+	int32_t table1[] = {1, 4, 5, 6};
+	axut_assert(r, seq_equal_array(self_r.seq, table1, sizeof table1));
+	axut_assert(r, *(int32_t *)ax_iter_get(&first) == 4);
+	axut_assert(r, ax_iter_equal(&first, &last));
+
+	first = ax_box_rbegin(self_r.box);
+	last = ax_box_rbegin(self_r.box);
+	ax_iter_next(&last);
+	ax_iter_next(&last);
+	axut_assert(r, !ax_seq_erase_range(self_r.seq, &first, &last));
+	int32_t table2[] = {1, 4};
+	axut_assert(r, seq_equal_array(self_r.seq, table2, sizeof table2));
+	axut_assert(r, *(int32_t *)ax_iter_get(&first) == 4);
+
+	first = ax_box_begin(self_r.box);
+	last = ax_box_end(self_r.box);
+	axut_assert(r, !ax_seq_erase_range(self_r.seq, &first, &last));
+	axut_assert(r, ax_box_size(self_r.box) == 0);
+
+	ax_base_destroy(base);
+}
+
+static void seq_range_link(axut_runner *r)
+{
+	ax_base* base = ax_base_create();
+	ax_vector_r self_r = ax_vector_create(ax_base_local(base), ax_stuff_traits(AX_ST_S));
+
+	const char *arr[] = {"a", "b", "c", "d"};
+	axut_assert(r, !ax_seq_append_arr(self_r.seq, arr, 4));
+	axut_assert(r, ax_box_size(self_r.box) == 4);
+
+	ax_iter first = ax_box_begin(self_r.box), last = ax_box_end(self_r.box);
+	ax_iter_next(&first);
+	ax_iter_prev(&last);
+	axut_assert(r, !ax_seq_erase_range(self_r.seq, &first, &last));
+
+	int i = 0;
+	const char *expect[] = {"a", "d"};
+	ax_box_cforeach(self_r.box, const char *, s) {
+		axut_assert(r, strcmp(s, expect[i++]) == 0);
+	}
+	axut_assert(r, i == 2);
+
+	ax_base_destroy(base);
+}
+
 static void any_move(axut_runner *r)
 {
 	ax_base* base = ax_base_create();
@@ -252,6 +341,114 @@ static void seq_invert(axut_runner *r)
 	ax_base_destroy(base);
 }
 
+static void any_copy_link(axut_runner *r)
+{
+	ax_base* base = ax_base_create();
+	ax_vector_r role1 = ax_vector_create(ax_base_local(base), ax_stuff_traits(AX_ST_S));
+	ax_seq_push(role1.seq, "foo");
+	ax_seq_push(role1.seq, "bar");
+	ax_vector_r role2 = { .any = ax_any_copy(role1.any) };
+	axut_assert(r, role2.any != NULL);
+
+	ax_box_clear(role1.box);
+	axut_assert(r, ax_box_size(role2.box) == 2);
+	ax_iter it = ax_seq_at(role2.seq, 0);
+	axut_assert(r, strcmp(ax_iter_get(&it), "foo") == 0);
+	it = ax_seq_at(role2.seq, 1);
+	axut_assert(r, strcmp(ax_iter_get(&it), "bar") == 0);
+
+	ax_base_destroy(base);
+}
+
+static void small_spill(axut_runner *r)
+{
+	ax_base* base = ax_base_create();
+	ax_vector_r vec_r = ax_vector_init(ax_base_local(base), "i32x3", 0, 1, 2);
+	ax_vector_r copy_r = { .any = ax_any_copy(vec_r.any) };
+
+	for (int i = 3; i < 100; i++) {
+		ax_seq_push(vec_r.seq, &i);
+		ax_iter it = ax_seq_at(vec_r.seq, 0);
+		axut_assert(r, *(int32_t *)ax_iter_get(&it) == 0);
+		it = ax_seq_at(vec_r.seq, i);
+		axut_assert(r, *(int32_t *)ax_iter_get(&it) == i);
+	}
+	int32_t table1[] = {0, 1, 2};
+	axut_assert(r, seq_equal_array(copy_r.seq, table1, sizeof table1));
+
+	ax_vector_r moved_r = { .any = ax_any_move(copy_r.any) };
+	axut_assert(r, seq_equal_array(moved_r.seq, table1, sizeof table1));
+	axut_assert(r, ax_box_size(copy_r.box) == 0);
+
+	moved_r.any = ax_any_move(vec_r.any);
+	axut_assert(r, ax_box_size(moved_r.box) == 100);
+	axut_assert(r, ax_box_size(vec_r.box) == 0);
+	ax_seq_push(vec_r.seq, table1);
+	axut_assert(r, ax_box_size(vec_r.box) == 1);
+
+	ax_base_destroy(base);
+}
+
+static void small_time(axut_runner *r)
+{
+	const int count = 1000000;
+	ax_base* base = ax_base_create();
+	ax_vector_r *vecs = malloc(count * sizeof *vecs);
+	clock_t time_before = clock();
+
+	for (int i = 0; i < count; i++) {
+		vecs[i] = ax_vector_create(ax_base_local(base), ax_stuff_traits(AX_ST_I64));
+		for (int64_t j = 0; j < 3; j++)
+			ax_seq_push(vecs[i].seq, &j);
+	}
+	for (int i = 0; i < count; i++)
+		ax_one_free(vecs[i].one);
+	//printf("create %d small vectors: %lfs\n", count, (double)(clock()-time_before) / CLOCKS_PER_SEC);
+
+	free(vecs);
+	ax_base_destroy(base);
+}
+
+static void trivial_time(axut_runner *r)
+{
+	const int count = 10000000, front = 20000;
+	ax_base* base = ax_base_create();
+	ax_stuff_trait slow_tr = *ax_stuff_traits(AX_ST_I64);
+	slow_tr.trivial_copy = ax_false;
+	slow_tr.trivial_move = ax_false;
+	slow_tr.trivial_free = ax_false;
+	const ax_stuff_trait *trs[] = { ax_stuff_traits(AX_ST_I64), &slow_tr };
+
+	for (int t = 0; t < 2; t++) {
+		clock_t time_before;
+		ax_vector_r vec_r = ax_vector_create(ax_base_local(base), trs[t]);
+
+		time_before = clock();
+		for (int64_t i = 0; i < count; i++)
+			ax_seq_push(vec_r.seq, &i);
+		//printf("push %s: %lfs\n", t ? "generic" : "trivial", (double)(clock()-time_before) / CLOCKS_PER_SEC);
+
+		time_before = clock();
+		ax_vector_r copy_r = { .any = ax_any_copy(vec_r.any) };
+		//printf("copy %s: %lfs\n", t ? "generic" : "trivial", (double)(clock()-time_before) / CLOCKS_PER_SEC);
+		axut_assert(r, ax_box_size(copy_r.box) == count);
+		ax_one_free(copy_r.one);
+
+		ax_box_clear(vec_r.box);
+		time_before = clock();
+		for (int64_t i = 0; i < front; i++) {
+			ax_iter it = ax_box_begin(vec_r.box);
+			ax_seq_insert(vec_r.seq, &it, &i);
+		}
+		//printf("insert at front %s: %lfs\n", t ? "generic" : "trivial", (double)(clock()-time_before) / CLOCKS_PER_SEC);
+		axut_assert(r, *(int64_t *)ax_seq_first(vec_r.seq) == front - 1);
+
+		ax_one_free(vec_r.one);
+	}
+
+	ax_base_destroy(base);
+}
+
 axut_suite *suite_for_vector(ax_base *base)
 {
 	axut_suite* suite = axut_suite_create(ax_base_local(base), "vector");
@@ -260,12 +457,19 @@ axut_suite *suite_for_vector(ax_base *base)
 	axut_suite_add(suite, push, 0);
 	axut_suite_add(suite, any_move, 0);
 	axut_suite_add(suite, any_copy, 0);
+	axut_suite_add(suite, any_copy_link, 0);
 	axut_suite_add(suite, iter, 0);
 	axut_suite_add(suite, riter, 0);
 	axut_suite_add(suite, seq_insert, 0);
 	axut_suite_add(suite, seq_insert_for_riter, 0);
+	axut_suite_add(suite, seq_range, 0);
+	axut_suite_add(suite, seq_erase_range, 0);
+	axut_suite_add(suite, seq_range_link, 0);
 	axut_suite_add(suite, seq_trunc, 0);
 	axut_suite_add(suite, seq_invert, 0);
+	axut_suite_add(suite, small_spill, 0);
+	axut_suite_add(suite, small_time, 0);
+	axut_suite_add(suite, trivial_time, 0);
 
 	return suite;
 }